@@ -20,6 +20,26 @@
 
 #include "dbbe_api.h"
 
+/*
+ * initialize a completion in caller-provided memory (e.g. from a pool)
+ */
+static inline
+dbBE_Completion_t* dbBE_Completion_init( dbBE_Completion_t *completion,
+                                         dbBE_Request_t *request,
+                                         DBR_Errorcode_t dbr_status,
+                                         int64_t rc )
+{
+  if(( completion == NULL ) || ( request == NULL ))
+    return NULL;
+
+  completion->_next = NULL;
+  completion->_rc = rc;
+  completion->_user = request->_user;
+  completion->_status = dbr_status;
+
+  return completion;
+}
+
 static inline
 dbBE_Completion_t* dbBE_Completion_create( dbBE_Request_t *request,
                                            DBR_Errorcode_t dbr_status,
@@ -32,12 +52,7 @@ dbBE_Completion_t* dbBE_Completion_create( dbBE_Request_t *request,
   if( completion == NULL )
     return NULL;
 
-  completion->_next = NULL;
-  completion->_rc = rc;
-  completion->_user = request->_user;
-  completion->_status = dbr_status;
-
-  return completion;
+  return dbBE_Completion_init( completion, request, dbr_status, rc );
 }
 
 static inline
@@ -78,6 +93,10 @@ ssize_t dbBE_Completion_serialize( const dbBE_Opcode op,
       if(( comp->_status == DBR_SUCCESS ) || ( comp->_status == DBR_ERR_UBUFFER ))
         sge_total = dbBE_SGE_serialize( sge, sge_count, data, space );
       break;
+    case DBBE_OPCODE_STAT:
+      if( comp->_status == DBR_SUCCESS )
+        sge_total = dbBE_SGE_serialize( sge, sge_count, data, space );
+      break;
     case DBBE_OPCODE_DIRECTORY:
       if( sge_count < 1 )
         return -ENOSPC;
@@ -164,6 +183,7 @@ ssize_t dbBE_Completion_deserialize( char *data,
     case DBBE_OPCODE_DIRECTORY:
     case DBBE_OPCODE_ITERATOR:
     case DBBE_OPCODE_NSQUERY:
+    case DBBE_OPCODE_STAT:
       if(( sge_out == NULL ) || ( sge_count_out == NULL ))
         return -EINVAL;
       if( status == DBR_SUCCESS )
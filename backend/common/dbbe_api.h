@@ -415,7 +415,32 @@ typedef enum
    * *  param[out] @ref dbBE_Completion_t*  _next = NULL unless multiple completions are created at the same time
    */
   DBBE_OPCODE_ITERATOR, /**< Iteration over existing keys */
-  DBBE_OPCODE_MAX  /**< Non-implemented operation to simplify range checks for opcodes  */
+
+  /** @brief Tuple metadata query without transferring any value
+   *
+   * The specs of the request are:
+   * *  param[in] _opcode = DBBE_OPCODE_STAT
+   * *  param[in] @ref dbBE_NS_Handle_t     _ns_hdl a valid handle to an attached namespace
+   * *  param[in]      void*                _user = pointer to anything, will be returned with completion without change
+   * *  param[in] @ref dbBE_Request_t*      _next = NULL unless this is a chained request
+   * *  param[in] @ref DBR_Group_t          _group = pointer or definition of source storage group
+   * *  param[in] @ref DBR_Tuple_name_t     _key = pointer to string with tuple name
+   * *  param[in] @ref DBR_Tuple_template_t _match = pattern to match when looking for the key
+   * *  param[in]      int64_t              _flags ignored
+   * *  param[in]      int                  _sge_count = 1
+   * *  param[in] @ref dbBE_sge_t[]         _sge[0] = space for 2 int64_t: number of values and size of the first value
+   *                                                  (with space for only 1 int64_t, only the number of values is queried)
+   *
+   * The specs for the completion are:
+   * *  param[out] _status = @ref DBR_SUCCESS or error code indicating issues:
+   *    * @ref DBR_ERR_UNAVAIL   the tuple doesn't exist
+   *    * for status codes see @ref DBBE_OPCODE_UNSPEC
+   * *  param[out] void*                    _user = unmodified ptr provided in request
+   * *  param[out] int64_t                  _rc = number of values stored under the tuple name
+   * *  param[out] @ref dbBE_Completion_t*  _next = NULL unless multiple completions are created at the same time
+   */
+  DBBE_OPCODE_STAT,
+  DBBE_OPCODE_MAX /**< Non-implemented operation to simplify range checks for opcodes  */
 } dbBE_Opcode;
 
 enum
@@ -562,6 +587,46 @@ typedef struct dbBE_api
    * @return pointer to a completion or NULL if no request is complete
    */
   dbBE_Completion_t* (*test_any)( dbBE_Handle_t );
+
+  /**
+   * @brief block until the back-end might be able to make progress
+   *
+   * Optional (may be NULL). Allows the client library to sleep instead of
+   * busy-polling test_any() while waiting for completions. Returns early
+   * if there's pending work, if any connection becomes ready, or if wakeup()
+   * is called by another thread. Has the same thread-safety requirements as test_any().
+   *
+   * @param [in] back-end handle  pointing to an initialized back-end
+   * @param [in] timeout_usec     max time to block in microseconds
+   *
+   * @return 1 if there's potential progress, 0 on timeout, negative error code otherwise
+   */
+  int (*wait)( dbBE_Handle_t, int64_t );
+
+  /**
+   * @brief interrupt a thread that's blocked in wait()
+   *
+   * Optional (may be NULL, must be provided if wait() is provided).
+   * Unlike the other calls, this one has to be safe to call from any thread
+   * at any time, e.g. when another thread needs to get into the back-end.
+   *
+   * @param [in] back-end handle  pointing to an initialized back-end
+   *
+   * @return 0 on success, error code otherwise
+   */
+  int (*wakeup)( dbBE_Handle_t );
+
+  /**
+   * @brief return a completion to the back-end after it has been processed
+   *
+   * Optional (may be NULL, the client library then calls free() on completions).
+   * Allows the back-end to recycle completions instead of allocating one for each request.
+   * Has the same thread-safety requirements as test_any().
+   *
+   * @param [in] back-end handle  pointing to an initialized back-end
+   * @param [in] completion       a completion that was returned by test() or test_any()
+   */
+  void (*release)( dbBE_Handle_t, dbBE_Completion_t* );
 } dbBE_api_t;
 
 
@@ -0,0 +1,129 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef BACKEND_COMMON_POOL_H_
+#define BACKEND_COMMON_POOL_H_
+
+#include <stddef.h>
+#include <errno.h>
+#ifdef __APPLE__
+#include <stdlib.h>
+#else
+#include <malloc.h>
+#endif
+#include <pthread.h>
+
+/*
+ * free-list cache of fixed-size objects for the request path
+ * released objects are kept for reuse up to a limit, beyond that they go back to the heap
+ * every object is allocated individually, so a pool can shrink and objects can be freed with free()
+ */
+typedef struct dbBE_Pool_entry
+{
+  struct dbBE_Pool_entry *_next;
+} dbBE_Pool_entry_t;
+
+typedef struct
+{
+  pthread_mutex_t _lock;
+  dbBE_Pool_entry_t *_free;   ///< cached objects
+  size_t _obj_size;           ///< size of each object
+  size_t _cached;             ///< number of cached objects
+  size_t _max_cached;         ///< limit of cached objects
+} dbBE_Pool_t;
+
+#define DBBE_POOL_INITIALIZER( obj_size, max_cached ) \
+  { PTHREAD_MUTEX_INITIALIZER, NULL, \
+    ( (obj_size) < sizeof( dbBE_Pool_entry_t ) ? sizeof( dbBE_Pool_entry_t ) : (obj_size) ), \
+    0, (max_cached) }
+
+/*
+ * take an object from the pool or allocate a new one
+ * the content of the object is undefined
+ */
+static inline
+void* dbBE_Pool_get( dbBE_Pool_t *pool )
+{
+  if( pool == NULL )
+  {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  pthread_mutex_lock( &pool->_lock );
+  dbBE_Pool_entry_t *obj = pool->_free;
+  if( obj != NULL )
+  {
+    pool->_free = obj->_next;
+    --pool->_cached;
+  }
+  pthread_mutex_unlock( &pool->_lock );
+
+  if( obj == NULL )
+    obj = (dbBE_Pool_entry_t*)malloc( pool->_obj_size );
+  return (void*)obj;
+}
+
+/*
+ * return an object to the pool
+ * the object has to be from this pool or a heap allocation of at least the object size
+ */
+static inline
+void dbBE_Pool_put( dbBE_Pool_t *pool, void *ptr )
+{
+  if(( pool == NULL ) || ( ptr == NULL ))
+    return;
+
+  dbBE_Pool_entry_t *obj = (dbBE_Pool_entry_t*)ptr;
+  pthread_mutex_lock( &pool->_lock );
+  if( pool->_cached < pool->_max_cached )
+  {
+    obj->_next = pool->_free;
+    pool->_free = obj;
+    ++pool->_cached;
+    obj = NULL;
+  }
+  pthread_mutex_unlock( &pool->_lock );
+
+  if( obj != NULL )
+    free( obj );
+}
+
+/*
+ * release all cached objects (the pool remains usable)
+ */
+static inline
+void dbBE_Pool_drain( dbBE_Pool_t *pool )
+{
+  if( pool == NULL )
+    return;
+
+  pthread_mutex_lock( &pool->_lock );
+  dbBE_Pool_entry_t *obj = pool->_free;
+  pool->_free = NULL;
+  pool->_cached = 0;
+  pthread_mutex_unlock( &pool->_lock );
+
+  while( obj != NULL )
+  {
+    dbBE_Pool_entry_t *next = obj->_next;
+    free( obj );
+    obj = next;
+  }
+}
+
+#endif /* BACKEND_COMMON_POOL_H_ */
@@ -97,6 +97,7 @@ ssize_t dbBE_Request_serialize(const dbBE_Request_t *req, char *data, size_t spa
     case DBBE_OPCODE_READ:
     case DBBE_OPCODE_NSQUERY:
     case DBBE_OPCODE_ITERATOR:
+    case DBBE_OPCODE_STAT:
       sge_total = dbBE_SGE_serialize_header( req->_sge, req->_sge_count, data, space );
       break;
     case DBBE_OPCODE_DIRECTORY:
@@ -247,6 +248,7 @@ ssize_t dbBE_Request_deserialize( char *data, size_t space, dbBE_Request_t **req
     case DBBE_OPCODE_READ:
     case DBBE_OPCODE_NSQUERY:
     case DBBE_OPCODE_ITERATOR:
+    case DBBE_OPCODE_STAT:
       sge_count = dbBE_SGE_extract_header( NULL, 0, data, space, &sge_out, (size_t*)&sge_total );
       if( sge_count < 0 )
         dbBE_Request_deserialize_error( -EAGAIN, key, match, sge_out )
@@ -31,14 +31,32 @@
 
 #include "../common/dbbe_api.h"
 
+/*
+ * open addressing hash set of request pointers (linear probing)
+ * the table is a power of two and at least twice the requested capacity,
+ * so probe sequences stay short and there is always a free slot to stop a probe
+ */
 typedef struct
 {
   dbBE_Request_t **_set;  // holding the data
   size_t _size;             // amount of available space
   size_t _fill;             // actually occupied space
+  size_t _mask;             // table length - 1
   pthread_mutex_t _mutex;  // for any multithreaded locking
 } dbBE_Request_set_t;
 
+/*
+ * slot of a request pointer; the low bits are always 0 because of allocation alignment
+ */
+static inline
+size_t dbBE_Request_set_hash( const dbBE_Request_set_t *set,
+                              const dbBE_Request_t *request )
+{
+  uint64_t h = (uint64_t)(uintptr_t)request >> 4;
+  h *= 0x9E3779B97F4A7C15ULL;
+  return (size_t)( h >> 32 ) & set->_mask;
+}
+
 /*
  * create and initialize the set
  */
@@ -51,14 +69,20 @@ dbBE_Request_set_t* dbBE_Request_set_create( const size_t size )
 
   pthread_mutex_init( &set->_mutex, NULL );
 
-  set->_set = (dbBE_Request_t**)calloc( sizeof( dbBE_Request_t* ), size );
+  size_t len = 2;
+  while( len < 2 * size )
+    len <<= 1;
+
+  set->_set = (dbBE_Request_t**)calloc( sizeof( dbBE_Request_t* ), len );
   if( set->_set == NULL )
   {
+    pthread_mutex_destroy( &set->_mutex );
     free( set );
     return NULL;
   }
 
   set->_size = size;
+  set->_mask = len - 1;
   set->_fill = 0;
   return set;
 }
@@ -66,18 +90,19 @@ dbBE_Request_set_t* dbBE_Request_set_create( const size_t size )
 /*
  * returns 0 if there are no requests in the set
  * returns 1 if there are requests in the set (or set == NULL )
+ * lock-free, so callers can skip the set entirely when nothing was inserted
  */
 static inline
 size_t dbBE_Request_set_empty( const dbBE_Request_set_t *set )
 {
-  return (set == NULL ) || ( set->_fill == 0 );
+  return (set == NULL ) || ( __atomic_load_n( &set->_fill, __ATOMIC_ACQUIRE ) == 0 );
 }
 
 static inline
 size_t dbBE_Request_set_get_len( const dbBE_Request_set_t *set )
 {
   if( set != NULL )
-    return set->_fill;
+    return __atomic_load_n( &set->_fill, __ATOMIC_ACQUIRE );
   return 0;
 }
 
@@ -91,12 +116,8 @@ int dbBE_Request_set_clear( dbBE_Request_set_t *set )
     return EINVAL;
 
   pthread_mutex_lock( &set->_mutex );
-  size_t slot;
-  for( slot = 0; slot < set->_size; ++slot )
-  {
-    set->_set[ slot ] = NULL;
-    --set->_fill;
-  }
+  memset( set->_set, 0, sizeof( dbBE_Request_t* ) * ( set->_mask + 1 ) );
+  __atomic_store_n( &set->_fill, 0, __ATOMIC_RELEASE );
   pthread_mutex_unlock( &set->_mutex );
   return 0;
 }
@@ -120,6 +141,44 @@ int dbBE_Request_set_destroy( dbBE_Request_set_t *set )
   return 0;
 }
 
+/*
+ * probe for the request (requires the set mutex)
+ * returns the slot of the request or of the first free slot of its probe sequence
+ */
+static inline
+size_t dbBE_Request_set_probe( const dbBE_Request_set_t *set,
+                               const dbBE_Request_t *request )
+{
+  size_t slot = dbBE_Request_set_hash( set, request );
+  while(( set->_set[ slot ] != NULL ) && ( set->_set[ slot ] != request ))
+    slot = ( slot + 1 ) & set->_mask;
+  return slot;
+}
+
+/*
+ * remove the entry at slot and close the gap in the probe sequence (requires the set mutex)
+ * moves later entries back so that lookups never need tombstones
+ */
+static inline
+void dbBE_Request_set_remove_slot( dbBE_Request_set_t *set,
+                                   size_t slot )
+{
+  size_t next = ( slot + 1 ) & set->_mask;
+  while( set->_set[ next ] != NULL )
+  {
+    size_t home = dbBE_Request_set_hash( set, set->_set[ next ] );
+    // move the entry if its home slot is not within (slot, next]
+    if((( next - home ) & set->_mask ) >= (( next - slot ) & set->_mask ))
+    {
+      set->_set[ slot ] = set->_set[ next ];
+      slot = next;
+    }
+    next = ( next + 1 ) & set->_mask;
+  }
+  set->_set[ slot ] = NULL;
+  __atomic_store_n( &set->_fill, set->_fill - 1, __ATOMIC_RELEASE );
+}
+
 /*
  * inserts request into set
  * returns 0 on success
@@ -132,15 +191,21 @@ int dbBE_Request_set_insert( dbBE_Request_set_t *set,
   if(( set == NULL ) || ( request == NULL ))
     return EINVAL;
 
-  size_t slot;
-  for( slot = 0; slot < set->_size; ++slot )
-    if( set->_set[ slot ] == NULL )
-    {
-      set->_set[ slot ] = request;
-      ++set->_fill;
-      return 0;
-    }
-  return ENOSPC;
+  pthread_mutex_lock( &set->_mutex );
+  if( set->_fill >= set->_size )
+  {
+    pthread_mutex_unlock( &set->_mutex );
+    return ENOSPC;
+  }
+
+  // like before, inserting the same request twice occupies two entries
+  size_t slot = dbBE_Request_set_hash( set, request );
+  while( set->_set[ slot ] != NULL )
+    slot = ( slot + 1 ) & set->_mask;
+  set->_set[ slot ] = request;
+  __atomic_store_n( &set->_fill, set->_fill + 1, __ATOMIC_RELEASE );
+  pthread_mutex_unlock( &set->_mutex );
+  return 0;
 }
 
 /*
@@ -154,12 +219,14 @@ int dbBE_Request_set_find( dbBE_Request_set_t *set,
 {
   if(( set == NULL ) || ( request == NULL ))
     return 0;
-  size_t slot;
-  for( slot = 0; slot < set->_size; ++slot )
-    if( set->_set[ slot ] == request )
-      return 1;
 
-  return 0;
+  if( dbBE_Request_set_empty( set ) )
+    return 0;
+
+  pthread_mutex_lock( &set->_mutex );
+  int found = ( set->_set[ dbBE_Request_set_probe( set, request ) ] != NULL );
+  pthread_mutex_unlock( &set->_mutex );
+  return found;
 }
 
 /*
@@ -177,17 +244,16 @@ int dbBE_Request_set_delete( dbBE_Request_set_t *set,
   if( dbBE_Request_set_empty( set ) )
     return 0;
 
-  size_t slot;
-  for( slot = 0; slot < set->_size; ++slot )
-    if( set->_set[ slot ] == request )
-    {
-      set->_set[ slot ] = NULL;
-      --set->_fill;
-      return 1;
-    }
-
-
-  return 0;
+  int deleted = 0;
+  pthread_mutex_lock( &set->_mutex );
+  size_t slot = dbBE_Request_set_probe( set, request );
+  if( set->_set[ slot ] != NULL )
+  {
+    dbBE_Request_set_remove_slot( set, slot );
+    deleted = 1;
+  }
+  pthread_mutex_unlock( &set->_mutex );
+  return deleted;
 }
 
 static inline
@@ -196,17 +262,21 @@ dbBE_Request_t* dbBE_Request_set_pop( dbBE_Request_set_t *set )
   if( set == NULL )
     return NULL;
 
+  if( dbBE_Request_set_empty( set ) )
+    return NULL;
+
+  dbBE_Request_t *request = NULL;
+  pthread_mutex_lock( &set->_mutex );
   size_t slot;
-  for( slot = 0; slot < set->_size; ++slot )
+  for( slot = 0; slot <= set->_mask; ++slot )
     if( set->_set[ slot ] != NULL )
     {
-      dbBE_Request_t *request = set->_set[ slot ];
-      set->_set[ slot ] = NULL;
-      --set->_fill;
-      return request;
+      request = set->_set[ slot ];
+      dbBE_Request_set_remove_slot( set, slot );
+      break;
     }
-
-  return NULL;
+  pthread_mutex_unlock( &set->_mutex );
+  return request;
 }
 
 #endif /* BACKEND_COMMON_REQUEST_SET_H_ */
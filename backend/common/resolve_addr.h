@@ -23,6 +23,7 @@
 
 #include <sys/types.h>  // getaddrinfo
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <netdb.h>
 
 #include "logutil.h" // LOG
@@ -32,6 +33,17 @@
 #define DBBE_MAX_PROTO_CHAR ( 16 )
 
 #define DBBE_PROTO_SOCKET "sock:"
+#define DBBE_PROTO_UNIX "unix:"
+
+/*
+ * getaddrinfo() doesn't resolve unix domain socket paths
+ * so those get a single self-contained entry that holds the address as well
+ */
+typedef struct
+{
+  struct addrinfo _info;
+  struct sockaddr_un _addr;
+} dbBE_Common_unix_addrinfo_t;
 
 static
 struct addrinfo* dbBE_Common_resolve_address_socket( const char *server_string, const int passive )
@@ -87,6 +99,36 @@ struct addrinfo* dbBE_Common_resolve_address_socket( const char *server_string,
 
 }
 
+static
+struct addrinfo* dbBE_Common_resolve_address_unix( const char *path )
+{
+  // check format:    no path or path exceeds the space in sockaddr_un
+  if(( path[0] == '\0' ) || ( strlen( path ) >= sizeof( ((struct sockaddr_un*)0)->sun_path )))
+  {
+    LOG( DBG_ERR, stderr, "DBR_SERVER requires UNIX://<path> formatting with a path of less than %zd chars\n",
+         sizeof( ((struct sockaddr_un*)0)->sun_path ) );
+    return NULL;
+  }
+
+  dbBE_Common_unix_addrinfo_t *uai = (dbBE_Common_unix_addrinfo_t*)calloc( 1, sizeof( dbBE_Common_unix_addrinfo_t ) );
+  if( uai == NULL )
+  {
+    LOG( DBG_ERR, stderr, "Failed to allocate mem for unix socket address\n" );
+    return NULL;
+  }
+
+  uai->_addr.sun_family = AF_UNIX;
+  strcpy( uai->_addr.sun_path, path );
+
+  uai->_info.ai_family = AF_UNIX;
+  uai->_info.ai_socktype = SOCK_STREAM;
+  uai->_info.ai_addr = (struct sockaddr*)&uai->_addr;
+  uai->_info.ai_addrlen = sizeof( struct sockaddr_un );
+
+  LOG( DBG_VERBOSE, stdout, "Using unix domain socket path=%s\n", path );
+  return &uai->_info;
+}
+
 static
 struct addrinfo* dbBE_Common_resolve_address( const char *server_string, const int passive )
 {
@@ -114,6 +156,12 @@ struct addrinfo* dbBE_Common_resolve_address( const char *server_string, const i
   {
     return dbBE_Common_resolve_address_socket( destination, passive );
   }
+
+  int unix_sock = strncmp( proto, DBBE_PROTO_UNIX, DBBE_MAX_PROTO_CHAR );
+  if( unix_sock == 0 )
+  {
+    return dbBE_Common_resolve_address_unix( destination );
+  }
   // todo: additional address resolvers go here ...
 
   return NULL;
@@ -123,7 +171,13 @@ static
 void dbBE_Common_release_addrinfo( struct addrinfo **addrs )
 {
   if(( addrs ) && ( *addrs ))
-    freeaddrinfo( *addrs );
+  {
+    // unix socket entries are not from getaddrinfo()
+    if( (*addrs)->ai_family == AF_UNIX )
+      free( *addrs );
+    else
+      freeaddrinfo( *addrs );
+  }
   *addrs = NULL;
 }
 
@@ -0,0 +1,201 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef BACKEND_COMMON_RING_H_
+#define BACKEND_COMMON_RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#ifdef __APPLE__
+#include <stdlib.h>
+#else
+#include <malloc.h>
+#endif
+#include <string.h>
+
+/*
+ * bounded lock-free ring of pointers
+ * any number of threads can push and pop concurrently (MPMC)
+ * each cell carries a sequence number that tells producers and consumers
+ * whether the cell is free or filled for the current lap around the ring
+ */
+#define DBBE_RING_CACHELINE ( 64 )
+
+typedef struct
+{
+  size_t _seq;
+  void *_data;
+} dbBE_Ring_cell_t;
+
+typedef struct
+{
+  dbBE_Ring_cell_t *_cells;
+  size_t _mask;        ///< number of cells - 1
+  char _pad0[ DBBE_RING_CACHELINE ];
+  size_t _head;        ///< next push position
+  char _pad1[ DBBE_RING_CACHELINE ];
+  size_t _tail;        ///< next pop position
+  char _pad2[ DBBE_RING_CACHELINE ];
+} dbBE_Ring_t;
+
+
+/*
+ * create a ring with space for at least size entries (rounded up to the next power of 2)
+ */
+static inline
+dbBE_Ring_t* dbBE_Ring_create( const size_t size )
+{
+  if( size == 0 )
+  {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  size_t cells = 1;
+  while( cells < size )
+    cells <<= 1;
+
+  dbBE_Ring_t *ring = (dbBE_Ring_t*)calloc( 1, sizeof( dbBE_Ring_t ) );
+  if( ring == NULL )
+    return NULL;
+
+  ring->_cells = (dbBE_Ring_cell_t*)calloc( cells, sizeof( dbBE_Ring_cell_t ) );
+  if( ring->_cells == NULL )
+  {
+    free( ring );
+    return NULL;
+  }
+
+  size_t n;
+  for( n = 0; n < cells; ++n )
+    ring->_cells[ n ]._seq = n;
+  ring->_mask = cells - 1;
+  return ring;
+}
+
+/*
+ * destroy the ring; remaining entries are dropped
+ */
+static inline
+int dbBE_Ring_destroy( dbBE_Ring_t *ring )
+{
+  if( ring == NULL )
+    return EINVAL;
+
+  free( ring->_cells );
+  memset( ring, 0, sizeof( dbBE_Ring_t ) );
+  free( ring );
+  return 0;
+}
+
+/*
+ * return the max number of entries
+ */
+static inline
+size_t dbBE_Ring_capacity( dbBE_Ring_t *ring )
+{
+  if( ring == NULL )
+    return 0;
+  return ring->_mask + 1;
+}
+
+/*
+ * return the current number of entries
+ * only a snapshot while other threads push or pop
+ */
+static inline
+size_t dbBE_Ring_len( dbBE_Ring_t *ring )
+{
+  if( ring == NULL )
+    return 0;
+  size_t tail = __atomic_load_n( &ring->_tail, __ATOMIC_ACQUIRE );
+  size_t head = __atomic_load_n( &ring->_head, __ATOMIC_ACQUIRE );
+  if( head <= tail )
+    return 0;
+  return ( head - tail > ring->_mask + 1 ) ? ring->_mask + 1 : head - tail;
+}
+
+/*
+ * append an entry
+ * returns EAGAIN if the ring is full
+ */
+static inline
+int dbBE_Ring_push( dbBE_Ring_t *ring, void *data )
+{
+  if(( ring == NULL ) || ( data == NULL ))
+    return EINVAL;
+
+  dbBE_Ring_cell_t *cell;
+  size_t pos = __atomic_load_n( &ring->_head, __ATOMIC_RELAXED );
+  for( ;; )
+  {
+    cell = &ring->_cells[ pos & ring->_mask ];
+    size_t seq = __atomic_load_n( &cell->_seq, __ATOMIC_ACQUIRE );
+    intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+    if( dif == 0 )
+    {
+      // cell is free in this lap; claim it
+      if( __atomic_compare_exchange_n( &ring->_head, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+        break;
+    }
+    else if( dif < 0 )
+      return EAGAIN; // cell still holds an entry from the previous lap
+    else
+      pos = __atomic_load_n( &ring->_head, __ATOMIC_RELAXED );
+  }
+
+  cell->_data = data;
+  __atomic_store_n( &cell->_seq, pos + 1, __ATOMIC_RELEASE );
+  return 0;
+}
+
+/*
+ * return and remove the first entry or NULL if the ring is empty
+ */
+static inline
+void* dbBE_Ring_pop( dbBE_Ring_t *ring )
+{
+  if( ring == NULL )
+    return NULL;
+
+  dbBE_Ring_cell_t *cell;
+  size_t pos = __atomic_load_n( &ring->_tail, __ATOMIC_RELAXED );
+  for( ;; )
+  {
+    cell = &ring->_cells[ pos & ring->_mask ];
+    size_t seq = __atomic_load_n( &cell->_seq, __ATOMIC_ACQUIRE );
+    intptr_t dif = (intptr_t)seq - (intptr_t)( pos + 1 );
+    if( dif == 0 )
+    {
+      // cell is filled in this lap; claim it
+      if( __atomic_compare_exchange_n( &ring->_tail, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+        break;
+    }
+    else if( dif < 0 )
+      return NULL; // nothing pushed to this cell yet
+    else
+      pos = __atomic_load_n( &ring->_tail, __ATOMIC_RELAXED );
+  }
+
+  void *data = cell->_data;
+  // release the cell for the next lap of producers
+  __atomic_store_n( &cell->_seq, pos + ring->_mask + 1, __ATOMIC_RELEASE );
+  return data;
+}
+
+#endif /* BACKEND_COMMON_RING_H_ */
@@ -0,0 +1,87 @@
+/*
+ * Copyright © 2018 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifdef __APPLE__
+#include <stdlib.h>
+#else
+#include <malloc.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+
+#include <libdatabroker.h>
+#include "logutil.h"
+#include "../pool.h"
+#include "test_utils.h"
+
+#define POOL_TEST_CACHED ( 4 )
+#define POOL_TEST_OBJ_SIZE ( 48 )
+
+int main( int argc, char ** argv )
+{
+  int rc = 0;
+  int i;
+  void *obj[ 2 * POOL_TEST_CACHED ];
+
+  dbBE_Pool_t pool = DBBE_POOL_INITIALIZER( POOL_TEST_OBJ_SIZE, POOL_TEST_CACHED );
+  dbBE_Pool_t tiny = DBBE_POOL_INITIALIZER( 1, POOL_TEST_CACHED );
+
+  rc += TEST( dbBE_Pool_get( NULL ), NULL );
+  dbBE_Pool_put( NULL, &rc );
+  dbBE_Pool_put( &pool, NULL );
+  rc += TEST( pool._cached, 0 );
+
+  // objects need to hold at least the free list pointer
+  rc += TEST( tiny._obj_size, sizeof( dbBE_Pool_entry_t ) );
+
+  // an empty pool allocates new objects
+  for( i = 0; i < 2 * POOL_TEST_CACHED; ++i )
+  {
+    obj[ i ] = dbBE_Pool_get( &pool );
+    rc += TEST_NOT( obj[ i ], NULL );
+    memset( obj[ i ], i, POOL_TEST_OBJ_SIZE );
+  }
+  TEST_LOG( rc, "Pool allocation" );
+
+  // only up to the limit is kept
+  for( i = 0; i < 2 * POOL_TEST_CACHED; ++i )
+    dbBE_Pool_put( &pool, obj[ i ] );
+  rc += TEST( pool._cached, POOL_TEST_CACHED );
+
+  // cached objects come back in LIFO order
+  for( i = POOL_TEST_CACHED - 1; i >= 0; --i )
+    rc += TEST( dbBE_Pool_get( &pool ), obj[ i ] );
+  rc += TEST( pool._cached, 0 );
+  TEST_LOG( rc, "Pool reuse" );
+
+  for( i = 0; i < POOL_TEST_CACHED; ++i )
+    dbBE_Pool_put( &pool, obj[ i ] );
+  rc += TEST( pool._cached, POOL_TEST_CACHED );
+  dbBE_Pool_drain( &pool );
+  rc += TEST( pool._cached, 0 );
+  rc += TEST( pool._free, NULL );
+
+  // still usable after drain
+  void *o = dbBE_Pool_get( &pool );
+  rc += TEST_NOT( o, NULL );
+  dbBE_Pool_put( &pool, o );
+  dbBE_Pool_drain( &pool );
+  dbBE_Pool_drain( &tiny );
+  TEST_LOG( rc, "Pool drain" );
+
+  printf( "Test exiting with rc=%d\n", rc );
+  return rc;
+}
@@ -56,8 +56,15 @@ int RemoveTest( dbBE_Request_set_t *set, dbBE_Request_t **req )
     rc += TEST_NOT( dbBE_Request_set_pop( set ), NULL );
   rc += TEST( dbBE_Request_set_get_len( set ), 1 );
 
-  // remove the last entry (head and tail access)
-  rc += TEST( dbBE_Request_set_delete( set, req[8] ), 1 );
+  // remove the last entry; pop order depends on the hash of the addresses
+  int remaining = 0;
+  for( i=0; i<10; ++i )
+    if( dbBE_Request_set_find( set, req[i] ) )
+    {
+      rc += TEST( dbBE_Request_set_delete( set, req[i] ), 1 );
+      ++remaining;
+    }
+  rc += TEST( remaining, 1 );
 
   // the set should be empty now
   rc += TEST( dbBE_Request_set_pop( set ), NULL );
@@ -66,6 +73,42 @@ int RemoveTest( dbBE_Request_set_t *set, dbBE_Request_t **req )
   return rc;
 }
 
+int CapacityTest()
+{
+  int rc = 0;
+  int i;
+  dbBE_Request_t req[ 64 ];
+  dbBE_Request_set_t *set = dbBE_Request_set_create( 63 );
+  rc += TEST_NOT( set, NULL );
+  TEST_BREAK( rc, "Set creation failed." );
+
+  // fill to capacity; more entries than slots get hashed close to each other
+  for( i=0; i<63; ++i )
+    rc += TEST( dbBE_Request_set_insert( set, &req[i] ), 0 );
+  rc += TEST( dbBE_Request_set_insert( set, &req[63] ), ENOSPC );
+  rc += TEST( dbBE_Request_set_get_len( set ), 63 );
+
+  for( i=0; i<63; ++i )
+    rc += TEST( dbBE_Request_set_find( set, &req[i] ), 1 );
+  rc += TEST( dbBE_Request_set_find( set, &req[63] ), 0 );
+
+  // delete every other entry; the rest has to stay reachable
+  for( i=0; i<63; i+=2 )
+    rc += TEST( dbBE_Request_set_delete( set, &req[i] ), 1 );
+  for( i=0; i<63; ++i )
+    rc += TEST( dbBE_Request_set_find( set, &req[i] ), i % 2 );
+  rc += TEST( dbBE_Request_set_delete( set, &req[0] ), 0 );
+  rc += TEST( dbBE_Request_set_get_len( set ), 31 );
+
+  rc += TEST( dbBE_Request_set_clear( set ), 0 );
+  rc += TEST_NOT( dbBE_Request_set_empty( set ), 0 );
+  rc += TEST( dbBE_Request_set_find( set, &req[1] ), 0 );
+
+  rc += TEST( dbBE_Request_set_destroy( set ), 0 );
+  TEST_LOG( rc, "Set Capacity Test." );
+  return rc;
+}
+
 int main( int argc, char *argv[] )
 {
   int rc = 0;
@@ -119,6 +162,7 @@ int main( int argc, char *argv[] )
   rc += TEST( dbBE_Request_set_get_len( set ), 0 );
 
   rc += RemoveTest( set, req );
+  rc += CapacityTest();
 
   // add a few items before destruction, to employ the wiping code path
   for( i=0; i<3; ++i )
@@ -0,0 +1,144 @@
+/*
+ * Copyright © 2018 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifdef __APPLE__
+#include <stdlib.h>
+#else
+#include <malloc.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <libdatabroker.h>
+#include "logutil.h"
+#include "../ring.h"
+#include "test_utils.h"
+
+#define RING_TEST_SIZE ( 6 )
+#define RING_TEST_THREADS ( 4 )
+#define RING_TEST_ITEMS ( 100000 )
+
+typedef struct
+{
+  dbBE_Ring_t *_ring;
+  uintptr_t _first;
+  uintptr_t _sum;
+} ring_thread_args_t;
+
+static
+void* producer( void *arg )
+{
+  ring_thread_args_t *a = (ring_thread_args_t*)arg;
+  uintptr_t n;
+  for( n = a->_first; n < a->_first + RING_TEST_ITEMS; ++n )
+    while( dbBE_Ring_push( a->_ring, (void*)n ) == EAGAIN )
+      sched_yield();
+  return NULL;
+}
+
+static
+void* consumer( void *arg )
+{
+  ring_thread_args_t *a = (ring_thread_args_t*)arg;
+  int n = 0;
+  while( n < RING_TEST_ITEMS )
+  {
+    uintptr_t v = (uintptr_t)dbBE_Ring_pop( a->_ring );
+    if( v == 0 )
+    {
+      sched_yield();
+      continue;
+    }
+    a->_sum += v;
+    ++n;
+  }
+  return NULL;
+}
+
+int main( int argc, char ** argv )
+{
+  int rc = 0;
+  uintptr_t i;
+
+  dbBE_Ring_t *ring = NULL;
+  rc += TEST( dbBE_Ring_create( 0 ), NULL );
+  rc += TEST_NOT_RC( dbBE_Ring_create( RING_TEST_SIZE ), NULL, ring );
+  TEST_BREAK( rc, "Ring creation failed" );
+
+  // capacity is rounded up to a power of 2
+  rc += TEST( dbBE_Ring_capacity( ring ), 8 );
+  rc += TEST( dbBE_Ring_len( ring ), 0 );
+  rc += TEST( dbBE_Ring_pop( ring ), NULL );
+  rc += TEST( dbBE_Ring_push( NULL, ring ), EINVAL );
+  rc += TEST( dbBE_Ring_push( ring, NULL ), EINVAL );
+  rc += TEST( dbBE_Ring_pop( NULL ), NULL );
+
+  // fill up and check backpressure
+  for( i = 1; i <= 8; ++i )
+    rc += TEST( dbBE_Ring_push( ring, (void*)i ), 0 );
+  rc += TEST( dbBE_Ring_len( ring ), 8 );
+  rc += TEST( dbBE_Ring_push( ring, (void*)i ), EAGAIN );
+  TEST_LOG( rc, "Ring fill" );
+
+  // FIFO order, also across the wrap-around
+  for( i = 1; i <= 4; ++i )
+    rc += TEST( dbBE_Ring_pop( ring ), (void*)i );
+  for( i = 9; i <= 12; ++i )
+    rc += TEST( dbBE_Ring_push( ring, (void*)i ), 0 );
+  for( i = 5; i <= 12; ++i )
+    rc += TEST( dbBE_Ring_pop( ring ), (void*)i );
+  rc += TEST( dbBE_Ring_pop( ring ), NULL );
+  rc += TEST( dbBE_Ring_len( ring ), 0 );
+  TEST_LOG( rc, "Ring order" );
+
+  rc += TEST( dbBE_Ring_destroy( ring ), 0 );
+  rc += TEST( dbBE_Ring_destroy( NULL ), EINVAL );
+
+  // concurrent producers and consumers through a small ring
+  ring_thread_args_t prod[ RING_TEST_THREADS ];
+  ring_thread_args_t cons[ RING_TEST_THREADS ];
+  pthread_t threads[ 2 * RING_TEST_THREADS ];
+  rc += TEST_NOT_RC( dbBE_Ring_create( 64 ), NULL, ring );
+  TEST_BREAK( rc, "Ring creation failed" );
+
+  int t;
+  for( t = 0; t < RING_TEST_THREADS; ++t )
+  {
+    prod[ t ]._ring = ring;
+    prod[ t ]._first = 1 + t * RING_TEST_ITEMS;
+    cons[ t ]._ring = ring;
+    cons[ t ]._sum = 0;
+    rc += TEST( pthread_create( &threads[ t ], NULL, producer, &prod[ t ] ), 0 );
+    rc += TEST( pthread_create( &threads[ RING_TEST_THREADS + t ], NULL, consumer, &cons[ t ] ), 0 );
+  }
+  uintptr_t sum = 0;
+  for( t = 0; t < 2 * RING_TEST_THREADS; ++t )
+    rc += TEST( pthread_join( threads[ t ], NULL ), 0 );
+  for( t = 0; t < RING_TEST_THREADS; ++t )
+    sum += cons[ t ]._sum;
+
+  // every item was consumed exactly once
+  uintptr_t total = RING_TEST_THREADS * RING_TEST_ITEMS;
+  rc += TEST( sum, total * ( total + 1 ) / 2 );
+  rc += TEST( dbBE_Ring_len( ring ), 0 );
+  rc += TEST( dbBE_Ring_destroy( ring ), 0 );
+  TEST_LOG( rc, "Ring concurrency" );
+
+  printf( "Test exiting with rc=%d\n", rc );
+  return rc;
+}
@@ -20,6 +20,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <inttypes.h>
 
 #include "logutil.h"
 
@@ -43,6 +44,22 @@ char* dbBE_Extract_env( const char *env_var, const char *env_default )
   return env;
 }
 
+/*
+ * FNV-1a hash of a string of up to maxlen characters
+ * used to index tables by name (e.g. namespaces)
+ */
+static inline
+uint32_t dbBE_String_hash( const char *str, const size_t maxlen )
+{
+  uint32_t hash = 2166136261u;
+  size_t n;
+  for( n = 0; ( n < maxlen ) && ( str[ n ] != '\0' ); ++n )
+  {
+    hash ^= (unsigned char)str[ n ];
+    hash *= 16777619u;
+  }
+  return hash;
+}
 
 
 
@@ -69,12 +69,49 @@ dbBE_Network_address_t* dbBE_Network_address_create( const char *host,
   return addr;
 }
 
+dbBE_Network_address_t* dbBE_Network_address_create_unix( const char *path )
+{
+  if(( path == NULL ) || ( path[0] == '\0' ))
+  {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  dbBE_Network_address_t *addr = dbBE_Network_address_allocate();
+  if( addr == NULL )
+    return NULL;
+
+  if( strlen( path ) >= sizeof( addr->_unix.sun_path ) )
+  {
+    dbBE_Network_address_destroy( addr );
+    errno = ENAMETOOLONG;
+    return NULL;
+  }
+
+  addr->_unix.sun_family = AF_UNIX;
+  strcpy( addr->_unix.sun_path, path );
+  addr->_len = sizeof( struct sockaddr_un );
+  return addr;
+}
+
 dbBE_Network_address_t* dbBE_Network_address_copy( struct sockaddr *in_addr,
                                                int in_addr_len )
 {
+  if(( in_addr == NULL ) || ( in_addr_len < 0 ))
+  {
+    errno = EINVAL;
+    return NULL;
+  }
+
   dbBE_Network_address_t *addr = dbBE_Network_address_allocate();
   if( addr != NULL )
+  {
+    // a truncated address from accept() can report more than we can hold
+    if( (size_t)in_addr_len > sizeof( addr->_unix ) )
+      in_addr_len = sizeof( addr->_unix );
     memcpy( &addr->_address, in_addr, in_addr_len );
+    addr->_len = in_addr_len;
+  }
 
   return addr;
 }
@@ -95,11 +132,18 @@ const char* dbBE_Network_address_to_string( dbBE_Network_address_t *addr, char *
   if(( str == NULL ) || ( addr == NULL ))
     return NULL;
 
+  // unnamed peers (e.g. accepted unix socket clients) just get the prefix
+  if( addr->_address.sin_family == AF_UNIX )
+  {
+    snprintf( str, strmaxlen, DBBE_NETWORK_UNIX_PREFIX"%.*s",
+              (int)sizeof( addr->_unix.sun_path ), addr->_unix.sun_path );
+    return str;
+  }
+
   char ip[ DBBE_URL_MAX_LENGTH ];
   if( inet_ntop( AF_INET, &(addr->_address.sin_addr.s_addr), ip, DBBE_URL_MAX_LENGTH ) == NULL )
     return NULL;
 
-  // for now just use the sock prefix until there are more/other url types
   snprintf( str, strmaxlen, "sock://%s:%d", ip, ntohs( addr->_address.sin_port ) );
 
   return str;
@@ -108,6 +152,12 @@ const char* dbBE_Network_address_to_string( dbBE_Network_address_t *addr, char *
 
 dbBE_Network_address_t* dbBE_Network_address_from_string( const char *str )
 {
+  if( str == NULL )
+    return NULL;
+
+  if( strncmp( str, DBBE_NETWORK_UNIX_PREFIX, DBBE_NETWORK_UNIX_PREFIX_LEN ) == 0 )
+    return dbBE_Network_address_create_unix( str + DBBE_NETWORK_UNIX_PREFIX_LEN );
+
   char *tmp = strdup( str );
   char *host = tmp;
   if( strchr( tmp, '/' ) != NULL )
@@ -141,6 +191,8 @@ int dbBE_Network_address_compare_ip( struct sockaddr_in *a,
   if( (a == NULL) || (b == NULL) )
     return 1;
   int rc = (a->sin_family == b->sin_family );
+  if( rc && ( a->sin_family == AF_UNIX ))
+    return 0;
   rc &= (a->sin_addr.s_addr == b->sin_addr.s_addr );
   return (rc == 0 );
 }
@@ -148,7 +200,11 @@ int dbBE_Network_address_compare_ip( struct sockaddr_in *a,
 int dbBE_Network_address_compare( dbBE_Network_address_t *a,
                                 dbBE_Network_address_t *b )
 {
+  if(( a == NULL ) || ( b == NULL ))
+    return 1;
   int rc = ( dbBE_Network_address_compare_ip( &a->_address, &b->_address ) == 0 );
+  if( rc && ( a->_address.sin_family == AF_UNIX ))
+    return ( strncmp( a->_unix.sun_path, b->_unix.sun_path, sizeof( a->_unix.sun_path )) != 0 );
   rc &= (a->_address.sin_port == b->_address.sin_port );
   return (rc == 0 );
 }
@@ -20,10 +20,20 @@
 
 #include <string.h>
 #include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define DBBE_NETWORK_UNIX_PREFIX "unix://"
+#define DBBE_NETWORK_UNIX_PREFIX_LEN ( 7 )
 
 typedef struct
 {
-  struct sockaddr_in _address;
+  union
+  {
+    struct sockaddr_in _address;
+    struct sockaddr_un _unix;  ///< node-local servers (_address.sin_family == AF_UNIX)
+  };
+  socklen_t _len;              ///< length of the valid part of the address
 } dbBE_Network_address_t;
 
 
@@ -38,6 +48,11 @@ dbBE_Network_address_t* dbBE_Network_address_allocate();
 dbBE_Network_address_t* dbBE_Network_address_create( const char *host,
                                                      const char *port );
 
+/*
+ * create a unix domain socket address from a path
+ */
+dbBE_Network_address_t* dbBE_Network_address_create_unix( const char *path );
+
 /*
  * copy the content of a socket address into the address
  */
@@ -46,7 +61,7 @@ dbBE_Network_address_t* dbBE_Network_address_copy( struct sockaddr *in_addr,
 
 
 /*
- * convert a sockaddr into a string addr:port
+ * convert a sockaddr into a string sock://addr:port or unix://path
  */
 const char* dbBE_Network_address_to_string( dbBE_Network_address_t *addr, char *str, int strmaxlen );
 
@@ -79,7 +94,7 @@ char* dbBE_Network_address_split( char *input )
 
 /*
  * compare 2 input addresses and return 0 if equal; 1 otherwise
- * compare the IP address only
+ * compare the IP address only; any 2 unix socket addresses are on the same node and match
  */
 int dbBE_Network_address_compare_ip( struct sockaddr_in *a,
                                      struct sockaddr_in *b );
@@ -184,7 +184,7 @@ int dbBE_Connection_reconnect( dbBE_Connection_t *conn )
 
   rc = connect( s,
                 (const struct sockaddr*)&(conn->_address->_address),
-                sizeof( conn->_address->_address ) );
+                conn->_address->_len );
   if( rc == 0 )
   {
     conn->_status = DBBE_CONNECTION_STATUS_CONNECTED;
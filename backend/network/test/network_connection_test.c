@@ -68,6 +68,12 @@ int main( int argc, char ** argv )
   rc += TEST_RC( dbBE_Connection_link( conn, "sock://localhost:", auth ), NULL, addr );
   rc += TEST( dbBE_Connection_get_status( conn ), DBBE_CONNECTION_STATUS_DISCONNECTED );
 
+  rc += TEST_RC( dbBE_Connection_link( conn, "unix://", auth ), NULL, addr );
+  rc += TEST( dbBE_Connection_get_status( conn ), DBBE_CONNECTION_STATUS_DISCONNECTED );
+
+  rc += TEST_RC( dbBE_Connection_link( conn, "unix:///NON_EXISTDIR/redis.sock", auth ), NULL, addr );
+  rc += TEST( dbBE_Connection_get_status( conn ), DBBE_CONNECTION_STATUS_DISCONNECTED );
+
   // now we should be able to link
   rc += TEST_NOT_RC( dbBE_Connection_link( conn, url, auth ), NULL, addr );
   rc += TEST( dbBE_Connection_get_status( conn ), DBBE_CONNECTION_STATUS_AUTHORIZED );
@@ -101,6 +107,25 @@ int main( int argc, char ** argv )
   rc += TEST( dbBE_Connection_unlink( conn ), 0 );
   rc += TEST( dbBE_Connection_get_status( conn ), DBBE_CONNECTION_STATUS_DISCONNECTED );
 
+  // unix socket addresses round-trip through their url and only match the same path
+  char ustr[ DBBE_URL_MAX_LENGTH ];
+  rc += TEST_NOT_RC( dbBE_Network_address_from_string( "unix:///tmp/dbr_test.sock" ), NULL, addr );
+  rc += TEST_NOT_RC( dbBE_Network_address_create_unix( "/tmp/dbr_test.sock" ), NULL, addr2 );
+  rc += TEST( strcmp( dbBE_Network_address_to_string( addr, ustr, DBBE_URL_MAX_LENGTH ), "unix:///tmp/dbr_test.sock" ), 0 );
+  rc += TEST( dbBE_Network_address_compare( addr, addr2 ), 0 );
+  rc += TEST( dbBE_Network_address_compare_ip( &addr->_address, &addr2->_address ), 0 );
+  dbBE_Network_address_destroy( addr2 );
+  rc += TEST_NOT_RC( dbBE_Network_address_create_unix( "/tmp/dbr_other.sock" ), NULL, addr2 );
+  rc += TEST( dbBE_Network_address_compare( addr, addr2 ), 1 );
+  rc += TEST( dbBE_Network_address_compare_ip( &addr->_address, &addr2->_address ), 0 );
+  dbBE_Network_address_destroy( addr2 );
+  rc += TEST_NOT_RC( dbBE_Network_address_from_string( "sock://127.0.0.1:6379" ), NULL, addr2 );
+  rc += TEST( dbBE_Network_address_compare( addr, addr2 ), 1 );
+  rc += TEST( dbBE_Network_address_compare_ip( &addr->_address, &addr2->_address ), 1 );
+  dbBE_Network_address_destroy( addr2 );
+  dbBE_Network_address_destroy( addr );
+  rc += TEST( dbBE_Network_address_create_unix( "" ), NULL );
+
   // cleanup
   rc += TEST( dbBE_Connection_destroy( NULL ), -EINVAL );
   rc += TEST( dbBE_Connection_destroy( conn ), 0 );
@@ -17,6 +17,12 @@
 
 #include "cluster_info.h"
 
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
 dbBE_Redis_cluster_info_t* dbBE_Redis_cluster_info_create_single( char *url )
 {
   // don't attempt to create cluster info for NULL-ptr url
@@ -143,6 +149,130 @@ int dbBE_Redis_cluster_info_remove_entry_idx( dbBE_Redis_cluster_info_t *ci, con
 
 
 
+/*
+ * topology cache file format (text):
+ *   line 1: magic, version, and the seed url the topology was discovered from
+ *   then one line per node: first_slot last_slot url [replica urls...]
+ */
+#define DBBE_REDIS_TOPOLOGY_MAGIC "dbr-topology"
+#define DBBE_REDIS_TOPOLOGY_VERSION ( 1 )
+
+int dbBE_Redis_cluster_info_save( dbBE_Redis_cluster_info_t *ci,
+                                  const char *seed_url,
+                                  const char *path )
+{
+  if(( ci == NULL ) || ( seed_url == NULL ) || ( path == NULL ) || ( ci->_cluster_size <= 0 ))
+    return -EINVAL;
+
+  // write to a private file and rename it, so concurrent readers only see complete snapshots
+  char tmp_path[ PATH_MAX ];
+  if( snprintf( tmp_path, PATH_MAX, "%s.%d", path, (int)getpid() ) >= PATH_MAX )
+    return -ENAMETOOLONG;
+
+  FILE *f = fopen( tmp_path, "w" );
+  if( f == NULL )
+    return -errno;
+
+  int rc = 0;
+  if( fprintf( f, "%s %d %s\n", DBBE_REDIS_TOPOLOGY_MAGIC, DBBE_REDIS_TOPOLOGY_VERSION, seed_url ) < 0 )
+    rc = -EIO;
+
+  int n, s;
+  for( n = 0; ( rc == 0 ) && ( n < ci->_cluster_size ); ++n )
+  {
+    dbBE_Redis_server_info_t *si = ci->_nodes[ n ];
+    if( fprintf( f, "%d %d", dbBE_Redis_server_info_get_first_slot( si ), dbBE_Redis_server_info_get_last_slot( si ) ) < 0 )
+      rc = -EIO;
+    // the current master goes first
+    char *master = dbBE_Redis_server_info_get_master( si );
+    if(( rc == 0 ) && ( master != NULL ) && ( fprintf( f, " %s", master ) < 0 ))
+      rc = -EIO;
+    for( s = 0; ( rc == 0 ) && ( s < dbBE_Redis_server_info_getsize( si ) ); ++s )
+    {
+      char *url = dbBE_Redis_server_info_get_replica( si, s );
+      if(( url != NULL ) && ( url != master ) && ( fprintf( f, " %s", url ) < 0 ))
+        rc = -EIO;
+    }
+    if(( rc == 0 ) && ( fputc( '\n', f ) == EOF ))
+      rc = -EIO;
+  }
+
+  if(( fclose( f ) != 0 ) && ( rc == 0 ))
+    rc = -EIO;
+  if(( rc == 0 ) && ( rename( tmp_path, path ) != 0 ))
+    rc = -errno;
+  if( rc != 0 )
+    unlink( tmp_path );
+  return rc;
+}
+
+dbBE_Redis_cluster_info_t* dbBE_Redis_cluster_info_load( const char *path,
+                                                         const char *seed_url )
+{
+  if(( path == NULL ) || ( seed_url == NULL ))
+    return NULL;
+
+  FILE *f = fopen( path, "r" );
+  if( f == NULL )
+    return NULL;
+
+  dbBE_Redis_cluster_info_t *ci = (dbBE_Redis_cluster_info_t*)calloc( 1, sizeof( dbBE_Redis_cluster_info_t ) );
+  const int line_len = DBR_SERVER_URL_MAX_LENGTH * ( DBBE_REDIS_CLUSTER_MAX_REPLICA + 1 ) + 64;
+  char *line = (char*)malloc( line_len );
+  if(( ci == NULL ) || ( line == NULL ))
+    goto error;
+
+  // a snapshot of a different cluster or version is ignored
+  char magic[ 16 ];
+  char seed[ DBR_SERVER_URL_MAX_LENGTH ];
+  int version = 0;
+  if(( fgets( line, line_len, f ) == NULL ) ||
+      ( sscanf( line, "%15s %d %1023s", magic, &version, seed ) != 3 ) ||
+      ( strcmp( magic, DBBE_REDIS_TOPOLOGY_MAGIC ) != 0 ) ||
+      ( version != DBBE_REDIS_TOPOLOGY_VERSION ) ||
+      ( strcmp( seed, seed_url ) != 0 ))
+    goto error;
+
+  while(( fgets( line, line_len, f ) != NULL ) && ( ci->_cluster_size < DBBE_REDIS_CLUSTER_MAX_SIZE ))
+  {
+    char *urls[ DBBE_REDIS_CLUSTER_MAX_REPLICA ];
+    char *save = NULL;
+    char *tok_first = strtok_r( line, " \n", &save );
+    char *tok_last = strtok_r( NULL, " \n", &save );
+    if(( tok_first == NULL ) || ( tok_last == NULL ))
+      goto error;
+
+    int count = 0;
+    char *url;
+    while(( count < DBBE_REDIS_CLUSTER_MAX_REPLICA ) && (( url = strtok_r( NULL, " \n", &save )) != NULL ))
+      urls[ count++ ] = url;
+
+    dbBE_Redis_server_info_t *si = dbBE_Redis_server_info_create_range( strtol( tok_first, NULL, 10 ),
+                                                                        strtol( tok_last, NULL, 10 ),
+                                                                        urls,
+                                                                        count );
+    if( si == NULL )
+      goto error;
+    ci->_nodes[ ci->_cluster_size++ ] = si;
+  }
+  if( ci->_cluster_size == 0 )
+    goto error;
+
+  free( line );
+  fclose( f );
+  return ci;
+
+error:
+  LOG( DBG_VERBOSE, stderr, "Ignoring invalid or mismatching topology cache %s\n", path );
+  if( ci != NULL )
+    dbBE_Redis_cluster_info_destroy( ci );
+  if( line != NULL )
+    free( line );
+  fclose( f );
+  return NULL;
+}
+
+
 int dbBE_Redis_cluster_info_destroy( dbBE_Redis_cluster_info_t *ci )
 {
   if( ci == NULL )
@@ -114,6 +114,21 @@ int dbBE_Redis_cluster_info_remove_entry_ptr( dbBE_Redis_cluster_info_t *ci,
 int dbBE_Redis_cluster_info_remove_entry_idx( dbBE_Redis_cluster_info_t *ci,
                                               const int idx );
 
+/*
+ * write a snapshot of the cluster info to a file (replaced atomically)
+ * the seed url identifies the cluster the snapshot belongs to
+ */
+int dbBE_Redis_cluster_info_save( dbBE_Redis_cluster_info_t *ci,
+                                  const char *seed_url,
+                                  const char *path );
+
+/*
+ * create cluster info from a snapshot file
+ * returns NULL if the file does not exist, is invalid, or belongs to a different seed url
+ */
+dbBE_Redis_cluster_info_t* dbBE_Redis_cluster_info_load( const char *path,
+                                                         const char *seed_url );
+
 /*
  * cleanup and destroy the cluster info structure
  */
@@ -16,6 +16,7 @@
  */
 
 #include "common/completion.h"
+#include "common/pool.h"
 #include "complete.h"
 #include "namespace.h"
 
@@ -27,6 +28,29 @@
 #include <malloc.h>
 #endif
 
+static dbBE_Pool_t gRedis_completion_pool = DBBE_POOL_INITIALIZER( sizeof( dbBE_Completion_t ), DBBE_REDIS_POOL_CACHED );
+
+static
+dbBE_Completion_t* dbBE_Redis_completion_create( dbBE_Request_t *request,
+                                                 DBR_Errorcode_t status,
+                                                 int64_t rc )
+{
+  if( request == NULL )
+    return NULL;
+  dbBE_Completion_t *completion = (dbBE_Completion_t*)dbBE_Pool_get( &gRedis_completion_pool );
+  return dbBE_Completion_init( completion, request, status, rc );
+}
+
+void dbBE_Redis_completion_release( dbBE_Completion_t *completion )
+{
+  dbBE_Pool_put( &gRedis_completion_pool, completion );
+}
+
+void dbBE_Redis_completion_pool_drain( void )
+{
+  dbBE_Pool_drain( &gRedis_completion_pool );
+}
+
 
 /*
  * convert a redis request in result stage into a completion
@@ -210,6 +234,10 @@ dbBE_Completion_t* dbBE_Redis_complete_command( dbBE_Redis_request_t *request,
           break;
       }
       break;
+    case DBBE_OPCODE_STAT:
+      if( rc == 0 )
+        localrc = result->_data._integer; // number of values
+      break;
     case DBBE_OPCODE_ITERATOR:
       switch( rc )
       {
@@ -225,17 +253,17 @@ dbBE_Completion_t* dbBE_Redis_complete_command( dbBE_Redis_request_t *request,
       break;
   }
 
-  return dbBE_Completion_create( request->_user, status, localrc );
+  return dbBE_Redis_completion_create( request->_user, status, localrc );
 }
 
 dbBE_Completion_t* dbBE_Redis_complete_error( dbBE_Redis_request_t *request,
                                               DBR_Errorcode_t error,
                                               int64_t retval )
 {
-  return dbBE_Completion_create( request->_user, error, retval );
+  return dbBE_Redis_completion_create( request->_user, error, retval );
 }
 
 dbBE_Completion_t* dbBE_Redis_complete_cancel( dbBE_Redis_request_t *request )
 {
-  return dbBE_Completion_create( request->_user, DBR_ERR_CANCELLED, 0 );
+  return dbBE_Redis_completion_create( request->_user, DBR_ERR_CANCELLED, 0 );
 }
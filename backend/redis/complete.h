@@ -44,4 +44,14 @@ dbBE_Completion_t* dbBE_Redis_complete_error( dbBE_Redis_request_t *request,
  */
 dbBE_Completion_t* dbBE_Redis_complete_cancel( dbBE_Redis_request_t *request );
 
+/*
+ * return a completion to the completion pool
+ */
+void dbBE_Redis_completion_release( dbBE_Completion_t *completion );
+
+/*
+ * release the cached completions (at back-end exit)
+ */
+void dbBE_Redis_completion_pool_drain( void );
+
 #endif /* BACKEND_REDIS_COMPLETE_H_ */
@@ -32,6 +32,8 @@
 #include <string.h>
 #include <stdio.h>
 #include <unistd.h> // usleep
+#include <poll.h>
+#include <time.h>
 #include <sys/types.h> // getifaddr
 #include <ifaddrs.h> // getifaddr
 
@@ -94,11 +96,13 @@ void dbBE_Redis_connection_mgr_exit( dbBE_Redis_connection_mgr_t *conn_mgr )
   unsigned n;
   for( n = 0; n < DBBE_REDIS_MAX_CONNECTIONS; ++n )
   {
-    if(( conn_mgr->_connections[ n ] == NULL ) && ( conn_mgr->_broken[ n ] == NULL ))
+    if(( conn_mgr->_connections[ n ] == NULL ) && ( conn_mgr->_broken[ n ] == NULL ) && ( conn_mgr->_blocking[ n ] == NULL ))
       continue;
     dbBE_Redis_connection_t *c = conn_mgr->_connections[ n ];
     if( c == NULL )
       c = conn_mgr->_broken[ n ];
+    if( c == NULL )
+      c = conn_mgr->_blocking[ n ];
     dbBE_Redis_event_mgr_rm( conn_mgr->_ev_mgr, c );
     dbBE_Redis_connection_destroy( c );
   }
@@ -154,7 +158,10 @@ int dbBE_Redis_connection_mgr_add( dbBE_Redis_connection_mgr_t *conn_mgr,
   }
 
   unsigned i = 0;
-  for( i = 0; (i < DBBE_REDIS_MAX_CONNECTIONS) && ((conn_mgr->_connections[ i ] != NULL) || ( conn_mgr->_broken[ i ] != NULL )); ++i ) {}
+  for( i = 0;
+      (i < DBBE_REDIS_MAX_CONNECTIONS) &&
+          ((conn_mgr->_connections[ i ] != NULL) || ( conn_mgr->_broken[ i ] != NULL ) || ( conn_mgr->_blocking[ i ] != NULL ));
+      ++i ) {}
   if( i >= DBBE_REDIS_MAX_CONNECTIONS )
   {
     LOG( DBG_ERR, stderr, "connection_mgr_add: connection slots exhausted. Can't add new connection.\n" );
@@ -165,6 +172,7 @@ int dbBE_Redis_connection_mgr_add( dbBE_Redis_connection_mgr_t *conn_mgr,
   conn_mgr->_broken[ i ] = NULL;
   ++conn_mgr->_connection_count;
   conn->_index = i;
+  conn->_worker = ( conn_mgr->_worker_count > 0 ) ? (int)( i % conn_mgr->_worker_count ) : 0;
 
   int rc = dbBE_Redis_event_mgr_add( conn_mgr->_ev_mgr, conn );
   if( rc != 0 )
@@ -222,6 +230,263 @@ exit_connect:
 }
 
 
+/*
+ * connect and authenticate new connections concurrently
+ * connects are non-blocking and the AUTH commands are pipelined, all within one link timeout
+ * successful conns end up AUTHORIZED; any others are closed (or NULL if they couldn't be created)
+ */
+static
+void dbBE_Redis_connection_mgr_link_all( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                         char **urls,
+                                         const int count,
+                                         const char *authfile,
+                                         dbBE_Redis_connection_t **conns )
+{
+  int n;
+  int pending = 0;
+  for( n = 0; n < count; ++n )
+  {
+    conns[ n ] = dbBE_Redis_connection_create( conn_mgr->_config->_rbuf_len );
+    if(( conns[ n ] != NULL ) && ( dbBE_Redis_connection_link_start( conns[ n ], urls[ n ] ) == 0 ))
+      ++pending;
+  }
+
+  // wait for all connects to complete at once
+  struct pollfd pfd[ DBBE_REDIS_MAX_CONNECTIONS ];
+  int idx[ DBBE_REDIS_MAX_CONNECTIONS ];
+  struct timespec now, deadline;
+  clock_gettime( CLOCK_MONOTONIC, &deadline );
+  deadline.tv_sec += DBBE_REDIS_LINK_TIMEOUT;
+  while( pending > 0 )
+  {
+    int nfds = 0;
+    for( n = 0; n < count; ++n )
+      if(( conns[ n ] != NULL ) && ( conns[ n ]->_status == DBBE_CONNECTION_STATUS_INITIALIZED ) && ( conns[ n ]->_socket >= 0 ))
+      {
+        pfd[ nfds ].fd = conns[ n ]->_socket;
+        pfd[ nfds ].events = POLLOUT;
+        pfd[ nfds ].revents = 0;
+        idx[ nfds ] = n;
+        ++nfds;
+      }
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    int64_t remaining_ms = ( deadline.tv_sec - now.tv_sec ) * 1000 + ( deadline.tv_nsec - now.tv_nsec ) / 1000000;
+    if(( nfds == 0 ) || ( remaining_ms <= 0 ))
+      break;
+
+    int rc = poll( pfd, nfds, (int)remaining_ms );
+    if(( rc < 0 ) && ( errno != EINTR ))
+      break;
+
+    int p;
+    for( p = 0; ( rc > 0 ) && ( p < nfds ); ++p )
+    {
+      if( pfd[ p ].revents == 0 )
+        continue;
+      dbBE_Redis_connection_link_finish( conns[ idx[ p ] ] );
+      --pending;
+    }
+  }
+
+  // pipelined authentication: all AUTH commands go out before any reply is awaited
+  for( n = 0; n < count; ++n )
+    if(( conns[ n ] != NULL ) && ( conns[ n ]->_status == DBBE_CONNECTION_STATUS_CONNECTED ))
+      if( dbBE_Redis_connection_auth_send( conns[ n ], authfile ) != 0 )
+        dbBE_Redis_connection_unlink( conns[ n ] );
+
+  for( n = 0; n < count; ++n )
+  {
+    if( conns[ n ] == NULL )
+      continue;
+    if( dbBE_Redis_connection_RTS( conns[ n ] ) && ( dbBE_Redis_connection_auth_complete( conns[ n ], &deadline ) == 0 ))
+      continue;
+    if( conns[ n ]->_socket >= 0 )
+    {
+      close( conns[ n ]->_socket );
+      conns[ n ]->_socket = -1;
+    }
+    conns[ n ]->_status = DBBE_CONNECTION_STATUS_DISCONNECTED;
+  }
+}
+
+int dbBE_Redis_connection_mgr_newlinks( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                        char **urls,
+                                        const int count,
+                                        dbBE_Redis_connection_t **conns )
+{
+  if(( conn_mgr == NULL ) || ( urls == NULL ) || ( conns == NULL ) ||
+      ( count < 0 ) || ( count > DBBE_REDIS_MAX_CONNECTIONS ))
+    return -EINVAL;
+
+  char *authfile = dbBE_Extract_env( DBR_SERVER_AUTHFILE_ENV, DBR_SERVER_DEFAULT_AUTHFILE );
+  if( authfile == NULL )
+    return -ENOENT;
+
+  dbBE_Redis_connection_mgr_link_all( conn_mgr, urls, count, authfile, conns );
+
+  int n;
+  int failed = 0;
+  for( n = 0; n < count; ++n )
+  {
+    if( conns[ n ] == NULL )
+    {
+      ++failed;
+      continue;
+    }
+
+    int rc = -ENOTCONN;
+    if( dbBE_Redis_connection_RTR( conns[ n ] ))
+      rc = dbBE_Redis_connection_mgr_add( conn_mgr, conns[ n ] );
+
+    if( rc != 0 )
+    {
+      // unfinished connects and any other failures get another try with the serial path
+      LOG( DBG_VERBOSE, stderr, "connection_mgr_newlinks: parallel link to %s failed (rc=%d); retrying\n", urls[ n ], rc );
+      if( conns[ n ]->_socket >= 0 )
+      {
+        close( conns[ n ]->_socket );
+        conns[ n ]->_socket = -1;
+        conns[ n ]->_status = DBBE_CONNECTION_STATUS_DISCONNECTED;
+      }
+      dbBE_Redis_connection_destroy( conns[ n ] );
+      conns[ n ] = dbBE_Redis_connection_mgr_newlink( conn_mgr, urls[ n ] );
+      if( conns[ n ] == NULL )
+        ++failed;
+    }
+  }
+
+  free( authfile );
+  return failed;
+}
+
+int dbBE_Redis_connection_mgr_blocking_links( dbBE_Redis_connection_mgr_t *conn_mgr )
+{
+  if( conn_mgr == NULL )
+    return -EINVAL;
+
+  // one url and owning connection per missing blocking connection, each in its own free slot
+  char *urls[ DBBE_REDIS_MAX_CONNECTIONS ];
+  dbBE_Redis_connection_t *owner[ DBBE_REDIS_MAX_CONNECTIONS ];
+  int slot[ DBBE_REDIS_MAX_CONNECTIONS ];
+  dbBE_Redis_connection_t *links[ DBBE_REDIS_MAX_CONNECTIONS ];
+  int blocking = 0;
+  int count = 0;
+  int next_slot = 0;
+  unsigned i, b;
+
+  for( b = 0; b < DBBE_REDIS_MAX_CONNECTIONS; ++b )
+    if( conn_mgr->_blocking[ b ] != NULL )
+      ++blocking;
+
+  for( i = 0; i < DBBE_REDIS_MAX_CONNECTIONS; ++i )
+  {
+    dbBE_Redis_connection_t *conn = conn_mgr->_connections[ i ];
+    if( ! dbBE_Redis_connection_RTR( conn ) )
+      continue;
+
+    // existing and already planned ones; more than one regular connection might go to the same server
+    int have = 0;
+    int k;
+    for( b = 0; b < DBBE_REDIS_MAX_CONNECTIONS; ++b )
+      if(( conn_mgr->_blocking[ b ] != NULL ) &&
+          ( dbBE_Network_address_compare( conn_mgr->_blocking[ b ]->_address, conn->_address ) == 0 ))
+        ++have;
+    for( k = 0; k < count; ++k )
+      if( dbBE_Network_address_compare( owner[ k ]->_address, conn->_address ) == 0 )
+        ++have;
+
+    // blocking connections never take more than a quarter of the table from the regular ones
+    for( ; ( have < DBBE_REDIS_BLOCKING_CONNECTIONS ) && ( blocking + count < (int)DBBE_REDIS_MAX_CONNECTIONS / 4 ); ++have )
+    {
+      for( ; ( next_slot < (int)DBBE_REDIS_MAX_CONNECTIONS ) &&
+             (( conn_mgr->_connections[ next_slot ] != NULL ) ||
+              ( conn_mgr->_broken[ next_slot ] != NULL ) ||
+              ( conn_mgr->_blocking[ next_slot ] != NULL )); ++next_slot ) {}
+      if( next_slot >= (int)DBBE_REDIS_MAX_CONNECTIONS )
+        break;
+      urls[ count ] = dbBE_Redis_connection_get_url( conn );
+      owner[ count ] = conn;
+      slot[ count ] = next_slot++;
+      ++count;
+    }
+  }
+  if( count == 0 )
+    return 0;
+
+  char *authfile = dbBE_Extract_env( DBR_SERVER_AUTHFILE_ENV, DBR_SERVER_DEFAULT_AUTHFILE );
+  if( authfile == NULL )
+    return -ENOENT;
+
+  dbBE_Redis_connection_mgr_link_all( conn_mgr, urls, count, authfile, links );
+  free( authfile );
+
+  int n;
+  int failed = 0;
+  for( n = 0; n < count; ++n )
+  {
+    int rc = -ENOTCONN;
+    if( dbBE_Redis_connection_RTR( links[ n ] ))
+    {
+      links[ n ]->_index = slot[ n ];
+      links[ n ]->_worker = owner[ n ]->_worker;
+      rc = dbBE_Redis_event_mgr_add( conn_mgr->_ev_mgr, links[ n ] );
+    }
+    if( rc != 0 )
+    {
+      LOG( DBG_ERR, stderr, "connection_mgr_blocking_links: failed to link %s. rc=%d\n", urls[ n ], rc );
+      if( links[ n ] != NULL )
+      {
+        dbBE_Redis_connection_unlink( links[ n ] );
+        dbBE_Redis_connection_destroy( links[ n ] );
+      }
+      ++failed;
+      continue;
+    }
+    conn_mgr->_blocking[ slot[ n ] ] = links[ n ];
+    LOG( DBG_VERBOSE, stderr, "New blocking connection idx=%d to %s\n", slot[ n ], urls[ n ] );
+  }
+  return failed;
+}
+
+dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_blocking( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                                                 dbBE_Redis_connection_t *conn )
+{
+  if(( conn_mgr == NULL ) || ( conn == NULL ))
+  {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  // find an idle blocking connection to the same server
+  unsigned i;
+  for( i = 0; i < DBBE_REDIS_MAX_CONNECTIONS; ++i )
+  {
+    dbBE_Redis_connection_t *bconn = conn_mgr->_blocking[ i ];
+    if(( bconn == NULL ) || ( bconn->_worker != conn->_worker ) ||
+        ( dbBE_Network_address_compare( bconn->_address, conn->_address ) != 0 ))
+      continue;
+    // a second blocking cmd on the same connection would only wait behind the first one
+    if( dbBE_Redis_connection_RTR( bconn ) && ( dbBE_Redis_s2r_queue_len( bconn->_posted_q ) == 0 ))
+      return bconn;
+  }
+
+  errno = EBUSY;
+  return NULL;
+}
+
+/*
+ * drop a dedicated blocking connection, blocking_links() replaces it with the next topology update
+ */
+static int dbBE_Redis_connection_mgr_blocking_rm( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                                  dbBE_Redis_connection_t *conn )
+{
+  dbBE_Redis_event_mgr_rm( conn_mgr->_ev_mgr, conn );
+  conn_mgr->_blocking[ conn->_index ] = NULL;
+  conn->_index = DBBE_REDIS_LOCATOR_INDEX_INVAL;
+  return 0;
+}
+
 /*
  * Move a connection from regular to broken list
  */
@@ -234,6 +499,15 @@ int dbBE_Redis_connection_mgr_conn_fail( dbBE_Redis_connection_mgr_t *conn_mgr,
     return -EINVAL;
   }
 
+  // blocking connections are not tracked for recovery
+  if( dbBE_Redis_connection_mgr_is_blocking( conn_mgr, conn ) )
+  {
+    dbBE_Redis_connection_mgr_blocking_rm( conn_mgr, conn );
+    dbBE_Redis_connection_unlink( conn );
+    dbBE_Redis_connection_destroy( conn );
+    return 0;
+  }
+
   if( conn_mgr->_connection_count <= 0 )
   {
     LOG( DBG_ERR, stderr, "connection_mgr_conn_fail: no active connections, can't fail more\n" );
@@ -778,6 +1052,9 @@ int dbBE_Redis_connection_mgr_rm( dbBE_Redis_connection_mgr_t *conn_mgr,
     return -EINVAL;
   }
 
+  if( dbBE_Redis_connection_mgr_is_blocking( conn_mgr, conn ) )
+    return dbBE_Redis_connection_mgr_blocking_rm( conn_mgr, conn );
+
   if( conn_mgr->_connection_count <= 0 )
   {
     LOG( DBG_ERR, stderr, "connection_mgr_rm: no connections tracked. Can't delete.\n" );
@@ -831,8 +1108,10 @@ dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_connection_to( dbBE_Redis
   for( i = 0; (i < DBBE_REDIS_MAX_CONNECTIONS); ++i )
   {
     conn = conn_mgr->_connections[ i ];
-    if(( conn  != NULL ) && ( dbBE_Network_address_compare( conn->_address, d_addr ) == 0 ))
+    if(( conn  != NULL ) && ( ! dbBE_Redis_connection_mgr_is_blocking( conn_mgr, conn ) ) &&
+        ( dbBE_Network_address_compare( conn->_address, d_addr ) == 0 ))
       break;
+    conn = NULL;
   }
   dbBE_Network_address_destroy( d_addr );
   return conn;
@@ -847,6 +1126,15 @@ dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_active( dbBE_Redis_connec
     return NULL;
 }
 
+int dbBE_Redis_connection_mgr_harvest_active( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                              dbBE_Redis_connection_t **conns,
+                                              const int max )
+{
+  if( conn_mgr == NULL )
+    return -EINVAL;
+  return dbBE_Redis_event_mgr_harvest( conn_mgr->_ev_mgr, conns, max );
+}
+
 dbBE_Redis_request_t* dbBE_Redis_connection_mgr_request_each( dbBE_Redis_connection_mgr_t *conn_mgr,
                                                               dbBE_Redis_request_t *template_request )
 {
@@ -928,7 +1216,9 @@ dbBE_Redis_result_t* dbBE_Redis_connection_mgr_retrieve_info( dbBE_Redis_connect
     if( result == NULL )
       goto error;
 
-    rc = dbBE_Redis_parse_sr_buffer( iobuf, result );
+    dbBE_Redis_parse_state_t state;
+    dbBE_Redis_parse_state_init( &state, 0 );
+    rc = dbBE_Redis_parse_sr_buffer_resume( iobuf, result, &state );
 
     while( rc == -EAGAIN )
     {
@@ -938,8 +1228,7 @@ dbBE_Redis_result_t* dbBE_Redis_connection_mgr_retrieve_info( dbBE_Redis_connect
       {
         rc = -EAGAIN;
       }
-      dbBE_Redis_result_cleanup( result, 0 );
-      rc = dbBE_Redis_parse_sr_buffer( iobuf, result );
+      rc = dbBE_Redis_parse_sr_buffer_resume( iobuf, result, &state );
     }
   }
   if( rc != 0 )
@@ -1026,6 +1315,16 @@ DBR_Errorcode_t dbBE_Redis_connection_mgr_set_local_address( dbBE_Redis_connecti
         return DBR_ERR_NOFILE;
       }
       dbBE_Network_address_t *addr = dbBE_Network_address_from_string( url );
+      if( addr == NULL )
+        continue;
+
+      // a unix socket server is always node-local
+      if( addr->_address.sin_family == AF_UNIX )
+      {
+        conn_mgr->_local = addr;
+        freeifaddrs( ifs );
+        return DBR_SUCCESS;
+      }
 
       it = ifs;
       while( it != NULL )
@@ -1095,3 +1394,40 @@ dbBE_Redis_cluster_info_t* dbBE_Redis_connection_mgr_get_cluster_info( dbBE_Redi
   dbBE_Redis_connection_mgr_set_local_address( conn_mgr, cl_info );
   return cl_info;
 }
+
+dbBE_Redis_cluster_info_t* dbBE_Redis_connection_mgr_query_cluster_info( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                                                          const char *url )
+{
+  if(( conn_mgr == NULL ) || ( url == NULL ))
+    return NULL;
+
+  dbBE_Redis_cluster_info_t *cl_info = NULL;
+  char *authfile = dbBE_Extract_env( DBR_SERVER_AUTHFILE_ENV, DBR_SERVER_DEFAULT_AUTHFILE );
+  dbBE_Redis_connection_t *conn = dbBE_Redis_connection_create( DBBE_REDIS_INFO_PER_SERVER );
+  dbBE_Redis_sr_buffer_t *iobuf = dbBE_Transport_sr_buffer_allocate(
+      DBBE_REDIS_MAX_CONNECTIONS * DBBE_REDIS_INFO_PER_SERVER );
+  if(( authfile == NULL ) || ( conn == NULL ) || ( iobuf == NULL ))
+    goto exit_query;
+
+  // a private connection: the pipelines of the regular connections stay untouched
+  if( dbBE_Redis_connection_link( conn, url, authfile ) == NULL )
+    goto exit_query;
+
+  dbBE_Redis_result_t *result = dbBE_Redis_connection_mgr_retrieve_info(
+      conn_mgr, conn, iobuf, DBBE_INFO_CATEGORY_CLUSTER_SLOTS );
+  if( result != NULL )
+  {
+    cl_info = dbBE_Redis_cluster_info_create( result );
+    dbBE_Redis_result_cleanup( result, 1 );
+  }
+  dbBE_Redis_connection_unlink( conn );
+
+exit_query:
+  if( iobuf != NULL )
+    dbBE_Transport_sr_buffer_free( iobuf );
+  if( conn != NULL )
+    dbBE_Redis_connection_destroy( conn );
+  if( authfile != NULL )
+    free( authfile );
+  return cl_info;
+}
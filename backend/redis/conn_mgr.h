@@ -47,11 +47,13 @@ typedef struct
   // connection list
   dbBE_Redis_connection_t *_connections[ DBBE_REDIS_MAX_CONNECTIONS ];
   dbBE_Redis_connection_t *_broken[ DBBE_REDIS_MAX_CONNECTIONS ];
+  dbBE_Redis_connection_t *_blocking[ DBBE_REDIS_MAX_CONNECTIONS ]; // dedicated connections for blocking cmds (not in locator)
   dbBE_Network_address_t *_local; // used to determine local vs. remote connections
   const dbBE_Redis_conn_mgr_config_t *_config;
   //  pthread_mutex_lock_t _lock;
 
   int _connection_count;
+  int _worker_count;  // number of I/O workers to distribute the connections across (0: no workers)
 
   // active connections?
   // disabled/old/disconnected connections?
@@ -103,6 +105,17 @@ int dbBE_Redis_connection_mgr_rm( dbBE_Redis_connection_mgr_t *conn_mgr,
 dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_newlink( dbBE_Redis_connection_mgr_t *conn_mgr,
                                                             const char *url );
 
+/*
+ * Insert and connect new connections to all urls concurrently
+ * connects are non-blocking and the AUTH commands are pipelined; failed links are retried with newlink()
+ * conns receives the connection for each url (NULL if it failed)
+ * returns the number of failed links or a negative error
+ */
+int dbBE_Redis_connection_mgr_newlinks( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                        char **urls,
+                                        const int count,
+                                        dbBE_Redis_connection_t **conns );
+
 /*
  * get the number of (active) connections
  */
@@ -115,20 +128,48 @@ int dbBE_Redis_connection_mgr_get_connections( dbBE_Redis_connection_mgr_t *conn
 }
 
 /*
- * return the connection entry at a given index
+ * return the connection entry at a given index (regular or blocking connection)
  */
 static inline
 dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_connection_at( dbBE_Redis_connection_mgr_t *conn_mgr,
                                                                       int index )
 {
   if(( conn_mgr != NULL ) && ( (unsigned)index == (unsigned)index % DBBE_REDIS_MAX_CONNECTIONS ))
-    return conn_mgr->_connections[ index ];
+    return conn_mgr->_connections[ index ] != NULL ? conn_mgr->_connections[ index ] : conn_mgr->_blocking[ index ];
   errno = ENOENT;
   return NULL;
 }
 
 /*
- * return the connection entry to a given destination address
+ * check whether a connection is one of the dedicated blocking connections
+ */
+static inline
+int dbBE_Redis_connection_mgr_is_blocking( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                           dbBE_Redis_connection_t *conn )
+{
+  return (( conn_mgr != NULL ) && ( conn != NULL ) &&
+      ( (unsigned)conn->_index == (unsigned)conn->_index % DBBE_REDIS_MAX_CONNECTIONS ) &&
+      ( conn_mgr->_blocking[ conn->_index ] == conn ));
+}
+
+/*
+ * link DBBE_REDIS_BLOCKING_CONNECTIONS dedicated connections for blocking commands to each connected server
+ * (only the missing ones; concurrently like newlinks())
+ * blocking connections are owned by the same I/O worker as the regular connection to their server
+ * returns the number of failed links or a negative error
+ */
+int dbBE_Redis_connection_mgr_blocking_links( dbBE_Redis_connection_mgr_t *conn_mgr );
+
+/*
+ * return an idle dedicated connection to the same server as conn for a blocking command
+ * never connects; the connections are created up front by blocking_links()
+ * returns NULL (errno=EBUSY) if all of them are busy
+ */
+dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_blocking( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                                                 dbBE_Redis_connection_t *conn );
+
+/*
+ * return the connection entry to a given destination address (dedicated blocking connections excluded)
  */
 dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_connection_to( dbBE_Redis_connection_mgr_t *conn_mgr,
                                                                       const char *dest );
@@ -139,6 +180,13 @@ dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_connection_to( dbBE_Redis
  */
 dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_active( dbBE_Redis_connection_mgr_t *conn_mgr, const int blocking );
 
+/*
+ * return all active connections at once (up to max); returns the number of connections in conns
+ */
+int dbBE_Redis_connection_mgr_harvest_active( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                              dbBE_Redis_connection_t **conns,
+                                              const int max );
+
 
 /*
  * return a list of empty requests, one for each (connected/authorized) connection
@@ -164,9 +212,23 @@ dbBE_Redis_result_t* dbBE_Redis_connection_mgr_retrieve_info( dbBE_Redis_connect
 int dbBE_Redis_connection_mgr_is_master( dbBE_Redis_connection_mgr_t *conn_mgr,
                                          dbBE_Redis_connection_t *conn );
 
+/*
+ * find a node-local server in the cluster info to tell local from remote connections
+ */
+DBR_Errorcode_t dbBE_Redis_connection_mgr_set_local_address( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                                             dbBE_Redis_cluster_info_t *cl_info );
+
 /*
  * create a cluster info structure after retrieving an updated cluster info (works for non-cluster as well)
  */
 dbBE_Redis_cluster_info_t* dbBE_Redis_connection_mgr_get_cluster_info( dbBE_Redis_connection_mgr_t *conn_mgr );
 
+/*
+ * retrieve the cluster slot map from the server at url through a temporary connection
+ * doesn't touch the connection mgr state, so it can run next to the I/O of other threads
+ * returns NULL if the server is unreachable or not in cluster mode
+ */
+dbBE_Redis_cluster_info_t* dbBE_Redis_connection_mgr_query_cluster_info( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                                                          const char *url );
+
 #endif /* BACKEND_REDIS_CONN_MGR_H_ */
@@ -31,6 +31,9 @@
 #include <unistd.h>
 #include <sys/socket.h>
 #include <netdb.h>
+#include <pthread.h>
+#include <poll.h>
+#include <time.h>
 
 #include "logutil.h"
 #include "common/utility.h"
@@ -38,6 +41,9 @@
 #include "connection.h"
 #include "common/resolve_addr.h"
 
+// source of the recv buffer generations
+static uint64_t dbBE_Redis_connection_buffer_gen = 0;
+
 /*
  * create a Redis connection object, initialize with default/uninitialized values
  * does not allocate the sr_buffers
@@ -77,6 +83,7 @@ dbBE_Redis_connection_t *dbBE_Redis_connection_create( const uint64_t sr_buffer_
   conn->_sr_dev = send_tr;
 
   conn->_recvbuf = recvb;
+  conn->_buffer_gen = __atomic_add_fetch( &dbBE_Redis_connection_buffer_gen, 1, __ATOMIC_RELAXED );
   conn->_index = DBBE_REDIS_LOCATOR_INDEX_INVAL;
   conn->_socket = -1;
   conn->_status = DBBE_CONNECTION_STATUS_INITIALIZED;
@@ -132,6 +139,7 @@ int dbBE_Redis_connection_assign_recvbuf( dbBE_Redis_connection_t *conn,
     return -EINVAL;
 
   conn->_recvbuf = recvb;
+  conn->_buffer_gen = __atomic_add_fetch( &dbBE_Redis_connection_buffer_gen, 1, __ATOMIC_RELAXED );
 
   // check the buffer status, if both buffers are available, it can transition to INITIALIZED
   if( conn->_recvbuf == NULL )
@@ -274,6 +282,89 @@ dbBE_Network_address_t* dbBE_Redis_connection_link( dbBE_Redis_connection_t *con
   return conn->_address;
 }
 
+int dbBE_Redis_connection_link_start( dbBE_Redis_connection_t *conn,
+                                      const char *url )
+{
+  if(( conn == NULL ) || ( url == NULL ) ||
+      (( conn->_status != DBBE_CONNECTION_STATUS_INITIALIZED ) &&
+       ( conn->_status != DBBE_CONNECTION_STATUS_DISCONNECTED )) )
+  {
+    LOG( DBG_ERR, stderr, "connection_link_start: invalid arguments/status conn=%p, url=%s\n", conn, url );
+    return -EINVAL;
+  }
+
+  struct addrinfo *addrs = dbBE_Common_resolve_address( url, 0 );
+  if( addrs == NULL )
+  {
+    LOG( DBG_ERR, stderr, "connection_link_start: unable to resolve: %s\n", url );
+    return -ENOTCONN;
+  }
+
+  // only the first usable address is tried; connection_link() walks through all of them
+  int rc = -ENOTCONN;
+  struct addrinfo *iface;
+  for( iface = addrs; iface != NULL; iface = iface->ai_next )
+  {
+    int s = socket( iface->ai_family, iface->ai_socktype | SOCK_NONBLOCK, iface->ai_protocol );
+    if( s < 0 )
+    {
+      rc = -errno;
+      if(( errno == ENFILE ) || ( errno == EMFILE ) || ( errno == ENOBUFS ) || ( errno == ENOMEM ))
+        break;
+      continue;
+    }
+
+    if(( connect( s, iface->ai_addr, iface->ai_addrlen ) != 0 ) && ( errno != EINPROGRESS ))
+    {
+      rc = -errno;
+      close( s );
+      break;
+    }
+
+    if( conn->_address != NULL )
+      dbBE_Network_address_destroy( conn->_address );
+    conn->_socket = s;
+    conn->_address = dbBE_Network_address_copy( iface->ai_addr, iface->ai_addrlen );
+    rc = 0;
+    break;
+  }
+
+  dbBE_Common_release_addrinfo( &addrs );
+  return rc;
+}
+
+int dbBE_Redis_connection_link_finish( dbBE_Redis_connection_t *conn )
+{
+  if(( conn == NULL ) || ( conn->_socket < 0 ) || ( conn->_address == NULL ))
+    return -EINVAL;
+
+  int err = 0;
+  socklen_t errlen = sizeof( err );
+  if( getsockopt( conn->_socket, SOL_SOCKET, SO_ERROR, &err, &errlen ) != 0 )
+    err = errno;
+
+  // the remaining protocol uses blocking sockets
+  int flags = fcntl( conn->_socket, F_GETFL );
+  if(( err == 0 ) && (( flags < 0 ) || ( fcntl( conn->_socket, F_SETFL, flags & ~O_NONBLOCK ) != 0 )))
+    err = errno;
+
+  if( err != 0 )
+  {
+    LOG( DBG_VERBOSE, stderr, "connection_link_finish: connect failed: %s\n", strerror( err ) );
+    close( conn->_socket );
+    conn->_socket = -1;
+    dbBE_Network_address_destroy( conn->_address );
+    conn->_address = NULL;
+    conn->_status = DBBE_CONNECTION_STATUS_DISCONNECTED;
+    return -err;
+  }
+
+  conn->_status = DBBE_CONNECTION_STATUS_CONNECTED;
+  dbBE_Network_address_to_string( conn->_address, conn->_url, DBR_SERVER_URL_MAX_LENGTH );
+  LOG( DBG_VERBOSE, stdout, "Connected to %s\n", conn->_url );
+  return 0;
+}
+
 dbBE_Redis_connection_recoverable_t dbBE_Redis_connection_recoverable( dbBE_Redis_connection_t *conn )
 {
   // grab the timestamp or reconnection counter and decide based on that whether it's considered recoverable or not
@@ -303,7 +394,7 @@ int dbBE_Redis_connection_reconnect( dbBE_Redis_connection_t *conn )
 
   rc = connect( s,
                 (const struct sockaddr*)&(conn->_address->_address),
-                sizeof( conn->_address->_address ) );
+                conn->_address->_len );
   if( rc == 0 )
   {
     conn->_status = DBBE_CONNECTION_STATUS_CONNECTED;
@@ -332,10 +423,36 @@ int dbBE_Redis_connection_reconnect( dbBE_Redis_connection_t *conn )
   return rc;
 }
 
+ssize_t dbBE_Redis_connection_recv_result( dbBE_Redis_connection_t *conn,
+                                           dbBE_Redis_sr_buffer_t *buf,
+                                           ssize_t rc,
+                                           size_t requested )
+{
+  if( rc == 0 )
+  {
+    LOG( DBG_INFO, stderr, "recv() got no data, Redis server down?\n" );
+    dbBE_Redis_connection_unlink( conn );
+    return -ENOTCONN;
+  }
+  if( rc < 0 )
+    return rc;
+
+  dbBE_Transport_sr_buffer_add_data( buf, rc, 0 );
+
+  // disarm connection status if the received data was less than requested
+  // we've received all currently available data; otherwise there might be more
+  if( (size_t)rc < requested )
+    conn->_status = DBBE_CONNECTION_STATUS_AUTHORIZED;
+  else
+    conn->_status = DBBE_CONNECTION_STATUS_PENDING_DATA;
+  return rc;
+}
+
 static
-ssize_t dbBE_Redis_connection_recv_base( dbBE_Redis_connection_t *conn, dbBE_Redis_sr_buffer_t *buf )
+ssize_t dbBE_Redis_connection_recv_base( dbBE_Redis_connection_t *conn, dbBE_Redis_sr_buffer_t *buf, const int flags )
 {
   ssize_t rc = 0;
+  ssize_t rsize = 0;
   int stored_errno=0;
   do
   {
@@ -346,50 +463,33 @@ ssize_t dbBE_Redis_connection_recv_base( dbBE_Redis_connection_t *conn, dbBE_Red
     }
     errno = 0;
 
-    // receive 7/8th at max
-    ssize_t rsize = dbBE_Transport_sr_buffer_remaining( buf ) - (dbBE_Transport_sr_buffer_remaining( buf ) >> 4);
+    rsize = dbBE_Redis_connection_recv_limit( buf );
     rc = recv( conn->_socket,
                dbBE_Transport_sr_buffer_get_available_position( buf ),
                rsize,
-               0 );
+               flags );
     stored_errno=errno;
 
-    LOG( DBG_TRACE, stderr, "recv( %d, %p, %ld, 0) = %ld\n", conn->_socket, dbBE_Transport_sr_buffer_get_available_position( buf ), rsize, rc );
+    LOG( DBG_TRACE, stderr, "recv( %d, %p, %ld, %d) = %ld\n", conn->_socket, dbBE_Transport_sr_buffer_get_available_position( buf ), rsize, flags, rc );
 
     if( stored_errno == EINTR )
       LOG( DBG_INFO, stderr, "recv() got interrupted by a signal. will retry\n" );
-    if( rc == 0 )
-    {
-      LOG( DBG_INFO, stderr, "recv() got no data, Redis server down?\n" );
-      dbBE_Redis_connection_unlink( conn );
-      rc = -1;
-      stored_errno = ENOTCONN;
-      break;
-    }
-    if( rc > 0 )
-      dbBE_Transport_sr_buffer_add_data( buf, rc, 0 );
-
-  } while( stored_errno == EINTR );
+  } while(( rc < 0 ) && ( stored_errno == EINTR ));
 
-  if( rc >= 0 )
+  // a non-blocking receive found the socket drained
+  if(( rc < 0 ) && ( flags & MSG_DONTWAIT ) && (( stored_errno == EAGAIN ) || ( stored_errno == EWOULDBLOCK )))
   {
-    // disarm connection status if the received data was less than the max capacity
-    // we've received all currently available data
-    if( (size_t)rc <= dbBE_Transport_sr_buffer_get_size( buf ) )
-    {
-      conn->_status = DBBE_CONNECTION_STATUS_AUTHORIZED;
-    }
+    conn->_status = DBBE_CONNECTION_STATUS_AUTHORIZED;
+    return 0;
   }
-  else
-    rc = -stored_errno;
 
-  return rc;
+  return dbBE_Redis_connection_recv_result( conn, buf, ( rc < 0 ) ? -stored_errno : rc, rsize );
 }
 
 ssize_t dbBE_Redis_connection_recv_direct( dbBE_Redis_connection_t *conn,
                                            dbBE_Redis_sr_buffer_t *buf )
 {
-  return dbBE_Redis_connection_recv_base( conn, buf );
+  return dbBE_Redis_connection_recv_base( conn, buf, 0 );
 }
 
 /*
@@ -400,6 +500,14 @@ ssize_t dbBE_Redis_connection_recv( dbBE_Redis_connection_t *conn,
 {
   if(( conn == NULL ) || ( buf == NULL ))
     return -EINVAL;
+
+  // the I/O engine already did the receive
+  if( conn->_prefetched )
+  {
+    conn->_prefetched = 0;
+    return conn->_prefetch_rc;
+  }
+
   if( ! dbBE_Redis_connection_RTR( conn ) )
     return -ENOTCONN;
 
@@ -413,7 +521,7 @@ ssize_t dbBE_Redis_connection_recv( dbBE_Redis_connection_t *conn,
   }
 
   dbBE_Transport_sr_buffer_reset( buf );
-  ssize_t rc = dbBE_Redis_connection_recv_base( conn, buf );
+  ssize_t rc = dbBE_Redis_connection_recv_base( conn, buf, MSG_DONTWAIT );
 
   LOG( DBG_TRACE, stdout, "RECV: conn=%d:%s", conn->_socket, dbBE_Transport_sr_buffer_get_start( buf ) );
 
@@ -437,7 +545,7 @@ ssize_t dbBE_Redis_connection_recv_more( dbBE_Redis_connection_t *conn,
   if( ! dbBE_Redis_connection_RTR( conn ) )
     return -ENOTCONN;
 
-  ssize_t rc = dbBE_Redis_connection_recv_base( conn, buf );
+  ssize_t rc = dbBE_Redis_connection_recv_base( conn, buf, 0 );
 
   LOG( DBG_VERBOSE, stdout, "recv_more: conn=%d; new=%zd; avail/rem=%zd/%zd\n",
        conn->_socket, rc, dbBE_Transport_sr_buffer_available( buf ), dbBE_Transport_sr_buffer_remaining( buf ) );
@@ -522,6 +630,31 @@ ssize_t dbBE_Redis_connection_flatten_cmd( dbBE_sge_t *cmd, int cmdlen, dbBE_Red
 #endif // DEBUG_REDIS_PROTOCOL
 
 
+void dbBE_Redis_connection_cmd_consume( dbBE_Redis_connection_t *conn,
+                                        ssize_t sent )
+{
+  dbBE_Transport_sge_buffer_t *sge_buf = conn->_cmd;
+  dbBE_sge_t *cmd = sge_buf->_cmd;
+  while(( sge_buf->_index > 0 ) && ( sent > 0 ))
+  {
+    if( (size_t)sent < cmd[0].iov_len )
+    {
+      LOG( DBG_TRACE, stderr, "SGE[0] reduce by %ld from %ld to %ld\n", sent, cmd[0].iov_len, cmd[0].iov_len - sent );
+      cmd[0].iov_base = (char*)cmd[0].iov_base + sent;
+      cmd[0].iov_len -= sent;
+      sent = 0;
+    }
+    else
+    {
+      LOG( DBG_TRACE, stderr, "SGE shift remaining data reduced by %ld from %ld to %ld; remaining entries: %d\n",
+           cmd[0].iov_len, sent, sent - cmd[0].iov_len, sge_buf->_index-1 );
+      sent -= cmd[0].iov_len;
+      memmove( cmd, &cmd[1], sizeof( cmd[0] ) * sge_buf->_index );
+      --sge_buf->_index;
+    }
+  }
+}
+
 /*
  * flush the send buffer by sending it to the connected Redis instance
  */
@@ -539,8 +672,6 @@ ssize_t dbBE_Redis_connection_send_cmd( dbBE_Redis_connection_t *conn )
 
   struct msghdr msg;
   memset( &msg, 0, sizeof( struct msghdr ) );
-  msg.msg_iov = cmd;
-  msg.msg_iovlen = sge_buf->_index;
 
   ssize_t total = dbBE_SGE_get_len( cmd, sge_buf->_index );
   ssize_t ssize = 0;
@@ -548,31 +679,13 @@ ssize_t dbBE_Redis_connection_send_cmd( dbBE_Redis_connection_t *conn )
 
   do
   {
+    msg.msg_iov = cmd;
+    msg.msg_iovlen = sge_buf->_index; // partial sends shrink the vector
     rc = sendmsg( conn->_socket, &msg, 0 );
 
     if( rc < 0 ) break;
     if(( rc > 0 ) && ( rc + ssize < total ))
-    {
-      ssize_t offset = rc;
-      while(( sge_buf->_index > 0 ) && ( offset > 0 ))
-      {
-        if( (size_t)offset < cmd[0].iov_len )
-        {
-          LOG( DBG_TRACE, stderr, "SGE[0] reduce by %ld from %ld to %ld\n", offset, cmd[0].iov_len, cmd[0].iov_len - offset );
-          cmd[0].iov_base = (char*)cmd[0].iov_base + offset;
-          cmd[0].iov_len -= offset;
-          offset = 0;
-        }
-        else
-        {
-          LOG( DBG_TRACE, stderr, "SGE shift remaining data reduced by %ld from %ld to %ld; remaining entries: %d\n",
-               cmd[0].iov_len, offset, offset - cmd[0].iov_len, sge_buf->_index-1 );
-          offset -= cmd[0].iov_len;
-          memmove( cmd, &cmd[1], sizeof( cmd[0] ) * sge_buf->_index );
-          --sge_buf->_index;
-        }
-      }
-    }
+      dbBE_Redis_connection_cmd_consume( conn, rc );
     ssize += rc;
   } while (( rc >= 0 ) && ( ssize < total ));
 
@@ -604,6 +717,7 @@ int dbBE_Redis_connection_unlink( dbBE_Redis_connection_t *conn )
   close( conn->_socket );
   conn->_socket = -1;
   conn->_status = DBBE_CONNECTION_STATUS_DISCONNECTED;
+  conn->_prefetched = 0;
 //  don't touch the address, it can be reused during reconnect
 //  dbBE_Redis_address_destroy( conn->_address );
 //  conn->_address = NULL;
@@ -612,11 +726,109 @@ int dbBE_Redis_connection_unlink( dbBE_Redis_connection_t *conn )
   return 0;
 }
 
-int dbBE_Redis_connection_auth( dbBE_Redis_connection_t *conn, const char *authfile_name )
+/*
+ * the passphrase is read once per process and kept for all further connections
+ * (a changed authfile name replaces it)
+ */
+static pthread_mutex_t gAuthLock = PTHREAD_MUTEX_INITIALIZER;
+static char *gAuthFile = NULL;
+static char *gAuthSecret = NULL;
+static size_t gAuthSecretLen = 0;
+
+static
+void dbBE_Redis_connection_auth_wipe()
 {
-  int rc = 0;
-  int auth_error = 0;
+  if( gAuthSecret != NULL )
+  {
+    memset( gAuthSecret, 0, gAuthSecretLen );
+    free( gAuthSecret );
+  }
+  if( gAuthFile != NULL )
+    free( gAuthFile );
+  gAuthSecret = NULL;
+  gAuthFile = NULL;
+  gAuthSecretLen = 0;
+}
+
+/*
+ * read the passphrase from the authfile into the cache
+ * requires the gAuthLock to be held
+ */
+static
+int dbBE_Redis_connection_auth_load( const char *authfile_name )
+{
+  if(( gAuthSecret != NULL ) && ( strcmp( gAuthFile, authfile_name ) == 0 ))
+    return 0;
+
+  dbBE_Redis_connection_auth_wipe();
+
+  // open the file
+  int auth_fd = open( authfile_name, O_RDONLY );
+  if( auth_fd < 0 )
+  {
+    int auth_error = errno;
+    perror( authfile_name );
+    return -auth_error;
+  }
+
+  // get the file size to determine the buffer size
   struct stat auth_file_stat;
+  if( fstat( auth_fd, &auth_file_stat ) != 0 )
+  {
+    int auth_error = errno;
+    close( auth_fd );
+    return -auth_error;
+  }
+
+  // allocate and reset the buffer
+  size_t authbuf_size = auth_file_stat.st_size + 128;
+  char *authbuf = (char*)calloc( 1, authbuf_size );
+  if( authbuf == NULL )
+  {
+    close( auth_fd );
+    return -ENOMEM;
+  }
+
+  // read the file data
+  int rc = 0;
+  ssize_t rlen = read( auth_fd, authbuf, authbuf_size - 1 );
+  int auth_error = errno;
+  close( auth_fd );
+  if( rlen <= 0 )
+    perror( "Read authfile" );
+  else
+  {
+    rc = strcspn( authbuf, "\r\n" );  // strip the auth-string
+    if(( rc > 0 ) && ( authbuf[ rc - 1 ] == ' ' ))
+    {
+      LOG( DBG_WARN, stderr, "Warning, password in file ends with white space. Double check if you have authentication problems.\n" );
+    }
+  }
+  if( rc <= 0 )
+  {
+    memset( authbuf, 0, authbuf_size );
+    free( authbuf );
+    return ( auth_error != 0 ) ? -auth_error : -EINVAL;
+  }
+
+  authbuf[ rc ] = '\0'; // terminate the authbuf and remove and newlines
+  gAuthFile = strdup( authfile_name );
+  gAuthSecret = authbuf;
+  gAuthSecretLen = authbuf_size;
+  return 0;
+}
+
+void dbBE_Redis_connection_auth_forget()
+{
+  pthread_mutex_lock( &gAuthLock );
+  dbBE_Redis_connection_auth_wipe();
+  pthread_mutex_unlock( &gAuthLock );
+}
+
+int dbBE_Redis_connection_auth_send( dbBE_Redis_connection_t *conn, const char *authfile_name )
+{
+  if(( conn == NULL ) || ( authfile_name == NULL ) || ( conn->_status != DBBE_CONNECTION_STATUS_CONNECTED ))
+    return -EINVAL;
 
   // skip authentication if authfile name is explicitly set to NONE
   if( strncmp( authfile_name, "NONE", 5 ) == 0 )
@@ -627,108 +839,124 @@ int dbBE_Redis_connection_auth( dbBE_Redis_connection_t *conn, const char *authf
 
   const size_t AUTHBUF_SIZE = 16384;
   dbBE_Redis_sr_buffer_t *sbuf = dbBE_Transport_sr_buffer_allocate( AUTHBUF_SIZE );
+  if( sbuf == NULL )
+    return -ENOMEM;
 
-  // open the file
-  int auth_fd = open( authfile_name, O_RDONLY );
-  if( auth_fd < 0 )
+  pthread_mutex_lock( &gAuthLock );
+  int auth_error = dbBE_Redis_connection_auth_load( authfile_name );
+  if( auth_error == 0 )
   {
-    perror( authfile_name );
-    dbBE_Transport_sr_buffer_free( sbuf );
-    return -1;
+    int len = snprintf( dbBE_Transport_sr_buffer_get_start( sbuf ),
+                        dbBE_Transport_sr_buffer_remaining( sbuf ),
+                        "*2\r\n$4\r\nAUTH\r\n$%zd\r\n%s\r\n", strlen( gAuthSecret ), gAuthSecret );
+    if(( len <= 0 ) || ( (size_t)len >= dbBE_Transport_sr_buffer_remaining( sbuf ) ))
+    {
+      LOG( DBG_ERR, stderr, "connection_auth: send/recv buffer too small for auth operation.\n" );
+      auth_error = -ENOBUFS;
+    }
+    else
+      dbBE_Transport_sr_buffer_add_data( sbuf, len, 1 );
   }
+  pthread_mutex_unlock( &gAuthLock );
 
-  size_t authbuf_size = 0;
-  char *authbuf = NULL;
+  // the reply is picked up by auth_complete(); the status stays CONNECTED until then
+  if(( auth_error == 0 ) && ( dbBE_Redis_connection_send( conn, sbuf ) <= 0 ))
+    auth_error = ( errno != 0 ) ? -errno : -EBADMSG;
 
-  // get the file size to determine the buffer size
-  rc = fstat( auth_fd, &auth_file_stat );
-  if( rc == 0 )
+  memset( dbBE_Transport_sr_buffer_get_start( sbuf ), 0, dbBE_Transport_sr_buffer_get_size( sbuf ) );
+  dbBE_Transport_sr_buffer_free( sbuf );
+  if( auth_error != 0 )
+    LOG( DBG_INFO, stderr, "completing authentication rc=%d\n", auth_error );
+  return auth_error;
+}
+
+int dbBE_Redis_connection_auth_complete( dbBE_Redis_connection_t *conn,
+                                         const struct timespec *deadline )
+{
+  if( conn == NULL )
+    return -EINVAL;
+
+  // nothing was sent (authfile NONE)
+  if( conn->_status == DBBE_CONNECTION_STATUS_AUTHORIZED )
+    return 0;
+
+  if( conn->_status != DBBE_CONNECTION_STATUS_CONNECTED )
+    return -EINVAL;
+
+  struct timespec now, limit;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  if( deadline != NULL )
+    limit = *deadline;
+  else
   {
-    // allocate and reset the buffer
-    authbuf_size = auth_file_stat.st_size + 128;
+    limit = now;
+    limit.tv_sec += DBBE_REDIS_LINK_TIMEOUT;
+  }
 
-    if( dbBE_Transport_sr_buffer_get_size( sbuf ) < authbuf_size )
+  int auth_error = 0;
+  char reply[ 1024 ];
+  memset( reply, 0, sizeof( reply ) );
+  ssize_t rc = -1;
+  while( rc < 0 )
+  {
+    // wait for the reply, but never past the deadline (one last check if it already passed)
+    int64_t remaining_ms = ( limit.tv_sec - now.tv_sec ) * 1000 + ( limit.tv_nsec - now.tv_nsec ) / 1000000;
+    struct pollfd pfd = { .fd = conn->_socket, .events = POLLIN, .revents = 0 };
+    int prc = poll( &pfd, 1, ( remaining_ms > 0 ) ? (int)remaining_ms : 0 );
+    if(( prc < 0 ) && ( errno != EINTR ))
     {
-      LOG( DBG_ERR, stderr, "connection_auth: send/recv buffer too small for auth operation.\n" );
-      close( auth_fd );
-      dbBE_Transport_sr_buffer_free( sbuf );
-      return -1;
+      auth_error = -errno;
+      break;
     }
-
-    authbuf = (char*)malloc( authbuf_size );
-    memset( authbuf, 0, authbuf_size );
-
-    // read the file data
-    ssize_t rlen = read( auth_fd, authbuf, authbuf_size );
-    if( rlen <= 0 )
-      perror( "Read authfile" );  // no exit needed because rc is 0
-    else
+    if( prc > 0 )
     {
-      rc = strcspn( authbuf, "\r\n" );  // strip the auth-string and update rc to enter the processing
-      if( authbuf[ rc - 1 ] == ' ' )
+      rc = recv( conn->_socket, reply, sizeof( reply ) - 1, MSG_DONTWAIT );
+      if( rc == 0 )
+      {
+        auth_error = -ECONNRESET;
+        break;
+      }
+      if(( rc < 0 ) && ( errno != EAGAIN ) && ( errno != EWOULDBLOCK ) && ( errno != EINTR ))
       {
-        LOG( DBG_WARN, stderr, "Warning, password in file ends with white space. Double check if you have authentication problems.\n" );
+        auth_error = -errno;
+        break;
       }
     }
     if( rc > 0 )
+      break;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    if(( prc == 0 ) && ( remaining_ms <= 0 ))
     {
-      authbuf[ rc ] = '\0'; // terminate the authbuf and remove and newlines
-      int len = snprintf( dbBE_Transport_sr_buffer_get_start( sbuf ),
-                          dbBE_Transport_sr_buffer_remaining( sbuf ),
-                          "*2\r\n$4\r\nAUTH\r\n$%d\r\n%s\r\n", rc, authbuf );
-      if( len > 0 )
-      {
-        dbBE_Transport_sr_buffer_add_data( sbuf, len, 1 );
-
-        conn->_status = DBBE_CONNECTION_STATUS_AUTHORIZED; // assume authorized for a brief moment to allow using the send/recv functions
-        rc = dbBE_Redis_connection_send( conn, sbuf );
-        if( rc > 0 )
-        {
-          memset( authbuf, 0, authbuf_size );
-          rc = 0;
-          while( rc == 0 )
-          {
-            rc = recv( conn->_socket, authbuf, authbuf_size, 0 );
-            if(( rc == -1 ) && ( errno == EAGAIN ))
-              rc = 0;
-          }
-          if( rc > 0 )
-          {
-            if( strncmp( authbuf, "+OK\r\n", 5 ) != 0 )
-            {
-              LOG( DBG_ERR, stderr, "Redis Authentication error: %s\n", &authbuf[1] );
-              conn->_status = DBBE_CONNECTION_STATUS_CONNECTED;
-              auth_error = EPERM;
-            }
-          }
-          else
-            auth_error = errno;
-        }
-        else
-          auth_error = errno;
-      }
-      else
-        auth_error = errno;
+      auth_error = -ETIMEDOUT;
+      break;
     }
-    else
-      auth_error = errno;
   }
-  else
-    auth_error = errno;
 
-  close( auth_fd );
-  if( authbuf != NULL )
+  if( rc > 0 )
   {
-    memset( authbuf, 0, authbuf_size );
-    free( authbuf );
+    if( strncmp( reply, "+OK\r\n", 5 ) != 0 )
+    {
+      LOG( DBG_ERR, stderr, "Redis Authentication error: %s\n", &reply[1] );
+      auth_error = -EPERM;
+    }
+    else
+      conn->_status = DBBE_CONNECTION_STATUS_AUTHORIZED;
   }
 
-  dbBE_Transport_sr_buffer_free( sbuf );
   if( auth_error != 0 )
     LOG( DBG_INFO, stderr, "completing authentication rc=%d\n", auth_error );
   return auth_error;
 }
 
+int dbBE_Redis_connection_auth( dbBE_Redis_connection_t *conn, const char *authfile_name )
+{
+  int rc = dbBE_Redis_connection_auth_send( conn, authfile_name );
+  if( rc == 0 )
+    rc = dbBE_Redis_connection_auth_complete( conn, NULL );
+  return rc;
+}
+
 /*
  * destroy a Redis connection object and free the
  * destroys the sr_buffers too
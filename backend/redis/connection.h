@@ -26,6 +26,8 @@
 #include "s2r_queue.h"
 #include "slot_bitmap.h"
 
+#include <time.h> // timespec
+
 //#ifndef DEBUG_REDIS_PROTOCOL
 //#define DEBUG_REDIS_PROTOCOL
 //#endif
@@ -53,6 +55,7 @@ typedef struct dbBE_Redis_connection
 {
   int _socket;
   int _index;
+  int _worker;  // I/O worker that owns the connection (0 without workers)
   dbBE_Network_address_t *_address;
   dbBE_Data_transport_t *_sr_dev;
   dbBE_Transport_dbuffer_t *_recvbuf;
@@ -61,6 +64,9 @@ typedef struct dbBE_Redis_connection
   volatile dbBE_Connection_status_t _status;
   struct timeval _last_alive;
   dbBE_Transport_sge_buffer_t *_cmd;
+  uint64_t _buffer_gen;  // changes whenever a recv buffer is assigned; the I/O engine re-registers it then
+  int _prefetched;       // the I/O engine already received into the active recv buffer
+  ssize_t _prefetch_rc;  // result of that receive; returned by the next dbBE_Redis_connection_recv()
   char _url[ DBR_SERVER_URL_MAX_LENGTH ];
 } dbBE_Redis_connection_t;
 
@@ -110,6 +116,12 @@ dbBE_Redis_connection_t *dbBE_Redis_connection_create( const uint64_t sr_buffer_
   ( ( (conn) != NULL ) && ( ((conn)->_status == DBBE_CONNECTION_STATUS_CONNECTED ) || dbBE_Redis_connection_RTR_nocheck( conn ) ) )
 
 
+/*
+ * max number of bytes to receive into a buffer at once (15/16th of the remaining space)
+ */
+#define dbBE_Redis_connection_recv_limit( buf ) \
+  ( dbBE_Transport_sr_buffer_remaining( buf ) - ( dbBE_Transport_sr_buffer_remaining( buf ) >> 4 ) )
+
 /*
  * return the send-transport device assigned to this connection
  */
@@ -143,6 +155,19 @@ dbBE_Network_address_t* dbBE_Redis_connection_link( dbBE_Redis_connection_t *con
                                                   const char *url,
                                                   const char *authfile );
 
+/*
+ * start a non-blocking connect to the first address of the destination url
+ * returns 0 once the connect is under way; the socket becomes writable when it completes
+ */
+int dbBE_Redis_connection_link_start( dbBE_Redis_connection_t *conn,
+                                      const char *url );
+
+/*
+ * complete a connect started with link_start(); switches the socket back to blocking
+ * returns 0 and CONNECTED status or a negative error (the connection is DISCONNECTED then)
+ */
+int dbBE_Redis_connection_link_finish( dbBE_Redis_connection_t *conn );
+
 /*
  * return 0 if the connection is considered not recoverable
  * return 1 otherwise
@@ -156,6 +181,7 @@ int dbBE_Redis_connection_reconnect( dbBE_Redis_connection_t *conn );
 
 /*
  * receive data from a connection and place data into the attached sr_buffer
+ * does not block; a connection stays in pending data status until a receive comes back short
  */
 ssize_t dbBE_Redis_connection_recv( dbBE_Redis_connection_t *conn,
                                     dbBE_Redis_sr_buffer_t *buf );
@@ -167,6 +193,16 @@ ssize_t dbBE_Redis_connection_recv( dbBE_Redis_connection_t *conn,
 ssize_t dbBE_Redis_connection_recv_more( dbBE_Redis_connection_t *conn,
                                          dbBE_Redis_sr_buffer_t *buf );
 
+/*
+ * account the result of a receive of up to requested bytes into buf (number of bytes or -errno)
+ * a closed connection (0 bytes) is unlinked and returns -ENOTCONN
+ * a full receive leaves the connection in pending data status because the socket may have more
+ */
+ssize_t dbBE_Redis_connection_recv_result( dbBE_Redis_connection_t *conn,
+                                           dbBE_Redis_sr_buffer_t *buf,
+                                           ssize_t rc,
+                                           size_t requested );
+
 /*
  * receive into user-provided buffer instead of connection-attached default
  * no buffer reset or cleanup is done.
@@ -197,16 +233,42 @@ int dbBE_Redis_connection_send( dbBE_Redis_connection_t *conn,
  */
 ssize_t dbBE_Redis_connection_send_cmd( dbBE_Redis_connection_t *conn );
 
+/*
+ * drop the first sent bytes from the cmd vector after a partial send
+ */
+void dbBE_Redis_connection_cmd_consume( dbBE_Redis_connection_t *conn,
+                                        ssize_t sent );
+
 /*
  * disconnect from a Redis instance
  */
 int dbBE_Redis_connection_unlink( dbBE_Redis_connection_t *conn );
 
 /*
- * read and send passwd authorization string
+ * read and send passwd authorization string and wait for the reply
  */
 int dbBE_Redis_connection_auth( dbBE_Redis_connection_t *conn, const char *authfile );
 
+/*
+ * send the AUTH command without waiting for the reply (pipelined authentication of many connections)
+ * the passphrase is read from the authfile only once per process
+ * with authfile NONE, the connection is authorized right away
+ */
+int dbBE_Redis_connection_auth_send( dbBE_Redis_connection_t *conn, const char *authfile );
+
+/*
+ * receive and check the reply to a previous auth_send()
+ * waits until the deadline (CLOCK_MONOTONIC; NULL: DBBE_REDIS_LINK_TIMEOUT from now)
+ * returns 0 if authorized or a negative errno (-ETIMEDOUT, -ECONNRESET, -EPERM, ...)
+ */
+int dbBE_Redis_connection_auth_complete( dbBE_Redis_connection_t *conn,
+                                         const struct timespec *deadline );
+
+/*
+ * wipe the cached passphrase
+ */
+void dbBE_Redis_connection_auth_forget();
+
 /*
  * destroy a Redis connection object and free the
  * does not destroy the sr_buffers
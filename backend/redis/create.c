@@ -22,11 +22,14 @@
 #include "create.h"
 #include "redis_cmds.h"
 #include "namespace.h"
+#include "encode.h"
+#include "locator.h"
 
 #include <stddef.h>
 #include <errno.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 /*
  * insert a Redis integer representation to the buffer
@@ -37,11 +40,7 @@ int Redis_insert_integer( char *buf, const int64_t value )
   if( buf == NULL )
     return -1;
 
-  int len = sprintf( buf, ":%"PRId64"\r\n", value );
-  if( len < 4 )
-    return -1;
-
-  return len;
+  return dbBE_Redis_encode_line( buf, ':', value );
 }
 
 /*
@@ -53,20 +52,12 @@ int Redis_insert_bulk_string( char *buf, const char *string )
   if( buf == NULL )
     return -1;
 
-  int len;
-  int exp_len = strlen( string ) + 6; // covers only expected minimal length (with 2-digit length, the string could be longer)
-
   if( string == NULL )
   {
-    len = sprintf( buf, "$-1\r\n");
-    exp_len = 5;
+    memcpy( buf, "$-1\r\n", 5 );
+    return 5;
   }
-  else
-    len = sprintf( buf, "$%ld\r\n%s\r\n", strlen( string ), string );
-
-  if( len < exp_len )
-    return -1;
-  return len;
+  return dbBE_Redis_encode_bulk_string( buf, string, strlen( string ) );
 }
 
 int Redis_insert_array_head( char *buf, const unsigned item_count )
@@ -74,20 +65,14 @@ int Redis_insert_array_head( char *buf, const unsigned item_count )
   if( buf == NULL )
     return -1;
 
-  int len = sprintf( buf, "*%d\r\n", item_count );
-  if( len < 4 )
-    return -1;
-  return len;
+  return dbBE_Redis_encode_line( buf, '*', item_count );
 }
 
 int Redis_insert_bulk_string_head( char *buf, const size_t size )
 {
   if( buf == NULL )
     return -1;
-  int len = sprintf( buf, "$%ld\r\n", size);
-  if( len < 4 )
-    return -1;
-  return len;
+  return dbBE_Redis_encode_bulk_head( buf, size );
 }
 
 /*
@@ -146,89 +131,115 @@ int Redis_insert_to_sr_buffer( dbBE_Redis_sr_buffer_t *sr_buf, dbBE_REDIS_DATA_T
 }
 
 /*
- * create the key, based on the command type
+ * render the key of the current stage into the request, based on the command type
+ * the key is kept for subsequent stages unless a stage uses a different namespace or name
  */
-int dbBE_Redis_create_key( dbBE_Redis_request_t *request, char *keybuf, uint16_t size )
+int dbBE_Redis_create_request_key( dbBE_Redis_request_t *request )
 {
-  if( keybuf == NULL )
+  if( request == NULL )
     return -EINVAL;
 
-  int len = 0;
   dbBE_Redis_namespace_t *ns = (dbBE_Redis_namespace_t*)request->_user->_ns_hdl;
-  memset( keybuf, 0, size );
+  char *name = NULL;
   switch( request->_user->_opcode )
   {
     case DBBE_OPCODE_PUT:
     case DBBE_OPCODE_GET:
     case DBBE_OPCODE_READ:
     case DBBE_OPCODE_REMOVE:
-    {
-      len = snprintf( keybuf, size, "%s%s%s",
-                          dbBE_Redis_namespace_get_name( ns ),
-                          DBBE_REDIS_NAMESPACE_SEPARATOR,
-                          request->_user->_key );
-      if(( len < 0 ) || ( len >= size ))
-        return -EMSGSIZE;
+    case DBBE_OPCODE_STAT:
+      name = request->_user->_key;
       break;
-    }
 
     case DBBE_OPCODE_MOVE:
-    {
-      len = 0;
-      switch( request->_step->_stage )
-      {
-        case DBBE_REDIS_MOVE_STAGE_RESTORE: // restore stage uses the new namespace for the key
-          ns = (dbBE_Redis_namespace_t*)request->_user->_sge[0].iov_base;  // destination namespace is in the first SGE arg
-          len = snprintf( keybuf, size, "%s%s%s",
-                          dbBE_Redis_namespace_get_name( ns ),
-                          DBBE_REDIS_NAMESPACE_SEPARATOR,
-                          request->_user->_key );
-          break;
-        default:
-          len = snprintf( keybuf, size, "%s%s%s",
-                          dbBE_Redis_namespace_get_name( ns ),
-                          DBBE_REDIS_NAMESPACE_SEPARATOR,
-                          request->_user->_key );
-          break;
-      }
-      if(( len < 0 ) || ( len >= size ))
-        return -EMSGSIZE;
+      if( request->_step->_stage == DBBE_REDIS_MOVE_STAGE_RESTORE ) // restore stage uses the new namespace for the key
+        ns = (dbBE_Redis_namespace_t*)request->_user->_sge[0].iov_base;  // destination namespace is in the first SGE arg
+      name = request->_user->_key;
       break;
-    }
+
     case DBBE_OPCODE_NSCREATE:
     case DBBE_OPCODE_NSATTACH:
-    {
-      len = snprintf( keybuf, size, "%s", request->_user->_key );
-      if(( len < 0 ) || ( len >= size ))
-        return -EMSGSIZE;
+      name = request->_user->_key;
+      ns = NULL;
       break;
-    }
+
     case DBBE_OPCODE_NSDETACH:
     case DBBE_OPCODE_NSDELETE:
-    {
-      len = snprintf( keybuf, size, "%s", dbBE_Redis_namespace_get_name( ns ) );
-      if(( len < 0 ) || ( len >= size ))
-        return -EMSGSIZE;
-      break;
-    }
     case DBBE_OPCODE_ITERATOR:
     case DBBE_OPCODE_DIRECTORY:
     case DBBE_OPCODE_NSQUERY:
-    {
-      len = snprintf( keybuf, size, "%s", dbBE_Redis_namespace_get_name( ns ) );
-      if(( len < 0 ) || ( len >= size ))
-        return -EMSGSIZE;
+      if( ns == NULL )
+        return -EINVAL;
+      name = dbBE_Redis_namespace_get_name( ns );
+      ns = NULL;
       break;
-    }
+
     case DBBE_OPCODE_NSADDUNITS:
     case DBBE_OPCODE_NSREMOVEUNITS:
     case DBBE_OPCODE_CANCEL:
       return -ENOSYS;
     case DBBE_OPCODE_UNSPEC:
     case DBBE_OPCODE_MAX:
+    default:
       return -EINVAL;
   }
-  return len;
+  if( name == NULL )
+    return -EINVAL;
+
+  dbBE_Redis_request_key_t *key = &request->_key;
+  if(( key->_data != NULL ) && ( key->_ns == ns ) && ( key->_name == name ))
+    return 0;
+
+  size_t namelen = strnlen( name, DBBE_REDIS_MAX_KEY_LEN );
+  size_t prefixlen = ( ns != NULL ) ? dbBE_Redis_namespace_get_prefix_len( ns ) : 0;
+  size_t keylen = prefixlen + namelen;
+  if( keylen >= DBBE_REDIS_MAX_KEY_LEN )
+    return -EMSGSIZE;
+
+  dbBE_Redis_request_key_release( key );
+  size_t space = keylen + DBBE_REDIS_ENCODE_HEAD_MAX + 2;
+  key->_data = key->_inline;
+  if( space > DBBE_REDIS_REQUEST_KEY_INLINE )
+  {
+    key->_data = (char*)malloc( space );
+    if( key->_data == NULL )
+      return -ENOMEM;
+  }
+
+  char *pos = key->_data;
+  int head = dbBE_Redis_encode_bulk_head( pos, keylen );
+  pos += head;
+  if( prefixlen > 0 )
+    memcpy( pos, dbBE_Redis_namespace_get_prefix( ns ), prefixlen );
+  memcpy( pos + prefixlen, name, namelen );
+  Redis_insert_redis_terminator( pos + keylen );
+
+  key->_ns = ns;
+  key->_name = name;
+  key->_head = (uint16_t)head;
+  key->_key_len = (uint16_t)keylen;
+  key->_len = (uint16_t)( head + keylen + 2 );
+  key->_slot = dbBE_Redis_locator_hash( pos, keylen );
+  return 0;
+}
+
+/*
+ * create the key, based on the command type
+ */
+int dbBE_Redis_create_key( dbBE_Redis_request_t *request, char *keybuf, uint16_t size )
+{
+  if( keybuf == NULL )
+    return -EINVAL;
+
+  int rc = dbBE_Redis_create_request_key( request );
+  if( rc != 0 )
+    return rc;
+
+  if( request->_key._key_len >= size )
+    return -EMSGSIZE;
+  memcpy( keybuf, request->_key._data + request->_key._head, request->_key._key_len );
+  keybuf[ request->_key._key_len ] = '\0';
+  return request->_key._key_len;
 }
 
 #ifdef DBR_DEBUG_PROTOCOL
@@ -259,26 +270,24 @@ int dbBE_Redis_create_scan_key( dbBE_Redis_request_t *request,
                                 dbBE_sge_t *keysge )
 {
   char *key = dbBE_Transport_sr_buffer_get_available_position( buf );
-  char *namespace = dbBE_Redis_namespace_get_name( (dbBE_Redis_namespace_t*)(request->_user->_ns_hdl) );
+  dbBE_Redis_namespace_t *ns = (dbBE_Redis_namespace_t*)(request->_user->_ns_hdl);
 
   char *match_all = "*";
   char *match = user_match;
   if(( user_match == NULL ) || ( user_match[0] == '\0'))
     match = match_all;
-  size_t keylen = strnlen( namespace,
-                        DBBE_REDIS_MAX_KEY_LEN ) + DBBE_REDIS_NAMESPACE_SEPARATOR_LEN + strnlen( match, DBBE_REDIS_MAX_KEY_LEN );
-  if( keylen > dbBE_Transport_sr_buffer_remaining( buf ) )
+  size_t prefixlen = dbBE_Redis_namespace_get_prefix_len( ns );
+  size_t matchlen = strnlen( match, DBBE_REDIS_MAX_KEY_LEN );
+  size_t keylen = prefixlen + matchlen;
+  if( keylen + DBBE_REDIS_ENCODE_HEAD_MAX + 2 > dbBE_Transport_sr_buffer_remaining( buf ) )
     return -ENOMEM;
 
-  int len = snprintf( key,
-                      DBBE_REDIS_MAX_KEY_LEN,
-                      "$%ld\r\n%s%s%s\r\n",
-                      keylen,
-                      namespace,
-                      DBBE_REDIS_NAMESPACE_SEPARATOR,
-                      match );
-  if( len < 0 )
-    return -EPROTO;
+  int len = dbBE_Redis_encode_bulk_head( key, keylen );
+  memcpy( key + len, dbBE_Redis_namespace_get_prefix( ns ), prefixlen );
+  len += prefixlen;
+  memcpy( key + len, match, matchlen );
+  len += matchlen;
+  len += Redis_insert_redis_terminator( key + len );
   dbBE_Transport_sr_buffer_add_data( buf, len, 1 );
 
   keysge->iov_base = key;
@@ -302,10 +311,18 @@ int dbBE_Redis_create_command_sge( dbBE_Redis_request_t *request,
       rc = dbBE_Redis_command_rpush_create( request, buf, cmd );
       break;
 
-    case DBBE_OPCODE_GET: // LPOP ns_name%sep;t_name
-      if( stage->_stage != 0 )
-        return -EPROTO;
-      rc = dbBE_Redis_command_lpop_create( request, buf, cmd );
+    case DBBE_OPCODE_GET: // LPOP ns_name%sep;t_name  or  BLPOP ns_name%sep;t_name timeout
+      switch( stage->_stage )
+      {
+        case DBBE_REDIS_GET_STAGE_POP:
+          rc = dbBE_Redis_command_lpop_create( request, buf, cmd );
+          break;
+        case DBBE_REDIS_GET_STAGE_BLOCK:
+          rc = dbBE_Redis_command_blpop_create( request, buf, cmd );
+          break;
+        default:
+          return -EPROTO;
+      }
       break;
 
     case DBBE_OPCODE_READ:
@@ -471,6 +488,20 @@ int dbBE_Redis_create_command_sge( dbBE_Redis_request_t *request,
       break;
     }
 
+    case DBBE_OPCODE_STAT: // EVAL <script> 1 ns_name%sep;t_name  or  LLEN ns_name%sep;t_name
+    {
+      switch( stage->_stage )
+      {
+        case DBBE_REDIS_STAT_STAGE_SIZE:
+        case DBBE_REDIS_STAT_STAGE_COUNT:
+          rc = dbBE_Redis_command_exists_create( request, buf, cmd ); // the key is the only argument in both cases
+          break;
+        default:
+          return -EINVAL;
+      }
+      break;
+    }
+
     case DBBE_OPCODE_ITERATOR:
     {
       dbBE_sge_t keysge;
@@ -29,6 +29,41 @@ int dbBE_Redis_create_command_sge( dbBE_Redis_request_t *request,
                                    dbBE_Redis_sr_buffer_t * buf,
                                    dbBE_sge_t *cmd );
 
+/*
+ * render the key of the current stage of a request into request->_key and compute its hash slot
+ * returns 0 or negative error
+ */
+int dbBE_Redis_create_request_key( dbBE_Redis_request_t *request );
+
+/*
+ * copy the key of the current stage of a request into keybuf (terminated)
+ * returns the key length or negative error
+ */
 int dbBE_Redis_create_key( dbBE_Redis_request_t *request, char *keybuf, uint16_t size );
 
+/*
+ * max number of SGEs of a key argument:
+ * "$<len>\r\n" header, namespace prefix, key name, "\r\n"
+ */
+#define DBBE_REDIS_KEY_SGE_MAX ( 4 )
+
+/*
+ * a key argument of a command
+ * either the rendered key of the request or a length header in the send buffer
+ * followed by the referenced key strings
+ */
+typedef struct
+{
+  int _count;
+  dbBE_sge_t _sge[ DBBE_REDIS_KEY_SGE_MAX ];
+} dbBE_Redis_key_sge_t;
+
+/*
+ * create the key argument of a command, based on the command type
+ * returns the number of SGEs in key or negative error
+ */
+int dbBE_Redis_create_key_cmd( dbBE_Redis_request_t *request,
+                               dbBE_Redis_sr_buffer_t *buf,
+                               dbBE_Redis_key_sge_t *key );
+
 #endif /* BACKEND_REDIS_CREATE_H_ */
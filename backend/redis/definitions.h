@@ -33,6 +33,17 @@
  */
 #define DBBE_REDIS_WORK_QUEUE_DEPTH ( 1024 )
 
+/*
+ * max number of completions held in the lock-free completion ring
+ * more completions spill into an overflow list
+ */
+#define DBBE_REDIS_COMPLETION_RING_DEPTH ( 4096 )
+
+/*
+ * number of released requests and completions that are kept for reuse
+ */
+#define DBBE_REDIS_POOL_CACHED ( 1024 )
+
 /*
  * max redis key len (combined length of namespace+separator+key)
  */
@@ -42,6 +53,14 @@
 #define DBR_SERVER_AUTHFILE_ENV "DBR_AUTHFILE"
 #define DBR_SERVER_DEFAULT_HOST "sock://localhost:6379"
 #define DBR_SERVER_DEFAULT_AUTHFILE ".redis.auth"
+#define DBR_BE_WORKERS_ENV "DBR_BE_WORKERS"
+#define DBR_BE_DEFAULT_WORKERS "0"
+#define DBR_BE_IOENGINE_ENV "DBR_BE_IOENGINE"
+#define DBR_BE_IOENGINE_SOCKET "socket"
+#define DBR_BE_IOENGINE_URING "uring"
+#define DBR_BE_DEFAULT_IOENGINE DBR_BE_IOENGINE_SOCKET
+#define DBR_BE_TOPOLOGY_CACHE_ENV "DBR_BE_TOPOLOGY_CACHE"
+#define DBR_BE_DEFAULT_TOPOLOGY_CACHE ""
 
 #define DBR_SERVER_URL_MAX_LENGTH ( 1024 )
 /*
@@ -59,6 +78,41 @@
 
 #define DBBE_REDIS_COALESCED_MAX ( 32 )
 
+/*
+ * max number of receives per connection within one receiver pass
+ * the active connections take turns, one receive each per round
+ */
+#define DBBE_REDIS_RECEIVE_ROUNDS ( 16 )
+
+/*
+ * number of dedicated connections per Redis server for blocking commands (BLPOP)
+ * each of them parks at most one command on the server at a time
+ * they are linked together with the regular connections, never on demand
+ */
+#define DBBE_REDIS_BLOCKING_CONNECTIONS ( 4 )
+
+/*
+ * timeout (in seconds) of a parked BLPOP
+ * the request comes back at least this often to notice cancellations and the client timeout
+ */
+#define DBBE_REDIS_BLOCKING_SLICE ( 1 )
+
+/*
+ * max time (in seconds) to wait for the remaining responses of a multi-response stage (e.g. MULTI/EXEC)
+ * once the first one arrived; the connection is failed if they don't show up
+ */
+#define DBBE_REDIS_RESPONSE_TIMEOUT ( 5 )
+
+/*
+ * max number of I/O worker threads
+ */
+#define DBBE_REDIS_MAX_WORKERS ( 64 )
+
+/*
+ * time (msec) an idle I/O worker waits for network activity or new requests before checking again
+ */
+#define DBBE_REDIS_WORKER_POLL_TIMEOUT ( 100 )
+
 /*
  * result type returned when parsing a Redis recv buffer
  * indicates the various types of responses from Redis
@@ -134,4 +188,16 @@ typedef struct dbBE_Redis_result {
 
 #define DBBE_REDIS_RECONNECT_TIMEOUT ( 5 )
 
+/*
+ * time limit in seconds for the parallel connects during the cluster bootstrap
+ * connections not established by then are retried one by one
+ */
+#define DBBE_REDIS_LINK_TIMEOUT ( 10 )
+
+/*
+ * min time (msec) between two slot map refreshes triggered by MOVED responses
+ * MOVED responses within that time are only fixed up slot by slot
+ */
+#define DBBE_REDIS_SLOTMAP_REFRESH_INTERVAL ( 100 )
+
 #endif /* BACKEND_REDIS_DEFINITIONS_H_ */
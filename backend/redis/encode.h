@@ -0,0 +1,139 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef BACKEND_REDIS_ENCODE_H_
+#define BACKEND_REDIS_ENCODE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * RESP encoding helpers of the command creation
+ * integers are rendered without format string interpretation, two digits per step
+ */
+
+/*
+ * max number of bytes of an encoded bulk string header: '$' + 20 digits + "\r\n"
+ */
+#define DBBE_REDIS_ENCODE_HEAD_MAX ( 24 )
+
+static const char dbBE_Redis_encode_digit_pairs[ 201 ] =
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+/*
+ * return the number of decimal digits of value
+ */
+static inline
+int dbBE_Redis_encode_digits( uint64_t value )
+{
+  int n = 1;
+  for( ;; )
+  {
+    if( value < 10 ) return n;
+    if( value < 100 ) return n + 1;
+    if( value < 1000 ) return n + 2;
+    if( value < 10000 ) return n + 3;
+    value /= 10000;
+    n += 4;
+  }
+}
+
+/*
+ * write the decimal representation of value to buf (not terminated)
+ * returns the number of bytes written
+ */
+static inline
+int dbBE_Redis_encode_uint( char *buf, uint64_t value )
+{
+  int len = dbBE_Redis_encode_digits( value );
+  char *p = buf + len;
+  while( value >= 100 )
+  {
+    unsigned i = (unsigned)( value % 100 ) * 2;
+    value /= 100;
+    *--p = dbBE_Redis_encode_digit_pairs[ i + 1 ];
+    *--p = dbBE_Redis_encode_digit_pairs[ i ];
+  }
+  if( value >= 10 )
+  {
+    unsigned i = (unsigned)value * 2;
+    *--p = dbBE_Redis_encode_digit_pairs[ i + 1 ];
+    *--p = dbBE_Redis_encode_digit_pairs[ i ];
+  }
+  else
+    *--p = (char)( '0' + value );
+  return len;
+}
+
+static inline
+int dbBE_Redis_encode_int( char *buf, int64_t value )
+{
+  if( value >= 0 )
+    return dbBE_Redis_encode_uint( buf, (uint64_t)value );
+  buf[0] = '-';
+  return dbBE_Redis_encode_uint( buf + 1, -(uint64_t)value ) + 1;
+}
+
+/*
+ * write a "<type><value>\r\n" line, e.g. "$5\r\n" or ":-1\r\n"
+ * buf needs DBBE_REDIS_ENCODE_HEAD_MAX bytes of space
+ */
+static inline
+int dbBE_Redis_encode_line( char *buf, const char type, int64_t value )
+{
+  buf[0] = type;
+  int len = dbBE_Redis_encode_int( buf + 1, value ) + 1;
+  buf[ len ] = '\r';
+  buf[ len + 1 ] = '\n';
+  return len + 2;
+}
+
+/*
+ * write the bulk string header "$<size>\r\n"
+ */
+static inline
+int dbBE_Redis_encode_bulk_head( char *buf, const size_t size )
+{
+  buf[0] = '$';
+  int len = dbBE_Redis_encode_uint( buf + 1, size ) + 1;
+  buf[ len ] = '\r';
+  buf[ len + 1 ] = '\n';
+  return len + 2;
+}
+
+/*
+ * write a complete bulk string "$<size>\r\n<data>\r\n"
+ * buf needs size + DBBE_REDIS_ENCODE_HEAD_MAX + 2 bytes of space
+ */
+static inline
+int dbBE_Redis_encode_bulk_string( char *buf, const char *data, const size_t size )
+{
+  int len = dbBE_Redis_encode_bulk_head( buf, size );
+  if( size > 0 )
+    memcpy( buf + len, data, size );
+  len += size;
+  buf[ len ] = '\r';
+  buf[ len + 1 ] = '\n';
+  return len + 2;
+}
+
+#endif /* BACKEND_REDIS_ENCODE_H_ */
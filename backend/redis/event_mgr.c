@@ -23,12 +23,330 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
 #ifndef __APPLE__
 #include <malloc.h>  // malloc
 #endif
+#ifdef DBBE_REDIS_WITH_EPOLL
+#include <stdint.h>
+#include <time.h>
+#include <sys/epoll.h>
+#else
 #include <event2/event.h>
+#endif
+
+#ifdef DBBE_REDIS_WITH_EPOLL
+
+// epoll data of the wakeup pipe; connections use their index
+#define DBBE_REDIS_EVENT_MGR_WAKEUP_ID ( (uint64_t)DBBE_REDIS_MAX_CONNECTIONS )
+
+static inline
+int64_t dbBE_Redis_event_mgr_now()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+#define dbBE_Redis_event_mgr_timeout_usec( mgr ) \
+  ( (int64_t)(mgr)->_timeout.tv_sec * 1000000 + (mgr)->_timeout.tv_usec )
+
+/*
+ * create and initialize the event mgr
+ */
+dbBE_Redis_event_mgr_t* dbBE_Redis_event_mgr_init( unsigned default_timeout )
+{
+  dbBE_Redis_event_mgr_t *evmgr = (dbBE_Redis_event_mgr_t*)malloc( sizeof( dbBE_Redis_event_mgr_t ) );
+  if( evmgr == NULL )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_init: Failed to allocate event manager\n" );
+    return NULL;
+  }
+
+  memset( evmgr, 0, sizeof( dbBE_Redis_event_mgr_t ) );
+  evmgr->_wakeup_fd[0] = evmgr->_wakeup_fd[1] = -1;
+  evmgr->_next_deadline = INT64_MAX;
+
+  evmgr->_active_queue = dbBE_Redis_connection_queue_create();
+  if( evmgr->_active_queue == NULL )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_init: Failed to allocate active connection queue\n" );
+    free( evmgr );
+    return NULL;
+  }
+
+  evmgr->_epfd = epoll_create1( EPOLL_CLOEXEC );
+  if( evmgr->_epfd < 0 )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_init: Failed to initialize event manager\n" );
+    dbBE_Redis_connection_queue_destroy( evmgr->_active_queue );
+    free( evmgr );
+    return NULL;
+  }
+
+  evmgr->_timeout.tv_sec = default_timeout;
+
+  // the wakeup pipe is only needed for blocking waits
+  struct epoll_event ev;
+  memset( &ev, 0, sizeof( ev ) );
+  ev.events = EPOLLIN;
+  ev.data.u64 = DBBE_REDIS_EVENT_MGR_WAKEUP_ID;
+  if(( pipe( evmgr->_wakeup_fd ) != 0 )
+      || ( fcntl( evmgr->_wakeup_fd[0], F_SETFL, O_NONBLOCK ) != 0 )
+      || ( fcntl( evmgr->_wakeup_fd[1], F_SETFL, O_NONBLOCK ) != 0 )
+      || ( epoll_ctl( evmgr->_epfd, EPOLL_CTL_ADD, evmgr->_wakeup_fd[0], &ev ) != 0 ))
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_init: Failed to create wakeup pipe\n" );
+    dbBE_Redis_event_mgr_exit( evmgr );
+    return NULL;
+  }
+
+  return evmgr;
+}
+
+
+/*
+ * exit and destroy the event mgr
+ */
+int dbBE_Redis_event_mgr_exit( dbBE_Redis_event_mgr_t *ev_mgr )
+{
+  if( ev_mgr == NULL )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_exit: Invalid argument ev_mgr=%p\n", ev_mgr );
+    return -EINVAL;
+  }
+
+  dbBE_Redis_uring_destroy( ev_mgr->_uring );
+
+  if( ev_mgr->_epfd >= 0 )
+    close( ev_mgr->_epfd );
+
+  if( ev_mgr->_wakeup_fd[0] >= 0 )
+    close( ev_mgr->_wakeup_fd[0] );
+  if( ev_mgr->_wakeup_fd[1] >= 0 )
+    close( ev_mgr->_wakeup_fd[1] );
+
+  dbBE_Redis_connection_queue_destroy( ev_mgr->_active_queue );
+
+  memset( ev_mgr, 0, sizeof( dbBE_Redis_event_mgr_t ) );
+  free( ev_mgr );
+
+  return 0;
+}
+
+
+int dbBE_Redis_event_mgr_add( dbBE_Redis_event_mgr_t *ev_mgr,
+                              const dbBE_Redis_connection_t *conn )
+{
+  if(( ev_mgr == NULL ) || ( conn == NULL ))
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_add: Invalid argument: ev_mgr=%p, conn=%p\n", ev_mgr, conn );
+    return -EINVAL;
+  }
+
+  if( conn->_socket <= 0 )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_add: conn=%p has incomplete state to add\n", conn );
+    return -EBADF;
+  }
+
+  if( (unsigned int)conn->_index % DBBE_REDIS_MAX_CONNECTIONS != (unsigned int)conn->_index )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_add: connection index=%d out of range=%d\n", conn->_index, DBBE_REDIS_MAX_CONNECTIONS );
+    return -ERANGE;
+  }
+
+  // check if this socket has an existing event registered already
+  unsigned n;
+  for( n = 0; n < DBBE_REDIS_MAX_CONNECTIONS; ++n )
+  {
+    dbBE_Redis_connection_t *ev_conn = ev_mgr->_conns[ n ];
+    if(( ev_conn != NULL ) && (( ev_conn == conn ) || ( ev_conn->_socket == conn->_socket )))
+    {
+      LOG( DBG_ERR, stderr, "event_mgr_add: requested socket=%d already registered\n", conn->_socket );
+      return -EEXIST;
+    }
+  }
+
+  // edge triggered: the receiver drains a connection until a receive comes back short
+  struct epoll_event ev;
+  memset( &ev, 0, sizeof( ev ) );
+  ev.events = EPOLLIN | EPOLLET;
+  ev.data.u64 = (uint64_t)conn->_index;
+  if( epoll_ctl( ev_mgr->_epfd, EPOLL_CTL_ADD, conn->_socket, &ev ) != 0 )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_add: failed to add event. errno=%d\n", errno );
+    return -EFAULT;
+  }
+
+  ev_mgr->_conns[ conn->_index ] = (dbBE_Redis_connection_t*)conn;
+  ev_mgr->_deadline[ conn->_index ] = dbBE_Redis_event_mgr_now() + dbBE_Redis_event_mgr_timeout_usec( ev_mgr );
+  if( ev_mgr->_deadline[ conn->_index ] < ev_mgr->_next_deadline )
+    ev_mgr->_next_deadline = ev_mgr->_deadline[ conn->_index ];
+
+  return 0;
+}
+
+int dbBE_Redis_event_mgr_rearm( dbBE_Redis_event_mgr_t *ev_mgr,
+                                const dbBE_Redis_connection_t *conn )
+{
+  if(( ev_mgr == NULL ) || ( conn == NULL ) )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_rearm: Invalid argument: ev_mgr=%p, conn=%p\n", ev_mgr, conn );
+    return -EINVAL;
+  }
+
+  if( (unsigned int)conn->_index % DBBE_REDIS_MAX_CONNECTIONS != (unsigned)conn->_index )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_rearm: connection index=%d out of range=%d\n", conn->_index, DBBE_REDIS_MAX_CONNECTIONS );
+    return -ERANGE;
+  }
+
+  if( ev_mgr->_conns[ conn->_index ] == NULL )
+  {
+    LOG( DBG_INFO, stderr, "event_mgr_rearm: need to create new event for connection index=%d\n", conn->_index );
+    return -ENOENT;
+  }
+
+  // modifying re-evaluates the readiness, so pending data triggers a new edge
+  struct epoll_event ev;
+  memset( &ev, 0, sizeof( ev ) );
+  ev.events = EPOLLIN | EPOLLET;
+  ev.data.u64 = (uint64_t)conn->_index;
+  if( epoll_ctl( ev_mgr->_epfd, EPOLL_CTL_MOD, conn->_socket, &ev ) != 0 )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_rearm: failed to rearm event.\n" );
+    return -EFAULT;
+  }
+  ev_mgr->_deadline[ conn->_index ] = dbBE_Redis_event_mgr_now() + dbBE_Redis_event_mgr_timeout_usec( ev_mgr );
+  return 0;
+}
+
+
+int dbBE_Redis_event_mgr_rm( dbBE_Redis_event_mgr_t *ev_mgr,
+                             const dbBE_Redis_connection_t *conn )
+{
+  if(( ev_mgr == NULL ) || ( conn == NULL ) )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_rm: Invalid argument: ev_mgr=%p, conn=%p\n", ev_mgr, conn );
+    return -EINVAL;
+  }
+
+  if( (unsigned int)conn->_index % DBBE_REDIS_MAX_CONNECTIONS != (unsigned)conn->_index )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_rm: connection index=%d out of range=%d\n", conn->_index, DBBE_REDIS_MAX_CONNECTIONS );
+    return -ERANGE;
+  }
+
+  dbBE_Redis_connection_t *ev_conn = ev_mgr->_conns[ conn->_index ];
+  if( ev_conn == NULL )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_rm: no event for connection index=%d\n", conn->_index );
+    return -ENOENT;
+  }
+
+  // a closed socket has already left the epoll set
+  if(( epoll_ctl( ev_mgr->_epfd, EPOLL_CTL_DEL, ev_conn->_socket, NULL ) != 0 ) && ( errno != EBADF ) && ( errno != ENOENT ))
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_rm: failed to remove connection from event mgr\n" );
+    return -EFAULT;
+  }
+
+  // remove entry from connection queue
+  int rc = dbBE_Redis_connection_queue_remove_connection( ev_mgr->_active_queue, conn );
+
+  // remove entry from tracking
+  ev_mgr->_conns[ conn->_index ] = NULL;
+
+  return rc;
+}
+
+
+/*
+ * wait up to timeout_ms for activity and queue all active connections at once
+ * connections without activity for longer than the timeout are queued too (status unchanged)
+ */
+static
+void dbBE_Redis_event_mgr_dispatch( dbBE_Redis_event_mgr_t *ev_mgr, const int timeout_ms )
+{
+  struct epoll_event events[ DBBE_REDIS_MAX_CONNECTIONS + 1 ];
+  int nev = epoll_wait( ev_mgr->_epfd, events, DBBE_REDIS_MAX_CONNECTIONS + 1, timeout_ms );
+  if(( nev < 0 ) && ( errno != EINTR ))
+    LOG( DBG_ERR, stderr, "event_mgr: epoll_wait failed. errno=%d\n", errno );
+
+  int64_t now = dbBE_Redis_event_mgr_now();
+  int64_t deadline = now + dbBE_Redis_event_mgr_timeout_usec( ev_mgr );
+  int n;
+  for( n = 0; n < nev; ++n )
+  {
+    if( events[ n ].data.u64 == DBBE_REDIS_EVENT_MGR_WAKEUP_ID )
+    {
+      char buf[ 64 ];
+      while( read( ev_mgr->_wakeup_fd[0], buf, sizeof( buf ) ) > 0 ) {}
+      continue;
+    }
+
+    dbBE_Redis_connection_t *conn = ev_mgr->_conns[ events[ n ].data.u64 ];
+    if( conn == NULL )
+      continue;
+    LOG( DBG_TRACE, stderr, "Triggered event for connection=%p, socket=%d, index=%d, events=%x\n",
+         conn, conn->_socket, conn->_index, events[ n ].events );
+    dbBE_Redis_connection_set_active( conn );
+    dbBE_Redis_connection_queue_push( ev_mgr->_active_queue, conn );
+    ev_mgr->_deadline[ conn->_index ] = deadline;
+  }
+
+  if( now < ev_mgr->_next_deadline )
+    return;
+
+  // idle timeouts
+  ev_mgr->_next_deadline = INT64_MAX;
+  for( n = 0; n < (int)DBBE_REDIS_MAX_CONNECTIONS; ++n )
+  {
+    dbBE_Redis_connection_t *conn = ev_mgr->_conns[ n ];
+    if( conn == NULL )
+      continue;
+    if( ev_mgr->_deadline[ n ] <= now )
+    {
+      LOG( DBG_VERBOSE, stderr, "Connection timeout detected (idx=%d).\n", conn->_index );
+      dbBE_Redis_connection_queue_push( ev_mgr->_active_queue, conn );
+      ev_mgr->_deadline[ n ] = deadline;
+    }
+    if( ev_mgr->_deadline[ n ] < ev_mgr->_next_deadline )
+      ev_mgr->_next_deadline = ev_mgr->_deadline[ n ];
+  }
+}
+
+
+int dbBE_Redis_event_mgr_wait( dbBE_Redis_event_mgr_t *ev_mgr,
+                               const struct timeval *timeout )
+{
+  if(( ev_mgr == NULL ) || ( timeout == NULL ))
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_wait: Invalid argument: ev_mgr=%p, timeout=%p\n", ev_mgr, timeout );
+    return -EINVAL;
+  }
+
+  // don't sleep if there's a connection that hasn't been processed yet
+  if( dbBE_Redis_connection_queue_head( ev_mgr->_active_queue ) != dbBE_Redis_connection_queue_tail( ev_mgr->_active_queue ) )
+    return 1;
+
+  // any of: socket activity, wakeup pipe, an idle timeout, or the timeout will end the wait
+  int64_t wait_us = (int64_t)timeout->tv_sec * 1000000 + timeout->tv_usec;
+  int64_t idle_us = ev_mgr->_next_deadline - dbBE_Redis_event_mgr_now();
+  if( idle_us < wait_us )
+    wait_us = ( idle_us > 0 ) ? idle_us : 0;
+  dbBE_Redis_event_mgr_dispatch( ev_mgr, (int)(( wait_us + 999 ) / 1000 ) );
+
+  return ( dbBE_Redis_connection_queue_head( ev_mgr->_active_queue ) != dbBE_Redis_connection_queue_tail( ev_mgr->_active_queue ) );
+}
+
+#else // DBBE_REDIS_WITH_EPOLL
 
 void dbBE_Redis_event_mgr_callback( evutil_socket_t socket, short ev_type, void *arg );
+static void dbBE_Redis_event_mgr_wakeup_callback( evutil_socket_t fd, short ev_type, void *arg );
+static void dbBE_Redis_event_mgr_timer_callback( evutil_socket_t fd, short ev_type, void *arg );
 
 /*
  * create and initialize the event mgr
@@ -63,6 +381,26 @@ dbBE_Redis_event_mgr_t* dbBE_Redis_event_mgr_init( unsigned default_timeout )
 
   evmgr->_timeout.tv_sec = default_timeout;
 
+  // the wakeup pipe and wait timer are only needed for blocking waits
+  evmgr->_wakeup_fd[0] = evmgr->_wakeup_fd[1] = -1;
+  if(( pipe( evmgr->_wakeup_fd ) != 0 )
+      || ( fcntl( evmgr->_wakeup_fd[0], F_SETFL, O_NONBLOCK ) != 0 )
+      || ( fcntl( evmgr->_wakeup_fd[1], F_SETFL, O_NONBLOCK ) != 0 ))
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_init: Failed to create wakeup pipe\n" );
+    dbBE_Redis_event_mgr_exit( evmgr );
+    return NULL;
+  }
+
+  evmgr->_wakeup_ev = event_new( evmgr->_evbase, evmgr->_wakeup_fd[0], EV_READ | EV_PERSIST, dbBE_Redis_event_mgr_wakeup_callback, (void*)evmgr );
+  evmgr->_wait_timer = evtimer_new( evmgr->_evbase, dbBE_Redis_event_mgr_timer_callback, (void*)evmgr );
+  if(( evmgr->_wakeup_ev == NULL ) || ( evmgr->_wait_timer == NULL ) || ( event_add( evmgr->_wakeup_ev, NULL ) != 0 ))
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_init: Failed to initialize wakeup events\n" );
+    dbBE_Redis_event_mgr_exit( evmgr );
+    return NULL;
+  }
+
   return evmgr;
 }
 
@@ -78,11 +416,23 @@ int dbBE_Redis_event_mgr_exit( dbBE_Redis_event_mgr_t *ev_mgr )
     return -EINVAL;
   }
 
+  dbBE_Redis_uring_destroy( ev_mgr->_uring );
+
+  if( ev_mgr->_wakeup_ev != NULL )
+    event_free( ev_mgr->_wakeup_ev );
+  if( ev_mgr->_wait_timer != NULL )
+    event_free( ev_mgr->_wait_timer );
+
   if( ev_mgr->_evbase != NULL )
   {
     event_base_free( ev_mgr->_evbase );
   }
 
+  if( ev_mgr->_wakeup_fd[0] >= 0 )
+    close( ev_mgr->_wakeup_fd[0] );
+  if( ev_mgr->_wakeup_fd[1] >= 0 )
+    close( ev_mgr->_wakeup_fd[1] );
+
   dbBE_Redis_connection_queue_destroy( ev_mgr->_active_queue );
 
   memset( ev_mgr, 0, sizeof( dbBE_Redis_event_mgr_t ) );
@@ -290,6 +640,88 @@ void dbBE_Redis_event_mgr_callback( evutil_socket_t socket, short ev_type, void
 }
 
 
+
+/*
+ * run one non-blocking pass of the event loop; the callbacks queue the active connections
+ */
+static
+void dbBE_Redis_event_mgr_dispatch( dbBE_Redis_event_mgr_t *ev_mgr, const int timeout_ms )
+{
+  event_base_loop( ev_mgr->_evbase, EVLOOP_ONCE | EVLOOP_NONBLOCK );
+}
+
+
+int dbBE_Redis_event_mgr_wait( dbBE_Redis_event_mgr_t *ev_mgr,
+                               const struct timeval *timeout )
+{
+  if(( ev_mgr == NULL ) || ( timeout == NULL ))
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_wait: Invalid argument: ev_mgr=%p, timeout=%p\n", ev_mgr, timeout );
+    return -EINVAL;
+  }
+
+  // don't sleep if there's a connection that hasn't been processed yet
+  if( dbBE_Redis_connection_queue_head( ev_mgr->_active_queue ) != dbBE_Redis_connection_queue_tail( ev_mgr->_active_queue ) )
+    return 1;
+
+  // any of: socket activity, wakeup pipe, or the timer will end the loop
+  evtimer_add( ev_mgr->_wait_timer, timeout );
+  event_base_loop( ev_mgr->_evbase, EVLOOP_ONCE );
+  evtimer_del( ev_mgr->_wait_timer );
+
+  return ( dbBE_Redis_connection_queue_head( ev_mgr->_active_queue ) != dbBE_Redis_connection_queue_tail( ev_mgr->_active_queue ) );
+}
+
+static void dbBE_Redis_event_mgr_wakeup_callback( evutil_socket_t fd, short ev_type, void *arg )
+{
+  char buf[ 64 ];
+  while( read( fd, buf, sizeof( buf ) ) > 0 ) {}
+}
+
+static void dbBE_Redis_event_mgr_timer_callback( evutil_socket_t fd, short ev_type, void *arg )
+{
+  LOG( DBG_TRACE, stderr, "event_mgr_wait: timeout\n" );
+}
+
+#endif // DBBE_REDIS_WITH_EPOLL
+
+
+/*
+ * receive on all newly activated connections with one io_uring submission
+ * the connections go back into the active queue in the same order
+ */
+static
+void dbBE_Redis_event_mgr_prefetch( dbBE_Redis_event_mgr_t *ev_mgr )
+{
+  dbBE_Redis_connection_t *active[ DBBE_REDIS_MAX_CONNECTIONS ];
+  int count = 0;
+  dbBE_Redis_connection_t *conn;
+  while(( count < (int)DBBE_REDIS_MAX_CONNECTIONS ) &&
+      (( conn = dbBE_Redis_connection_queue_pop( ev_mgr->_active_queue )) != NULL ))
+    active[ count++ ] = conn;
+  if( count == 0 )
+    return;
+
+  int rc = dbBE_Redis_uring_recv( ev_mgr->_uring, active, count );
+  if( rc < 0 )
+    LOG( DBG_ERR, stderr, "event_mgr_next: io_uring receive failed. rc=%d\n", rc );
+
+  int n;
+  for( n = 0; n < count; ++n )
+    dbBE_Redis_connection_queue_push( ev_mgr->_active_queue, active[ n ] );
+}
+
+/*
+ * check the readiness of all connections without blocking and queue the active ones
+ */
+static
+void dbBE_Redis_event_mgr_refill( dbBE_Redis_event_mgr_t *ev_mgr )
+{
+  dbBE_Redis_event_mgr_dispatch( ev_mgr, 0 );
+  if( ev_mgr->_uring != NULL )
+    dbBE_Redis_event_mgr_prefetch( ev_mgr );
+}
+
 dbBE_Redis_connection_t* dbBE_Redis_event_mgr_next( dbBE_Redis_event_mgr_t *ev_mgr )
 {
   if( ev_mgr == NULL )
@@ -304,9 +736,53 @@ dbBE_Redis_connection_t* dbBE_Redis_event_mgr_next( dbBE_Redis_event_mgr_t *ev_m
     return next;
 
   LOG( DBG_TRACE, stderr, "event_mgr_next: starting loop\n" );
-  event_base_loop( ev_mgr->_evbase, EVLOOP_ONCE | EVLOOP_NONBLOCK );
+  dbBE_Redis_event_mgr_refill( ev_mgr );
   next = dbBE_Redis_connection_queue_pop( ev_mgr->_active_queue );
   LOG( DBG_VERBOSE, stderr, "event_mgr_next: new active connection: conn=%p\n", next );
 
   return next;
 }
+
+
+int dbBE_Redis_event_mgr_harvest( dbBE_Redis_event_mgr_t *ev_mgr,
+                                  dbBE_Redis_connection_t **conns,
+                                  const int max )
+{
+  if(( ev_mgr == NULL ) || ( conns == NULL ) || ( max <= 0 ))
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_harvest: Invalid argument: ev_mgr=%p, conns=%p, max=%d\n", ev_mgr, conns, max );
+    return -EINVAL;
+  }
+
+  if( dbBE_Redis_connection_queue_head( ev_mgr->_active_queue ) == dbBE_Redis_connection_queue_tail( ev_mgr->_active_queue ) )
+    dbBE_Redis_event_mgr_refill( ev_mgr );
+
+  // the queue may list a connection more than once (e.g. a timeout and new data)
+  uint8_t listed[ DBBE_REDIS_MAX_CONNECTIONS ];
+  memset( listed, 0, sizeof( listed ) );
+  int count = 0;
+  dbBE_Redis_connection_t *conn;
+  while(( count < max ) && (( conn = dbBE_Redis_connection_queue_pop( ev_mgr->_active_queue )) != NULL ))
+  {
+    unsigned idx = (unsigned)conn->_index % DBBE_REDIS_MAX_CONNECTIONS;
+    if( listed[ idx ] )
+      continue;
+    listed[ idx ] = 1;
+    conns[ count++ ] = conn;
+  }
+  LOG( DBG_VERBOSE, stderr, "event_mgr_harvest: %d active connections\n", count );
+  return count;
+}
+
+
+int dbBE_Redis_event_mgr_wakeup( dbBE_Redis_event_mgr_t *ev_mgr )
+{
+  if(( ev_mgr == NULL ) || ( ev_mgr->_wakeup_fd[1] < 0 ))
+    return -EINVAL;
+
+  // a full pipe already guarantees the wakeup
+  char c = 0;
+  if(( write( ev_mgr->_wakeup_fd[1], &c, 1 ) < 0 ) && ( errno != EAGAIN ) && ( errno != EWOULDBLOCK ))
+    return -errno;
+  return 0;
+}
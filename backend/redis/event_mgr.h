@@ -19,30 +19,46 @@
 #define BACKEND_REDIS_EVENT_MGR_H_
 
 #include <sys/types.h>
+#include <stdint.h>
+#ifndef DBBE_REDIS_WITH_EPOLL
 #include <event2/event.h>
+#endif
 
 #include "definitions.h"
 #include "connection.h"
 #include "connection_queue.h"
+#include "uring.h"
 
 typedef struct dbBE_Redis_event_mgr
 {
   struct timeval _timeout;
+#ifdef DBBE_REDIS_WITH_EPOLL
+  int _epfd;                       ///< epoll instance; one epoll_wait() harvests the readiness of all connections
+  dbBE_Redis_connection_t *_conns[ DBBE_REDIS_MAX_CONNECTIONS ];  ///< registered connections by index
+  int64_t _deadline[ DBBE_REDIS_MAX_CONNECTIONS ];  ///< idle timeout of each registered connection (usec, monotonic)
+  int64_t _next_deadline;          ///< earliest idle timeout of all connections
+#else
   struct event_base *_evbase;
   struct event *_events[ DBBE_REDIS_MAX_CONNECTIONS ];
+  struct event *_wakeup_ev;
+  struct event *_wait_timer;       ///< bounds the time of a blocking wait
+#endif
   dbBE_Redis_connection_queue_t *_active_queue;
+  int _wakeup_fd[2];               ///< self-pipe to interrupt a blocking wait from another thread
+  dbBE_Redis_uring_t *_uring;      ///< io_uring engine (DBR_BE_IOENGINE=uring) or NULL; owned by the event mgr
 } dbBE_Redis_event_mgr_t;
 
 
+#ifndef DBBE_REDIS_WITH_EPOLL
 typedef struct dbBE_Redis_event_info
 {
   dbBE_Redis_connection_t *_conn;
   dbBE_Redis_event_mgr_t *_ev_mgr;
 } dbBE_Redis_event_info_t;
+#endif
 
 
 
-#define dbBE_Redis_event_mgr_getbase( mgr ) ((mgr)->_evbase)
 #define dbBE_Redis_connection_mgr_getqueue( mgr ) ((mgr)->_active_queue)
 
 /*
@@ -83,4 +99,36 @@ int dbBE_Redis_event_mgr_rm( dbBE_Redis_event_mgr_t *ev_mgr,
 dbBE_Redis_connection_t* dbBE_Redis_event_mgr_next( dbBE_Redis_event_mgr_t *ev_mgr );
 
 
+/*
+ * retrieve all active connections at once (up to max)
+ * the readiness of all connections is checked only if no connection is waiting in the queue
+ * returns the number of connections placed into conns
+ */
+int dbBE_Redis_event_mgr_harvest( dbBE_Redis_event_mgr_t *ev_mgr,
+                                  dbBE_Redis_connection_t **conns,
+                                  const int max );
+
+
+/*
+ * put a connection back into the active queue
+ * (e.g. a connection that has more data than could be received within one pass)
+ */
+#define dbBE_Redis_event_mgr_requeue( mgr, conn ) \
+  dbBE_Redis_connection_queue_push( (mgr)->_active_queue, (conn) )
+
+
+/*
+ * block until a connection becomes active, the timeout expires, or wakeup is called
+ * returns 1 if there's an active connection in the queue, 0 otherwise
+ */
+int dbBE_Redis_event_mgr_wait( dbBE_Redis_event_mgr_t *ev_mgr,
+                               const struct timeval *timeout );
+
+
+/*
+ * interrupt a blocking wait (safe to call from any thread)
+ */
+int dbBE_Redis_event_mgr_wakeup( dbBE_Redis_event_mgr_t *ev_mgr );
+
+
 #endif /* BACKEND_REDIS_EVENT_MGR_H_ */
@@ -162,7 +162,20 @@ int dbBE_Redis_locator_reassociate_conn_index( dbBE_Redis_locator_t *locator,
 
 dbBE_Redis_hash_slot_t dbBE_Redis_locator_hash( const char *key, const uint16_t size )
 {
-  return (dbBE_Redis_hash_slot_t)crcremainder( key, size ) & DBBE_REDIS_HASH_SLOT_MASK;
+  // Redis cluster hash tags: if there's a non-empty substring between the first '{'
+  // and the following '}', only that substring is hashed
+  uint16_t len = size;
+  const char *open = ( key != NULL ) ? memchr( key, '{', size ) : NULL;
+  if( open != NULL )
+  {
+    const char *close = memchr( open + 1, '}', size - ( open + 1 - key ) );
+    if(( close != NULL ) && ( close > open + 1 ))
+    {
+      key = open + 1;
+      len = close - key;
+    }
+  }
+  return (dbBE_Redis_hash_slot_t)crcremainder( key, len ) & DBBE_REDIS_HASH_SLOT_MASK;
 }
 
 
@@ -95,6 +95,7 @@ int dbBE_Redis_locator_reassociate_conn_index( dbBE_Redis_locator_t *locator,
 
 /*
  * calculate crc16 of the key and return the redis hash slot
+ * (honors {hashtag} sections in the key the same way Redis cluster does)
  */
 dbBE_Redis_hash_slot_t dbBE_Redis_locator_hash( const char *key, const uint16_t size );
 
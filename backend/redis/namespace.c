@@ -18,7 +18,9 @@
 #include "logutil.h"
 #include "memutil.h"
 #include "namespace.h"
+#include "definitions.h"
 #include "namespacelist.h"
+#include "common/utility.h"
 
 
 
@@ -81,7 +83,9 @@ dbBE_Redis_namespace_t* dbBE_Redis_namespace_create( const char *name )
     return NULL;
   }
 
-  dbBE_Redis_namespace_t *ns = (dbBE_Redis_namespace_t*)calloc( 1, sizeof( dbBE_Redis_namespace_t ) + len + 4 ); // +4 for trailling \0 and checksum calc
+  // name, +4 for trailling \0 and checksum calc, then the key prefix with separator and \0
+  dbBE_Redis_namespace_t *ns = (dbBE_Redis_namespace_t*)calloc( 1, sizeof( dbBE_Redis_namespace_t ) + len + 4
+                                                                + len + DBBE_REDIS_NAMESPACE_SEPARATOR_LEN + 1 );
   if( ns == NULL )
   {
     errno = ENOMEM;
@@ -92,6 +96,13 @@ dbBE_Redis_namespace_t* dbBE_Redis_namespace_create( const char *name )
   strncpy( ns->_name, name, len );
   // no explicit setting of terminating '\0' because calloc already has a trailing zero
 
+  // the key prefix is needed for every key in this namespace
+  ns->_prefix = &ns->_name[ len + 4 ];
+  memcpy( ns->_prefix, name, len );
+  memcpy( &ns->_prefix[ len ], DBBE_REDIS_NAMESPACE_SEPARATOR, DBBE_REDIS_NAMESPACE_SEPARATOR_LEN );
+  ns->_prefix_len = len + DBBE_REDIS_NAMESPACE_SEPARATOR_LEN;
+
+  ns->_hash = dbBE_String_hash( ns->_name, len );
   ns->_refcnt = 1;
   ns->_chksum = dbBE_Redis_namespace_checksum( ns );
   return ns;
@@ -165,168 +176,151 @@ int dbBE_Redis_namespace_detach( dbBE_Redis_namespace_t *ns )
  * NAMESPACE LIST FUNCTIONS
  */
 
-// use last bit of ptr address to signal matching namespace was found
-#define DBBE_REDIS_NS_PTR_MATCH( p ) ((dbBE_Redis_namespace_list_t*)((uintptr_t)(p) | 0x1ull))
-#define DBBE_REDIS_NS_MATCHED( p )   (((uintptr_t)(p) & 0x1ull) != 0)
-#define DBBE_REDIS_NS_PTR_FIX( p )   ((dbBE_Redis_namespace_list_t*)((uintptr_t)(p) & (~0x1ull)))
+dbBE_Redis_namespace_list_t* dbBE_Redis_namespace_list_create()
+{
+  dbBE_Redis_namespace_list_t *s = (dbBE_Redis_namespace_list_t*)calloc( 1, sizeof( dbBE_Redis_namespace_list_t ) );
+  if( s == NULL )
+  {
+    errno = ENOMEM;
+    return NULL;
+  }
+  s->_buckets = (dbBE_Redis_namespace_t**)calloc( DBBE_REDIS_NAMESPACE_TABLE_INITIAL, sizeof( dbBE_Redis_namespace_t* ) );
+  if( s->_buckets == NULL )
+  {
+    free( s );
+    errno = ENOMEM;
+    return NULL;
+  }
+  s->_mask = DBBE_REDIS_NAMESPACE_TABLE_INITIAL - 1;
+  s->_count = 0;
+  return s;
+}
 
-// search for namespace entry
-// if found: return entry but with lowest bit set to 1 (i.e. cannot be dereferenced directly!!!)
-// if not found: return list entry BEFORE insertion needs to happen
+// double the number of buckets and rehash; the table stays intact if there's no memory
 static
-dbBE_Redis_namespace_list_t* dbBE_Redis_namespace_list_find( dbBE_Redis_namespace_list_t *s,
-                                                             const char *name )
+int dbBE_Redis_namespace_list_grow( dbBE_Redis_namespace_list_t *s )
 {
-  dbBE_Redis_namespace_list_t *r = s;
-  int dir = 0;
-  int lcomp = 0;
-  dir = strncmp( name, r->_ns->_name, 1 );
-  do
-  {
-    int comp = strncmp( name, r->_ns->_name, DBR_MAX_KEY_LEN );
-    if( comp == 0 )
-      return DBBE_REDIS_NS_PTR_MATCH( r );
+  uint32_t new_mask = ( s->_mask << 1 ) + 1;
+  dbBE_Redis_namespace_t **buckets = (dbBE_Redis_namespace_t**)calloc( (size_t)new_mask + 1, sizeof( dbBE_Redis_namespace_t* ) );
+  if( buckets == NULL )
+    return -ENOMEM;
 
-    if( comp < 0 )
-    {
-      if( dir > 0 )
-      {
-        r = r->_p; // one step back; we just detected that we went one step too far
-        break;
-      }
-      lcomp = strncmp( r->_ns->_name, r->_p->_ns->_name, DBR_MAX_KEY_LEN );
-      if( lcomp < 0 )
-      {
-        r = r->_p;
-        break;
-      }
-      dir = -1;
-      r = r->_p;
-    }
-    if( comp > 0 )
+  uint32_t b;
+  for( b = 0; b <= s->_mask; ++b )
+  {
+    dbBE_Redis_namespace_t *ns = s->_buckets[ b ];
+    while( ns != NULL )
     {
-      if( dir < 0 )
-        break;
-      lcomp = strncmp( r->_ns->_name, r->_n->_ns->_name, DBR_MAX_KEY_LEN );
-      if( lcomp > 0 )
-        break;
-      dir = 1;
-      r = r->_n;
+      dbBE_Redis_namespace_t *next = ns->_next;
+      uint32_t nb = ns->_hash & new_mask;
+      ns->_next = buckets[ nb ];
+      buckets[ nb ] = ns;
+      ns = next;
     }
-  } while( r != s );
-  return r;
+  }
+  free( s->_buckets );
+  s->_buckets = buckets;
+  s->_mask = new_mask;
+  return 0;
 }
 
-dbBE_Redis_namespace_list_t* dbBE_Redis_namespace_list_get( dbBE_Redis_namespace_list_t *s,
-                                                            const char *name )
+// search for namespace entry
+// returns the link that points to the entry; the link contains NULL if the namespace doesn't exist
+static
+dbBE_Redis_namespace_t** dbBE_Redis_namespace_list_find( dbBE_Redis_namespace_list_t *s,
+                                                         const char *name,
+                                                         const uint32_t hash )
 {
-  if( (s==NULL) || ( name == NULL ))
-  {
-    errno = EINVAL;
-    return NULL;
-  }
-  dbBE_Redis_namespace_list_t *p = dbBE_Redis_namespace_list_find( s, name );
-  if( DBBE_REDIS_NS_MATCHED( p ) )
-  {
-    p = DBBE_REDIS_NS_PTR_FIX( p );
-    return p;
-  }
-  errno = ENOENT;
-  return NULL;
+  dbBE_Redis_namespace_t **link = &s->_buckets[ hash & s->_mask ];
+  while(( *link != NULL ) &&
+        (( (*link)->_hash != hash ) || ( strncmp( (*link)->_name, name, DBR_MAX_KEY_LEN ) != 0 )))
+    link = &(*link)->_next;
+  return link;
 }
 
-dbBE_Redis_namespace_list_t* dbBE_Redis_namespace_list_insert( dbBE_Redis_namespace_list_t *s,
-                                                               dbBE_Redis_namespace_t * const ns )
+dbBE_Redis_namespace_t* dbBE_Redis_namespace_list_get( dbBE_Redis_namespace_list_t *s,
+                                                       const char *name )
 {
-  if( ns == NULL )
+  if( (s==NULL) || ( name == NULL ))
   {
     errno = EINVAL;
     return NULL;
   }
-  dbBE_Redis_namespace_list_t *r = s;
-  if( s == NULL )
-  {
-    r = (dbBE_Redis_namespace_list_t*)calloc( 1, sizeof( dbBE_Redis_namespace_list_t ) );
-    if( r == NULL )
-    {
-      errno = ENOMEM;
-      return NULL;
-    }
-  }
+  uint32_t hash = dbBE_String_hash( name, DBR_MAX_KEY_LEN );
+  dbBE_Redis_namespace_t *ns = *dbBE_Redis_namespace_list_find( s, name, hash );
+  if( ns == NULL )
+    errno = ENOENT;
+  return ns;
+}
 
-  if(( r->_ns == NULL ) && ( r->_n == NULL ) && ( r->_p == NULL ))
-  {
-    r->_n = r;
-    r->_p = r;
-    r->_ns = ns;
-    return r;
-  }
+int dbBE_Redis_namespace_list_insert( dbBE_Redis_namespace_list_t *s,
+                                      dbBE_Redis_namespace_t * const ns )
+{
+  if(( s == NULL ) || ( ns == NULL ))
+    return -EINVAL;
 
-  dbBE_Redis_namespace_list_t *t = dbBE_Redis_namespace_list_find( r, ns->_name );
-  if( DBBE_REDIS_NS_MATCHED( t ) ) // if exact entry is found, the lowest bit is 1
+  dbBE_Redis_namespace_t **link = dbBE_Redis_namespace_list_find( s, ns->_name, ns->_hash );
+  if( *link != NULL )
   {
     // don't call attach, because insert of existing NS might be an error case
-    errno = EEXIST;
-    return NULL;
+    return -EEXIST;
   }
 
-  r = (dbBE_Redis_namespace_list_t*)calloc( 1, sizeof( dbBE_Redis_namespace_list_t ) );
-  r->_n = t->_n;
-  r->_p = t;
-  t->_n = r;
-  r->_n->_p = r;
-  r->_ns = ns;
-  t = r;
-  return t;
+  // keep the load factor <= 1; a failed grow only costs longer bucket chains
+  if(( s->_count > s->_mask ) && ( dbBE_Redis_namespace_list_grow( s ) == 0 ))
+    link = dbBE_Redis_namespace_list_find( s, ns->_name, ns->_hash );
+
+  ns->_next = NULL;
+  *link = ns;
+  ++s->_count;
+  return 0;
 }
 
-dbBE_Redis_namespace_list_t* dbBE_Redis_namespace_list_remove( dbBE_Redis_namespace_list_t *s,
-                                                               const dbBE_Redis_namespace_t *ns )
+int dbBE_Redis_namespace_list_remove( dbBE_Redis_namespace_list_t *s,
+                                      dbBE_Redis_namespace_t *ns )
 {
   if(( s == NULL ) || ( ns == NULL ))
-  {
-    errno = EINVAL;
-    return NULL;
-  }
+    return -EINVAL;
+
+  int rc = dbBE_Redis_namespace_validate( ns );
+  if( rc != 0 )
+    return -rc;
+
+  dbBE_Redis_namespace_t **link = dbBE_Redis_namespace_list_find( s, ns->_name, ns->_hash );
+  if( *link != ns )
+    return -ENOENT;
 
-  dbBE_Redis_namespace_list_t *t = s;
-  dbBE_Redis_namespace_list_t *r = dbBE_Redis_namespace_list_find( s, ns->_name );
-  if( DBBE_REDIS_NS_MATCHED( r ) )
+  // the last detach destroys the namespace, so it has to leave the table before
+  if( dbBE_Redis_namespace_get_refcnt( ns ) <= 1 )
   {
-    r = DBBE_REDIS_NS_PTR_FIX( r );
-    if( dbBE_Redis_namespace_detach( r->_ns ) > 0 )
-    {
-      errno = EBUSY;
-      return r;
-    }
-    t = r->_n;
-    if( t == r ) // last element in the ring?
-      t = NULL;
-    r->_p->_n = r->_n;
-    r->_n->_p = r->_p;
-    if( memzero( r, 0, sizeof( r ) ) == NULL )
-      free( r );
-    else
-      free( r );
+    *link = ns->_next;
+    ns->_next = NULL;
+    --s->_count;
   }
-  return t;
+  return dbBE_Redis_namespace_detach( ns );
 }
 
 int dbBE_Redis_namespace_list_clean( dbBE_Redis_namespace_list_t *s )
 {
-  if( (s != NULL ) && ( s->_p != NULL )) // cut the ring
-    s->_p->_n = NULL;
-  while( s != NULL)
+  if( s == NULL )
+    return 0;
+
+  uint32_t b;
+  for( b = 0; ( s->_buckets != NULL ) && ( b <= s->_mask ); ++b )
   {
-    dbBE_Redis_namespace_list_t *t = s->_n;
-    s->_n = NULL;
-    s->_p = NULL;
-    while( dbBE_Redis_namespace_destroy( s->_ns ) == -EBUSY )
-      dbBE_Redis_namespace_detach( s->_ns );
-    s->_ns = NULL;
-    free( s );
-    s = t;
+    dbBE_Redis_namespace_t *ns = s->_buckets[ b ];
+    while( ns != NULL )
+    {
+      dbBE_Redis_namespace_t *next = ns->_next;
+      ns->_next = NULL;
+      while( dbBE_Redis_namespace_destroy( ns ) == -EBUSY )
+        dbBE_Redis_namespace_detach( ns );
+      ns = next;
+    }
   }
+  free( s->_buckets );
+  memset( s, 0, sizeof( dbBE_Redis_namespace_list_t ) );
+  free( s );
   return 0;
 }
 
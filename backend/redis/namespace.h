@@ -33,15 +33,22 @@
 typedef struct dbBE_Redis_namespace
 {
   int64_t _chksum; // a simple checksum to allow some validity checks; e.g. for use-after-free cases
+  struct dbBE_Redis_namespace *_next; // next entry in the same bucket of the namespace table
+  uint32_t _hash;       // hash of the name to index the namespace table
   uint32_t _refcnt;     // local reference counting
   uint32_t _len;        // length of the namespace string to speed up length calculation
+  uint32_t _prefix_len; // length of the key prefix
+  char *_prefix;        // key prefix "<name>::" (stored behind the name)
   char _name[0];   // space holder for the actual namespace string
 } dbBE_Redis_namespace_t;
 
 
 #define dbBE_Redis_namespace_get_name( ns ) ( (ns)->_name )
 #define dbBE_Redis_namespace_get_len( ns ) ( (ns)->_len )
+#define dbBE_Redis_namespace_get_prefix( ns ) ( (ns)->_prefix )
+#define dbBE_Redis_namespace_get_prefix_len( ns ) ( (ns)->_prefix_len )
 #define dbBE_Redis_namespace_get_refcnt( ns ) ( (ns)->_refcnt )
+#define dbBE_Redis_namespace_get_hash( ns ) ( (ns)->_hash )
 
 int dbBE_Redis_namespace_validate( const dbBE_Redis_namespace_t *ns );
 dbBE_Redis_namespace_t* dbBE_Redis_namespace_create( const char *name );
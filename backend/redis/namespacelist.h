@@ -20,29 +20,39 @@
 
 #include "namespace.h"
 
+#define DBBE_REDIS_NAMESPACE_TABLE_INITIAL ( 64 )  // initial number of buckets (power of 2)
+
+/*
+ * hash table of namespaces by name
+ * namespaces are chained into their bucket through their _next member
+ * the number of buckets doubles when it drops below the number of namespaces
+ */
 typedef struct dbBE_Redis_namespace_list
 {
-  struct dbBE_Redis_namespace_list *_n;
-  struct dbBE_Redis_namespace_list *_p;
-  dbBE_Redis_namespace_t *_ns;
+  dbBE_Redis_namespace_t **_buckets;
+  uint32_t _mask;     // number of buckets - 1
+  uint32_t _count;    // number of namespaces in the table
 } dbBE_Redis_namespace_list_t;
 
 
-// retrieve namespace list ptr if namespace 'name' exists; otherwise NULL is returned
-dbBE_Redis_namespace_list_t* dbBE_Redis_namespace_list_get( dbBE_Redis_namespace_list_t *s,
-                                                            const char *name );
+// create an empty namespace table
+dbBE_Redis_namespace_list_t* dbBE_Redis_namespace_list_create();
+
+// retrieve namespace 'name' if it exists; otherwise NULL is returned and errno is set to ENOENT
+dbBE_Redis_namespace_t* dbBE_Redis_namespace_list_get( dbBE_Redis_namespace_list_t *s,
+                                                       const char *name );
 
-// insert namespace into sorted list; only insert if not exists
+// insert namespace into the table; only insert if not exists (returns -EEXIST)
 // attach/refcount needs to be done separately if needed
-dbBE_Redis_namespace_list_t* dbBE_Redis_namespace_list_insert( dbBE_Redis_namespace_list_t *s,
-                                                               dbBE_Redis_namespace_t * const ns );
+int dbBE_Redis_namespace_list_insert( dbBE_Redis_namespace_list_t *s,
+                                      dbBE_Redis_namespace_t * const ns );
 
-// remove namespace from list in case the reference count hits 0 (in that case it's detached/cleaned up too)
-// otherwise only detach, i.e. refcnt decrease
-dbBE_Redis_namespace_list_t* dbBE_Redis_namespace_list_remove( dbBE_Redis_namespace_list_t *s,
-                                                               const dbBE_Redis_namespace_t *ns );
+// detach the namespace and remove it from the table in case the reference count hits 0 (in that case it's cleaned up too)
+// returns the remaining reference count or a negative error code
+int dbBE_Redis_namespace_list_remove( dbBE_Redis_namespace_list_t *s,
+                                      dbBE_Redis_namespace_t *ns );
 
-// wipe the namespace list, regardless of content status
+// wipe the namespace table, regardless of content status
 int dbBE_Redis_namespace_list_clean( dbBE_Redis_namespace_list_t *s );
 
 #endif /* BACKEND_REDIS_NAMESPACELIST_H_ */
@@ -34,6 +34,7 @@
 #include "../../src/libdatabroker_int.h"
 #include "result.h"
 #include "parse.h"
+#include "scan.h"
 #include "connection.h"
 
 
@@ -64,8 +65,8 @@ int64_t dbBE_Redis_nul_terminate_string( char *p, size_t *parsed, const int64_t
     errno = EINVAL;
     return 0;
   }
-  char *end = strstr( p, "\r\n" );
-  if(( end == NULL ) || ( end - p > limit ))
+  char *end = dbBE_Redis_scan_crlf( p, limit );
+  if( end == NULL )
   {
     *parsed = 0;
     return -EAGAIN;
@@ -110,6 +111,20 @@ int64_t dbBE_Redis_extract_integer( char *p, size_t *parsed, const int64_t limit
     ++pp;
     --remaining;
   }
+  // fast path: up to 8 digits and the terminator are available
+  if( remaining >= 10 )
+  {
+    uint64_t value;
+    int digits = dbBE_Redis_scan_digits8( p, &value );
+    if(( digits >= 0 ) && ( p[ digits ] == '\r' ))
+    {
+      ret = (int64_t)value;
+      p += digits;
+      pp += digits;
+      remaining -= digits;
+    }
+  }
+
   while((*p != '\r') && (*p != '\0' ) && ( remaining > 0 ))
   {
     ret *= 10;
@@ -151,24 +166,10 @@ exit_with_nan:
 // function to find the terminator, strstr will not work because of zeroes in the data
 char* dbBE_Redis_find_terminator( char *haystack, const int64_t limit )
 {
-  char *p = haystack;
-  int64_t pos = 0;
-  while( pos < limit )
-  {
-    while( ( pos < limit - 1 ) && ( *p != '\r'))
-    {
-      ++pos;
-      ++p;
-    }
-    if( ( *p == '\r') && ( p[1] == '\n'))
-    {
-      LOG( DBG_VERBOSE, stdout, "Found Terminator @%"PRId64"\n", pos );
-      return p;
-    }
-    ++pos;
-    ++p;
-  }
-  return NULL;
+  char *p = dbBE_Redis_scan_crlf( haystack, limit );
+  if( p != NULL )
+    LOG( DBG_VERBOSE, stdout, "Found Terminator @%"PRId64"\n", (int64_t)( p - haystack ) );
+  return p;
 }
 
 int64_t dbBE_Redis_extract_bulk_string( char **p, size_t *parsed, const int64_t limit, size_t *actual_size )
@@ -267,9 +268,14 @@ int64_t dbBE_Redis_extract_bulk_string( char **p, size_t *parsed, const int64_t
 // try not to do anything here, really only do parsing and return of pointer into the rbuffer without copies
 // if copies are needed, let the caller do that, it should know better...
 // the only change happens on the buffer in-place by nul-terminating the strings
-int dbBE_Redis_parse_sr_buffer_check( dbBE_Redis_sr_buffer_t *sr_buf,
-                                      dbBE_Redis_result_t *result,
-                                      const int toplevel )
+//
+// parses a single element at the current position; arrays only up to their header,
+// the entries get allocated and are left to the caller
+// an incomplete element leaves the processed position of the buffer unchanged
+static
+int dbBE_Redis_parse_element( dbBE_Redis_sr_buffer_t *sr_buf,
+                              dbBE_Redis_result_t *result,
+                              const int partial )
 {
   int rc = 0;
   if(( sr_buf == NULL ) || ( result == NULL ))
@@ -291,6 +297,10 @@ int dbBE_Redis_parse_sr_buffer_check( dbBE_Redis_sr_buffer_t *sr_buf,
 
   int64_t available = dbBE_Transport_sr_buffer_unprocessed( sr_buf );
 
+  // nothing to parse if only the type has arrived
+  if( available < 2 )
+    return -EAGAIN;
+
   char type;
 
   // the current type of response from Redis
@@ -408,7 +418,7 @@ int dbBE_Redis_parse_sr_buffer_check( dbBE_Redis_sr_buffer_t *sr_buf,
             break;
           case -EOVERFLOW:
             // prevent partial strings in arrays
-            if( toplevel == 0 )
+            if( partial == 0 )
             {
               rc = -EAGAIN;
               break;
@@ -432,7 +442,6 @@ int dbBE_Redis_parse_sr_buffer_check( dbBE_Redis_sr_buffer_t *sr_buf,
 
     case '*': // parse an array by just skipping the array size and repeat the first
     {
-      int n;
       int64_t tmp_len = dbBE_Redis_extract_integer( p, &parsed, available );
       result->_data._array._len = (int)tmp_len;
       if(( result->_data._array._len == -EAGAIN ) && ( parsed == 0 ))
@@ -447,24 +456,18 @@ int dbBE_Redis_parse_sr_buffer_check( dbBE_Redis_sr_buffer_t *sr_buf,
         result->_data._integer = -EPROTO;
         break;
       }
-      result->_data._array._data = (dbBE_Redis_result_t*)malloc( sizeof (dbBE_Redis_result_t ) * result->_data._array._len );
-      memset( result->_data._array._data, 0, sizeof (dbBE_Redis_result_t ) * result->_data._array._len );
-
-      dbBE_Transport_sr_buffer_advance( sr_buf, parsed );
 
-      rc = 0;
-      for( n = 0; (n < result->_data._array._len) && ( rc == 0 ); ++n )
-        rc = dbBE_Redis_parse_sr_buffer_check( sr_buf, &result->_data._array._data[ n ], 0 );
-      if(( rc == -EAGAIN ) || ( rc == -ENODATA ))
+      // null array (e.g. timed out BLPOP): report the same way as a nil bulk string
+      if( tmp_len == -1 )
       {
-        result->_type = dbBE_REDIS_TYPE_ARRAY;
-        dbBE_Redis_result_cleanup( result, 0 );
-        parsed = 0;
-        rc = -EAGAIN;
+        result->_type = dbBE_REDIS_TYPE_CHAR;
+        result->_data._string._data = NULL;
+        result->_data._string._size = 0;
         break;
       }
+      result->_data._array._data = (dbBE_Redis_result_t*)malloc( sizeof (dbBE_Redis_result_t ) * result->_data._array._len );
+      memset( result->_data._array._data, 0, sizeof (dbBE_Redis_result_t ) * result->_data._array._len );
       result->_type = dbBE_REDIS_TYPE_ARRAY;
-      parsed = 0;
       break;
     }
     default:
@@ -477,12 +480,113 @@ int dbBE_Redis_parse_sr_buffer_check( dbBE_Redis_sr_buffer_t *sr_buf,
   if( rc == -EAGAIN )
     dbBE_Transport_sr_buffer_rewind_processed_to( sr_buf, start_parse );
   else
-  {
     dbBE_Transport_sr_buffer_advance( sr_buf, parsed );
-    // terminate any strings in the result structure, ONLY if this is the top-level call
-    if( toplevel != 0 )
-      rc = dbBE_Redis_result_terminate_strings( result );
+  return rc;
+}
+
+/*
+ * continue parsing a response where the last call stopped
+ * completed entries of (nested) arrays remain in the result and are not parsed again
+ */
+int dbBE_Redis_parse_sr_buffer_resume( dbBE_Redis_sr_buffer_t *sr_buf,
+                                       dbBE_Redis_result_t *result,
+                                       dbBE_Redis_parse_state_t *state )
+{
+  if(( sr_buf == NULL ) || ( result == NULL ) || ( state == NULL ))
+  {
+    if( result != NULL )
+    {
+      result->_data._integer = -EINVAL;
+      result->_type = dbBE_REDIS_TYPE_INVALID;
+    }
+    return -EINVAL;
+  }
+
+  int rc = 0;
+  dbBE_Redis_parse_frame_t *frame = NULL;
+  dbBE_Redis_result_t *element = result;
+  if( state->_depth > 0 )
+  {
+    frame = &state->_stack[ state->_depth - 1 ];
+    element = &frame->_array->_data._array._data[ frame->_next ];
+  }
+
+  while( element != NULL )
+  {
+    // partial strings: only the top-level string or the last entry of a top-level array
+    int partial = 0;
+    if( state->_depth == 0 )
+      partial = state->_flags & DBBE_REDIS_PARSE_PARTIAL;
+    else if(( state->_depth == 1 ) && ( state->_flags & DBBE_REDIS_PARSE_PARTIAL_TAIL ))
+      partial = ( state->_stack[ 0 ]._next == state->_stack[ 0 ]._array->_data._array._len - 1 );
+
+    rc = dbBE_Redis_parse_element( sr_buf, element, partial );
+    if(( rc == -EAGAIN ) || ( rc == -ENODATA ))
+    {
+      if( state->_depth == 0 )
+        return rc;
+      // keep the state and the completed entries for the next attempt
+      memset( element, 0, sizeof( dbBE_Redis_result_t ) );
+      return -EAGAIN;
+    }
+    if( rc != 0 )
+      break;
+
+    // descend into non-empty arrays
+    if(( element->_type == dbBE_REDIS_TYPE_ARRAY ) && ( element->_data._array._len > 0 ))
+    {
+      if( state->_depth >= DBBE_REDIS_PARSE_MAX_DEPTH )
+      {
+        LOG( DBG_ERR, stderr, "Error: Redis protocol parsing error. Arrays nested deeper than %d\n", DBBE_REDIS_PARSE_MAX_DEPTH );
+        dbBE_Redis_result_cleanup( element, 0 );
+        element->_type = dbBE_REDIS_TYPE_INVALID;
+        break;
+      }
+      frame = &state->_stack[ state->_depth++ ];
+      frame->_array = element;
+      frame->_next = 0;
+      element = &element->_data._array._data[ 0 ];
+      continue;
+    }
+
+    // entry complete: continue with the next entry of the innermost unfinished array
+    element = NULL;
+    while(( element == NULL ) && ( state->_depth > 0 ))
+    {
+      frame = &state->_stack[ state->_depth - 1 ];
+      if( ++frame->_next < frame->_array->_data._array._len )
+        element = &frame->_array->_data._array._data[ frame->_next ];
+      else
+        --state->_depth;
+    }
+  }
+
+  // response is complete (or broken); the next call starts with a new response
+  state->_depth = 0;
+
+  // terminate any strings in the result structure
+  return dbBE_Redis_result_terminate_strings( result );
+}
+
+/*
+ * parse a complete response or nothing at all
+ * an incomplete response is dropped and the buffer rewound
+ */
+static
+int dbBE_Redis_parse_sr_buffer_complete( dbBE_Redis_sr_buffer_t *sr_buf,
+                                         dbBE_Redis_result_t *result,
+                                         const int flags )
+{
+  dbBE_Redis_parse_state_t state;
+  dbBE_Redis_parse_state_init( &state, flags );
 
+  char *start_parse = ( sr_buf != NULL ) ? dbBE_Transport_sr_buffer_get_processed_position( sr_buf ) : NULL;
+  int rc = dbBE_Redis_parse_sr_buffer_resume( sr_buf, result, &state );
+  if( rc == -EAGAIN )
+  {
+    if( state._depth > 0 )
+      dbBE_Redis_result_cleanup( result, 0 );
+    dbBE_Transport_sr_buffer_rewind_processed_to( sr_buf, start_parse );
   }
   return rc;
 }
@@ -494,11 +598,17 @@ int dbBE_Redis_parse_sr_buffer_check( dbBE_Redis_sr_buffer_t *sr_buf,
 int dbBE_Redis_parse_sr_buffer( dbBE_Redis_sr_buffer_t *sr_buf,
                                 dbBE_Redis_result_t *result )
 {
-  return dbBE_Redis_parse_sr_buffer_check( sr_buf, result, 1 );
+  return dbBE_Redis_parse_sr_buffer_complete( sr_buf, result, DBBE_REDIS_PARSE_PARTIAL );
 }
 
-
-
+/*
+ * parse the input buffer and allow a partial string as the last element of a top-level array
+ */
+int dbBE_Redis_parse_sr_buffer_partial_tail( dbBE_Redis_sr_buffer_t *sr_buf,
+                                             dbBE_Redis_result_t *result )
+{
+  return dbBE_Redis_parse_sr_buffer_complete( sr_buf, result, DBBE_REDIS_PARSE_PARTIAL | DBBE_REDIS_PARSE_PARTIAL_TAIL );
+}
 
 int dbBE_Redis_process_put( dbBE_Redis_request_t *request,
                             dbBE_Redis_result_t *result )
@@ -639,6 +749,26 @@ dbBE_Transport_sge_buffer_t* dbBE_Redis_parse_copy_assemble_sge( dbBE_Request_t
   return sge_buf;
 }
 
+/*
+ * a successful BLPOP returns [key, value]
+ * replace the array by its value to continue like any LPOP response
+ */
+static inline
+int dbBE_Redis_process_get_unwrap( dbBE_Redis_result_t *result )
+{
+  if( result->_type != dbBE_REDIS_TYPE_ARRAY )
+    return 0;
+
+  if(( result->_data._array._len != 2 ) || ( result->_data._array._data == NULL ))
+    return -EPROTO;
+
+  dbBE_Redis_result_t *elements = result->_data._array._data;
+  dbBE_Redis_result_cleanup( &elements[ 0 ], 0 );
+  memcpy( result, &elements[ 1 ], sizeof( dbBE_Redis_result_t ) );
+  free( elements );
+  return 0;
+}
+
 int dbBE_Redis_process_get( dbBE_Redis_request_t *request,
                             dbBE_Redis_result_t *result,
                             dbBE_Data_transport_t *transport,
@@ -646,6 +776,13 @@ int dbBE_Redis_process_get( dbBE_Redis_request_t *request,
 {
   int rc = 0;
 
+  if(( request != NULL ) && ( request->_step != NULL ) && ( request->_step->_blocking != 0 ))
+  {
+    rc = dbBE_Redis_process_get_unwrap( result );
+    if( rc != 0 )
+      return return_error_clean_result( rc, result );
+  }
+
   rc = dbBE_Redis_process_general( request, result );
 
   if( rc == 0 )
@@ -663,8 +800,12 @@ int dbBE_Redis_process_get( dbBE_Redis_request_t *request,
         result->_data._integer = 0;
         if( request->_user->_flags & DBBE_OPCODE_FLAGS_IMMEDIATE )
           return -ENOENT;
-        else
-          return -EAGAIN;
+
+        // instead of polling with LPOP, park the request on the server with BLPOP
+        // (a timed out BLPOP gets re-queued as is; the retry checks for cancellation)
+        if( request->_user->_opcode == DBBE_OPCODE_GET )
+          dbBE_Redis_request_stage_set( request, DBBE_REDIS_GET_STAGE_BLOCK );
+        return -EAGAIN;
       }
 
       int64_t transferred = 0;
@@ -803,6 +944,57 @@ int dbBE_Redis_process_remove( dbBE_Redis_request_t *request,
   return rc;
 }
 
+int dbBE_Redis_process_stat( dbBE_Redis_request_t *request,
+                             dbBE_Redis_result_t *result,
+                             dbBE_Data_transport_t *transport )
+{
+  int rc = dbBE_Redis_process_general( request, result );
+  if( rc != 0 )
+    return return_error_clean_result( rc, result );
+
+  int64_t stat[ 2 ] = { 0, 0 }; // number of values, size of the first value
+  switch( request->_step->_stage )
+  {
+    case DBBE_REDIS_STAT_STAGE_COUNT:
+      stat[ 0 ] = result->_data._integer;
+      break;
+
+    case DBBE_REDIS_STAT_STAGE_SIZE:
+      if(( result->_data._array._len != 2 ) ||
+          ( result->_data._array._data[ 0 ]._type != dbBE_REDIS_TYPE_INT ) ||
+          ( result->_data._array._data[ 1 ]._type != dbBE_REDIS_TYPE_INT ))
+        return return_error_clean_result( -EBADMSG, result );
+      stat[ 0 ] = result->_data._array._data[ 0 ]._data._integer;
+      stat[ 1 ] = result->_data._array._data[ 1 ]._data._integer;
+      break;
+
+    default:
+      return return_error_clean_result( -EPROTO, result );
+  }
+
+  if( stat[ 0 ] <= 0 )
+    return return_error_clean_result( -ENOENT, result );
+
+  // the user SGE might only have space for the count
+  size_t user_len = dbBE_SGE_get_len( request->_user->_sge, request->_user->_sge_count );
+  dbBE_sge_t pstat;
+  pstat.iov_base = stat;
+  pstat.iov_len = user_len < sizeof( stat ) ? user_len : sizeof( stat );
+  int64_t transferred = transport->scatter( (dbBE_Data_transport_endpoint_t*)NULL,
+                                            NULL,
+                                            &pstat,
+                                            pstat.iov_len,
+                                            request->_user->_sge_count,
+                                            request->_user->_sge );
+  if( transferred != (int64_t)pstat.iov_len )
+    return return_error_clean_result( -EBADMSG, result );
+
+  dbBE_Redis_result_cleanup( result, 0 );
+  result->_type = dbBE_REDIS_TYPE_INT;
+  result->_data._integer = stat[ 0 ];
+  return 0;
+}
+
 int dbBE_Redis_process_move( dbBE_Redis_request_t *request,
                              dbBE_Redis_result_t *result,
                              dbBE_Redis_connection_t *conn )
@@ -1084,7 +1276,7 @@ int dbBE_Redis_process_directory( dbBE_Redis_request_t **in_out_request,
   return rc;
 }
 
-int dbBE_Redis_process_nshandling( dbBE_Redis_namespace_list_t **s,
+int dbBE_Redis_process_nshandling( dbBE_Redis_namespace_list_t *s,
                                    dbBE_Redis_request_t *request,
                                    dbBE_Redis_result_t *result,
                                    int rc )
@@ -1099,17 +1291,19 @@ int dbBE_Redis_process_nshandling( dbBE_Redis_namespace_list_t **s,
     {
       ns = dbBE_Redis_namespace_create( request->_user->_key );
       if( ns == NULL )
+      {
         rc = return_error_clean_result( -errno, result );
+        break;
+      }
 
-      dbBE_Redis_namespace_list_t *tmp = dbBE_Redis_namespace_list_insert( *s, ns );
-      if( tmp == NULL )
+      int ins = dbBE_Redis_namespace_list_insert( s, ns );
+      if( ins != 0 )
       {
-        rc = return_error_clean_result( -errno, result );
+        rc = return_error_clean_result( ins, result );
         dbBE_Redis_namespace_destroy( ns ); // clean up
       }
       else
       {
-        *s = tmp;
         dbBE_Redis_result_cleanup( result, 0 );
         result->_type = dbBE_REDIS_TYPE_INT;
         result->_data._integer = (int64_t)ns;
@@ -1118,29 +1312,25 @@ int dbBE_Redis_process_nshandling( dbBE_Redis_namespace_list_t **s,
     }
     case DBBE_OPCODE_NSATTACH:
     {
-      dbBE_Redis_namespace_list_t *tmp = dbBE_Redis_namespace_list_get( *s, request->_user->_key );
-      if( tmp == NULL )
+      ns = dbBE_Redis_namespace_list_get( s, request->_user->_key );
+      if( ns == NULL )
       {
         ns = dbBE_Redis_namespace_create( request->_user->_key );
-        tmp = dbBE_Redis_namespace_list_insert( *s, ns );
-        if( tmp == NULL )
+        if( ns == NULL )
+        {
+          rc = return_error_clean_result( -errno, result );
+          break;
+        }
+        int ins = dbBE_Redis_namespace_list_insert( s, ns );
+        if( ins != 0 )
         {
-          int tmperr = -errno;
           dbBE_Redis_namespace_destroy( ns );
-          rc = return_error_clean_result( tmperr, result );
+          rc = return_error_clean_result( ins, result );
           break;
         }
-        *s = tmp;
       }
       else // in case it was already there:
       {
-        ns = tmp->_ns;
-        if( ns == NULL )
-        {
-          LOG( DBG_ERR, stderr, "Fatal: found namespace with NULL entry when looking for %s.\n", request->_user->_key );
-          rc = return_error_clean_result( -EINVAL, result );
-          break;
-        }
         uint32_t refcnt = dbBE_Redis_namespace_get_refcnt( ns );
         if( dbBE_Redis_namespace_attach( ns ) != (int)refcnt + 1 )
         {
@@ -1149,7 +1339,6 @@ int dbBE_Redis_process_nshandling( dbBE_Redis_namespace_list_t **s,
           break;
         }
         rc = 0;
-        *s = tmp;
       }
       dbBE_Redis_result_cleanup( result, 0 );
       result->_type = dbBE_REDIS_TYPE_INT;
@@ -50,6 +50,12 @@ int64_t dbBE_Redis_nul_terminate_string( char *p, size_t *parsed, const int64_t
  */
 int64_t dbBE_Redis_extract_integer( char *p, size_t *parsed, const int64_t limit );
 
+/*
+ * find the first "\r\n" within limit bytes of haystack; the data may contain zeroes
+ * returns a pointer to the '\r' or NULL
+ */
+char* dbBE_Redis_find_terminator( char *haystack, const int64_t limit );
+
 /*
  * extract a redis bulk string from p (buffer is modified!)
  * returns the string length and points *p to the beginning of the string
@@ -62,6 +68,47 @@ int64_t dbBE_Redis_extract_integer( char *p, size_t *parsed, const int64_t limit
  */
 int64_t dbBE_Redis_extract_bulk_string( char **p, size_t *parsed, const int64_t limit, size_t *actual_size );
 
+/*
+ * parser flags: a top-level bulk string may be returned as partial string;
+ * same for the last element of a top-level array (e.g. the value of a BLPOP response)
+ */
+#define DBBE_REDIS_PARSE_PARTIAL ( 0x1 )
+#define DBBE_REDIS_PARSE_PARTIAL_TAIL ( 0x2 )
+
+/*
+ * max nesting of arrays in a response
+ */
+#define DBBE_REDIS_PARSE_MAX_DEPTH ( 8 )
+
+/*
+ * an array of an incomplete response and its next entry to parse
+ */
+typedef struct
+{
+  dbBE_Redis_result_t *_array;
+  int _next;
+} dbBE_Redis_parse_frame_t;
+
+/*
+ * parser state of an incomplete response to continue after more data got received
+ */
+typedef struct
+{
+  int _flags;
+  int _depth;
+  dbBE_Redis_parse_frame_t _stack[ DBBE_REDIS_PARSE_MAX_DEPTH ];
+} dbBE_Redis_parse_state_t;
+
+/*
+ * prepare the parser state for a new response
+ */
+static inline
+void dbBE_Redis_parse_state_init( dbBE_Redis_parse_state_t *state, const int flags )
+{
+  state->_flags = flags;
+  state->_depth = 0;
+}
+
 /*
  * parse the input buffer
  * return the Redis result including its type and its size
@@ -69,6 +116,23 @@ int64_t dbBE_Redis_extract_bulk_string( char **p, size_t *parsed, const int64_t
 int dbBE_Redis_parse_sr_buffer( dbBE_Redis_sr_buffer_t *sr_buf,
                                 dbBE_Redis_result_t *result );
 
+/*
+ * parse the input buffer and keep the progress of an incomplete response in state
+ * returns -EAGAIN if the response is incomplete; the result then holds the completed part
+ * and the buffer position is at the first incomplete element
+ * call again with the same result and state after receiving more data
+ */
+int dbBE_Redis_parse_sr_buffer_resume( dbBE_Redis_sr_buffer_t *sr_buf,
+                                       dbBE_Redis_result_t *result,
+                                       dbBE_Redis_parse_state_t *state );
+
+/*
+ * parse the input buffer like above but allow the last element of
+ * a top-level array to be a partial string (e.g. the value of a BLPOP response)
+ */
+int dbBE_Redis_parse_sr_buffer_partial_tail( dbBE_Redis_sr_buffer_t *sr_buf,
+                                             dbBE_Redis_result_t *result );
+
 /*
  * process the response based on the request
  */
@@ -107,6 +171,14 @@ int dbBE_Redis_process_move( dbBE_Redis_request_t *request,
 int dbBE_Redis_process_remove( dbBE_Redis_request_t *request,
                                dbBE_Redis_result_t *result );
 
+/*
+ * process the response data of a tuple stat request
+ * count and size are scattered into the user SGE
+ */
+int dbBE_Redis_process_stat( dbBE_Redis_request_t *request,
+                             dbBE_Redis_result_t *result,
+                             dbBE_Data_transport_t *transport );
+
 /*
  * process the response data of a directory request
  */
@@ -120,7 +192,7 @@ int dbBE_Redis_process_directory( dbBE_Redis_request_t **in_out_request,
 /*
  * post-process namespace create/attach to handle locally tracked namespace handles/structures
  */
-int dbBE_Redis_process_nshandling( dbBE_Redis_namespace_list_t **s,
+int dbBE_Redis_process_nshandling( dbBE_Redis_namespace_list_t *s,
                                    dbBE_Redis_request_t *request,
                                    dbBE_Redis_result_t *result,
                                    int rc );
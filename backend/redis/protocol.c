@@ -22,6 +22,8 @@
 #include <malloc.h>
 #endif
 #include <string.h>
+#include <stdio.h>
+#include <errno.h>
 
 #include "protocol.h"
 
@@ -88,6 +90,25 @@ dbBE_Redis_command_stage_spec_t* dbBE_Redis_command_stages_spec_init()
   strcpy( s->_command, "*2\r\n$4\r\nLPOP\r\n%0" );
   s->_stage = stage;
 
+  /*
+   * - BLPOP ns_name::t_name <timeout>
+   * -   (only if LPOP came back empty: parks the request on the server
+   * -    instead of polling; re-queued after each DBBE_REDIS_BLOCKING_SLICE)
+   */
+  stage = DBBE_REDIS_GET_STAGE_BLOCK;
+  index = op * DBBE_REDIS_COMMAND_STAGE_MAX + stage;
+  s = &specs[ index ];
+  s->_array_len = 1;
+  s->_resp_cnt = 1;
+  s->_final = 1;
+  s->_result = 1;
+  s->_blocking = 1;
+  s->_expect = dbBE_REDIS_TYPE_CHAR; // returns [key, value]; unwrapped to the value before processing
+  char to_buf[ 16 ];
+  int to_len = snprintf( to_buf, sizeof( to_buf ), "%d", DBBE_REDIS_BLOCKING_SLICE );
+  snprintf( s->_command, DBBE_REDIS_COMMAND_LENGTH_MAX, "*3\r\n$5\r\nBLPOP\r\n%%0$%d\r\n%s\r\n", to_len, to_buf );
+  s->_stage = stage;
+
   /*
    * read
    * - LINDEX ns_name::t_name <index>
@@ -377,11 +398,94 @@ dbBE_Redis_command_stage_spec_t* dbBE_Redis_command_stages_spec_init()
   strcpy( s->_command, "*6\r\n$4\r\nSCAN\r\n%0$5\r\nMATCH\r\n%1$5\r\nCOUNT\r\n$2\r\n10\r\n" );
   s->_stage = stage;
 
+  /*
+   * STAT command
+   * - EVAL <script> 1 ns_name::t_name
+   * -   (returns the number of values and the length of the first value; only metadata is transferred)
+   * - LLEN ns_name::t_name
+   * -   (if the request only asks for the number of values)
+   */
+  op = DBBE_OPCODE_STAT;
+  stage = DBBE_REDIS_STAT_STAGE_SIZE;
+  index = op * DBBE_REDIS_COMMAND_STAGE_MAX + stage;
+  s = &specs[ index ];
+  s->_array_len = 1;
+  s->_resp_cnt = 1;
+  s->_final = 1;
+  s->_result = 1;
+  s->_expect = dbBE_REDIS_TYPE_ARRAY; // will return [ count, size ]
+  const char *stat_script = "local n=redis.call('LLEN',KEYS[1]) if n==0 then return {0,0} end "
+                            "return {n,string.len(redis.call('LINDEX',KEYS[1],0))}";
+  snprintf( s->_command, DBBE_REDIS_COMMAND_LENGTH_MAX, "*4\r\n$4\r\nEVAL\r\n$%d\r\n%s\r\n$1\r\n1\r\n%%0",
+            (int)strlen( stat_script ), stat_script );
+  s->_stage = stage;
+
+  stage = DBBE_REDIS_STAT_STAGE_COUNT;
+  index = op * DBBE_REDIS_COMMAND_STAGE_MAX + stage;
+  s = &specs[ index ];
+  s->_array_len = 1;
+  s->_resp_cnt = 1;
+  s->_final = 1;
+  s->_result = 1;
+  s->_expect = dbBE_REDIS_TYPE_INT; // will return number of values (0 if it doesn't exist)
+  strcpy( s->_command, "*2\r\n$4\r\nLLEN\r\n%0" );
+  s->_stage = stage;
+
+  for( index = 0; index < total_stages; ++index )
+    if( dbBE_Redis_command_stage_compile( &specs[ index ] ) != 0 )
+    {
+      free( specs );
+      return NULL;
+    }
+
   gRedis_command_spec = specs;
 
   return specs;
 }
 
+int dbBE_Redis_command_stage_compile( dbBE_Redis_command_stage_spec_t *stage )
+{
+  if( stage == NULL )
+    return -EINVAL;
+
+  const char *cmd = stage->_command;
+  const char *pos = cmd;
+  int n = 0;
+
+  stage->_segment_count = 0;
+  while( *pos != '\0' )
+  {
+    const char *loc = strchr( pos, '%' );
+    const char *end = ( loc != NULL ) ? loc : pos + strlen( pos );
+
+    // literal part of the command string up to the next argument
+    if( end > pos )
+    {
+      if( n >= DBBE_REDIS_COMMAND_SEGMENTS_MAX )
+        return -E2BIG;
+      stage->_segments[ n ]._arg = DBBE_REDIS_COMMAND_SEGMENT_LITERAL;
+      stage->_segments[ n ]._offset = (uint16_t)( pos - cmd );
+      stage->_segments[ n ]._len = (uint16_t)( end - pos );
+      ++n;
+    }
+    if( loc == NULL )
+      break;
+
+    int idx = (int)loc[1] - '0';
+    if(( idx < 0 ) || ( idx >= stage->_array_len ))
+      return -EBADMSG;
+    if( n >= DBBE_REDIS_COMMAND_SEGMENTS_MAX )
+      return -E2BIG;
+    stage->_segments[ n ]._arg = (int16_t)idx;
+    stage->_segments[ n ]._offset = 0;
+    stage->_segments[ n ]._len = 0;
+    ++n;
+    pos = loc + 2;
+  }
+  stage->_segment_count = (uint8_t)n;
+  return 0;
+}
+
 void dbBE_Redis_command_stages_spec_destroy( dbBE_Redis_command_stage_spec_t *specs )
 {
   --gRedis_command_spec_refcnt;
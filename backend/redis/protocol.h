@@ -38,6 +38,26 @@
  */
 #define DBBE_REDIS_COMMAND_ARGS_MAX ( 6 )
 
+/*
+ * max number of segments (literals and positional args) of a compiled command
+ */
+#define DBBE_REDIS_COMMAND_SEGMENTS_MAX ( 16 )
+
+/*
+ * segment argument index of a literal segment
+ */
+#define DBBE_REDIS_COMMAND_SEGMENT_LITERAL ( -1 )
+
+
+/*
+ * enumeration of the get stages
+ * the blocking stage is only used after the pop found no data
+ */
+typedef enum
+{
+  DBBE_REDIS_GET_STAGE_POP = 0,
+  DBBE_REDIS_GET_STAGE_BLOCK = 1
+} dbBE_Redis_get_stages_t;
 
 /*
  * enumeration of the directory scan stages
@@ -79,6 +99,27 @@ typedef enum
   DBBE_REDIS_MOVE_STAGE_DEL = 2
 } dbBE_Redis_move_stages_t;
 
+/*
+ * enumeration of the tuple stat stages
+ * the count stage is used if the request has no space for the value size
+ */
+typedef enum
+{
+  DBBE_REDIS_STAT_STAGE_SIZE = 0,
+  DBBE_REDIS_STAT_STAGE_COUNT = 1
+} dbBE_Redis_stat_stages_t;
+
+/*
+ * a segment of a compiled command string
+ * either a literal part of the command string or a positional argument (%0..%9)
+ */
+typedef struct
+{
+  int16_t _arg; // positional arg index or DBBE_REDIS_COMMAND_SEGMENT_LITERAL
+  uint16_t _offset; // start of a literal in the command string
+  uint16_t _len; // length of a literal
+} dbBE_Redis_command_segment_t;
+
 /*
  * holds the generic spec of a command stage
  * - stage number
@@ -92,8 +133,11 @@ typedef struct dbBE_Redis_command_stage_spec
   uint8_t _resp_cnt; // number of responses expected (see MULTI cmds)
   uint8_t _final; // is it the last stage of this command?
   uint8_t _result; // is it the result-stage of this command?
+  uint8_t _blocking; // does this stage block on the server (requires a dedicated connection)?
   dbBE_REDIS_DATA_TYPE _expect; // what result type to expect for this stage
   char _command[ DBBE_REDIS_COMMAND_LENGTH_MAX ]; // Redis command string
+  uint8_t _segment_count; // number of segments of the compiled command string
+  dbBE_Redis_command_segment_t _segments[ DBBE_REDIS_COMMAND_SEGMENTS_MAX ]; // compiled command string
 } dbBE_Redis_command_stage_spec_t;
 
 extern dbBE_Redis_command_stage_spec_t *gRedis_command_spec;
@@ -104,6 +148,12 @@ extern dbBE_Redis_command_stage_spec_t *gRedis_command_spec;
  */
 dbBE_Redis_command_stage_spec_t* dbBE_Redis_command_stages_spec_init();
 
+/*
+ * split the command string of a stage into literal and argument segments
+ * so that command creation doesn't have to parse the string for every request
+ */
+int dbBE_Redis_command_stage_compile( dbBE_Redis_command_stage_spec_t *stage );
+
 /*
  * destroy the stage specs (if refcount is 0)
  */
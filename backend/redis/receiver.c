@@ -21,6 +21,7 @@
 #include "request.h"
 #include "parse.h"
 #include "complete.h"
+#include "worker.h"
 
 #ifdef __APPLE__
 #include <stdlib.h>
@@ -31,53 +32,84 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h> // unlink
 
 /*
  * receiver thread function, retrieves and parses Redis responses
  */
 
-typedef struct dbBE_Redis_receiver_args
-{
-  dbBE_Redis_context_t *_backend;
-  int _looping;
-} dbBE_Redis_receiver_args_t;
+typedef dbBE_Redis_io_args_t dbBE_Redis_receiver_args_t;
 
 
-void* dbBE_Redis_receiver( void *args )
+/*
+ * the value of a blocking pop arrives inside an array
+ * allow it to be streamed just like a partial string of a plain pop
+ * memcpy transport is not ready for partial string result handling
+ */
+static inline
+int dbBE_Redis_receiver_parse_flags( dbBE_Redis_context_t *backend,
+                                     dbBE_Redis_request_t *request )
 {
-  int rc = 0;
-  dbBE_Redis_receiver_args_t *input = (dbBE_Redis_receiver_args_t*)args;
-  if( args == NULL )
-  {
-    errno = EINVAL;
-    return NULL;
-  }
-
-  /*
-   * Input:
-   *  - completion queue(s)
-   *  - request queue filled by sender thread
-   *  - redirection/retry queue for sender
-   *  - list/map of receive buffers + Redis server instance references
-   *
-   */
+  if( backend->_transport == &dbBE_Memcopy_transport )
+    return 0;
+  if( request->_step->_blocking != 0 )
+    return DBBE_REDIS_PARSE_PARTIAL | DBBE_REDIS_PARSE_PARTIAL_TAIL;
+  return DBBE_REDIS_PARSE_PARTIAL;
+}
 
-  // check for any activity:
-  //  - on the receive buffers/Redis sockets
-  //  - on a notification/wake-up pipe for cancellations/urgent matters
+/*
+ * pull in more of a multi-response stage whose first response(s) arrived without the rest
+ * waits for the socket, but at most DBBE_REDIS_RESPONSE_TIMEOUT, since the caller holds up others meanwhile
+ * returns the received size or a negative error (-ETIMEDOUT if nothing arrived in time)
+ */
+static
+ssize_t dbBE_Redis_receiver_recv_remaining( dbBE_Redis_connection_t *conn,
+                                            dbBE_Redis_sr_buffer_t *sr_buf )
+{
+  struct timespec now, deadline;
+  clock_gettime( CLOCK_MONOTONIC, &deadline );
+  deadline.tv_sec += DBBE_REDIS_RESPONSE_TIMEOUT;
 
-  int receive_limit = 128 * 1024 * 1024;
-  dbBE_Redis_connection_t *conn = NULL;
+  ssize_t rc = 0;
+  while( dbBE_Transport_sr_buffer_empty( sr_buf ) )
+  {
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    int64_t remaining_ms = ( deadline.tv_sec - now.tv_sec ) * 1000 + ( deadline.tv_nsec - now.tv_nsec ) / 1000000;
+    struct pollfd pfd = { .fd = conn->_socket, .events = POLLIN, .revents = 0 };
+    int prc = poll( &pfd, 1, ( remaining_ms > 0 ) ? (int)remaining_ms : 0 );
+    if(( prc < 0 ) && ( errno != EINTR ))
+      return -errno;
+    if( prc > 0 )
+    {
+      rc = dbBE_Redis_connection_recv_more( conn, sr_buf );
+      if(( rc < 0 ) && ( rc != -EAGAIN ) && ( rc != -EWOULDBLOCK ))
+        return rc;
+    }
+    else if(( prc == 0 ) && ( remaining_ms <= 0 ))
+      return -ETIMEDOUT;
+  }
+  return rc;
+}
 
-receive_more_responses:
+/*
+ * receive once from an active connection and process all complete responses
+ * returns 1 if the connection might have more data, 0 if it's drained, -1 if it was failed or removed
+ */
+static
+int dbBE_Redis_receiver_process( dbBE_Redis_receiver_args_t *input,
+                                 dbBE_Redis_connection_t *conn )
+{
+  int rc = 0;
+  int ret = 0;
 
-  conn = dbBE_Redis_connection_mgr_get_active( input->_backend->_conn_mgr, 0 );
-  if( conn == NULL )
-    goto skip_receiving;
+  // with workers, only the processing of responses needs the backend lock
+  // receiving and parsing is done by the owner of the connection without it
+  int locked = 0;
 
   dbBE_Redis_sr_buffer_t *sr_buf = dbBE_Transport_dbuffer_get_active( conn->_recvbuf );
 
-  receive_limit = dbBE_Transport_sr_buffer_get_size( sr_buf );
   rc = dbBE_Redis_connection_recv( conn, sr_buf );
   if( rc <= 0 )
   {
@@ -93,6 +125,8 @@ receive_more_responses:
         // intentionally no break
       default:
         LOG( DBG_ERR, stderr, "Recv from conn %d returned %d\n", conn->_index, rc );
+        dbBE_Redis_context_lock( input->_backend );
+        locked = 1;
 
         // drain the posted queue of this connection and place the requests for retry
         dbBE_Redis_request_t *request;
@@ -107,6 +141,7 @@ receive_more_responses:
 
         // remove the connection from the connection mgr
         dbBE_Redis_connection_mgr_conn_fail( input->_backend->_conn_mgr, conn );
+        ret = -1;
 
         // todo: cancel all remaining requests for cleanup
 
@@ -120,10 +155,11 @@ receive_more_responses:
   dbBE_Redis_request_t *request = NULL;
   dbBE_Redis_result_t result;
   memset( &result, 0, sizeof( dbBE_Redis_result_t ) );
+  dbBE_Redis_parse_state_t parse_state;
+  int asking_rejected = 0;
 
   // assume this is a new request
   int responses_remain = 0;
-  receive_limit -= rc;
 
 process_next_item:
 
@@ -147,6 +183,7 @@ process_next_item:
   else
     --responses_remain;
 
+parse_response:
   // parse buffer for next complete response including nested arrays
   dbBE_Redis_result_cleanup( &result, 0 );
 
@@ -158,16 +195,10 @@ process_next_item:
 
 
 
+  // an incomplete response keeps its parsed part; parsing continues after the next recv
+  dbBE_Redis_parse_state_init( &parse_state, dbBE_Redis_receiver_parse_flags( input->_backend, request ) );
   sr_buf = dbBE_Transport_dbuffer_get_active( conn->_recvbuf );
-  rc = dbBE_Redis_parse_sr_buffer( sr_buf, &result );
-
-  // memcpy transport is not ready for partial string result handling
-  if(( result._type == dbBE_REDIS_TYPE_STRING_PART ) && ( input->_backend->_transport == &dbBE_Memcopy_transport ))
-  {
-    // restore parsing position for the next loop
-    dbBE_Transport_sr_buffer_rewind_processed_to( sr_buf, dbBE_Transport_sr_buffer_get_start( sr_buf ) );
-    rc = -EAGAIN;
-  }
+  rc = dbBE_Redis_parse_sr_buffer_resume( sr_buf, &result, &parse_state );
 
   while( rc == -EAGAIN )
   {
@@ -177,14 +208,38 @@ process_next_item:
     {
       rc = -EAGAIN;
     }
-    rc = dbBE_Redis_parse_sr_buffer( sr_buf, &result );
+    rc = dbBE_Redis_parse_sr_buffer_resume( sr_buf, &result, &parse_state );
+  }
 
-    // memcpy transport is not ready for partial string result handling
-    if(( result._type == dbBE_REDIS_TYPE_STRING_PART ) && ( input->_backend->_transport == &dbBE_Memcopy_transport ))
+  // a request redirected by ASK was prefixed with ASKING; its reply precedes the actual response
+  if( request->_asking != 0 )
+  {
+    request->_asking = 0;
+    if( result._type == dbBE_REDIS_TYPE_ERROR )
     {
-      // restore parsing position for the next loop
-      dbBE_Transport_sr_buffer_rewind_processed_to( sr_buf, dbBE_Transport_sr_buffer_get_start( sr_buf ) );
-      rc = -EAGAIN;
+      LOG( DBG_ERR, stderr, "ASKING rejected on conn %d: %.*s\n", conn->_index,
+           (int)result._data._string._size, result._data._string._data );
+      asking_rejected = 1;
+    }
+    if( dbBE_Transport_sr_buffer_empty( sr_buf ) )
+      dbBE_Transport_sr_buffer_reset( sr_buf );
+    goto parse_response;
+  }
+
+  // the node didn't accept the ASK redirect; unless it redirects the request again,
+  // drop the remaining responses of the step and fail the request below
+  if( asking_rejected != 0 )
+  {
+    if(( asking_rejected == 1 ) &&
+        (( result._type == dbBE_REDIS_TYPE_REDIRECT ) || ( result._type == dbBE_REDIS_TYPE_RELOCATE )))
+      asking_rejected = 0;
+    else if( responses_remain > 0 )
+    {
+      asking_rejected = 2;
+      --responses_remain;
+      if( dbBE_Transport_sr_buffer_empty( sr_buf ) )
+        dbBE_Transport_sr_buffer_reset( sr_buf );
+      goto parse_response;
     }
   }
 
@@ -192,16 +247,70 @@ process_next_item:
   //  - it's completed and goes to the completion queue
   //  - it's a redirect and needs to be returned to sender
   //    - extract the destination node and queue
+  dbBE_Redis_context_lock( input->_backend );
+  locked = 1;
+  if( asking_rejected != 0 )
+  {
+    asking_rejected = 0;
+    dbBE_Redis_result_cleanup( &result, 0 );
+
+    // drop any completion from previous result stage(s)
+    dbBE_Completion_t *completion = request->_completion;
+    if( completion != NULL )
+    {
+      memset( completion, 0, sizeof( dbBE_Completion_t ) );
+      dbBE_Redis_completion_release( completion );
+    }
+    completion = dbBE_Redis_complete_error( request, DBR_ERR_BE_GENERAL, 0 );
+    dbBE_Redis_request_destroy( request );
+    request = NULL;
+    if(( completion != NULL ) && ( dbBE_Redis_completion_push( input->_backend, completion ) != 0 ))
+      dbBE_Redis_completion_release( completion );
+  }
   switch( result._type )
   {
     case dbBE_REDIS_TYPE_REDIRECT:
-      // retrieve/connect the destination connection and add the index
-      // to the request that's pushed to the sender-queue
+    {
+      // the slot is being migrated and the key already lives at the importing node
+      // send this one request there (prefixed with ASKING), the slot map stays as is
+      dbBE_Redis_connection_t *dest =
+          dbBE_Redis_connection_mgr_get_connection_to( input->_backend->_conn_mgr,
+                                                       result._data._location._address );
+      if( dest == NULL )
+      {
+        char address[ DBR_SERVER_URL_MAX_LENGTH ];
+        snprintf( address, DBR_SERVER_URL_MAX_LENGTH, "sock://%s", result._data._location._address );
+        dest = dbBE_Redis_connection_mgr_newlink( input->_backend->_conn_mgr, address );
+      }
+      if( dest == NULL )
+      {
+        LOG( DBG_ERR, stderr, "Unable to connect to ASK destination %s\n", result._data._location._address );
+        dbBE_Completion_t *completion = dbBE_Redis_complete_error( request, DBR_ERR_NOCONNECT, 0 );
+        dbBE_Redis_request_destroy( request );
+        if(( completion != NULL ) && ( dbBE_Redis_completion_push( input->_backend, completion ) != 0 ))
+          dbBE_Redis_completion_release( completion );
+        break;
+      }
 
+      request->_location._type = DBBE_REDIS_REQUEST_LOCATION_TYPE_CONNECTION;
+      request->_location._data._connection = dest;
+      request->_asking = 1;
+      dbBE_Redis_s2r_queue_push( input->_backend->_retry_q, request );
       break;
+    }
 
     case dbBE_REDIS_TYPE_RELOCATE:
     {
+      // the topology snapshot is outdated; the next process rediscovers and rewrites it
+      if(( input->_backend->_topology_cache != NULL ) && ( ! input->_backend->_topology_stale ))
+      {
+        input->_backend->_topology_stale = 1;
+        unlink( input->_backend->_topology_cache );
+      }
+
+      // slots rarely move alone; fetch the whole slot map once instead of collecting a MOVED per slot
+      dbBE_Redis_slotmap_refresh_start( input->_backend, result._data._location._address );
+
       // unset the connection slot in old place
       dbBE_Redis_slot_bitmap_t *slots = dbBE_Redis_connection_get_slot_range( conn );
       dbBE_Redis_slot_bitmap_unset( slots, result._data._location._hash );
@@ -248,6 +357,7 @@ process_next_item:
             // remove the connection from the connection mgr
             // todo: drain the response pipe to avoid stuck requests
             dbBE_Redis_connection_mgr_rm( input->_backend->_conn_mgr, conn );
+            ret = -1;
             goto skip_receiving;
           }
           case 1:
@@ -265,12 +375,16 @@ process_next_item:
                   DBR_ERR_NOCONNECT,
                   0 );
               dbBE_Redis_request_destroy( request );
+              request = NULL;
               if( completion == NULL )
               {
                 fprintf( stderr, "RedisBE: Failed to create error completion.\n");
                 dbBE_Redis_result_cleanup( &result, 0 );
                 goto skip_receiving;
               }
+              if( dbBE_Redis_completion_push( input->_backend, completion ) != 0 )
+                dbBE_Redis_completion_release( completion );
+              break;
             }
             // update the connection slot in new destination
             dbBE_Redis_slot_bitmap_t *slots = dbBE_Redis_connection_get_slot_range( dest );
@@ -285,6 +399,10 @@ process_next_item:
         }
       }
 
+      // the request already failed if the new master was unreachable
+      if( request == NULL )
+        break;
+
       // push request to sender queue as is
       request->_location._data._conn_idx = dbBE_Redis_connection_get_index( dest );
       dbBE_Redis_s2r_queue_push( input->_backend->_retry_q, request );
@@ -330,7 +448,7 @@ process_next_item:
             break;
           case DBBE_OPCODE_NSCREATE:
             rc = dbBE_Redis_process_nscreate( request, &result );
-            rc = dbBE_Redis_process_nshandling( &input->_backend->_namespaces, request, &result, rc );
+            rc = dbBE_Redis_process_nshandling( input->_backend->_namespaces, request, &result, rc );
             break;
 
           case DBBE_OPCODE_NSQUERY:
@@ -339,7 +457,7 @@ process_next_item:
 
           case DBBE_OPCODE_NSATTACH:
             rc = dbBE_Redis_process_nsattach( request, &result );
-            rc = dbBE_Redis_process_nshandling( &input->_backend->_namespaces, request, &result, rc );
+            rc = dbBE_Redis_process_nshandling( input->_backend->_namespaces, request, &result, rc );
             break;
 
           case DBBE_OPCODE_NSDETACH:
@@ -349,8 +467,7 @@ process_next_item:
                                               responses_remain );
             if(( rc == 0 ) && ( request != NULL ) && ( request->_step->_final != 0 ))
             {
-              dbBE_Redis_namespace_list_t *tmp = dbBE_Redis_namespace_list_remove( input->_backend->_namespaces, request->_user->_ns_hdl );
-              input->_backend->_namespaces = tmp;
+              dbBE_Redis_namespace_list_remove( input->_backend->_namespaces, (dbBE_Redis_namespace_t*)request->_user->_ns_hdl );
             }
             break;
 
@@ -359,6 +476,10 @@ process_next_item:
                                               &result );
             break;
 
+          case DBBE_OPCODE_STAT:
+            rc = dbBE_Redis_process_stat( request, &result, input->_backend->_transport );
+            break;
+
           case DBBE_OPCODE_ITERATOR:
             rc = dbBE_Redis_process_iterator( &request,
                                               &result,
@@ -379,8 +500,39 @@ process_next_item:
 
         // do not attempt to queue a new request until all responses have been
         sr_buf = dbBE_Transport_dbuffer_get_active( conn->_recvbuf ); // re-get the active buffer in case it has changed while processing cmds
-        if(( responses_remain > 0 ) && ( ! dbBE_Transport_sr_buffer_empty( sr_buf ) ))
+        if( responses_remain > 0 )
+        {
+          // the remaining responses of this request might still be in flight
+          // (e.g. MULTI/EXEC replies split across packets) pull them in before processing further
+          if( dbBE_Transport_sr_buffer_empty( sr_buf ) )
+          {
+            dbBE_Transport_sr_buffer_reset( sr_buf );
+            dbBE_Redis_context_unlock( input->_backend );
+            locked = 0;
+            ssize_t rrc = dbBE_Redis_receiver_recv_remaining( conn, sr_buf );
+            dbBE_Redis_context_lock( input->_backend );
+            locked = 1;
+            if( rrc < 0 )
+            {
+              LOG( DBG_ERR, stderr, "Recv of remaining responses from conn %d returned %ld\n", conn->_index, rrc );
+              dbBE_Redis_result_cleanup( &result, 0 );
+
+              // late responses would be taken for the next request; retry everything that's in flight
+              dbBE_Redis_s2r_queue_push( input->_backend->_retry_q, request );
+              while( ( request = dbBE_Redis_s2r_queue_pop( conn->_posted_q ) ) != NULL )
+              {
+                dbBE_Redis_s2r_queue_push( input->_backend->_retry_q, request );
+              }
+              dbBE_Redis_locator_reassociate_conn_index( input->_backend->_locator,
+                                                         conn->_index,
+                                                         DBBE_REDIS_LOCATOR_INDEX_INVAL );
+              dbBE_Redis_connection_mgr_conn_fail( input->_backend->_conn_mgr, conn );
+              ret = -1;
+              goto skip_receiving;
+            }
+          }
           break;
+        }
 
         if( rc >= 0 )
         {
@@ -411,10 +563,9 @@ process_next_item:
           }
           else // final stage
           {
-            if( dbBE_Completion_queue_push( input->_backend->_compl_q, request->_completion ) != 0 )
+            if( dbBE_Redis_completion_push( input->_backend, request->_completion ) != 0 )
             {
-              free( request->_completion );
-              dbBE_Redis_request_destroy( request );
+              dbBE_Redis_completion_release( request->_completion );
               LOG( DBG_ERR, stderr, "RedisBE: Failed to queue completion in final request stage.\n" );
               // todo: save the status to mark the request for cleanup during the next stages
             }
@@ -435,6 +586,8 @@ process_next_item:
             {
               LOG( DBG_TRACE, stderr, "Multiple responses in buffer of conn %d; remaining data=%ld\n",
                    conn->_index, dbBE_Transport_sr_buffer_unprocessed( sr_buf ) );
+              dbBE_Redis_context_unlock( input->_backend );
+              locked = 0;
               goto process_next_item;
             }
             else
@@ -446,7 +599,8 @@ process_next_item:
           if( completion != NULL )
           {
             memset( completion, 0, sizeof( dbBE_Completion_t ) );
-            free( completion );
+            dbBE_Redis_completion_release( completion );
+            request->_completion = NULL;
           }
 
           completion = dbBE_Redis_complete_command(
@@ -460,10 +614,9 @@ process_next_item:
             dbBE_Redis_result_cleanup( &result, 0 );
             goto skip_receiving;
           }
-          if( dbBE_Completion_queue_push( input->_backend->_compl_q, completion ) != 0 )
+          if( dbBE_Redis_completion_push( input->_backend, completion ) != 0 )
           {
-            free( completion );
-            dbBE_Redis_request_destroy( request );
+            dbBE_Redis_completion_release( completion );
             fprintf( stderr, "RedisBE: Failed to queue completion.\n" );
             // todo: save the status to mark the request for cleanup during the next stages
           }
@@ -476,6 +629,8 @@ process_next_item:
       }
       break;
   }
+  dbBE_Redis_context_unlock( input->_backend );
+  locked = 0;
 
   // question: completion in order or out-of-order?
   // can only complete out-of-order because Gets would block the whole completion queue
@@ -489,23 +644,73 @@ process_next_item:
   }
   dbBE_Redis_result_cleanup( &result, 0 );
 
-  if( receive_limit > 0 )
-    goto receive_more_responses;
+  // a full receive leaves the connection pending; there might be more in the socket
+  ret = ( dbBE_Redis_connection_get_status( conn ) == DBBE_CONNECTION_STATUS_PENDING_DATA );
 
 skip_receiving:
-  return NULL;
+  if( locked )
+    dbBE_Redis_context_unlock( input->_backend );
+  return ret;
 }
 
-void dbBE_Redis_receiver_trigger( dbBE_Redis_context_t *backend )
+void* dbBE_Redis_receiver( void *args )
 {
-  dbBE_Redis_receiver_args_t *args = (dbBE_Redis_receiver_args_t*)malloc( sizeof( dbBE_Redis_receiver_args_t ) );
+  dbBE_Redis_receiver_args_t *input = (dbBE_Redis_receiver_args_t*)args;
   if( args == NULL )
   {
-    LOG( DBG_ERR, stderr, "Args allocation when trying to trigger the receiver." );
-    return;
+    errno = EINVAL;
+    return NULL;
+  }
+
+  /*
+   * Input:
+   *  - completion queue(s)
+   *  - request queue filled by sender thread
+   *  - redirection/retry queue for sender
+   *  - list/map of receive buffers + Redis server instance references
+   *
+   */
+
+  // harvest all connections with activity at once
+  dbBE_Redis_connection_t *ready[ DBBE_REDIS_MAX_CONNECTIONS ];
+  int count = 0;
+  if( input->_worker != NULL )
+  {
+    dbBE_Redis_connection_t *conn;
+    while(( conn = dbBE_Redis_worker_get_active( input->_worker )) != NULL )
+      ready[ count++ ] = conn;
+  }
+  else
+    count = dbBE_Redis_connection_mgr_harvest_active( input->_backend->_conn_mgr, ready, DBBE_REDIS_MAX_CONNECTIONS );
+
+  // one receive per connection and round, so a busy node can't hold up the responses of the others
+  int round;
+  for( round = 0; ( count > 0 ) && ( round < DBBE_REDIS_RECEIVE_ROUNDS ); ++round )
+  {
+    int pending = 0;
+    int n;
+    for( n = 0; n < count; ++n )
+      if( dbBE_Redis_receiver_process( input, ready[ n ] ) > 0 )
+        ready[ pending++ ] = ready[ n ];
+    count = pending;
+  }
+
+  // leftovers for the next pass; edge-triggered events wouldn't report them again
+  // (workers poll level-triggered and find them anyway)
+  if( input->_worker == NULL )
+  {
+    int n;
+    for( n = 0; n < count; ++n )
+      dbBE_Redis_event_mgr_requeue( input->_backend->_conn_mgr->_ev_mgr, ready[ n ] );
   }
-  args->_backend = backend;
-  args->_looping = 1;
-  dbBE_Redis_receiver( (void*) args );
-  free( args );
+  return NULL;
+}
+
+void dbBE_Redis_receiver_trigger( dbBE_Redis_context_t *backend )
+{
+  dbBE_Redis_receiver_args_t args;
+  args._backend = backend;
+  args._looping = 1;
+  args._worker = NULL;
+  dbBE_Redis_receiver( (void*) &args );
 }
@@ -26,6 +26,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include "logutil.h"
 #include "../common/data_transport.h"
@@ -38,6 +39,8 @@
 #include "redis.h"
 #include "result.h"
 #include "cluster_info.h"
+#include "complete.h"
+#include "worker.h"
 
 const dbBE_api_t dbBE =
     { .initialize = Redis_initialize,
@@ -45,7 +48,10 @@ const dbBE_api_t dbBE =
       .post = Redis_post,
       .cancel = Redis_cancel,
       .test = Redis_test,
-      .test_any = Redis_test_any
+      .test_any = Redis_test_any,
+      .wait = Redis_wait,
+      .wakeup = Redis_wakeup,
+      .release = Redis_release
     };
 
 /*
@@ -62,6 +68,17 @@ dbBE_Handle_t Redis_initialize(void)
 
   memset( context, 0, sizeof( dbBE_Redis_context_t ) );
 
+  // recovery by one worker must not starve while others keep doing I/O
+  pthread_rwlockattr_t rwattr;
+  pthread_rwlockattr_init( &rwattr );
+#ifdef __GLIBC__
+  pthread_rwlockattr_setkind_np( &rwattr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP );
+#endif
+  pthread_mutex_init( &context->_lock, NULL );
+  pthread_rwlock_init( &context->_io_lock, &rwattr );
+  pthread_cond_init( &context->_cpl_cond, NULL );
+  pthread_rwlockattr_destroy( &rwattr );
+
   // protocol spec allocation
   dbBE_Redis_command_stage_spec_t *spec = dbBE_Redis_command_stages_spec_init();
   if( spec == NULL )
@@ -84,7 +101,7 @@ dbBE_Handle_t Redis_initialize(void)
 
   context->_locator = locator;
 
-  dbBE_Request_queue_t *work_q = dbBE_Request_queue_create( DBBE_REDIS_WORK_QUEUE_DEPTH );
+  dbBE_Ring_t *work_q = dbBE_Ring_create( DBBE_REDIS_WORK_QUEUE_DEPTH );
   if( work_q == NULL )
   {
     LOG( DBG_ERR, stderr, "dbBE_Redis_context_t::initialize: Failed to allocate work queue.\n" );
@@ -94,16 +111,17 @@ dbBE_Handle_t Redis_initialize(void)
 
   context->_work_q = work_q;
 
-  dbBE_Completion_queue_t *compl_q = dbBE_Completion_queue_create( DBBE_REDIS_WORK_QUEUE_DEPTH );
-  if( compl_q == NULL )
+  dbBE_Ring_t *compl_q = dbBE_Ring_create( DBBE_REDIS_COMPLETION_RING_DEPTH );
+  dbBE_Completion_queue_t *compl_overflow = dbBE_Completion_queue_create( 0 );
+  context->_compl_q = compl_q;
+  context->_compl_overflow = compl_overflow;
+  if(( compl_q == NULL ) || ( compl_overflow == NULL ))
   {
     LOG( DBG_ERR, stderr, "dbBE_Redis_context_t::initialize: Failed to allocate completion queue.\n" );
     Redis_exit( context );
     return NULL;
   }
 
-  context->_compl_q = compl_q;
-
   // create send-to-receive queue
   dbBE_Redis_s2r_queue_t *retry_q = dbBE_Redis_s2r_queue_create( 1 );
   if( retry_q == NULL )
@@ -164,8 +182,14 @@ dbBE_Handle_t Redis_initialize(void)
 
   context->_conn_mgr = conn_mgr;
 
-  // initialize an empty list of namespaces
-  context->_namespaces = NULL;
+  // initialize an empty table of namespaces
+  context->_namespaces = dbBE_Redis_namespace_list_create();
+  if( context->_namespaces == NULL )
+  {
+    LOG( DBG_ERR, stderr, "dbBE_Redis_context_t::initialize: Failed to initialize namespace table\n" );
+    Redis_exit( context );
+    return NULL;
+  }
 
   dbBE_Redis_iterator_list_t iterators = dbBE_Redis_iterator_list_allocate();
   if( iterators == NULL )
@@ -177,6 +201,13 @@ dbBE_Handle_t Redis_initialize(void)
   context->_iterators = iterators;
 
   int rc;
+  context->_topology_cache = dbBE_Extract_env( DBR_BE_TOPOLOGY_CACHE_ENV, DBR_BE_DEFAULT_TOPOLOGY_CACHE );
+  if(( context->_topology_cache != NULL ) && ( context->_topology_cache[0] == '\0' ))
+  {
+    free( context->_topology_cache );
+    context->_topology_cache = NULL;
+  }
+
   if( ( rc = dbBE_Redis_connect_initial( context )) != 0 )
   {
     LOG( DBG_ERR, stderr, "dbBE_Redis_context_t::initialize: Failed to connect to Redis. rc=%d\n", rc );
@@ -184,6 +215,36 @@ dbBE_Handle_t Redis_initialize(void)
     return NULL;
   }
 
+  char *ioengine = dbBE_Extract_env( DBR_BE_IOENGINE_ENV, DBR_BE_DEFAULT_IOENGINE );
+  if( ioengine != NULL )
+  {
+    context->_ioengine_uring = ( strcmp( ioengine, DBR_BE_IOENGINE_URING ) == 0 );
+    if(( ! context->_ioengine_uring ) && ( strcmp( ioengine, DBR_BE_IOENGINE_SOCKET ) != 0 ))
+      LOG( DBG_ERR, stderr, "dbBE_Redis_context_t::initialize: Unknown I/O engine %s; using %s\n", ioengine, DBR_BE_IOENGINE_SOCKET );
+    free( ioengine );
+  }
+
+  char *workers_str = dbBE_Extract_env( DBR_BE_WORKERS_ENV, DBR_BE_DEFAULT_WORKERS );
+  long workers = ( workers_str != NULL ) ? strtol( workers_str, NULL, 10 ) : 0;
+  free( workers_str );
+  if( workers > DBBE_REDIS_MAX_WORKERS )
+    workers = DBBE_REDIS_MAX_WORKERS;
+
+  if(( workers > 0 ) && (( rc = dbBE_Redis_workers_start( context, (int)workers )) != 0 ))
+  {
+    LOG( DBG_ERR, stderr, "dbBE_Redis_context_t::initialize: Failed to start %ld I/O workers. rc=%d\n", workers, rc );
+    Redis_exit( context );
+    return NULL;
+  }
+
+  // without workers, the caller thread does the I/O with the ring of the event mgr
+  if(( workers <= 0 ) && ( context->_ioengine_uring ))
+  {
+    context->_conn_mgr->_ev_mgr->_uring = dbBE_Redis_uring_create();
+    if( context->_conn_mgr->_ev_mgr->_uring == NULL )
+      LOG( DBG_ERR, stderr, "dbBE_Redis_context_t::initialize: io_uring not available (errno=%d); using socket calls\n", errno );
+  }
+
   return (dbBE_Handle_t*)context;
 }
 
@@ -197,6 +258,14 @@ int Redis_exit( dbBE_Handle_t be )
   if( be != NULL )
   {
     dbBE_Redis_context_t *context = (dbBE_Redis_context_t*)be;
+    if( __atomic_load_n( &context->_refresh_state, __ATOMIC_ACQUIRE ) != DBBE_REDIS_SLOTMAP_REFRESH_IDLE )
+    {
+      pthread_join( context->_refresh_thread, NULL );
+      if( context->_refresh_result != NULL )
+        dbBE_Redis_cluster_info_destroy( context->_refresh_result );
+    }
+    temp = dbBE_Redis_workers_stop( context );
+    if(( temp != 0 ) && ( rc == 0 )) rc = temp;
     dbBE_Redis_connection_mgr_exit( context->_conn_mgr );
     temp = dbBE_Redis_iterator_list_destroy( context->_iterators );
     if(( temp != 0 ) && ( rc == 0 )) rc = temp;
@@ -213,11 +282,18 @@ int Redis_exit( dbBE_Handle_t be )
     dbBE_Transport_sr_buffer_free( context->_sender_buffer );
     temp = dbBE_Redis_s2r_queue_destroy( context->_retry_q );
     if(( temp != 0 ) && ( rc == 0 )) rc = temp;
-    temp = dbBE_Completion_queue_destroy( context->_compl_q );
+    temp = dbBE_Completion_queue_destroy( context->_compl_overflow );
     if(( temp != 0 ) && ( rc == 0 )) rc = temp;
-    temp = dbBE_Request_queue_destroy( context->_work_q );
+    temp = dbBE_Ring_destroy( context->_compl_q );
+    if(( temp != 0 ) && ( rc == 0 )) rc = temp;
+    temp = dbBE_Ring_destroy( context->_work_q );
     if(( temp != 0 ) && ( rc == 0 )) rc = temp;
     dbBE_Redis_command_stages_spec_destroy( context->_spec );
+    if( context->_topology_cache != NULL )
+      free( context->_topology_cache );
+    pthread_cond_destroy( &context->_cpl_cond );
+    pthread_rwlock_destroy( &context->_io_lock );
+    pthread_mutex_destroy( &context->_lock );
     memset( context, 0, sizeof( dbBE_Redis_context_t ) );
     free( context );
     if( gScrapSpace != NULL )
@@ -225,6 +301,9 @@ int Redis_exit( dbBE_Handle_t be )
       free( gScrapSpace );
       gScrapSpace = NULL;
     }
+    dbBE_Redis_request_pool_drain();
+    dbBE_Redis_completion_pool_drain();
+    dbBE_Redis_connection_auth_forget();
     context = NULL;
   }
 
@@ -271,6 +350,13 @@ int dbBE_Redis_request_sanity_check( dbBE_Request_t *request )
       if(( request->_sge_count != 1 ) && ( request->_sge[0].iov_base != request->_key ))
         rc = EINVAL;
       break;
+    case DBBE_OPCODE_STAT: // single SGE with space for at least the count
+      if(( request->_key == NULL ) || ( request->_sge_count != 1 ) ||
+          ( request->_sge[0].iov_base == NULL ) || ( request->_sge[0].iov_len < sizeof( int64_t )))
+        rc = EINVAL;
+      else
+        rc = dbBE_Redis_namespace_validate( request->_ns_hdl );
+      break;
     case DBBE_OPCODE_UNSPEC:
     case DBBE_OPCODE_CANCEL:
     case DBBE_OPCODE_NSCREATE:
@@ -284,6 +370,40 @@ int dbBE_Redis_request_sanity_check( dbBE_Request_t *request )
   return rc;
 }
 
+/*
+ * queue a request for the I/O workers
+ * the request is picked up by whichever worker is notified first and then forwarded to the owner of its connection
+ * posting is lock-free; only a full queue needs the lock to register for a wakeup once there's space again
+ */
+static
+dbBE_Request_handle_t Redis_post_to_workers( dbBE_Redis_context_t *rbe,
+                                             dbBE_Request_t *request,
+                                             int trigger )
+{
+  size_t queued = dbBE_Ring_len( rbe->_work_q );
+  int rc = dbBE_Ring_push( rbe->_work_q, request );
+  unsigned next = __atomic_fetch_add( &rbe->_next_worker, 1, __ATOMIC_RELAXED );
+  dbBE_Redis_worker_t *worker = &rbe->_workers[ next % rbe->_worker_count ];
+
+  if( rc == EAGAIN )
+  {
+    pthread_mutex_lock( &rbe->_lock );
+    rbe->_post_blocked = 1;
+    pthread_mutex_unlock( &rbe->_lock );
+  }
+
+  // workers keep going while the queue is not empty, so only the first request needs a wakeup
+  if(( trigger ) || ( queued == 0 ) || ( rc != 0 ))
+    dbBE_Redis_worker_wakeup( worker );
+
+  if( rc != 0 )
+  {
+    errno = ( rc == EAGAIN ) ? EAGAIN : ENOENT;
+    return NULL;
+  }
+  return (dbBE_Request_handle_t*)request;
+}
+
 /*
  * post a new request to the backend
  */
@@ -305,17 +425,18 @@ dbBE_Request_handle_t Redis_post( dbBE_Handle_t be,
 
   dbBE_Redis_context_t *rbe = ( dbBE_Redis_context_t* )be;
 
-  // check if there's space in the queue
-  if( dbBE_Request_queue_len( rbe->_work_q ) >= DBBE_REDIS_WORK_QUEUE_DEPTH )
+  if( rbe->_worker_count > 0 )
+    return Redis_post_to_workers( rbe, request, trigger );
+
+  // queue to posting queue; if there's no space, make some progress and let the caller retry
+  int rc = dbBE_Ring_push( rbe->_work_q, request );
+  if( rc == EAGAIN )
   {
     dbBE_Redis_sender_trigger( rbe );
     errno = EAGAIN;
     return NULL;
   }
 
-  // queue to posting queue
-  int rc = dbBE_Request_queue_push( rbe->_work_q, request );
-
   if( rc != 0 )
   {
     errno = ENOENT;
@@ -373,21 +494,209 @@ dbBE_Completion_t* Redis_test_any( dbBE_Handle_t be )
 
   dbBE_Redis_context_t *rbe = ( dbBE_Redis_context_t* )be;
 
-  if( dbBE_Completion_queue_len( rbe->_compl_q ) == 0 )
+  dbBE_Completion_t *compl = dbBE_Redis_completion_pop( rbe );
+
+  // if completion queue is empty, see if we can make some progress on requests to change that.
+  // the workers make progress on their own
+  if(( compl == NULL ) && ( rbe->_worker_count == 0 ))
   {
-    // if completion queue is empty, see if we can make some progress on requests to change that.
     dbBE_Redis_sender_trigger( rbe );
-    // if then still no completion, give up here and let the caller retry later
-    if( dbBE_Completion_queue_len( rbe->_compl_q ) == 0 )
+    compl = dbBE_Redis_completion_pop( rbe );
+  }
+
+  // if then still no completion, give up here and let the caller retry later
+  if( compl == NULL )
+    errno = EAGAIN;
+  return compl;
+}
+
+void Redis_release( dbBE_Handle_t be, dbBE_Completion_t *completion )
+{
+  dbBE_Redis_completion_release( completion );
+}
+
+/*
+ * with workers, the only progress the caller can make is to pick up completions
+ */
+static
+int Redis_wait_for_workers( dbBE_Redis_context_t *rbe, int64_t timeout_usec )
+{
+  struct timespec deadline;
+  clock_gettime( CLOCK_REALTIME, &deadline );
+  deadline.tv_sec += timeout_usec / 1000000;
+  deadline.tv_nsec += ( timeout_usec % 1000000 ) * 1000;
+  if( deadline.tv_nsec >= 1000000000 )
+  {
+    deadline.tv_sec += 1;
+    deadline.tv_nsec -= 1000000000;
+  }
+
+  pthread_mutex_lock( &rbe->_lock );
+  int rc = 0;
+  // a blocked post can make progress once the workers drained the work queue
+  int blocked = rbe->_post_blocked;
+  while(( rc == 0 )
+      && ( dbBE_Redis_completion_len( rbe ) == 0 )
+      && ( rbe->_interrupted == 0 )
+      && (( blocked == 0 ) || ( rbe->_post_blocked != 0 ))
+      && ( timeout_usec > 0 ))
+    rc = pthread_cond_timedwait( &rbe->_cpl_cond, &rbe->_lock, &deadline );
+  rc = ( dbBE_Redis_completion_len( rbe ) != 0 ) || (( blocked != 0 ) && ( rbe->_post_blocked == 0 ));
+  rbe->_interrupted = 0;
+  pthread_mutex_unlock( &rbe->_lock );
+  return rc;
+}
+
+int Redis_wait( dbBE_Handle_t be, int64_t timeout_usec )
+{
+  if( be == NULL )
+    return -EINVAL;
+
+  dbBE_Redis_context_t *rbe = ( dbBE_Redis_context_t* )be;
+
+  if( rbe->_worker_count > 0 )
+    return Redis_wait_for_workers( rbe, timeout_usec );
+
+  // queued work or completions can make progress without any network activity
+  if(( dbBE_Redis_completion_len( rbe ) != 0 )
+      || ( dbBE_Ring_len( rbe->_work_q ) != 0 )
+      || ( dbBE_Redis_s2r_queue_len( rbe->_retry_q ) != 0 ))
+    return 1;
+
+  if( timeout_usec <= 0 )
+    return 0;
+
+  struct timeval timeout;
+  timeout.tv_sec = timeout_usec / 1000000;
+  timeout.tv_usec = timeout_usec % 1000000;
+  return dbBE_Redis_event_mgr_wait( rbe->_conn_mgr->_ev_mgr, &timeout );
+}
+
+int Redis_wakeup( dbBE_Handle_t be )
+{
+  if( be == NULL )
+    return -EINVAL;
+
+  dbBE_Redis_context_t *rbe = ( dbBE_Redis_context_t* )be;
+  if( rbe->_worker_count > 0 )
+  {
+    pthread_mutex_lock( &rbe->_lock );
+    rbe->_interrupted = 1;
+    pthread_cond_broadcast( &rbe->_cpl_cond );
+    pthread_mutex_unlock( &rbe->_lock );
+    return 0;
+  }
+  return dbBE_Redis_event_mgr_wakeup( rbe->_conn_mgr->_ev_mgr );
+}
+
+/*
+ * link all masters of the cluster info that have no connection yet and set up the locator
+ */
+static
+int dbBE_Redis_connect_masters( dbBE_Redis_context_t *ctx, dbBE_Redis_cluster_info_t *cl_info )
+{
+  int rc = 0;
+
+  // collect the masters that need a new connection, then link them all at once
+  int nodes = dbBE_Redis_cluster_info_getsize( cl_info );
+  char **urls = (char**)calloc( nodes + 1, sizeof( char* ) );
+  int *link_of = (int*)calloc( nodes + 1, sizeof( int ) );
+  dbBE_Redis_connection_t **links = (dbBE_Redis_connection_t**)calloc( nodes + 1, sizeof( dbBE_Redis_connection_t* ) );
+  if(( urls == NULL ) || ( link_of == NULL ) || ( links == NULL ))
+  {
+    rc = -ENOMEM;
+    goto exit_links;
+  }
+
+  int n, s, l;
+  int link_count = 0;
+  for( n = 0; n < nodes; ++n )
+  {
+    dbBE_Redis_server_info_t *si = dbBE_Redis_cluster_info_get_server( cl_info, n );
+    if( si == NULL )
+    {
+      LOG( DBG_ERR, stderr, "No server info available for node %d\n", n );
+      rc = -ENOTCONN;
+      goto exit_links;
+    }
+
+    for( s = 0; s < dbBE_Redis_server_info_getsize( si ); ++ s )
     {
-      errno = EAGAIN;
-      return NULL;
+      if( dbBE_Redis_server_info_get_replica( si, s ) == NULL )
+      {
+        LOG( DBG_ERR, stderr, "No replica url available for node %d:%d\n", n, s );
+        rc = -ENOTCONN;
+        goto exit_links;
+      }
     }
+
+    // replica connections will be created only if a master goes down
+    char *url = dbBE_Redis_server_info_get_replica( si, 0 );
+    link_of[ n ] = -1;
+    if(( url == NULL ) || ( dbBE_Redis_connection_mgr_get_connection_to( ctx->_conn_mgr, url ) != NULL ))
+      continue;
+
+    for( l = 0; ( l < link_count ) && ( strcmp( urls[ l ], url ) != 0 ); ++l ) {}
+    if( l == link_count )
+      urls[ link_count++ ] = url;
+    link_of[ n ] = l;
+  }
+
+  if(( link_count > 0 ) && ( dbBE_Redis_connection_mgr_newlinks( ctx->_conn_mgr, urls, link_count, links ) != 0 ))
+  {
+    rc = -ENOLINK;
+    goto exit_links;
   }
 
-  dbBE_Completion_t *compl = dbBE_Completion_queue_pop( rbe->_compl_q );
+  for( n = 0; n < nodes; ++n )
+  {
+    dbBE_Redis_server_info_t *si = dbBE_Redis_cluster_info_get_server( cl_info, n );
+    char *url = dbBE_Redis_server_info_get_replica( si, 0 );
+    if( url == NULL )
+      continue;
+    dbBE_Redis_connection_t *dest = ( link_of[ n ] >= 0 ) ? links[ link_of[ n ] ] :
+        dbBE_Redis_connection_mgr_get_connection_to( ctx->_conn_mgr, url );
 
-  return compl;
+    dbBE_Redis_hash_slot_t first_slot = dbBE_Redis_server_info_get_first_slot( si );
+    dbBE_Redis_hash_slot_t last_slot = dbBE_Redis_server_info_get_last_slot( si );
+
+    dbBE_Redis_connection_assign_slot_range( dest,
+                                             first_slot,
+                                             last_slot );
+
+    // update locator
+    dbBE_Redis_locator_associate_range_conn_index( ctx->_locator, first_slot, last_slot, dest->_index );
+  }
+
+  // without them, blocking Gets just poll; not worth failing the connect
+  int blocking_failed = dbBE_Redis_connection_mgr_blocking_links( ctx->_conn_mgr );
+  if( blocking_failed != 0 )
+    LOG( DBG_WARN, stderr, "Unable to link all blocking connections. rc=%d\n", blocking_failed );
+
+exit_links:
+  free( links );
+  free( link_of );
+  free( urls );
+  return rc;
+}
+
+/*
+ * drop all connections after the masters of a stale topology cache turned out unreachable
+ */
+static
+void dbBE_Redis_disconnect_all( dbBE_Redis_context_t *ctx )
+{
+  int n;
+  for( n = 0; n < DBBE_REDIS_MAX_CONNECTIONS; ++n )
+  {
+    dbBE_Redis_connection_t *conn = ctx->_conn_mgr->_connections[ n ];
+    if( conn == NULL )
+      continue;
+    dbBE_Redis_locator_reassociate_conn_index( ctx->_locator, conn->_index, DBBE_REDIS_LOCATOR_INDEX_INVAL );
+    dbBE_Redis_connection_mgr_rm( ctx->_conn_mgr, conn );
+    dbBE_Redis_connection_unlink( conn );
+    dbBE_Redis_connection_destroy( conn );
+  }
 }
 
 /*
@@ -411,6 +720,26 @@ int dbBE_Redis_connect_initial( dbBE_Redis_context_t *ctx )
 
   LOG(DBG_VERBOSE, stderr, "url=%s\n", env_url );
 
+  // trust a cached topology and only fall back to discovery if its masters can't be linked
+  // stale slot assignments are corrected by MOVED responses
+  if( ctx->_topology_cache != NULL )
+  {
+    dbBE_Redis_cluster_info_t *cached = dbBE_Redis_cluster_info_load( ctx->_topology_cache, env_url );
+    if( cached != NULL )
+    {
+      if( dbBE_Redis_connect_masters( ctx, cached ) == 0 )
+      {
+        LOG( DBG_VERBOSE, stderr, "Using cached topology from %s\n", ctx->_topology_cache );
+        dbBE_Redis_connection_mgr_set_local_address( ctx->_conn_mgr, cached );
+        ctx->_cluster_info = cached;
+        goto exit_connect;
+      }
+      LOG( DBG_INFO, stderr, "Cached topology %s is stale. Rediscovering.\n", ctx->_topology_cache );
+      dbBE_Redis_disconnect_all( ctx );
+      dbBE_Redis_cluster_info_destroy( cached );
+    }
+  }
+
   dbBE_Redis_connection_t *initial_conn = dbBE_Redis_connection_mgr_newlink( ctx->_conn_mgr, env_url );
   if( initial_conn == NULL )
   {
@@ -444,58 +773,127 @@ int dbBE_Redis_connect_initial( dbBE_Redis_context_t *ctx )
 
   ctx->_cluster_info = cl_info;
 
-  int n, s;
-  for( n = 0; n < dbBE_Redis_cluster_info_getsize( cl_info ); ++n )
+  rc = dbBE_Redis_connect_masters( ctx, cl_info );
+  if(( rc == 0 ) && ( ctx->_topology_cache != NULL ))
   {
-    dbBE_Redis_server_info_t *si = dbBE_Redis_cluster_info_get_server( cl_info, n );
-    if( si == NULL )
-    {
-      LOG( DBG_ERR, stderr, "No server info available for node %d\n", n );
-      rc = -ENOTCONN;
-      goto exit_connect;
-    }
+    int save_rc = dbBE_Redis_cluster_info_save( cl_info, env_url, ctx->_topology_cache );
+    if( save_rc != 0 )
+      LOG( DBG_WARN, stderr, "Unable to write topology cache %s. rc=%d\n", ctx->_topology_cache, save_rc );
+  }
 
-    dbBE_Redis_hash_slot_t first_slot = dbBE_Redis_server_info_get_first_slot( si );
-    dbBE_Redis_hash_slot_t last_slot = dbBE_Redis_server_info_get_last_slot( si );
+exit_connect:
+  free( env_url );
+  return rc;
+}
 
-    for( s = 0; s < dbBE_Redis_server_info_getsize( si ); ++ s )
-    {
-      char *url = dbBE_Redis_server_info_get_replica( si, s );
-      if( url == NULL )
-      {
-        LOG( DBG_ERR, stderr, "No replica url available for node %d:%d\n", n, s );
-        rc = -ENOTCONN;
-        goto exit_connect;
-      }
+/*
+ * helper thread: fetch the slot map through its own connection and hand it over to the I/O path
+ */
+static
+void* dbBE_Redis_slotmap_refresh_main( void *arg )
+{
+  dbBE_Redis_context_t *ctx = (dbBE_Redis_context_t*)arg;
+
+  ctx->_refresh_result = dbBE_Redis_connection_mgr_query_cluster_info( ctx->_conn_mgr, ctx->_refresh_url );
+  if( ctx->_refresh_result == NULL )
+    LOG( DBG_ERR, stderr, "Slot map refresh from %s failed\n", ctx->_refresh_url );
+  __atomic_store_n( &ctx->_refresh_state, DBBE_REDIS_SLOTMAP_REFRESH_READY, __ATOMIC_RELEASE );
+
+  // make sure the next sender pass picks it up soon
+  if( ctx->_worker_count > 0 )
+    dbBE_Redis_worker_wakeup( &ctx->_workers[ 0 ] );
+  else
+    dbBE_Redis_event_mgr_wakeup( ctx->_conn_mgr->_ev_mgr );
+  return NULL;
+}
 
-      // replica connections will be created only if a master goes down
-      if( s > 0 )
-        continue;
+int dbBE_Redis_slotmap_refresh_start( dbBE_Redis_context_t *ctx, const char *address )
+{
+  if(( ctx == NULL ) || ( address == NULL ))
+    return -EINVAL;
 
-      // check and create connection
-      // check connection exists,
-      dbBE_Redis_connection_t *dest =
-          dbBE_Redis_connection_mgr_get_connection_to( ctx->_conn_mgr, url );
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  int64_t now_ms = (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+
+  // a burst of MOVED responses only triggers one refresh
+  int expected = DBBE_REDIS_SLOTMAP_REFRESH_IDLE;
+  if(( ctx->_refresh_time != 0 ) && ( now_ms - ctx->_refresh_time < DBBE_REDIS_SLOTMAP_REFRESH_INTERVAL ))
+    return -EBUSY;
+  if( ! __atomic_compare_exchange_n( &ctx->_refresh_state, &expected, DBBE_REDIS_SLOTMAP_REFRESH_RUNNING,
+                                     0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE ))
+    return -EBUSY;
+
+  ctx->_refresh_time = now_ms;
+  ctx->_refresh_result = NULL;
+  snprintf( ctx->_refresh_url, DBR_SERVER_URL_MAX_LENGTH, "sock://%s", address );
+  if( pthread_create( &ctx->_refresh_thread, NULL, dbBE_Redis_slotmap_refresh_main, ctx ) != 0 )
+  {
+    LOG( DBG_ERR, stderr, "Unable to start slot map refresh. errno=%d\n", errno );
+    __atomic_store_n( &ctx->_refresh_state, DBBE_REDIS_SLOTMAP_REFRESH_IDLE, __ATOMIC_RELEASE );
+    return -EAGAIN;
+  }
+  LOG( DBG_VERBOSE, stderr, "Refreshing slot map from %s\n", ctx->_refresh_url );
+  return 0;
+}
 
-      if( dest == NULL )
-        dest = dbBE_Redis_connection_mgr_newlink( ctx->_conn_mgr, url );
+/*
+ * point queued requests to the current owner of their slot
+ * requests of later stages skip the locator lookup and would otherwise collect another MOVED
+ */
+static
+void dbBE_Redis_slotmap_reroute( dbBE_Redis_locator_t *locator, dbBE_Redis_s2r_queue_t *queue )
+{
+  size_t n = dbBE_Redis_s2r_queue_len( queue );
+  while( n-- > 0 )
+  {
+    dbBE_Redis_request_t *request = dbBE_Redis_s2r_queue_pop( queue );
+    if( request == NULL )
+      break;
+    if( request->_location._type == DBBE_REDIS_REQUEST_LOCATION_TYPE_SLOT )
+    {
+      dbBE_Redis_locator_index_t idx = dbBE_Redis_locator_get_conn_index( locator, request->_key._slot );
+      if( idx != DBBE_REDIS_LOCATOR_INDEX_INVAL )
+        request->_location._data._conn_idx = idx;
+    }
+    dbBE_Redis_s2r_queue_push( queue, request );
+  }
+}
 
-      if( dest == NULL )
-      {
-        rc = -ENOLINK;
-        goto exit_connect;
-      }
+int dbBE_Redis_slotmap_refresh_apply( dbBE_Redis_context_t *ctx )
+{
+  if(( ctx == NULL ) || ( ! dbBE_Redis_slotmap_refresh_ready( ctx ) ))
+    return 0;
 
-      dbBE_Redis_connection_assign_slot_range( dest,
-                                               first_slot,
-                                               last_slot );
+  pthread_join( ctx->_refresh_thread, NULL );
+  dbBE_Redis_cluster_info_t *cl_info = ctx->_refresh_result;
+  ctx->_refresh_result = NULL;
 
-      // update locator
-      dbBE_Redis_locator_associate_range_conn_index( ctx->_locator, first_slot, last_slot, dest->_index );
-    }
+  int rc = -ENOMSG;
+  if(( cl_info != NULL ) && (( rc = dbBE_Redis_connect_masters( ctx, cl_info )) == 0 ))
+  {
+    int w;
+    dbBE_Redis_slotmap_reroute( ctx->_locator, ctx->_retry_q );
+    for( w = 0; w < ctx->_worker_count; ++w )
+      dbBE_Redis_slotmap_reroute( ctx->_locator, ctx->_workers[ w ]._inbox );
+
+    dbBE_Redis_cluster_info_destroy( ctx->_cluster_info );
+    ctx->_cluster_info = cl_info;
+    LOG( DBG_VERBOSE, stderr, "Applied refreshed slot map with %d ranges\n", dbBE_Redis_cluster_info_getsize( cl_info ) );
+
+    // the snapshot is current again
+    char *env_url = dbBE_Extract_env( DBR_SERVER_HOST_ENV, DBR_SERVER_DEFAULT_HOST );
+    if(( ctx->_topology_cache != NULL ) && ( env_url != NULL ) &&
+        ( dbBE_Redis_cluster_info_save( cl_info, env_url, ctx->_topology_cache ) == 0 ))
+      ctx->_topology_stale = 0;
+    free( env_url );
+    cl_info = NULL;
   }
+  else
+    LOG( DBG_ERR, stderr, "Unable to apply refreshed slot map. rc=%d\n", rc );
 
-exit_connect:
-  free( env_url );
+  if( cl_info != NULL )
+    dbBE_Redis_cluster_info_destroy( cl_info );
+  __atomic_store_n( &ctx->_refresh_state, DBBE_REDIS_SLOTMAP_REFRESH_IDLE, __ATOMIC_RELEASE );
   return rc;
 }
@@ -19,8 +19,8 @@
 #define BACKEND_REDIS_API_H_
 
 #include "../common/dbbe_api.h"
-#include "../common/request_queue.h"
 #include "../common/completion_queue.h"
+#include "../common/ring.h"
 #include "../common/request_set.h"
 #include "../common/data_transport.h"
 
@@ -33,14 +33,19 @@
 #include "namespacelist.h"
 #include "iterator.h"
 
-typedef struct
+#include <pthread.h>
+
+struct dbBE_Redis_worker;
+
+typedef struct dbBE_Redis_context
 {
   dbBE_Redis_command_stage_spec_t *_spec;
   dbBE_Redis_cluster_info_t *_cluster_info;
   dbBE_Redis_locator_t *_locator;
   dbBE_Redis_connection_mgr_t *_conn_mgr;
-  dbBE_Request_queue_t *_work_q;
-  dbBE_Completion_queue_t *_compl_q;
+  dbBE_Ring_t *_work_q;                     // posted requests; lock-free so posting never contends with the workers
+  dbBE_Ring_t *_compl_q;                    // completions; lock-free so test_any() never contends with the workers
+  dbBE_Completion_queue_t *_compl_overflow; // completions that didn't fit into _compl_q (protected by _lock)
   dbBE_Redis_s2r_queue_t *_retry_q;
   dbBE_Request_set_t *_cancellations;
   dbBE_Data_transport_t *_transport;
@@ -48,10 +53,103 @@ typedef struct
   dbBE_Redis_namespace_list_t *_namespaces;
   int *_sender_connections;
   dbBE_Redis_iterator_list_t _iterators;
-  // sender/receiver threads
 
+  // I/O worker threads (DBR_BE_WORKERS); without workers, everything runs inline on the caller thread
+  int _worker_count;
+  struct dbBE_Redis_worker *_workers;
+  unsigned _next_worker;        // round-robin worker to notify about new requests
+  pthread_mutex_t _lock;        // protects queues, topology, and namespaces while workers are running
+  pthread_rwlock_t _io_lock;    // workers hold it shared while doing I/O; connection recovery takes it exclusive
+  pthread_cond_t _cpl_cond;     // signaled when completions are queued or Redis_wakeup() is called
+  int _recover;                 // a worker found the hash range uncovered and requests recovery
+  unsigned _recoveries;         // number of recovery attempts; invalidates the poll results of the workers
+  int _interrupted;             // pending Redis_wakeup()
+  int _post_blocked;            // a post found the work queue full; signal _cpl_cond when there's space again
+  int _ioengine_uring;          // DBR_BE_IOENGINE=uring: send/recv batches go through io_uring
+  char *_topology_cache;        // DBR_BE_TOPOLOGY_CACHE: topology snapshot file (NULL if disabled)
+  int _topology_stale;          // a MOVED response invalidated the snapshot already
+
+  // slot map refresh after MOVED: fetched by a helper thread, applied by the sender (or worker recovery)
+  pthread_t _refresh_thread;
+  int _refresh_state;           // dbBE_Redis_slotmap_refresh_state_t; atomic, hands over _refresh_result
+  dbBE_Redis_cluster_info_t *_refresh_result;
+  int64_t _refresh_time;        // msec timestamp of the last refresh start
+  char _refresh_url[ DBR_SERVER_URL_MAX_LENGTH ];
 } dbBE_Redis_context_t;
 
+typedef enum
+{
+  DBBE_REDIS_SLOTMAP_REFRESH_IDLE = 0,
+  DBBE_REDIS_SLOTMAP_REFRESH_RUNNING = 1,
+  DBBE_REDIS_SLOTMAP_REFRESH_READY = 2
+} dbBE_Redis_slotmap_refresh_state_t;
+
+/*
+ * check whether a refreshed slot map is waiting to be applied
+ */
+#define dbBE_Redis_slotmap_refresh_ready( ctx ) \
+    ( __atomic_load_n( &(ctx)->_refresh_state, __ATOMIC_ACQUIRE ) == DBBE_REDIS_SLOTMAP_REFRESH_READY )
+
+/*
+ * the backend lock is only needed if there are worker threads
+ */
+#define dbBE_Redis_context_lock( ctx ) \
+    { if( (ctx)->_worker_count > 0 ) pthread_mutex_lock( &(ctx)->_lock ); }
+
+#define dbBE_Redis_context_unlock( ctx ) \
+    { if( (ctx)->_worker_count > 0 ) pthread_mutex_unlock( &(ctx)->_lock ); }
+
+/*
+ * queue a completion for test_any(); requires the backend lock
+ * once the ring is full, completions go to the overflow list until test_any() drained it
+ */
+static inline
+int dbBE_Redis_completion_push( dbBE_Redis_context_t *backend, dbBE_Completion_t *completion )
+{
+  if(( dbBE_Completion_queue_len( backend->_compl_overflow ) == 0 )
+      && ( dbBE_Ring_push( backend->_compl_q, completion ) == 0 ))
+    return 0;
+  return dbBE_Completion_queue_push( backend->_compl_overflow, completion );
+}
+
+/*
+ * fetch the next completion or NULL; the lock is only taken if there's overflow
+ */
+static inline
+dbBE_Completion_t* dbBE_Redis_completion_pop( dbBE_Redis_context_t *backend )
+{
+  dbBE_Completion_t *completion = (dbBE_Completion_t*)dbBE_Ring_pop( backend->_compl_q );
+  if(( completion == NULL )
+      && ( __atomic_load_n( &backend->_compl_overflow->_len, __ATOMIC_ACQUIRE ) != 0 ))
+  {
+    dbBE_Redis_context_lock( backend );
+    completion = dbBE_Completion_queue_pop( backend->_compl_overflow );
+    dbBE_Redis_context_unlock( backend );
+  }
+  return completion;
+}
+
+/*
+ * number of completions waiting for test_any()
+ */
+static inline
+size_t dbBE_Redis_completion_len( dbBE_Redis_context_t *backend )
+{
+  return dbBE_Ring_len( backend->_compl_q )
+      + __atomic_load_n( &backend->_compl_overflow->_len, __ATOMIC_ACQUIRE );
+}
+
+/*
+ * input of the sender and receiver functions
+ * without a worker, they process all connections on the caller thread
+ */
+typedef struct dbBE_Redis_io_args
+{
+  dbBE_Redis_context_t *_backend;
+  int _looping;
+  struct dbBE_Redis_worker *_worker;
+} dbBE_Redis_io_args_t;
+
 
 /*
  * initialize the system library
@@ -89,6 +187,22 @@ dbBE_Completion_t* Redis_test( dbBE_Handle_t be,
  */
 dbBE_Completion_t* Redis_test_any( dbBE_Handle_t be );
 
+/*
+ * block until there's potential progress (pending work, active connection)
+ * or until the timeout expires or another thread calls Redis_wakeup()
+ */
+int Redis_wait( dbBE_Handle_t be, int64_t timeout_usec );
+
+/*
+ * interrupt a Redis_wait() from another thread
+ */
+int Redis_wakeup( dbBE_Handle_t be );
+
+/*
+ * return a processed completion to the completion pool
+ */
+void Redis_release( dbBE_Handle_t be, dbBE_Completion_t *completion );
+
 
 /**************************************************************************
  * non-API functions
@@ -99,7 +213,28 @@ dbBE_Completion_t* Redis_test_any( dbBE_Handle_t be );
  */
 int dbBE_Redis_connect_initial( dbBE_Redis_context_t *ctx );
 
+/*
+ * check the connections and attempt to recover if not all hash slots are covered
+ * fails all queued requests if the cluster is not recoverable
+ */
+dbBE_Redis_connection_recoverable_t dbBE_Redis_sender_recover( dbBE_Redis_context_t *backend );
+
+/*
+ * start fetching the slot map from the server at address (<host>:<port>) in the background
+ * only one refresh runs at a time and starts are rate limited
+ * returns -EBUSY if no refresh was started
+ */
+int dbBE_Redis_slotmap_refresh_start( dbBE_Redis_context_t *ctx, const char *address );
+
+/*
+ * install a fetched slot map: link new masters, update the locator, re-route queued requests
+ * requires exclusive access to the connections (inline sender or worker recovery)
+ * returns 0 if nothing was pending or the map was applied, <0 if it had to be dropped
+ */
+int dbBE_Redis_slotmap_refresh_apply( dbBE_Redis_context_t *ctx );
+
 void dbBE_Redis_sender_trigger( dbBE_Redis_context_t *backend );
+void* dbBE_Redis_sender( void *args );
 void* dbBE_Redis_receiver( void *args );
 void dbBE_Redis_receiver_trigger( dbBE_Redis_context_t *backend );
 
@@ -23,22 +23,25 @@
 #include "protocol.h"
 #include "request.h"
 #include "namespace.h"
+#include "encode.h"
+#include "create.h"
 
 #include <inttypes.h>
 #include <string.h>
 #include <errno.h>
 #include <stdio.h>
-#include <math.h>
 
 /*
  * implementation of single redis command exec
  */
 
+static const char dbBE_Redis_command_crlf[] = "\r\n";
+
 static inline
 int Redis_insert_redis_terminator( char *buf )
 {
-  if( sprintf( buf, "\r\n" ) < 2 )
-    return -1;
+  buf[0] = '\r';
+  buf[1] = '\n';
   return 2;
 }
 
@@ -63,117 +66,85 @@ int dbBE_Redis_command_microcmd_create( dbBE_Redis_command_stage_spec_t *stage,
 }
 
 
-int dbBE_Redis_create_key_cmd( dbBE_Redis_request_t *request, char *keybuf, uint16_t size )
+/*
+ * assemble the SGEs of a key argument: [ns::]name
+ * returns the number of SGEs or negative error
+ */
+static inline
+int dbBE_Redis_command_key_sge( dbBE_Redis_sr_buffer_t *buf,
+                                dbBE_Redis_key_sge_t *key,
+                                dbBE_Redis_namespace_t *ns,
+                                char *name )
 {
-  if( keybuf == NULL )
+  if( name == NULL )
     return -EINVAL;
 
-  int len = 0;
-  dbBE_Redis_namespace_t *ns = (dbBE_Redis_namespace_t*)request->_user->_ns_hdl;
-  switch( request->_user->_opcode )
+  size_t namelen = strnlen( name, DBBE_REDIS_MAX_KEY_LEN );
+  size_t keylen = namelen;
+  if( ns != NULL )
+    keylen += dbBE_Redis_namespace_get_prefix_len( ns );
+  if( keylen >= DBBE_REDIS_MAX_KEY_LEN )
+    return -EMSGSIZE;
+  if( dbBE_Transport_sr_buffer_remaining( buf ) < DBBE_REDIS_ENCODE_HEAD_MAX )
+    return -E2BIG;
+
+  char *head = dbBE_Transport_sr_buffer_get_available_position( buf );
+  int headlen = dbBE_Redis_encode_bulk_head( head, keylen );
+  dbBE_Transport_sr_buffer_add_data( buf, headlen, 1 );
+
+  int n = 0;
+  key->_sge[ n ].iov_base = head;
+  key->_sge[ n ].iov_len = headlen;
+  ++n;
+  if( ns != NULL )
   {
-    case DBBE_OPCODE_PUT:
-    case DBBE_OPCODE_GET:
-    case DBBE_OPCODE_READ:
-    case DBBE_OPCODE_REMOVE:
-    {
-      int keylen = strnlen( dbBE_Redis_namespace_get_name( ns ), size ) + DBBE_REDIS_NAMESPACE_SEPARATOR_LEN + strnlen( request->_user->_key, size );
-      len = snprintf( keybuf, size, "$%d\r\n%s%s%s\r\n",
-                      keylen,
-                      dbBE_Redis_namespace_get_name( ns ),
-                      DBBE_REDIS_NAMESPACE_SEPARATOR,
-                      request->_user->_key );
-      if(( len < 0 ) || ( len >= size ))
-        return -EMSGSIZE;
-      break;
-    }
-    case DBBE_OPCODE_NSCREATE:
-    case DBBE_OPCODE_NSATTACH:
-    {
-      int keylen = strnlen( request->_user->_key, size );
-      len = snprintf( keybuf, size, "$%d\r\n%s\r\n",
-                      keylen,
-                      request->_user->_key );
-      break;
-    }
-    case DBBE_OPCODE_DIRECTORY:
-    case DBBE_OPCODE_NSQUERY:
-    case DBBE_OPCODE_ITERATOR: // iterator should never get here to build a key (SCAN <cursor> MATCH ....) has no 'key'
-    {
-      int keylen = strnlen( dbBE_Redis_namespace_get_name( ns ), size );
-      len = snprintf( keybuf, size, "$%d\r\n%s\r\n",
-                      keylen,
-                      dbBE_Redis_namespace_get_name( ns ) );
-      break;
-    }
-    case DBBE_OPCODE_NSDELETE:
-    {
-      int keylen = strnlen( dbBE_Redis_namespace_get_name( ns ), size );
-      len = snprintf( keybuf, size, "$%d\r\n%s\r\n",
-                      keylen,
-                      dbBE_Redis_namespace_get_name( ns ) );
-      break;
-    }
+    key->_sge[ n ].iov_base = dbBE_Redis_namespace_get_prefix( ns );
+    key->_sge[ n ].iov_len = dbBE_Redis_namespace_get_prefix_len( ns );
+    ++n;
+  }
+  key->_sge[ n ].iov_base = name;
+  key->_sge[ n ].iov_len = namelen;
+  ++n;
+  key->_sge[ n ].iov_base = (void*)dbBE_Redis_command_crlf;
+  key->_sge[ n ].iov_len = 2;
+  ++n;
+
+  key->_count = n;
+  return n;
+}
 
-    case DBBE_OPCODE_NSDETACH:
-    {
-      switch( request->_step->_stage )
-      {
-        case DBBE_REDIS_NSDETACH_STAGE_DELCHECK: // HINCRBY ns_name refcnt -1; HMGET ns_name refcnt flags
-        case DBBE_REDIS_NSDETACH_STAGE_DELNS: // DEL ns_name
-        {
-          int keylen = strnlen( dbBE_Redis_namespace_get_name( ns ), size );
-          len = snprintf( keybuf, size, "$%d\r\n%s\r\n",
-                          keylen,
-                          dbBE_Redis_namespace_get_name( ns ) );
-          break;
-        }
-        case DBBE_REDIS_NSDETACH_STAGE_SCAN: // SCAN 0 MATCH ns_name%sep;*
-          return -ENOSYS;
-        case DBBE_REDIS_NSDETACH_STAGE_DELKEYS: // DEL ns_name%sep;key  (already complete key in nsdetach.scankey)
-        {
-          int keylen = strnlen( request->_status.nsdetach.scankey, size );
-          len = snprintf( keybuf, size, "$%d\r\n%s\r\n",
-                          keylen,
-                          request->_status.nsdetach.scankey );
-          if(( len < 0 ) || ( len >= size ))
-            return -EMSGSIZE;
-          break;
-        }
-        default:
-          return -EPROTO;
-      }
-      break;
-    }
-    case DBBE_OPCODE_MOVE:
+int dbBE_Redis_create_key_cmd( dbBE_Redis_request_t *request,
+                               dbBE_Redis_sr_buffer_t *buf,
+                               dbBE_Redis_key_sge_t *key )
+{
+  if(( buf == NULL ) || ( key == NULL ))
+    return -EINVAL;
+
+  if( request->_user->_opcode == DBBE_OPCODE_NSDETACH )
+  {
+    switch( request->_step->_stage )
     {
-      char *ns_name = NULL;
-      switch( request->_step->_stage )
-      {
-        case DBBE_REDIS_MOVE_STAGE_RESTORE: // restore stage uses the new namespace for the key
-          ns_name = dbBE_Redis_namespace_get_name( (dbBE_Redis_namespace_t*)request->_user->_sge[0].iov_base );
-          break;
-        default:
-          ns_name = dbBE_Redis_namespace_get_name( ns );
-          break;
-      }
-      if( ns_name == NULL )
-        return -EINVAL;
-
-      int keylen = strnlen( ns_name, size ) + DBBE_REDIS_NAMESPACE_SEPARATOR_LEN + strnlen( request->_user->_key, size );
-      len = snprintf( keybuf, size, "$%d\r\n%s%s%s\r\n",
-                      keylen,
-                      ns_name,
-                      DBBE_REDIS_NAMESPACE_SEPARATOR,
-                      request->_user->_key );
-      if(( len < 0 ) || ( len >= size ))
-        return -EMSGSIZE;
-      break;
+      case DBBE_REDIS_NSDETACH_STAGE_DELCHECK: // HINCRBY ns_name refcnt -1; HMGET ns_name refcnt flags
+      case DBBE_REDIS_NSDETACH_STAGE_DELNS: // DEL ns_name
+        break;
+      case DBBE_REDIS_NSDETACH_STAGE_SCAN: // SCAN 0 MATCH ns_name%sep;*
+        return -ENOSYS;
+      case DBBE_REDIS_NSDETACH_STAGE_DELKEYS: // DEL ns_name%sep;key  (already complete key in nsdetach.scankey)
+        return dbBE_Redis_command_key_sge( buf, key, NULL, request->_status.nsdetach.scankey );
+      default:
+        return -EPROTO;
     }
-    default:
-      return -ENOSYS;
   }
-  return len;
+
+  // all other keys are rendered once per request and referenced in place
+  int rc = dbBE_Redis_create_request_key( request );
+  if( rc != 0 )
+    return rc;
+
+  key->_sge[0].iov_base = request->_key._data;
+  key->_sge[0].iov_len = request->_key._len;
+  key->_count = 1;
+  return 1;
 }
 
 
@@ -209,14 +180,13 @@ int dbBE_Redis_command_create_sr_buffer_field( dbBE_Redis_sr_buffer_t *buf,
                                                dbBE_sge_t *sge )
 {
   // create and insert field entry
-  char *fld = dbBE_Transport_sr_buffer_get_available_position( buf );
-  int fldlen = 0;
   if( field == NULL )
-    fldlen = snprintf( fld, dbBE_Transport_sr_buffer_remaining( buf ), "$0\r\n\r\n" ); // insert empty-string
-  else
-    fldlen = snprintf( fld, dbBE_Transport_sr_buffer_remaining( buf ), "$%ld\r\n%s\r\n", len, field );
-  if( fldlen <= 0 )
+    len = 0; // insert empty-string
+  if( dbBE_Transport_sr_buffer_remaining( buf ) < len + DBBE_REDIS_ENCODE_HEAD_MAX + 2 )
     return -E2BIG;
+
+  char *fld = dbBE_Transport_sr_buffer_get_available_position( buf );
+  int fldlen = dbBE_Redis_encode_bulk_string( fld, field, len );
   if( dbBE_Transport_sr_buffer_add_data( buf, fldlen, 1 ) != (size_t)fldlen )
     return -E2BIG;
 
@@ -226,6 +196,16 @@ int dbBE_Redis_command_create_sr_buffer_field( dbBE_Redis_sr_buffer_t *buf,
   return 0;
 }
 
+static inline
+int dbBE_Redis_command_create_sr_buffer_int( dbBE_Redis_sr_buffer_t *buf,
+                                             int64_t value,
+                                             dbBE_sge_t *sge )
+{
+  char num[ DBBE_REDIS_ENCODE_HEAD_MAX ];
+  int len = dbBE_Redis_encode_int( num, value );
+  return dbBE_Redis_command_create_sr_buffer_field( buf, num, len, sge );
+}
+
 
 int dbBE_Redis_command_put_parse( dbBE_Redis_command_stage_spec_t spec,
                                   dbBE_Redis_result_t *result )
@@ -240,151 +220,88 @@ int dbBE_Redis_command_put_parse( dbBE_Redis_command_stage_spec_t spec,
       return ( err ); \
     }
 
-#define DBBE_REDIS_CMD_REWIND_CMD_AND_ERROR( err, cmd_idx ) \
-    { \
-      cmd_idx = 0; \
-      return ( err ); \
-    }
-
+/*
+ * render the compiled command of a stage with its args into the buffer
+ */
 static inline
 int dbBE_Redis_command_create_sgeN( dbBE_Redis_command_stage_spec_t *stage,
                                     dbBE_Redis_sr_buffer_t *sr_buf,
                                     dbBE_sge_t *args )
 {
   int rc = 0;
-  int n = 0;
-  char *cmdptr = stage->_command;
+  int s;
   char *initial = dbBE_Transport_sr_buffer_get_processed_position( sr_buf );
-  char *cmdend = stage->_command + strlen( stage->_command );
 
-  while((cmdptr < cmdend ))
+  for( s = 0; s < stage->_segment_count; ++s )
   {
-    // get next location of parameter
-    char *loc = index( cmdptr, '%' );
-
-    // no more parameters. break and add the remaining cmd string
-    if( loc == NULL )
-      break;
-
-    // index() did something funky...
-    if(( loc > cmdend ) || ( *loc != '%' ))
-      DBBE_REDIS_CMD_REWIND_BUF_AND_ERROR( -EBADMSG, sr_buf, initial );
-
-    // what positional arg to insert?
-    int idx = (int)loc[1] - 48;
-    if(( idx < 0 )  ||  ( idx >= stage->_array_len )  || ( args[ idx ].iov_base == NULL ))
-      DBBE_REDIS_CMD_REWIND_BUF_AND_ERROR( -EBADMSG, sr_buf, initial );
-
-    // insert cmd string up to position
-    char tmp = *loc;
-    /*
-     *  todo: note this changes the cmd buffer and thus is not thread-safe
-     *        in case there are multiple threads creating commands
-     */
-    *loc = '\0';
-    int len = snprintf( dbBE_Transport_sr_buffer_get_processed_position( sr_buf ),
-                        dbBE_Transport_sr_buffer_remaining( sr_buf ),
-                        "%s", cmdptr );
-    *loc = tmp;
-    if( len < 0 ) // can be 0 if 2 args appear back-to-back
-      DBBE_REDIS_CMD_REWIND_BUF_AND_ERROR( -ENOMEM, sr_buf, initial );
-
-    rc += dbBE_Transport_sr_buffer_add_data( sr_buf, len, 1 );
-
-    // insert args[n]
-    len = snprintf( dbBE_Transport_sr_buffer_get_processed_position( sr_buf ),
-                    dbBE_Transport_sr_buffer_remaining( sr_buf ),
-                    "$%ld\r\n", args[ idx ].iov_len );
-    if( len < 4 ) // fixed chars + single digit number + one-length argument
-      DBBE_REDIS_CMD_REWIND_BUF_AND_ERROR( -ENOMEM, sr_buf, initial );
-
-    rc += dbBE_Transport_sr_buffer_add_data( sr_buf, len, 1 );
-
-    size_t maxlen = args[ idx ].iov_len;
-    if( maxlen > dbBE_Transport_sr_buffer_remaining( sr_buf ) - 2 ) // -2 because of cmd terminator
-      maxlen = dbBE_Transport_sr_buffer_remaining( sr_buf ) - 2;
-    memcpy( dbBE_Transport_sr_buffer_get_processed_position( sr_buf ),
-            args[ idx ].iov_base,
-            maxlen );
-
-    rc += dbBE_Transport_sr_buffer_add_data( sr_buf, maxlen, 1 );
-    rc += dbBE_Redis_command_create_terminate( sr_buf );
-
-    cmdptr = loc + 2;
-    ++n;
-  }
-
-  // add any remaining/trailing cmd string data
-  if( cmdptr < cmdend )
-  {
-    int len = snprintf( dbBE_Transport_sr_buffer_get_processed_position( sr_buf ),
-                        dbBE_Transport_sr_buffer_remaining( sr_buf ),
-                        "%s", cmdptr );
-    if( len <= 0 ) // if equal to zero, then cmdptr == cmdend - can't be true here
-      DBBE_REDIS_CMD_REWIND_BUF_AND_ERROR( -ENOMEM, sr_buf, initial );
+    dbBE_Redis_command_segment_t *seg = &stage->_segments[ s ];
+    char *pos = dbBE_Transport_sr_buffer_get_processed_position( sr_buf );
+    size_t remaining = dbBE_Transport_sr_buffer_remaining( sr_buf );
+    int len;
 
+    if( seg->_arg == DBBE_REDIS_COMMAND_SEGMENT_LITERAL )
+    {
+      if( remaining < seg->_len )
+        DBBE_REDIS_CMD_REWIND_BUF_AND_ERROR( -ENOMEM, sr_buf, initial );
+      memcpy( pos, &stage->_command[ seg->_offset ], seg->_len );
+      len = seg->_len;
+    }
+    else
+    {
+      if( args[ seg->_arg ].iov_base == NULL )
+        DBBE_REDIS_CMD_REWIND_BUF_AND_ERROR( -EBADMSG, sr_buf, initial );
+      if( remaining < args[ seg->_arg ].iov_len + DBBE_REDIS_ENCODE_HEAD_MAX + 2 )
+        DBBE_REDIS_CMD_REWIND_BUF_AND_ERROR( -ENOMEM, sr_buf, initial );
+      len = dbBE_Redis_encode_bulk_string( pos, args[ seg->_arg ].iov_base, args[ seg->_arg ].iov_len );
+    }
     rc += dbBE_Transport_sr_buffer_add_data( sr_buf, len, 1 );
   }
-
   return rc;
 }
 
+/*
+ * assemble the SGE list of a command from the compiled stage command
+ * literal segments point into the command spec, arg 0 is taken from key (if not NULL)
+ * all other args are expected to be complete bulk strings
+ * returns the number of SGEs in cmd or negative error
+ */
 static inline
-int dbBE_Redis_command_create_sgeN_uncheck( dbBE_Redis_command_stage_spec_t *stage,
-                                            dbBE_sge_t *args,
-                                            dbBE_sge_t *cmd )
+int dbBE_Redis_command_encode( dbBE_Redis_command_stage_spec_t *stage,
+                               dbBE_Redis_key_sge_t *key,
+                               dbBE_sge_t *args,
+                               dbBE_sge_t *cmd )
 {
-  char *cmdptr = stage->_command;
-  char *cmdend = stage->_command + strlen( stage->_command );
-
   int cmd_idx = 0;
+  int s;
 
-  while((cmdptr < cmdend ))
+  for( s = 0; s < stage->_segment_count; ++s )
   {
-    // get next location of parameter
-    char *loc = index( cmdptr, '%' );
-
-    // no more parameters. break and add the remaining cmd string
-    if( loc == NULL )
-      break;
-
-    // index() did something funky...
-    if(( loc > cmdend ) || ( *loc != '%' ))
-      DBBE_REDIS_CMD_REWIND_CMD_AND_ERROR( -EBADMSG, cmd_idx );
-
-    // insert chars from defined cmd string, if any
-    if( loc != cmdptr )
+    dbBE_Redis_command_segment_t *seg = &stage->_segments[ s ];
+    if( seg->_arg == DBBE_REDIS_COMMAND_SEGMENT_LITERAL )
     {
-      cmd[ cmd_idx ].iov_base = cmdptr;
-      cmd[ cmd_idx ].iov_len = (size_t)(loc - cmdptr);
-      cmdptr += cmd[ cmd_idx ].iov_len;
+      cmd[ cmd_idx ].iov_base = &stage->_command[ seg->_offset ];
+      cmd[ cmd_idx ].iov_len = seg->_len;
       ++cmd_idx;
+      continue;
     }
 
-    // what positional arg to insert?
-    int idx = (int)loc[1] - 48;
-    if(( idx < 0 )  ||  ( idx >= stage->_array_len ))
-      DBBE_REDIS_CMD_REWIND_CMD_AND_ERROR( -EBADMSG, cmd_idx );
+    if(( seg->_arg == 0 ) && ( key != NULL ))
+    {
+      memcpy( &cmd[ cmd_idx ], key->_sge, key->_count * sizeof( dbBE_sge_t ) );
+      cmd_idx += key->_count;
+      continue;
+    }
 
-    if( args[ idx ].iov_base == NULL )
+    if(( args == NULL ) || ( args[ seg->_arg ].iov_base == NULL ))
       break;
 
     // insert args[n]
-    if( args[ idx ].iov_len > 0 )
+    if( args[ seg->_arg ].iov_len > 0 )
     {
-      cmd[ cmd_idx ].iov_base = args[ idx ].iov_base;
-      cmd[ cmd_idx ].iov_len = args[ idx ].iov_len;
+      cmd[ cmd_idx ].iov_base = args[ seg->_arg ].iov_base;
+      cmd[ cmd_idx ].iov_len = args[ seg->_arg ].iov_len;
       ++cmd_idx;
     }
-    cmdptr = loc + 2;
-  }
-
-  // add any remaining/trailing cmd string data
-  if( cmdptr < cmdend )
-  {
-    cmd[ cmd_idx ].iov_base = cmdptr;
-    cmd[ cmd_idx ].iov_len = (size_t)( cmdend - cmdptr );
-    ++cmd_idx;
   }
 
   return cmd_idx;
@@ -408,38 +325,46 @@ int dbBE_Redis_command_create_str1( dbBE_Redis_command_stage_spec_t *stage,
   return dbBE_Redis_command_create_sgeN( stage, sr_buf, sge );
 }
 
+/*
+ * commands that only take the key as an argument
+ */
+static inline
+int dbBE_Redis_command_key_only_create( dbBE_Redis_request_t *req,
+                                        dbBE_Redis_sr_buffer_t *buf,
+                                        dbBE_sge_t *cmd )
+{
+  dbBE_Redis_key_sge_t key;
+  int rc = dbBE_Redis_create_key_cmd( req, buf, &key );
+  if( rc < 0 )
+    return rc;
+
+  return dbBE_Redis_command_encode( req->_step, &key, NULL, cmd );
+}
+
 int dbBE_Redis_command_lpop_create( dbBE_Redis_request_t *req,
                                     dbBE_Redis_sr_buffer_t *buf,
                                     dbBE_sge_t *cmd )
 {
-  char *key = dbBE_Transport_sr_buffer_get_available_position( buf );
-  int keylen = dbBE_Redis_create_key_cmd( req, key,
-                                          dbBE_Transport_sr_buffer_remaining( buf ) >= DBBE_REDIS_MAX_KEY_LEN ? DBBE_REDIS_MAX_KEY_LEN : dbBE_Transport_sr_buffer_remaining( buf ) );
-  if( keylen < 0 )
-    return keylen;
-  if( dbBE_Transport_sr_buffer_add_data( buf, keylen, 1 ) != (size_t)keylen )
-    return -E2BIG;
-
-  dbBE_sge_t sge[ req->_step->_array_len + 1 ];
-  sge[ req->_step->_array_len ].iov_base = NULL;
-  sge[ req->_step->_array_len ].iov_len = 0;
+  return dbBE_Redis_command_key_only_create( req, buf, cmd );
+}
 
-  sge[0].iov_base = key;
-  sge[0].iov_len = keylen;
-  return dbBE_Redis_command_create_sgeN_uncheck( req->_step, sge, cmd );
+int dbBE_Redis_command_blpop_create( dbBE_Redis_request_t *req,
+                                     dbBE_Redis_sr_buffer_t *buf,
+                                     dbBE_sge_t *cmd )
+{
+  // the timeout is already part of the command spec
+  return dbBE_Redis_command_key_only_create( req, buf, cmd );
 }
 
 int dbBE_Redis_command_lindex_create( dbBE_Redis_request_t *req,
                                       dbBE_Redis_sr_buffer_t *buf,
                                       dbBE_sge_t *cmd )
 {
-  char *key = dbBE_Transport_sr_buffer_get_available_position( buf );
-  int keylen = dbBE_Redis_create_key_cmd( req, key,
-                                          dbBE_Transport_sr_buffer_remaining( buf ) >= DBBE_REDIS_MAX_KEY_LEN ? DBBE_REDIS_MAX_KEY_LEN : dbBE_Transport_sr_buffer_remaining( buf ) );
-  if( keylen < 0 )
-    return keylen;
-  if( dbBE_Transport_sr_buffer_add_data( buf, keylen, 1 ) != (size_t)keylen )
-    return -E2BIG;
+  char *bstart = dbBE_Transport_sr_buffer_get_available_position( buf );
+  dbBE_Redis_key_sge_t key;
+  int rc = dbBE_Redis_create_key_cmd( req, buf, &key );
+  if( rc < 0 )
+    return rc;
 
   dbBE_sge_t sge[ req->_step->_array_len + 1 ];
   sge[ req->_step->_array_len ].iov_base = NULL;
@@ -447,21 +372,13 @@ int dbBE_Redis_command_lindex_create( dbBE_Redis_request_t *req,
 
   // insert the index to fetch (extracted from the flags value)
   int64_t uindex = req->_user->_flags >> 4;
-  int uindex_len = uindex == 0 ? 1 : (int64_t)( log10( uindex )) + 1;
-  char *lindex = dbBE_Transport_sr_buffer_get_available_position( buf );
-  int lindex_len = snprintf( lindex, dbBE_Transport_sr_buffer_remaining( buf ),
-                             "$%d\r\n%ld\r\n", uindex_len, uindex );
-  if(( lindex_len < 0 ) || ( ( dbBE_Transport_sr_buffer_add_data( buf, lindex_len, 1 ) != (size_t)lindex_len ) ))
+  if( dbBE_Redis_command_create_sr_buffer_int( buf, uindex, &sge[1] ) != 0 )
     goto error;
 
-  sge[0].iov_base = key;
-  sge[0].iov_len = keylen;
-  sge[1].iov_base = lindex;
-  sge[1].iov_len = lindex_len;
-  return dbBE_Redis_command_create_sgeN_uncheck( req->_step, sge, cmd );
+  return dbBE_Redis_command_encode( req->_step, &key, sge, cmd );
 
 error:
-  dbBE_Transport_sr_buffer_rewind_available_to( buf, key );
+  dbBE_Transport_sr_buffer_rewind_available_to( buf, bstart );
   return -E2BIG;
 }
 
@@ -469,110 +386,35 @@ int dbBE_Redis_command_del_create( dbBE_Redis_request_t *req,
                                    dbBE_Redis_sr_buffer_t *buf,
                                    dbBE_sge_t *cmd )
 {
-  char *key = dbBE_Transport_sr_buffer_get_available_position( buf );
-  int keylen = dbBE_Redis_create_key_cmd( req, key,
-                                          dbBE_Transport_sr_buffer_remaining( buf ) >= DBBE_REDIS_MAX_KEY_LEN ? DBBE_REDIS_MAX_KEY_LEN : dbBE_Transport_sr_buffer_remaining( buf ) );
-  if( keylen < 0 )
-    return keylen;
-  if( dbBE_Transport_sr_buffer_add_data( buf, keylen, 1 ) != (size_t)keylen )
-    return -E2BIG;
-
-  dbBE_sge_t sge[ req->_step->_array_len + 1 ];
-  sge[ req->_step->_array_len ].iov_base = NULL;
-  sge[ req->_step->_array_len ].iov_len = 0;
-
-  sge[0].iov_base = key;
-  sge[0].iov_len = keylen;
-  return dbBE_Redis_command_create_sgeN_uncheck( req->_step, sge, cmd );
+  return dbBE_Redis_command_key_only_create( req, buf, cmd );
 }
 
 int dbBE_Redis_command_hmgetall_create( dbBE_Redis_request_t *req,
                                         dbBE_Redis_sr_buffer_t *buf,
                                         dbBE_sge_t *cmd )
 {
-  char *key = dbBE_Transport_sr_buffer_get_available_position( buf );
-  int keylen = dbBE_Redis_create_key_cmd( req, key,
-                                          dbBE_Transport_sr_buffer_remaining( buf ) >= DBBE_REDIS_MAX_KEY_LEN ? DBBE_REDIS_MAX_KEY_LEN : dbBE_Transport_sr_buffer_remaining( buf ) );
-  if( keylen < 0 )
-    return keylen;
-  if( dbBE_Transport_sr_buffer_add_data( buf, keylen, 1 ) != (size_t)keylen )
-    return -E2BIG;
-
-  dbBE_sge_t sge[ 1 ];
-  sge[0].iov_base = key;
-  sge[0].iov_len = keylen;
-
-  return dbBE_Redis_command_create_sgeN_uncheck( req->_step, sge, cmd );
+  return dbBE_Redis_command_key_only_create( req, buf, cmd );
 }
 
 int dbBE_Redis_command_hmget_create( dbBE_Redis_request_t *req,
                                      dbBE_Redis_sr_buffer_t *buf,
                                      dbBE_sge_t *cmd )
 {
-  char *key = dbBE_Transport_sr_buffer_get_available_position( buf );
-  int keylen = dbBE_Redis_create_key_cmd( req, key,
-                                          dbBE_Transport_sr_buffer_remaining( buf ) >= DBBE_REDIS_MAX_KEY_LEN ? DBBE_REDIS_MAX_KEY_LEN : dbBE_Transport_sr_buffer_remaining( buf ) );
-  if( keylen < 0 )
-    return keylen;
-  if( dbBE_Transport_sr_buffer_add_data( buf, keylen, 1 ) != (size_t)keylen )
-    return -E2BIG;
-
-  dbBE_sge_t sge[ req->_step->_array_len + 1 ];
-  sge[ req->_step->_array_len ].iov_base = NULL;
-  sge[ req->_step->_array_len ].iov_len = 0;
-
-  sge[0].iov_base = key;
-  sge[0].iov_len = keylen;
-
-  return dbBE_Redis_command_create_sgeN_uncheck( req->_step, sge, cmd );
+  return dbBE_Redis_command_key_only_create( req, buf, cmd );
 }
 
 int dbBE_Redis_command_exists_create( dbBE_Redis_request_t *req,
                                       dbBE_Redis_sr_buffer_t *buf,
                                       dbBE_sge_t *cmd )
 {
-  dbBE_Redis_command_stage_spec_t *stage = req->_step;
-
-  char *key = dbBE_Transport_sr_buffer_get_available_position( buf );
-  int keylen = dbBE_Redis_create_key_cmd( req, key,
-                                          dbBE_Transport_sr_buffer_remaining( buf ) >= DBBE_REDIS_MAX_KEY_LEN ? DBBE_REDIS_MAX_KEY_LEN : dbBE_Transport_sr_buffer_remaining( buf ) );
-  if( keylen < 0 )
-    return keylen;
-  if( dbBE_Transport_sr_buffer_add_data( buf, keylen, 1 ) != (size_t)keylen )
-    return -E2BIG;
-
-  dbBE_sge_t sge[ stage->_array_len + 1 ];
-  sge[ stage->_array_len ].iov_base = NULL;
-  sge[ stage->_array_len ].iov_len = 0;
-
-  sge[0].iov_base = key;
-  sge[0].iov_len = keylen;
-
-  return dbBE_Redis_command_create_sgeN_uncheck( stage, sge, cmd );
+  return dbBE_Redis_command_key_only_create( req, buf, cmd );
 }
 
 int dbBE_Redis_command_dump_create(  dbBE_Redis_request_t *req,
                                      dbBE_Redis_sr_buffer_t *buf,
                                      dbBE_sge_t *cmd )
 {
- dbBE_Redis_command_stage_spec_t *stage = req->_step;
-
- char *key = dbBE_Transport_sr_buffer_get_available_position( buf );
- int keylen = dbBE_Redis_create_key_cmd( req, key,
-                                         dbBE_Transport_sr_buffer_remaining( buf ) >= DBBE_REDIS_MAX_KEY_LEN ? DBBE_REDIS_MAX_KEY_LEN : dbBE_Transport_sr_buffer_remaining( buf ) );
- if( keylen < 0 )
-   return keylen;
- if( dbBE_Transport_sr_buffer_add_data( buf, keylen, 1 ) != (size_t)keylen )
-   return -E2BIG;
-
- dbBE_sge_t sge[ stage->_array_len + 1 ];
- sge[ stage->_array_len ].iov_base = NULL;
- sge[ stage->_array_len ].iov_len = 0;
-
- sge[0].iov_base = key;
- sge[0].iov_len = keylen;
-
- return dbBE_Redis_command_create_sgeN_uncheck( stage, sge, cmd );
+  return dbBE_Redis_command_key_only_create( req, buf, cmd );
 }
 
 
@@ -586,30 +428,25 @@ int dbBE_Redis_command_restore_create( dbBE_Redis_request_t *req,
   sge[ stage->_array_len ].iov_len = 0;
 
   char *bstart = dbBE_Transport_sr_buffer_get_available_position( buf );
-  char *key = bstart;
-  int keylen = dbBE_Redis_create_key_cmd( req, key,
-                                          dbBE_Transport_sr_buffer_remaining( buf ) >= DBBE_REDIS_MAX_KEY_LEN ? DBBE_REDIS_MAX_KEY_LEN : dbBE_Transport_sr_buffer_remaining( buf ) );
-  if( keylen < 0 )
-    return keylen;
-  if( dbBE_Transport_sr_buffer_add_data( buf, keylen, 1 ) != (size_t)keylen )
-    goto error;
+  dbBE_Redis_key_sge_t key;
+  int rc = dbBE_Redis_create_key_cmd( req, buf, &key );
+  if( rc < 0 )
+    return rc;
 
   // todo: see note in protocol.c
   // create dump-value prefix
-  char *prefix = dbBE_Transport_sr_buffer_get_available_position( buf );
-  int prefix_len = snprintf( prefix, dbBE_Transport_sr_buffer_remaining( buf ),
-                             "$%ld\r\n", req->_status.move.len );
-  if(( prefix_len < 0 ) || ( ( dbBE_Transport_sr_buffer_add_data( buf, prefix_len, 1 ) != (size_t)prefix_len ) ))
+  if( dbBE_Transport_sr_buffer_remaining( buf ) < DBBE_REDIS_ENCODE_HEAD_MAX )
     goto error;
+  char *prefix = dbBE_Transport_sr_buffer_get_available_position( buf );
+  int prefix_len = dbBE_Redis_encode_bulk_head( prefix, req->_status.move.len );
+  dbBE_Transport_sr_buffer_add_data( buf, prefix_len, 1 );
 
-  sge[0].iov_base = key;
-  sge[0].iov_len = keylen;
   sge[1].iov_base = prefix;
   sge[1].iov_len = prefix_len;
   sge[2].iov_base = req->_status.move.dumped_value;
   sge[2].iov_len = req->_status.move.len;
 
-  return dbBE_Redis_command_create_sgeN_uncheck( stage, sge, cmd );
+  return dbBE_Redis_command_encode( stage, &key, sge, cmd );
 
 error:
   dbBE_Transport_sr_buffer_rewind_available_to( buf, bstart );
@@ -668,16 +505,10 @@ int dbBE_Redis_command_hsetnx_create( dbBE_Redis_request_t *req,
   char *bstart = dbBE_Transport_sr_buffer_get_available_position( buf );
 
   // create and insert key
-  char *key = dbBE_Transport_sr_buffer_get_available_position( buf );
-  int keylen = dbBE_Redis_create_key_cmd( req, key,
-                                          dbBE_Transport_sr_buffer_remaining( buf ) >= DBBE_REDIS_MAX_KEY_LEN ? DBBE_REDIS_MAX_KEY_LEN : dbBE_Transport_sr_buffer_remaining( buf ) );
-  if( keylen < 0 )
-    return keylen;
-  if( dbBE_Transport_sr_buffer_add_data( buf, keylen, 1 ) != (size_t)keylen )
-    return -E2BIG;
-
-  sge[0].iov_base = key;
-  sge[0].iov_len = keylen;
+  dbBE_Redis_key_sge_t key;
+  int rc = dbBE_Redis_create_key_cmd( req, buf, &key );
+  if( rc < 0 )
+    return rc;
 
   // create and insert field entry
   if( dbBE_Redis_command_create_sr_buffer_field( buf, field, strlen( field ), &sge[1] ) != 0 )
@@ -693,7 +524,7 @@ int dbBE_Redis_command_hsetnx_create( dbBE_Redis_request_t *req,
     return -E2BIG;
   }
 
-  return dbBE_Redis_command_create_sgeN_uncheck( stage, sge, cmd );
+  return dbBE_Redis_command_encode( stage, &key, sge, cmd );
 }
 
 int dbBE_Redis_command_hset_create( dbBE_Redis_request_t *req,
@@ -710,16 +541,10 @@ int dbBE_Redis_command_hset_create( dbBE_Redis_request_t *req,
 
   // create and insert key
   char *bstart = dbBE_Transport_sr_buffer_get_available_position( buf );
-  char *key = bstart;
-  int keylen = dbBE_Redis_create_key_cmd( req, key,
-                                          dbBE_Transport_sr_buffer_remaining( buf ) >= DBBE_REDIS_MAX_KEY_LEN ? DBBE_REDIS_MAX_KEY_LEN : dbBE_Transport_sr_buffer_remaining( buf ) );
-  if( keylen < 0 )
-    return keylen;
-  if( dbBE_Transport_sr_buffer_add_data( buf, keylen, 1 ) != (size_t)keylen )
-    goto error;
-
-  sge[0].iov_base = key;
-  sge[0].iov_len = keylen;
+  dbBE_Redis_key_sge_t key;
+  int rc = dbBE_Redis_create_key_cmd( req, buf, &key );
+  if( rc < 0 )
+    return rc;
 
   if( dbBE_Redis_command_create_sr_buffer_field( buf, field, strlen(field), &sge[1] ) != 0 )
     goto error;
@@ -727,7 +552,7 @@ int dbBE_Redis_command_hset_create( dbBE_Redis_request_t *req,
   if( dbBE_Redis_command_create_sr_buffer_field( buf, value, strlen(value), &sge[2] ) != 0 )
     goto error;
 
-  return dbBE_Redis_command_create_sgeN_uncheck( stage, sge, cmd );
+  return dbBE_Redis_command_encode( stage, &key, sge, cmd );
 
 error:
   dbBE_Transport_sr_buffer_rewind_available_to( buf, bstart );
@@ -747,16 +572,10 @@ int dbBE_Redis_command_hmset_create( dbBE_Redis_request_t *req,
 
   // create and insert key
   char *bstart = dbBE_Transport_sr_buffer_get_available_position( buf );
-  char *key = bstart;
-  int keylen = dbBE_Redis_create_key_cmd( req, key,
-                                          dbBE_Transport_sr_buffer_remaining( buf ) >= DBBE_REDIS_MAX_KEY_LEN ? DBBE_REDIS_MAX_KEY_LEN : dbBE_Transport_sr_buffer_remaining( buf ) );
-  if( keylen < 0 )
-    return keylen;
-  if( dbBE_Transport_sr_buffer_add_data( buf, keylen, 1 ) != (size_t)keylen )
-    return -E2BIG;
-
-  sge[0].iov_base = key;
-  sge[0].iov_len = keylen;
+  dbBE_Redis_key_sge_t key;
+  int rc = dbBE_Redis_create_key_cmd( req, buf, &key );
+  if( rc < 0 )
+    return rc;
 
   if( dbBE_Redis_command_create_sr_buffer_field( buf, "refcnt", 6, &sge[1] ) != 0 )
     goto error;
@@ -781,7 +600,7 @@ int dbBE_Redis_command_hmset_create( dbBE_Redis_request_t *req,
   if( dbBE_Redis_command_create_sr_buffer_field( buf, "0", 1, &sge[6] ) != 0 )
     goto error;
 
-  return dbBE_Redis_command_create_sgeN_uncheck( stage, sge, cmd );
+  return dbBE_Redis_command_encode( stage, &key, sge, cmd );
 
 error:
   dbBE_Transport_sr_buffer_rewind_available_to( buf, bstart );
@@ -799,23 +618,15 @@ int dbBE_Redis_command_hincrby_create( dbBE_Redis_request_t *req,
 
   // create and insert key
   char *bstart = dbBE_Transport_sr_buffer_get_available_position( buf );
-  char *key = bstart;
-  int keylen = dbBE_Redis_create_key_cmd( req, key,
-                                          dbBE_Transport_sr_buffer_remaining( buf ) >= DBBE_REDIS_MAX_KEY_LEN ? DBBE_REDIS_MAX_KEY_LEN : dbBE_Transport_sr_buffer_remaining( buf ) );
-  if( keylen < 0 )
-    return keylen;
-  if( dbBE_Transport_sr_buffer_add_data( buf, keylen, 1 ) != (size_t)keylen )
-    goto error;
-
-  sge[0].iov_base = key;
-  sge[0].iov_len = keylen;
+  dbBE_Redis_key_sge_t key;
+  int rc = dbBE_Redis_create_key_cmd( req, buf, &key );
+  if( rc < 0 )
+    return rc;
 
-  char incbuf[ 32 ];
-  int len = snprintf( incbuf, 31, "%d", increment );
-  if( dbBE_Redis_command_create_sr_buffer_field( buf, incbuf, len, &sge[ 1 ] ) != 0 )
+  if( dbBE_Redis_command_create_sr_buffer_int( buf, increment, &sge[ 1 ] ) != 0 )
     goto error;
 
-  return dbBE_Redis_command_create_sgeN_uncheck( req->_step, sge, cmd );
+  return dbBE_Redis_command_encode( req->_step, &key, sge, cmd );
 
 error:
   dbBE_Transport_sr_buffer_rewind_available_to( buf, bstart );
@@ -832,24 +643,16 @@ int dbBE_Redis_command_delcheck_create( dbBE_Redis_request_t *req,
 
   // create and insert key
   char *bstart = dbBE_Transport_sr_buffer_get_available_position( buf );
-  char *key = bstart;
-  int keylen = dbBE_Redis_create_key_cmd( req, key,
-                                          dbBE_Transport_sr_buffer_remaining( buf ) >= DBBE_REDIS_MAX_KEY_LEN ? DBBE_REDIS_MAX_KEY_LEN : dbBE_Transport_sr_buffer_remaining( buf ) );
-  if( keylen < 0 )
-    return keylen;
-  if( dbBE_Transport_sr_buffer_add_data( buf, keylen, 1 ) != (size_t)keylen )
-    goto error;
-
-  sge[0].iov_base = key;
-  sge[0].iov_len = keylen;
+  dbBE_Redis_key_sge_t key;
+  int rc = dbBE_Redis_create_key_cmd( req, buf, &key );
+  if( rc < 0 )
+    return rc;
 
   // create and insert decrement value
-  char incbuf[ 32 ];
-  int len = snprintf( incbuf, 31, "%d", increment );
-  if( dbBE_Redis_command_create_sr_buffer_field( buf, incbuf, len, &sge[ 1 ] ) != 0 )
+  if( dbBE_Redis_command_create_sr_buffer_int( buf, increment, &sge[ 1 ] ) != 0 )
     goto error;
 
-  return dbBE_Redis_command_create_sgeN_uncheck( stage, sge, cmd );
+  return dbBE_Redis_command_encode( stage, &key, sge, cmd );
 
 error:
   dbBE_Transport_sr_buffer_rewind_available_to( buf, bstart );
@@ -887,7 +690,8 @@ int dbBE_Redis_command_scan_create( dbBE_Redis_request_t *request,
   args[ 1 ].iov_base = key->iov_base;
   args[ 1 ].iov_len = key->iov_len;
 
-  return dbBE_Redis_command_create_sgeN_uncheck( stage, args, cmd );
+  // arg 0 is the cursor, not a key
+  return dbBE_Redis_command_encode( stage, NULL, args, cmd );
 }
 
 int dbBE_Redis_command_rpush_create( dbBE_Redis_request_t *request,
@@ -901,19 +705,23 @@ int dbBE_Redis_command_rpush_create( dbBE_Redis_request_t *request,
     return -EINVAL;
 
   // create key
-  char *key = dbBE_Transport_sr_buffer_get_available_position( buf );
-  int keylen = dbBE_Redis_create_key_cmd( request, key,
-                                          dbBE_Transport_sr_buffer_remaining( buf ) >= DBBE_REDIS_MAX_KEY_LEN ? DBBE_REDIS_MAX_KEY_LEN : dbBE_Transport_sr_buffer_remaining( buf ) );
-  dbBE_Transport_sr_buffer_add_data( buf, keylen, 1 );
+  char *bstart = dbBE_Transport_sr_buffer_get_available_position( buf );
+  dbBE_Redis_key_sge_t key;
+  rc = dbBE_Redis_create_key_cmd( request, buf, &key );
+  if( rc < 0 )
+  {
+    LOG( DBG_ERR, stderr, "Failed to create PUT key. rc=%d\n", rc );
+    return rc;
+  }
 
   // insert key into cmd sge
   dbBE_sge_t args[2];
-  args[0].iov_base = key;
-  args[0].iov_len = keylen;
+  args[0].iov_base = NULL;
+  args[0].iov_len = 0;
   args[1].iov_base = "";  // add empty dummy argument as the value
   args[1].iov_len = 0;
 
-  rc = dbBE_Redis_command_create_sgeN_uncheck( stage, args, cmd );
+  rc = dbBE_Redis_command_encode( stage, &key, args, cmd );
   if( rc < 0 )
   {
     LOG( DBG_ERR, stderr, "Failed to create PUT cmd+key. rc=%d\n", rc );
@@ -924,16 +732,13 @@ int dbBE_Redis_command_rpush_create( dbBE_Redis_request_t *request,
   size_t vallen = dbBE_SGE_get_len( request->_user->_sge, request->_user->_sge_count );
 
   // insert lenth-prefix to buffer
-  char *valpre = dbBE_Transport_sr_buffer_get_available_position( buf );
-  if( dbBE_Transport_sr_buffer_remaining( buf ) <= (log10( vallen + 1 ) + 3 ) )  // pre-check if there's enough space for the prefix
-    return -E2BIG;
-
-  int valprelen = snprintf( valpre, dbBE_Transport_sr_buffer_remaining( buf ), "$%ld\r\n", vallen );
-  if( valprelen < 4 )
+  if( dbBE_Transport_sr_buffer_remaining( buf ) < DBBE_REDIS_ENCODE_HEAD_MAX )  // pre-check if there's enough space for the prefix
   {
-    dbBE_Transport_sr_buffer_rewind_available_to( buf, key );
+    dbBE_Transport_sr_buffer_rewind_available_to( buf, bstart );
     return -E2BIG;
   }
+  char *valpre = dbBE_Transport_sr_buffer_get_available_position( buf );
+  int valprelen = dbBE_Redis_encode_bulk_head( valpre, vallen );
   dbBE_Transport_sr_buffer_add_data( buf, valprelen, 1 );
   int idx = rc;
 
@@ -950,7 +755,7 @@ int dbBE_Redis_command_rpush_create( dbBE_Redis_request_t *request,
   idx += request->_user->_sge_count;
 
   // terminate
-  cmd[ idx ].iov_base = &stage->_command[2];
+  cmd[ idx ].iov_base = (void*)dbBE_Redis_command_crlf;
   cmd[ idx ].iov_len = 2;
   ++idx;
 
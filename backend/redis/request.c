@@ -26,6 +26,9 @@
 #include <errno.h>
 
 #include "request.h"
+#include "common/pool.h"
+
+static dbBE_Pool_t gRedis_request_pool = DBBE_POOL_INITIALIZER( sizeof( dbBE_Redis_request_t ), DBBE_REDIS_POOL_CACHED );
 
 
  /*
@@ -36,7 +39,7 @@ dbBE_Redis_request_t* dbBE_Redis_request_allocate( dbBE_Request_t *user )
   if( user == NULL )
     return NULL;
 
-  dbBE_Redis_request_t *request = (dbBE_Redis_request_t*)malloc( sizeof( dbBE_Redis_request_t ) );
+  dbBE_Redis_request_t *request = (dbBE_Redis_request_t*)dbBE_Pool_get( &gRedis_request_pool );
   if( request == NULL )
     return NULL;
 
@@ -53,9 +56,25 @@ void dbBE_Redis_request_destroy( dbBE_Redis_request_t *request )
   if( request == NULL )
     return;
 
+  dbBE_Redis_request_key_release( &request->_key );
+
   // do not destroy any potential completion here because completions live longer than requests
   memset( request, 0, sizeof( dbBE_Redis_request_t ) );
-  free( request );
+  dbBE_Pool_put( &gRedis_request_pool, request );
+}
+
+void dbBE_Redis_request_key_release( dbBE_Redis_request_key_t *key )
+{
+  if(( key->_data != NULL ) && ( key->_data != key->_inline ))
+    free( key->_data );
+  key->_data = NULL;
+  key->_ns = NULL;
+  key->_name = NULL;
+}
+
+void dbBE_Redis_request_pool_drain( void )
+{
+  dbBE_Pool_drain( &gRedis_request_pool );
 }
 
 int dbBE_Redis_request_stage_transition( dbBE_Redis_request_t *request )
@@ -85,3 +104,15 @@ int dbBE_Redis_request_stage_transition( dbBE_Redis_request_t *request )
   request->_step = &gRedis_command_spec[ request->_user->_opcode * DBBE_REDIS_COMMAND_STAGE_MAX + stage ];
   return 0;
 }
+
+int dbBE_Redis_request_stage_set( dbBE_Redis_request_t *request, const int stage )
+{
+  if(( request == NULL ) || ( request->_user == NULL ))
+    return -EINVAL;
+
+  if(( stage < 0 ) || ( stage >= DBBE_REDIS_COMMAND_STAGE_MAX ))
+    return -ERANGE;
+
+  request->_step = &gRedis_command_spec[ request->_user->_opcode * DBBE_REDIS_COMMAND_STAGE_MAX + stage ];
+  return 0;
+}
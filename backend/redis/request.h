@@ -82,6 +82,24 @@ typedef struct dbBE_Redis_request_location
   dbBE_Redis_request_location_data_t _data;
 } dbBE_Redis_request_location_t;
 
+/*
+ * the Redis key of a request, rendered once as complete bulk string argument "$<len>\r\n[ns::]name\r\n"
+ * the command SGEs of all stages reference it, it's only rebuilt if a stage uses a different key (e.g. MOVE)
+ */
+#define DBBE_REDIS_REQUEST_KEY_INLINE ( 128 )
+
+typedef struct dbBE_Redis_request_key
+{
+  char *_data; // the bulk string; points to _inline or to heap memory for long keys
+  const void *_ns; // namespace and name that the key was built from
+  const char *_name;
+  uint16_t _len; // length of the bulk string
+  uint16_t _head; // length of the bulk string header (the key starts at _data + _head)
+  uint16_t _key_len; // length of the key
+  dbBE_Redis_hash_slot_t _slot; // hash slot of the key
+  char _inline[ DBBE_REDIS_REQUEST_KEY_INLINE ];
+} dbBE_Redis_request_key_t;
+
 typedef struct dbBE_Redis_request
 {
   dbBE_Redis_intern_data_t _status;  // allows to keep some state to keep track of multistage-multinode request processing
@@ -89,6 +107,8 @@ typedef struct dbBE_Redis_request
   dbBE_Redis_command_stage_spec_t *_step;
   dbBE_Completion_t *_completion;  // multi-stage requests with early completions need to hold that here
   dbBE_Redis_request_location_t _location; // where this request should go (in case we know)
+  dbBE_Redis_request_key_t _key; // key and hash slot of the current stage
+  int _asking; // redirected by ASK: the next send is prefixed with ASKING and its reply is skipped
   struct dbBE_Redis_request *_next;
 } dbBE_Redis_request_t;
 
@@ -102,11 +122,26 @@ dbBE_Redis_request_t* dbBE_Redis_request_allocate( dbBE_Request_t *user );
  */
 void dbBE_Redis_request_destroy( dbBE_Redis_request_t *request );
 
+/*
+ * release heap memory of the request key (if any)
+ */
+void dbBE_Redis_request_key_release( dbBE_Redis_request_key_t *key );
+
+/*
+ * release the cached requests (at back-end exit)
+ */
+void dbBE_Redis_request_pool_drain( void );
+
 
 /*
  * transition a request to the next stage
  */
 int dbBE_Redis_request_stage_transition( dbBE_Redis_request_t *request );
 
+/*
+ * switch a request to a given stage of its command (e.g. for alternative stages)
+ */
+int dbBE_Redis_request_stage_set( dbBE_Redis_request_t *request, const int stage );
+
 
 #endif /* BACKEND_REDIS_REQUEST_H_ */
@@ -0,0 +1,144 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef BACKEND_REDIS_SCAN_H_
+#define BACKEND_REDIS_SCAN_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined( __AVX2__ ) || defined( __SSE2__ )
+#include <immintrin.h>
+#endif
+
+/*
+ * byte scanning helpers of the RESP parser
+ * the vector width is picked at compile time: AVX2, SSE2, or a scalar fallback
+ */
+
+#if defined( __AVX2__ )
+#define DBBE_REDIS_SCAN_IMPL "avx2"
+#elif defined( __SSE2__ )
+#define DBBE_REDIS_SCAN_IMPL "sse2"
+#else
+#define DBBE_REDIS_SCAN_IMPL "scalar"
+#endif
+
+/*
+ * find the first "\r\n" with both bytes inside the first limit bytes of p
+ * returns a pointer to the '\r' or NULL
+ */
+static inline
+char* dbBE_Redis_scan_crlf( const char *p, const int64_t limit )
+{
+  int64_t i = 0;
+
+#if defined( __AVX2__ )
+  const __m256i cr32 = _mm256_set1_epi8( '\r' );
+  const __m256i lf32 = _mm256_set1_epi8( '\n' );
+  // compare each position for '\r' and the next position for '\n' at once
+  for( ; i + 33 <= limit; i += 32 )
+  {
+    __m256i c = _mm256_loadu_si256( (const __m256i*)( p + i ) );
+    __m256i n = _mm256_loadu_si256( (const __m256i*)( p + i + 1 ) );
+    uint32_t mask = (uint32_t)_mm256_movemask_epi8( _mm256_and_si256( _mm256_cmpeq_epi8( c, cr32 ),
+                                                                       _mm256_cmpeq_epi8( n, lf32 ) ) );
+    if( mask != 0 )
+      return (char*)( p + i + __builtin_ctz( mask ) );
+  }
+#endif
+
+#if defined( __AVX2__ ) || defined( __SSE2__ )
+  const __m128i cr16 = _mm_set1_epi8( '\r' );
+  const __m128i lf16 = _mm_set1_epi8( '\n' );
+  for( ; i + 17 <= limit; i += 16 )
+  {
+    __m128i c = _mm_loadu_si128( (const __m128i*)( p + i ) );
+    __m128i n = _mm_loadu_si128( (const __m128i*)( p + i + 1 ) );
+    unsigned mask = (unsigned)_mm_movemask_epi8( _mm_and_si128( _mm_cmpeq_epi8( c, cr16 ),
+                                                                _mm_cmpeq_epi8( n, lf16 ) ) );
+    if( mask != 0 )
+      return (char*)( p + i + __builtin_ctz( mask ) );
+  }
+#endif
+
+  // scalar tail (or everything without vector support)
+  while( i + 1 < limit )
+  {
+    const char *cr = (const char*)memchr( p + i, '\r', limit - i - 1 );
+    if( cr == NULL )
+      return NULL;
+    if( cr[1] == '\n' )
+      return (char*)cr;
+    i = cr - p + 1;
+  }
+  return NULL;
+}
+
+/*
+ * decode up to 8 decimal digits at once (SWAR, little-endian only)
+ * returns the number of leading digits of p (0..8) and sets *value if the digits are
+ * followed by a non-digit within the 8 bytes; returns -1 if all 8 bytes are digits
+ * requires 8 readable bytes at p
+ */
+static inline
+int dbBE_Redis_scan_digits8( const char *p, uint64_t *value )
+{
+#if defined( __BYTE_ORDER__ ) && ( __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ )
+  uint64_t v;
+  memcpy( &v, p, sizeof( v ) );
+
+  // a byte is a digit if its high nibble is 3 and adding 6 does not overflow the low nibble
+  // a carry out of a non-digit byte can only corrupt bytes behind the first non-digit
+  uint64_t nondigit = ( ( v & 0xF0F0F0F0F0F0F0F0ull ) ^ 0x3030303030303030ull )
+                    | ( ( ( v + 0x0606060606060606ull ) & 0xF0F0F0F0F0F0F0F0ull ) ^ 0x3030303030303030ull );
+  if( nondigit == 0 )
+    return -1;
+
+  int n = __builtin_ctzll( nondigit ) >> 3;
+  if( n == 0 )
+  {
+    *value = 0;
+    return 0;
+  }
+
+  // right-align the digits (leading zero bytes decode to 0) and combine pairs, quads, octets
+  v <<= ( 8 - n ) * 8;
+  v = (( v & 0x0F0F0F0F0F0F0F0Full ) * 2561 ) >> 8;
+  v = (( v & 0x00FF00FF00FF00FFull ) * 6553601 ) >> 16;
+  v = (( v & 0x0000FFFF0000FFFFull ) * 42949672960001ull ) >> 32;
+  *value = v;
+  return n;
+#else
+  uint64_t v = 0;
+  int n;
+  for( n = 0; n < 8; ++n )
+  {
+    unsigned digit = (unsigned char)p[ n ] - '0';
+    if( digit > 9 )
+    {
+      *value = v;
+      return n;
+    }
+    v = v * 10 + digit;
+  }
+  return -1;
+#endif
+}
+
+#endif /* BACKEND_REDIS_SCAN_H_ */
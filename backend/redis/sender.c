@@ -23,6 +23,7 @@
 
 #include <stddef.h>
 #include <stdio.h>
+#include <string.h> // memmove
 
 #include "logutil.h"
 #include "../common/completion_queue.h"
@@ -30,14 +31,16 @@
 #include "create.h"
 #include "complete.h"
 #include "iterator.h"
+#include "worker.h"
 
-typedef struct dbBE_Redis_sender_args
-{
-  dbBE_Redis_context_t *_backend;
-  int _looping;
-} dbBE_Redis_sender_args_t;
+typedef dbBE_Redis_io_args_t dbBE_Redis_sender_args_t;
+
+/*
+ * prefix for a request that got redirected by ASK to the node importing its slot
+ */
+static char dbBE_Redis_asking_cmd[] = "*1\r\n$6\r\nASKING\r\n";
 
-int dbBE_Redis_create_send_error( dbBE_Completion_queue_t *cq, dbBE_Redis_request_t *request, int error )
+int dbBE_Redis_create_send_error( dbBE_Redis_context_t *backend, dbBE_Redis_request_t *request, int error )
 {
   dbBE_Completion_t *completion = dbBE_Redis_complete_error( request,
                                                              error,
@@ -45,10 +48,9 @@ int dbBE_Redis_create_send_error( dbBE_Completion_queue_t *cq, dbBE_Redis_reques
   dbBE_Redis_request_destroy( request );
   if( completion != NULL )
   {
-    if( dbBE_Completion_queue_push( cq, completion ) != 0 )
+    if( dbBE_Redis_completion_push( backend, completion ) != 0 )
     {
-      free( completion );
-      dbBE_Redis_request_destroy( request );
+      dbBE_Redis_completion_release( completion );
       fprintf( stderr, "RedisBE: Failed to queue send-error completion.\n" );
     }
   }
@@ -64,6 +66,7 @@ int dbBE_Redis_cmd_stage_needs_rekeying( dbBE_Redis_request_t *request )
   int check = 0;
   check += (( request->_step->_stage == 0 ) && ( request->_user->_opcode != DBBE_OPCODE_ITERATOR )); // all first-stage requests need to get checked (except iterators)
   check += ( request->_user->_opcode == DBBE_OPCODE_MOVE ); // MOVE cmd needs re-keying for each stage
+  check += ( request->_user->_opcode == DBBE_OPCODE_STAT ); // STAT might start with the count stage
   check += (( request->_user->_opcode == DBBE_OPCODE_NSDETACH ) && ( request->_step->_stage == DBBE_REDIS_NSDETACH_STAGE_DELNS ) );
   return check;
 }
@@ -73,6 +76,11 @@ dbBE_Redis_request_t* dbBE_Redis_request_preprocess( dbBE_Redis_context_t *backe
 {
   if(( request == NULL ) || ( backend == NULL ))
     return request;
+
+  // stat requests without space for the value size don't need the metadata script
+  if(( request->_user->_opcode == DBBE_OPCODE_STAT ) && ( request->_user->_sge[0].iov_len < 2 * sizeof( int64_t )))
+    dbBE_Redis_request_stage_set( request, DBBE_REDIS_STAT_STAGE_COUNT );
+
   if( request->_user->_opcode == DBBE_OPCODE_ITERATOR )
   {
     dbBE_Redis_iterator_t *it = request->_status.iterator._it;
@@ -83,7 +91,7 @@ dbBE_Redis_request_t* dbBE_Redis_request_preprocess( dbBE_Redis_context_t *backe
     // iterator with no data but end-of cycle is invalid
     if(( it != NULL ) && ( it->_cache_count == 0 ) && ( it->_connection == NULL ))
     {
-      dbBE_Redis_create_send_error( backend->_compl_q, request, DBR_ERR_ITERATOR );
+      dbBE_Redis_create_send_error( backend, request, DBR_ERR_ITERATOR );
       return NULL;
     }
 
@@ -94,7 +102,7 @@ dbBE_Redis_request_t* dbBE_Redis_request_preprocess( dbBE_Redis_context_t *backe
       it = dbBE_Redis_iterator_new( backend->_iterators );
       if( it == NULL )
       {
-        dbBE_Redis_create_send_error( backend->_compl_q, request, DBR_ERR_ITERATOR );
+        dbBE_Redis_create_send_error( backend, request, DBR_ERR_ITERATOR );
         return NULL;
       }
       request->_status.iterator._it = it;
@@ -112,7 +120,7 @@ dbBE_Redis_request_t* dbBE_Redis_request_preprocess( dbBE_Redis_context_t *backe
       }
       if( i == DBBE_REDIS_MAX_CONNECTIONS )
       {
-        dbBE_Redis_create_send_error( backend->_compl_q, request, DBR_ERR_NOCONNECT );
+        dbBE_Redis_create_send_error( backend, request, DBR_ERR_NOCONNECT );
         return NULL;
       }
       request->_location._type = DBBE_REDIS_REQUEST_LOCATION_TYPE_CONNECTION;
@@ -157,12 +165,12 @@ dbBE_Redis_request_t* dbBE_Redis_request_preprocess( dbBE_Redis_context_t *backe
 
         if( completion == NULL )
         {
-          dbBE_Redis_create_send_error( backend->_compl_q, request, DBR_ERR_BE_GENERAL );
+          dbBE_Redis_create_send_error( backend, request, DBR_ERR_BE_GENERAL );
           return NULL;
         }
-        if( dbBE_Completion_queue_push( backend->_compl_q, completion ) != 0 )
+        if( dbBE_Redis_completion_push( backend, completion ) != 0 )
         {
-          free( completion );
+          dbBE_Redis_completion_release( completion );
           dbBE_Redis_request_destroy( request );
           fprintf( stderr, "RedisBE: Failed to queue completion.\n" );
           return NULL;
@@ -170,7 +178,7 @@ dbBE_Redis_request_t* dbBE_Redis_request_preprocess( dbBE_Redis_context_t *backe
       }
       else // iterator is complete/empty/invalid
       {
-        dbBE_Redis_create_send_error( backend->_compl_q, request, DBR_ERR_ITERATOR );
+        dbBE_Redis_create_send_error( backend, request, DBR_ERR_ITERATOR );
         return NULL;
       }
       dbBE_Redis_request_destroy( request );
@@ -181,15 +189,24 @@ dbBE_Redis_request_t* dbBE_Redis_request_preprocess( dbBE_Redis_context_t *backe
 }
 
 static
-dbBE_Redis_request_t* dbBE_Redis_sender_acquire_request( dbBE_Redis_context_t *backend )
+dbBE_Redis_request_t* dbBE_Redis_sender_acquire_request( dbBE_Redis_context_t *backend,
+                                                         dbBE_Redis_worker_t *worker )
 {
   // check for any activity according to priority
   //  - request shelf (anything that had to wait because of broken connections)
+  //  - requests forwarded by other workers (already checked for cancellation)
   //  - repeat/multistage/redirect (anything that needs an additional iteration)
   //  - new user requests
   dbBE_Redis_request_t *request = NULL; // todo: pick from shelf
   dbBE_Request_t *user_req = NULL;
 
+  if( worker != NULL )
+  {
+    request = dbBE_Redis_s2r_queue_pop( worker->_inbox );
+    if( request != NULL )
+      return request;
+  }
+
   do
   {
     if( request == NULL )
@@ -197,7 +214,7 @@ dbBE_Redis_request_t* dbBE_Redis_sender_acquire_request( dbBE_Redis_context_t *b
 
     if( request == NULL )
     {
-      user_req = dbBE_Request_queue_pop( backend->_work_q );
+      user_req = (dbBE_Request_t*)dbBE_Ring_pop( backend->_work_q );
       if( user_req != NULL )
         request = dbBE_Redis_request_allocate( user_req );
     }
@@ -213,10 +230,9 @@ dbBE_Redis_request_t* dbBE_Redis_sender_acquire_request( dbBE_Redis_context_t *b
       dbBE_Completion_t *completion = dbBE_Redis_complete_cancel( request );
 
       if( completion != NULL )
-        if( dbBE_Completion_queue_push( backend->_compl_q, completion ) != 0 )
+        if( dbBE_Redis_completion_push( backend, completion ) != 0 )
         {
-          free( completion );
-          dbBE_Redis_request_destroy( request );
+          dbBE_Redis_completion_release( completion );
           fprintf( stderr, "RedisBE: Failed to queue completion.\n" );
           // todo: save the status to mark the request for cleanup during the next stages
         }
@@ -245,10 +261,10 @@ dbBE_Redis_connection_t* dbBE_Redis_sender_find_connection( dbBE_Redis_context_t
    */
   if( dbBE_Redis_cmd_stage_needs_rekeying( request ) != 0 )
   {
-    char keybuffer[ DBBE_REDIS_MAX_KEY_LEN ];
-    if( dbBE_Redis_create_key( request, keybuffer, DBBE_REDIS_MAX_KEY_LEN ) < 0 )
+    // the key and its slot are only rendered again if the stage uses a different key
+    if( dbBE_Redis_create_request_key( request ) < 0 )
     {
-      dbBE_Redis_create_send_error( backend->_compl_q, request, DBR_ERR_INVALID );
+      dbBE_Redis_create_send_error( backend, request, DBR_ERR_INVALID );
       return NULL;
     }
 
@@ -257,7 +273,7 @@ dbBE_Redis_connection_t* dbBE_Redis_sender_find_connection( dbBE_Redis_context_t
      * unless it's a redirect (ASK) which directly contains
      * a direct connection pointer for temporary requesting a different server
      */
-    uint16_t slot = dbBE_Redis_locator_hash( keybuffer, strnlen( keybuffer, DBBE_REDIS_MAX_KEY_LEN ) );
+    dbBE_Redis_hash_slot_t slot = request->_key._slot;
     if( request->_location._type != DBBE_REDIS_REQUEST_LOCATION_TYPE_CONNECTION )
     {
       request->_location._data._conn_idx = dbBE_Redis_locator_get_conn_index( backend->_locator, slot );
@@ -269,7 +285,7 @@ dbBE_Redis_connection_t* dbBE_Redis_sender_find_connection( dbBE_Redis_context_t
 
     if( request->_location._type == DBBE_REDIS_REQUEST_LOCATION_TYPE_UNKNOWN )
     {
-      dbBE_Redis_create_send_error( backend->_compl_q, request, DBR_ERR_NOCONNECT );
+      dbBE_Redis_create_send_error( backend, request, DBR_ERR_NOCONNECT );
       return NULL;
     }
   }
@@ -283,8 +299,72 @@ dbBE_Redis_connection_t* dbBE_Redis_sender_find_connection( dbBE_Redis_context_t
   return conn;
 }
 
+/*
+ * blocking cmds must not stall the pipeline of a regular connection
+ * if no dedicated connection is available, fall back to the non-blocking (polling) stage
+ */
+static
+dbBE_Redis_connection_t* dbBE_Redis_sender_blocking_connection( dbBE_Redis_context_t *backend,
+                                                                dbBE_Redis_request_t *request,
+                                                                dbBE_Redis_connection_t *conn )
+{
+  dbBE_Redis_connection_t *bconn = dbBE_Redis_connection_mgr_get_blocking( backend->_conn_mgr, conn );
+  if( bconn != NULL )
+    return bconn;
+
+  LOG( DBG_VERBOSE, stderr, "No blocking connection available (errno=%d). Polling instead.\n", errno );
+  dbBE_Redis_request_stage_set( request, 0 );
+  return conn;
+}
+
+/*
+ * check server connections,
+ * fail requests only if situation is not recoverable
+ */
+dbBE_Redis_connection_recoverable_t dbBE_Redis_sender_recover( dbBE_Redis_context_t *backend )
+{
+  // a refreshed slot map might already fix what's broken
+  dbBE_Redis_slotmap_refresh_apply( backend );
+
+  if( dbBE_Redis_locator_hash_covered( backend->_locator ) != 0 )
+    return DBBE_REDIS_CONNECTION_RECOVERED;
+
+  dbBE_Redis_connection_recoverable_t recoverable = dbBE_Redis_connection_mgr_conn_recover(
+      backend->_conn_mgr,
+      backend->_locator,
+      &( backend->_cluster_info ) );
+
+  switch( recoverable )
+  {
+    case DBBE_REDIS_CONNECTION_RECOVERABLE:  // recoverable but not yet recovered
+      break;
+    case DBBE_REDIS_CONNECTION_RECOVERED: // recovered
+      // a replacement server starts out without blocking connections
+      dbBE_Redis_connection_mgr_blocking_links( backend->_conn_mgr );
+      break;
+    case DBBE_REDIS_CONNECTION_UNRECOVERABLE: // not recoverable at the moment
+      LOG(DBG_ERR, stderr, "Unrecoverable cluster connection. Completing all requests as failed.\n")
+      // intentionally no break
+    default: // unrecognized
+    {
+      // flush queues
+      dbBE_Redis_request_t *request;
+      int w;
+      while( ( request = dbBE_Redis_s2r_queue_pop( backend->_retry_q )) != NULL )
+        dbBE_Redis_create_send_error( backend, request, DBR_ERR_NOCONNECT );
+      for( w = 0; w < backend->_worker_count; ++w )
+        while( ( request = dbBE_Redis_s2r_queue_pop( backend->_workers[ w ]._inbox )) != NULL )
+          dbBE_Redis_create_send_error( backend, request, DBR_ERR_NOCONNECT );
+      break;
+    }
+  }
+  return recoverable;
+}
+
 /*
  * sender function, creates requests to redis
+ * with a worker, it only sends to the connections owned by that worker
+ * and forwards requests for other connections to their owner
  */
 void* dbBE_Redis_sender( void *args )
 {
@@ -303,49 +383,40 @@ void* dbBE_Redis_sender( void *args )
     return NULL;
   }
 
+  dbBE_Redis_worker_t *worker = input->_worker;
+  dbBE_Redis_sr_buffer_t *sender_buffer = input->_backend->_sender_buffer;
+  int *pending_conn = input->_backend->_sender_connections;
+  dbBE_Redis_uring_t *ring = input->_backend->_conn_mgr->_ev_mgr->_uring;
+  if( worker != NULL )
+  {
+    sender_buffer = worker->_sender_buffer;
+    pending_conn = worker->_sender_connections;
+    ring = worker->_uring;
+  }
+
+  dbBE_Redis_context_lock( input->_backend );
+
   int pending_last = -1;
   int request_limit = DBBE_REDIS_COALESCED_MAX * dbBE_Redis_connection_mgr_get_connections( input->_backend->_conn_mgr );
 
-  /*
-   * check server connections,
-   * fail requests only if situation is not recoverable
-   */
-  if( dbBE_Redis_locator_hash_covered( input->_backend->_locator ) == 0 )
+  if(( dbBE_Redis_locator_hash_covered( input->_backend->_locator ) == 0 ) ||
+      ( dbBE_Redis_slotmap_refresh_ready( input->_backend ) ))
   {
-    dbBE_Redis_connection_recoverable_t recoverable = dbBE_Redis_connection_mgr_conn_recover(
-        input->_backend->_conn_mgr,
-        input->_backend->_locator,
-        &( input->_backend->_cluster_info ) );
-
-    switch( recoverable )
+    // recovery and slot map updates touch all connections, workers have to leave it to the worker loop
+    if( worker != NULL )
     {
-      case DBBE_REDIS_CONNECTION_RECOVERABLE:  // recoverable but not yet recovered
-        goto skip_sending;
-        break;
-      case DBBE_REDIS_CONNECTION_RECOVERED: // recovered
-        // nothing to do, we're good to continue
-        break;
-      case DBBE_REDIS_CONNECTION_UNRECOVERABLE: // not recoverable at the moment
-        LOG(DBG_ERR, stderr, "Unrecoverable cluster connection. Completing all requests as failed.\n")
-        // intentionally no break
-      default: // unrecognized
-      {
-        // flush queues
-        dbBE_Redis_request_t *request;
-        while( ( request = dbBE_Redis_s2r_queue_pop( input->_backend->_retry_q )) != NULL )
-          dbBE_Redis_create_send_error( input->_backend->_compl_q, request, DBR_ERR_NOCONNECT );
-        return NULL;
-        break;
-      }
+      input->_backend->_recover = 1;
+      goto skip_sending;
     }
+    if( dbBE_Redis_sender_recover( input->_backend ) != DBBE_REDIS_CONNECTION_RECOVERED )
+      goto skip_sending;
   }
 
   dbBE_Redis_request_t *request = NULL;
-  int *pending_conn = input->_backend->_sender_connections;
 
   while(( --request_limit > 0 ) && ( pending_last < DBBE_REDIS_COALESCED_MAX * dbBE_Redis_connection_mgr_get_connections( input->_backend->_conn_mgr ) ))
   {
-    request = dbBE_Redis_sender_acquire_request( input->_backend );
+    request = dbBE_Redis_sender_acquire_request( input->_backend, worker );
     if( request == NULL )
       break;
 
@@ -367,11 +438,21 @@ void* dbBE_Redis_sender( void *args )
       break;
     }
 
+    if(( worker != NULL ) && ( conn->_worker != worker->_id ))
+    {
+      if( dbBE_Redis_worker_forward( input->_backend, conn->_worker, request ) != 0 )
+        dbBE_Redis_create_send_error( input->_backend, request, DBR_ERR_BE_GENERAL );
+      continue;
+    }
+
+    if( request->_step->_blocking != 0 )
+      conn = dbBE_Redis_sender_blocking_connection( input->_backend, request, conn );
+
     // create_command assembles an SGE list
     // entries either come directly from user or from send buffer
     // when complete, connection.send() fires the assembled data
     dbBE_sge_t *cmd = dbBE_Transport_sge_buffer_get_current( conn->_cmd );
-    rc = dbBE_Redis_create_command_sge( request, input->_backend->_sender_buffer, cmd );
+    rc = dbBE_Redis_create_command_sge( request, sender_buffer, cmd );
     if( rc < 0 )
     {
       LOG( DBG_ERR, stderr, "Failed to create command. rc=%d\n", rc );
@@ -379,8 +460,27 @@ void* dbBE_Redis_sender( void *args )
       break;
     }
 
+    // a request redirected by ASK goes to the importing node once, prefixed with ASKING
+    // any later attempt or stage is located by its slot again
+    if( request->_asking != 0 )
+    {
+      if( (unsigned)rc + 1 > dbBE_Transport_sge_buffer_remain( conn->_cmd ) )
+      {
+        LOG( DBG_ERR, stderr, "No SGE space left to prefix ASKING\n" );
+        rc = -ENOMSG;
+        break;
+      }
+      memmove( &cmd[ 1 ], cmd, rc * sizeof( dbBE_sge_t ) );
+      cmd[ 0 ].iov_base = dbBE_Redis_asking_cmd;
+      cmd[ 0 ].iov_len = sizeof( dbBE_Redis_asking_cmd ) - 1;
+      ++rc;
+      request->_location._type = DBBE_REDIS_REQUEST_LOCATION_TYPE_SLOT;
+      request->_location._data._conn_idx = dbBE_Redis_locator_get_conn_index( input->_backend->_locator,
+                                                                              request->_key._slot );
+    }
+
     // update cmd buffer status for this connection
-    if( dbBE_Transport_sge_buffer_add( conn->_cmd, rc ) > ( (DBBE_SGE_MAX << 4) * 3 ))
+    if( dbBE_Transport_sge_buffer_add( conn->_cmd, rc ) > ( (DBBE_SGE_MAX >> 2) * 3 ))
       request_limit = 1; // if we exceed 75% of the SGE space, we better stop to avoid blowing the limit with the next request
 
     // instead of sending, add connection to a pending connections list
@@ -399,10 +499,17 @@ void* dbBE_Redis_sender( void *args )
   }
 
 skip_sending:
+  // only the owner of a connection sends, so this doesn't need the lock
+  dbBE_Redis_context_unlock( input->_backend );
+
   // before triggering the receiver, do the post on all pending connections
   while( pending_last >= 0 )
   {
-    rc = dbBE_Redis_connection_send_cmd( dbBE_Redis_connection_mgr_get_connection_at( input->_backend->_conn_mgr, pending_conn[ pending_last ] ) );
+    dbBE_Redis_connection_t *conn = dbBE_Redis_connection_mgr_get_connection_at( input->_backend->_conn_mgr, pending_conn[ pending_last ] );
+    if( ring != NULL )
+      rc = dbBE_Redis_uring_send( ring, conn );
+    else
+      rc = dbBE_Redis_connection_send_cmd( conn );
     if( rc < 0 )
     {
       LOG( DBG_ERR, stderr, "Failed to send command. rc=%d\n", rc );
@@ -410,7 +517,10 @@ skip_sending:
     }
     --pending_last;
   }
-  dbBE_Transport_sr_buffer_reset( input->_backend->_sender_buffer );
+  // the io_uring engine only queued the commands; send them all with a single syscall
+  if(( ring != NULL ) && (( rc = dbBE_Redis_uring_send_flush( ring )) < 0 ))
+    LOG( DBG_ERR, stderr, "Failed to send commands. rc=%d\n", rc );
+  dbBE_Transport_sr_buffer_reset( sender_buffer );
 
   // complete the request with an error
   //dbBE_Redis_create_error( request, input->_backend->_compl_q );
@@ -421,10 +531,10 @@ skip_sending:
 
 void dbBE_Redis_sender_trigger( dbBE_Redis_context_t *backend )
 {
-  dbBE_Redis_sender_args_t *args = (dbBE_Redis_sender_args_t*)malloc( sizeof( dbBE_Redis_sender_args_t ) );
-  args->_backend = backend;
-  args->_looping = 1;
-  dbBE_Redis_sender( (void*) args );
-  dbBE_Redis_receiver( (void*) args );
-  free( args );
+  dbBE_Redis_sender_args_t args;
+  args._backend = backend;
+  args._looping = 1;
+  args._worker = NULL;
+  dbBE_Redis_sender( (void*) &args );
+  dbBE_Redis_receiver( (void*) &args );
 }
@@ -165,6 +165,55 @@ error:
   return NULL;
 }
 
+/*
+ * create server info from a slot range and a list of urls (master first)
+ */
+dbBE_Redis_server_info_t* dbBE_Redis_server_info_create_range( const int first_slot,
+                                                               const int last_slot,
+                                                               char **urls,
+                                                               const int count )
+{
+  if(( urls == NULL ) || ( count <= 0 ) || ( count > DBBE_REDIS_CLUSTER_MAX_REPLICA ) ||
+      ( first_slot < 0 ) || ( last_slot >= DBBE_REDIS_HASH_SLOT_MAX ) || ( first_slot > last_slot ))
+    return NULL;
+
+  dbBE_Redis_server_info_t *si = (dbBE_Redis_server_info_t*)calloc( 1, sizeof( dbBE_Redis_server_info_t ) );
+  if( si == NULL )
+  {
+    LOG( DBG_ERR, stderr, "Unable to allocate sufficient memory for server info\n" );
+    return NULL;
+  }
+
+  si->_urls = (char*)calloc( DBR_SERVER_URL_MAX_LENGTH * (DBBE_REDIS_CLUSTER_MAX_REPLICA + 1 ), sizeof( char ) );
+  if( si->_urls == NULL )
+  {
+    LOG( DBG_ERR, stderr, "Unable to allocate sufficient memory to hold master+replica urls\n" );
+    goto error;
+  }
+
+  int replica;
+  for( replica = 0; replica < count; ++replica )
+  {
+    if(( urls[ replica ] == NULL ) || ( strlen( urls[ replica ] ) >= DBR_SERVER_URL_MAX_LENGTH ))
+    {
+      LOG( DBG_ERR, stderr, "Invalid server url at index %d.\n", replica );
+      goto error;
+    }
+    si->_servers[ replica ] = &(si->_urls[ DBR_SERVER_URL_MAX_LENGTH * replica ]);
+    strcpy( si->_servers[ replica ], urls[ replica ] );
+  }
+  si->_first_slot = first_slot;
+  si->_last_slot = last_slot;
+  si->_server_count = count;
+  si->_master = si->_servers[ 0 ];
+
+  return si;
+error:
+  if( si != NULL )
+    dbBE_Redis_server_info_destroy( si );
+  return NULL;
+}
+
 
 int dbBE_Redis_server_info_destroy( dbBE_Redis_server_info_t *si )
 {
@@ -99,6 +99,14 @@ dbBE_Redis_server_info_t* dbBE_Redis_server_info_create( dbBE_Redis_result_t *si
  */
 dbBE_Redis_server_info_t* dbBE_Redis_server_info_create_single( char *url );
 
+/*
+ * create server info from a slot range and a list of urls (master first)
+ */
+dbBE_Redis_server_info_t* dbBE_Redis_server_info_create_range( const int first_slot,
+                                                               const int last_slot,
+                                                               char **urls,
+                                                               const int count );
+
 /*
  * cleanup and free the server info structure
  */
@@ -163,11 +163,75 @@ int main( int argc, char ** argv )
   dbBE_Redis_connection_mgr_exit( NULL );
   rc += TEST( dbBE_Redis_connection_mgr_get_connections( mgr ), 1 );
 
+  // blocking connections are linked up front, a pool per server; get_blocking() never connects
+  rc += TEST( dbBE_Redis_connection_mgr_blocking_links( NULL ), -EINVAL );
+  rc += TEST( dbBE_Redis_connection_mgr_blocking_links( mgr ), 0 );
+  rc += TEST( dbBE_Redis_connection_mgr_blocking_links( mgr ), 0 );
+  rc += TEST( dbBE_Redis_connection_mgr_get_connections( mgr ), 1 );
+  int blocking = 0;
+  for( i = 0; i < DBBE_REDIS_MAX_CONNECTIONS; ++i )
+    if( mgr->_blocking[ i ] != NULL )
+    {
+      rc += TEST( dbBE_Redis_connection_get_status( mgr->_blocking[ i ] ), DBBE_CONNECTION_STATUS_AUTHORIZED );
+      ++blocking;
+    }
+  rc += TEST( blocking, DBBE_REDIS_BLOCKING_CONNECTIONS );
+  rc += TEST( dbBE_Redis_connection_mgr_is_blocking( mgr, dbBE_Redis_connection_mgr_get_blocking( mgr, conn ) ), 1 );
+  for( i = 0; i < DBBE_REDIS_MAX_CONNECTIONS; ++i )
+    if( mgr->_blocking[ i ] != NULL )
+      rc += TEST( dbBE_Redis_connection_mgr_conn_fail( mgr, mgr->_blocking[ i ] ), 0 );
+  rc += TEST( dbBE_Redis_connection_mgr_get_blocking( mgr, conn ), NULL );
+  rc += TEST( errno, EBUSY );
+  rc += TEST( dbBE_Redis_connection_mgr_get_connections( mgr ), 1 );
+  TEST_LOG( rc, "blocking links" );
 
   // remove the connection and expect an empty mgr
   rc += TEST( dbBE_Redis_connection_mgr_rm( mgr, conn ), 0 );
   rc += TEST( dbBE_Redis_connection_mgr_get_connections( mgr ), 0 );
 
+  // concurrent links: one per url, the unreachable one fails
+  char *urls[ 3 ] = { host, host, "sock://localhost:1" };
+  dbBE_Redis_connection_t *links[ 3 ];
+  rc += TEST( dbBE_Redis_connection_mgr_newlinks( NULL, urls, 3, links ), -EINVAL );
+  rc += TEST( dbBE_Redis_connection_mgr_newlinks( mgr, urls, -1, links ), -EINVAL );
+  rc += TEST( dbBE_Redis_connection_mgr_newlinks( mgr, urls, 3, links ), 1 );
+  rc += TEST( dbBE_Redis_connection_mgr_get_connections( mgr ), 2 );
+  rc += TEST( dbBE_Redis_connection_get_status( links[ 0 ] ), DBBE_CONNECTION_STATUS_AUTHORIZED );
+  rc += TEST( dbBE_Redis_connection_get_status( links[ 1 ] ), DBBE_CONNECTION_STATUS_AUTHORIZED );
+  rc += TEST( links[ 2 ], NULL );
+
+  // both links go to the same server, which gets a single pool of blocking connections
+  rc += TEST( dbBE_Redis_connection_mgr_blocking_links( mgr ), 0 );
+  int pooled = 0;
+  for( i = 0; i < DBBE_REDIS_MAX_CONNECTIONS; ++i )
+    if( mgr->_blocking[ i ] != NULL )
+    {
+      rc += TEST( dbBE_Redis_connection_get_status( mgr->_blocking[ i ] ), DBBE_CONNECTION_STATUS_AUTHORIZED );
+      rc += TEST( dbBE_Redis_connection_mgr_conn_fail( mgr, mgr->_blocking[ i ] ), 0 );
+      ++pooled;
+    }
+  rc += TEST( pooled, DBBE_REDIS_BLOCKING_CONNECTIONS );
+  rc += TEST( dbBE_Redis_connection_mgr_get_connections( mgr ), 2 );
+
+  for( i = 0; i < 2; ++i )
+  {
+    rc += TEST( dbBE_Redis_connection_mgr_rm( mgr, links[ i ] ), 0 );
+    rc += TEST( dbBE_Redis_connection_unlink( links[ i ] ), 0 );
+    dbBE_Redis_connection_destroy( links[ i ] );
+  }
+  rc += TEST( dbBE_Redis_connection_mgr_get_connections( mgr ), 0 );
+  TEST_LOG( rc, "newlinks" );
+
+  // slot map query through a private connection leaves the mgr untouched
+  rc += TEST( dbBE_Redis_connection_mgr_query_cluster_info( NULL, host ), NULL );
+  rc += TEST( dbBE_Redis_connection_mgr_query_cluster_info( mgr, NULL ), NULL );
+  rc += TEST( dbBE_Redis_connection_mgr_query_cluster_info( mgr, "sock://localhost:1" ), NULL );
+  dbBE_Redis_cluster_info_t *qci = dbBE_Redis_connection_mgr_query_cluster_info( mgr, host );
+  if( qci != NULL ) // only a cluster reports a slot map
+    rc += TEST( dbBE_Redis_cluster_info_destroy( qci ), 0 );
+  rc += TEST( dbBE_Redis_connection_mgr_get_connections( mgr ), 0 );
+  TEST_LOG( rc, "query cluster info" );
+
   // fill the connmgr with connections
   for( i = 0; i < flimit; ++i )
   {
@@ -19,6 +19,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
 
 #include "../backend/redis/redis.h"
 #include "common/utility.h"
@@ -27,6 +31,52 @@
 
 #define DBBE_TEST_BUFFER_LEN ( 1024 )
 
+/*
+ * waiting for the AUTH reply has to end on a reply, a peer shutdown, or the deadline
+ */
+static
+int test_auth_complete()
+{
+  int rc = 0;
+  int sv[ 2 ];
+  struct timespec now;
+
+  dbBE_Redis_connection_t *aconn = dbBE_Redis_connection_create( DBBE_TEST_BUFFER_LEN );
+  rc += TEST_NOT( aconn, NULL );
+  if( aconn == NULL )
+    return rc;
+
+  rc += TEST( dbBE_Redis_connection_auth_complete( NULL, NULL ), -EINVAL );
+  rc += TEST( dbBE_Redis_connection_auth_complete( aconn, NULL ), -EINVAL );
+
+  // accepted and rejected passphrase
+  rc += TEST( socketpair( AF_UNIX, SOCK_STREAM, 0, sv ), 0 );
+  aconn->_socket = sv[0];
+  aconn->_status = DBBE_CONNECTION_STATUS_CONNECTED;
+  rc += TEST( write( sv[1], "-ERR invalid password\r\n", 23 ), 23 );
+  rc += TEST( dbBE_Redis_connection_auth_complete( aconn, NULL ), -EPERM );
+  rc += TEST( dbBE_Redis_connection_get_status( aconn ), DBBE_CONNECTION_STATUS_CONNECTED );
+  rc += TEST( write( sv[1], "+OK\r\n", 5 ), 5 );
+  rc += TEST( dbBE_Redis_connection_auth_complete( aconn, NULL ), 0 );
+  rc += TEST( dbBE_Redis_connection_get_status( aconn ), DBBE_CONNECTION_STATUS_AUTHORIZED );
+
+  // no reply before the deadline
+  aconn->_status = DBBE_CONNECTION_STATUS_CONNECTED;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  rc += TEST( dbBE_Redis_connection_auth_complete( aconn, &now ), -ETIMEDOUT );
+
+  // peer went away
+  close( sv[1] );
+  rc += TEST( dbBE_Redis_connection_auth_complete( aconn, NULL ), -ECONNRESET );
+
+  close( sv[0] );
+  aconn->_socket = -1;
+  aconn->_status = DBBE_CONNECTION_STATUS_DISCONNECTED;
+  dbBE_Redis_connection_destroy( aconn );
+  TEST_LOG( rc, "auth_complete" );
+  return rc;
+}
+
 int main( int argc, char ** argv )
 {
   int rc = 0;
@@ -42,6 +92,8 @@ int main( int argc, char ** argv )
   rc += TEST( dbBE_Redis_connection_get_status( conn ), DBBE_CONNECTION_STATUS_INITIALIZED );
   fprintf(stderr,"0. rc=%d\n", rc);
 
+  rc += test_auth_complete();
+
 
   char *url = dbBE_Extract_env( DBR_SERVER_HOST_ENV, DBR_SERVER_DEFAULT_HOST );
   rc += TEST_NOT( url, NULL );
@@ -81,6 +133,14 @@ int main( int argc, char ** argv )
   rc += TEST( addr, NULL );
   rc += TEST( dbBE_Redis_connection_get_status( conn ), DBBE_CONNECTION_STATUS_DISCONNECTED );
 
+  addr = dbBE_Redis_connection_link( conn, "unix://", auth );
+  rc += TEST( addr, NULL );
+  rc += TEST( dbBE_Redis_connection_get_status( conn ), DBBE_CONNECTION_STATUS_DISCONNECTED );
+
+  addr = dbBE_Redis_connection_link( conn, "unix:///NON_EXISTDIR/redis.sock", auth );
+  rc += TEST( addr, NULL );
+  rc += TEST( dbBE_Redis_connection_get_status( conn ), DBBE_CONNECTION_STATUS_DISCONNECTED );
+
 
   dbBE_Redis_sr_buffer_t *rbuf = dbBE_Transport_dbuffer_get_active( conn->_recvbuf );
 
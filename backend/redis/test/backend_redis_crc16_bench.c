@@ -0,0 +1,134 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * micro benchmark: per-key cost of the hash slot calculation
+ * compares the table-driven crc16 with the previous bitwise implementation
+ * usage: backend_redis_crc16_bench [iterations]
+ */
+
+#include "test_utils.h"
+#include "../crc16.h"
+#include "../locator.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_KEY_COUNT ( 1024 )
+#define BENCH_KEY_LEN ( 64 )
+
+/*
+ * the previous implementation: allocates a zero-padded copy and computes the crc bit by bit
+ */
+static
+int crcremainder_bitwise( const char * message, const uint16_t size )
+{
+  char * paddedmsg;
+  unsigned int remain = 0x0000;
+  unsigned int mask;
+  unsigned char byte;
+  int len = size;
+
+  if(( message == NULL ) || ( size == 0 ))
+    return -EINVAL;
+
+  if( len > DBBE_REDIS_MAX_KEY_LEN )
+    return -ENAMETOOLONG;
+
+  paddedmsg = malloc( len + 2 );
+  memcpy( paddedmsg, message, len );
+  memset( &paddedmsg[len], 0, 2 );
+  len += 2;
+
+  int i;
+  for( i=0; i<len; i++ )
+  {
+    byte = paddedmsg[i];
+    mask = 0x80;
+    while( mask > 0 )
+    {
+      remain <<= 1;
+      if( byte & mask ) remain += 1;
+      mask >>= 1;
+      if( remain > 0xffff )
+      {
+        remain &= 0xffff;
+        remain ^= 0x1021;
+      }
+    }
+  }
+  free( paddedmsg );
+  return remain;
+}
+
+static
+double now_nsec()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main( int argc, char ** argv )
+{
+  int rc = 0;
+  long iterations = ( argc > 1 ) ? strtol( argv[1], NULL, 10 ) : 1000;
+  if( iterations <= 0 )
+    iterations = 1000;
+
+  // keys that look like the ones created by the back-end: <namespace>::<tuple name>
+  char keys[ BENCH_KEY_COUNT ][ BENCH_KEY_LEN ];
+  uint16_t lens[ BENCH_KEY_COUNT ];
+  int k;
+  int mismatch = 0;
+  for( k=0; k<BENCH_KEY_COUNT; ++k )
+  {
+    snprintf( keys[k], BENCH_KEY_LEN, "benchns::tuple_name_%d", k * 7919 );
+    lens[k] = strlen( keys[k] );
+    mismatch += ( crcremainder( keys[k], lens[k] ) != crcremainder_bitwise( keys[k], lens[k] ) );
+  }
+  rc += TEST( mismatch, 0 );
+  TEST_BREAK( rc, "table-driven and bitwise crc differ" );
+
+  volatile unsigned sink = 0;
+  long i;
+  double start = now_nsec();
+  for( i=0; i<iterations; ++i )
+    for( k=0; k<BENCH_KEY_COUNT; ++k )
+      sink += crcremainder_bitwise( keys[k], lens[k] );
+  double bitwise = ( now_nsec() - start ) / ( (double)iterations * BENCH_KEY_COUNT );
+
+  start = now_nsec();
+  for( i=0; i<iterations; ++i )
+    for( k=0; k<BENCH_KEY_COUNT; ++k )
+      sink += crcremainder( keys[k], lens[k] );
+  double table = ( now_nsec() - start ) / ( (double)iterations * BENCH_KEY_COUNT );
+
+  start = now_nsec();
+  for( i=0; i<iterations; ++i )
+    for( k=0; k<BENCH_KEY_COUNT; ++k )
+      sink += dbBE_Redis_locator_hash( keys[k], lens[k] );
+  double slot = ( now_nsec() - start ) / ( (double)iterations * BENCH_KEY_COUNT );
+
+  printf( "crc16 per key (avg len %d): bitwise=%.1fns table=%.1fns (%.1fx) locator_hash=%.1fns\n",
+          lens[ BENCH_KEY_COUNT / 2 ], bitwise, table, bitwise / table, slot );
+
+  printf( "Test exiting with rc=%d\n", rc );
+  return rc;
+}
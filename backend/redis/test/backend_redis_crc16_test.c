@@ -52,6 +52,12 @@ int main(int argc, char * argv[])
   rc += TEST( crcremainder( msg, 9 ), 0x1e7a );
   TEST_LOG( rc, "Regular CRC failed" );
 
+  // odd and even lengths take different paths through the table lookup
+  rc += TEST( crcremainder( "foo", 3 ), 0xaf96 );
+  rc += TEST( crcremainder( "fo", 2 ), 0x3cc5 );
+  rc += TEST( crcremainder( "f", 1 ), 0x0c60 );
+  TEST_LOG( rc, "Odd/even length CRC failed" );
+
 
   if (argc < 2)
     free( msg );
@@ -0,0 +1,299 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+ * micro benchmark: command creation of PUT, GET, and READ requests
+ * compares the compiled command encoders with the previous sprintf-based command creation
+ * usage: backend_redis_create_bench [iterations [key-length]]
+ */
+
+#include "test_utils.h"
+#include "../create.h"
+#include "../protocol.h"
+#include "../namespace.h"
+#include "../definitions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <inttypes.h>
+#include <math.h>
+#include <time.h>
+
+#define BENCH_COMMANDS ( 16 )
+#define BENCH_VALUE_LEN ( 64 )
+
+/*
+ * the previous key creation: format the complete key argument into the buffer
+ */
+static __attribute__((noinline))
+int create_key_sprintf( const char *ns_name, const char *key, char *keybuf, uint16_t size )
+{
+  int keylen = strnlen( ns_name, size ) + DBBE_REDIS_NAMESPACE_SEPARATOR_LEN + strnlen( key, size );
+  int len = snprintf( keybuf, size, "$%d\r\n%s%s%s\r\n",
+                      keylen,
+                      ns_name,
+                      DBBE_REDIS_NAMESPACE_SEPARATOR,
+                      key );
+  if(( len < 0 ) || ( len >= size ))
+    return -EMSGSIZE;
+  return len;
+}
+
+/*
+ * the previous command assembly: parse the command template for every request
+ */
+static __attribute__((noinline))
+int create_sge_template( char *command, const int array_len, dbBE_sge_t *args, dbBE_sge_t *cmd )
+{
+  char *cmdptr = command;
+  char *cmdend = command + strlen( command );
+  int cmd_idx = 0;
+
+  while(( cmdptr < cmdend ))
+  {
+    char *loc = index( cmdptr, '%' );
+    if( loc == NULL )
+      break;
+    if( loc != cmdptr )
+    {
+      cmd[ cmd_idx ].iov_base = cmdptr;
+      cmd[ cmd_idx ].iov_len = (size_t)(loc - cmdptr);
+      cmdptr += cmd[ cmd_idx ].iov_len;
+      ++cmd_idx;
+    }
+    int idx = (int)loc[1] - 48;
+    if(( idx < 0 ) || ( idx >= array_len ))
+      return -EBADMSG;
+    if( args[ idx ].iov_base == NULL )
+      break;
+    if( args[ idx ].iov_len > 0 )
+    {
+      cmd[ cmd_idx ].iov_base = args[ idx ].iov_base;
+      cmd[ cmd_idx ].iov_len = args[ idx ].iov_len;
+      ++cmd_idx;
+    }
+    cmdptr = loc + 2;
+  }
+  if( cmdptr < cmdend )
+  {
+    cmd[ cmd_idx ].iov_base = cmdptr;
+    cmd[ cmd_idx ].iov_len = (size_t)( cmdend - cmdptr );
+    ++cmd_idx;
+  }
+  return cmd_idx;
+}
+
+/*
+ * the previous command creation of PUT, GET, and READ
+ */
+static
+int create_command_sprintf( dbBE_Redis_request_t *req, dbBE_Redis_sr_buffer_t *buf, dbBE_sge_t *cmd )
+{
+  dbBE_Redis_command_stage_spec_t *stage = req->_step;
+  char *key = dbBE_Transport_sr_buffer_get_available_position( buf );
+  int keylen = create_key_sprintf( dbBE_Redis_namespace_get_name( (dbBE_Redis_namespace_t*)req->_user->_ns_hdl ),
+                                   req->_user->_key,
+                                   key,
+                                   DBBE_REDIS_MAX_KEY_LEN );
+  if( keylen < 0 )
+    return keylen;
+  dbBE_Transport_sr_buffer_add_data( buf, keylen, 1 );
+
+  dbBE_sge_t args[ 3 ];
+  args[0].iov_base = key;
+  args[0].iov_len = keylen;
+  args[1].iov_base = NULL;
+  args[1].iov_len = 0;
+  args[2].iov_base = NULL;
+  args[2].iov_len = 0;
+
+  int idx = 0;
+  switch( req->_user->_opcode )
+  {
+    case DBBE_OPCODE_PUT:
+    {
+      args[1].iov_base = "";
+      idx = create_sge_template( stage->_command, stage->_array_len, args, cmd );
+      size_t vallen = dbBE_SGE_get_len( req->_user->_sge, req->_user->_sge_count );
+      char *valpre = dbBE_Transport_sr_buffer_get_available_position( buf );
+      int valprelen = snprintf( valpre, dbBE_Transport_sr_buffer_remaining( buf ), "$%ld\r\n", vallen );
+      dbBE_Transport_sr_buffer_add_data( buf, valprelen, 1 );
+      cmd[ idx ].iov_base = valpre;
+      cmd[ idx ].iov_len = valprelen;
+      ++idx;
+      memcpy( &cmd[ idx ], req->_user->_sge, req->_user->_sge_count * sizeof( dbBE_sge_t ) );
+      idx += req->_user->_sge_count;
+      cmd[ idx ].iov_base = &stage->_command[2];
+      cmd[ idx ].iov_len = 2;
+      ++idx;
+      break;
+    }
+    case DBBE_OPCODE_GET:
+      idx = create_sge_template( stage->_command, stage->_array_len, args, cmd );
+      break;
+    case DBBE_OPCODE_READ:
+    {
+      int64_t uindex = req->_user->_flags >> 4;
+      int uindex_len = uindex == 0 ? 1 : (int64_t)( log10( uindex )) + 1;
+      char *lindex = dbBE_Transport_sr_buffer_get_available_position( buf );
+      int lindex_len = snprintf( lindex, dbBE_Transport_sr_buffer_remaining( buf ),
+                                 "$%d\r\n%ld\r\n", uindex_len, uindex );
+      dbBE_Transport_sr_buffer_add_data( buf, lindex_len, 1 );
+      args[1].iov_base = lindex;
+      args[1].iov_len = lindex_len;
+      idx = create_sge_template( stage->_command, stage->_array_len, args, cmd );
+      break;
+    }
+    default:
+      return -ENOSYS;
+  }
+  return idx;
+}
+
+static
+size_t flatten( dbBE_sge_t *cmd, int cmdlen, char *dest )
+{
+  size_t len = 0;
+  int n;
+  for( n = 0; n < cmdlen; ++n )
+  {
+    memcpy( dest + len, cmd[ n ].iov_base, cmd[ n ].iov_len );
+    len += cmd[ n ].iov_len;
+  }
+  dest[ len ] = '\0';
+  return len;
+}
+
+static
+double now_nsec()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+typedef int (*create_fn_t)( dbBE_Redis_request_t *, dbBE_Redis_sr_buffer_t *, dbBE_sge_t * );
+
+/*
+ * create batches of commands like the sender does between two sends
+ * returns ns per command
+ */
+static
+double run( create_fn_t create, dbBE_Redis_request_t *req, dbBE_Redis_sr_buffer_t *buf,
+            dbBE_sge_t *cmd, const long iterations, int *rc )
+{
+  double start = now_nsec();
+  long i;
+  for( i = 0; i < iterations; ++i )
+  {
+    dbBE_Transport_sr_buffer_reset( buf );
+    int sges = 0;
+    int n;
+    for( n = 0; n < BENCH_COMMANDS; ++n )
+    {
+      int len = create( req, buf, &cmd[ sges ] );
+      if( len < 0 )
+      {
+        ++(*rc);
+        return 0.0;
+      }
+      sges += len;
+    }
+  }
+  return ( now_nsec() - start ) / ( iterations * BENCH_COMMANDS );
+}
+
+int main( int argc, char ** argv )
+{
+  int rc = 0;
+  long iterations = ( argc > 1 ) ? strtol( argv[1], NULL, 10 ) : 200000;
+  if( iterations <= 0 )
+    iterations = 200000;
+  int keylen = ( argc > 2 ) ? atoi( argv[2] ) : 16;
+  if(( keylen <= 0 ) || ( keylen >= DBR_MAX_KEY_LEN ))
+    keylen = 16;
+
+  dbBE_Redis_command_stage_spec_t *specs = NULL;
+  dbBE_Redis_namespace_t *ns = NULL;
+  rc += TEST_NOT_RC( dbBE_Redis_command_stages_spec_init(), NULL, specs );
+  rc += TEST_NOT_RC( dbBE_Redis_namespace_create( "BenchSpace" ), NULL, ns );
+  TEST_BREAK( rc, "initialization failed" );
+
+  char *key = (char*)calloc( 1, keylen + 1 );
+  memset( key, 'k', keylen );
+  char value[ BENCH_VALUE_LEN ];
+  memset( value, 'v', BENCH_VALUE_LEN );
+
+  dbBE_Request_t *ureq = (dbBE_Request_t*)calloc( 1, sizeof( dbBE_Request_t ) + sizeof( dbBE_sge_t ) );
+  ureq->_key = key;
+  ureq->_ns_hdl = ns;
+  ureq->_flags = 1234 << 4;
+  ureq->_sge_count = 1;
+  ureq->_sge[0].iov_base = value;
+  ureq->_sge[0].iov_len = BENCH_VALUE_LEN;
+
+  dbBE_Redis_sr_buffer_t *buf = dbBE_Transport_sr_buffer_allocate( DBBE_REDIS_MAX_KEY_LEN * BENCH_COMMANDS * 4 );
+  dbBE_sge_t *cmd = (dbBE_sge_t*)calloc( DBBE_SGE_MAX, sizeof( dbBE_sge_t ) );
+  char *ref = (char*)calloc( 1, DBBE_REDIS_MAX_KEY_LEN * 4 );
+  char *out = (char*)calloc( 1, DBBE_REDIS_MAX_KEY_LEN * 4 );
+
+  printf( "key length: %d, value length: %d, commands per batch: %d\n", keylen, BENCH_VALUE_LEN, BENCH_COMMANDS );
+
+  const dbBE_Opcode ops[] = { DBBE_OPCODE_PUT, DBBE_OPCODE_GET, DBBE_OPCODE_READ };
+  const char *names[] = { "PUT", "GET", "READ" };
+  unsigned o;
+  for( o = 0; o < sizeof( ops ) / sizeof( ops[0] ); ++o )
+  {
+    ureq->_opcode = ops[ o ];
+    dbBE_Redis_request_t *req = dbBE_Redis_request_allocate( ureq );
+    rc += TEST_NOT( req, NULL );
+    TEST_BREAK( rc, "request allocation failed" );
+
+    // both paths have to create the same byte stream
+    int len;
+    dbBE_Transport_sr_buffer_reset( buf );
+    len = create_command_sprintf( req, buf, cmd );
+    rc += TEST( len > 0, 1 );
+    flatten( cmd, len, ref );
+    dbBE_Transport_sr_buffer_reset( buf );
+    len = dbBE_Redis_create_command_sge( req, buf, cmd );
+    rc += TEST( len > 0, 1 );
+    flatten( cmd, len, out );
+    rc += TEST( strcmp( ref, out ), 0 );
+    TEST_BREAK( rc, "command creation mismatch" );
+    int sges = len;
+
+    double old = run( create_command_sprintf, req, buf, cmd, iterations, &rc );
+    double compiled = run( dbBE_Redis_create_command_sge, req, buf, cmd, iterations, &rc );
+    printf( "%-4s: sprintf=%.1f ns/cmd compiled=%.1f ns/cmd (%.1fx) sges=%d\n",
+            names[ o ], old, compiled, old / compiled, sges );
+
+    dbBE_Redis_request_destroy( req );
+  }
+
+  free( out );
+  free( ref );
+  free( cmd );
+  dbBE_Transport_sr_buffer_free( buf );
+  free( ureq );
+  free( key );
+  rc += TEST( dbBE_Redis_namespace_destroy( ns ), 0 );
+  dbBE_Redis_command_stages_spec_destroy( specs );
+  printf( "Test exiting with rc=%d\n", rc );
+  return rc;
+}
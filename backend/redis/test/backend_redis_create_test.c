@@ -16,6 +16,7 @@
  */
 
 #include <math.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 #ifdef __APPLE__
@@ -33,6 +34,7 @@
 
 #include "../backend/redis/create.h"
 #include "../backend/redis/protocol.h"
+#include "../backend/redis/encode.h"
 #include "../backend/transports/memcopy.h"
 
 #define DBBE_TEST_BUFFER_LEN ( 1024 )
@@ -57,12 +59,13 @@ int Flatten_cmd( dbBE_sge_t *cmd, int cmdlen, dbBE_Redis_sr_buffer_t *dest )
   return 0;
 }
 
-extern int dbBE_Redis_create_key_cmd( dbBE_Redis_request_t *request, char *keybuf, uint16_t size );
-
 int key_creation_test()
 {
   dbBE_Request_t *ureq = (dbBE_Request_t*)calloc( 1, sizeof( dbBE_Request_t ) + 2 * sizeof( dbBE_sge_t ) );
   dbBE_Redis_sr_buffer_t *buf = dbBE_Transport_sr_buffer_allocate( DBBE_REDIS_MAX_KEY_LEN * 10 );
+  dbBE_Redis_sr_buffer_t *flat = dbBE_Transport_sr_buffer_allocate( DBBE_REDIS_MAX_KEY_LEN * 2 );
+  dbBE_Redis_namespace_t *ns = dbBE_Redis_namespace_create( "test" );
+  dbBE_Redis_namespace_t *moved_ns = dbBE_Redis_namespace_create( "moved" );
 
   int rc = 0;
   char *reference = (char*)malloc(DBBE_REDIS_MAX_KEY_LEN);
@@ -74,8 +77,8 @@ int key_creation_test()
   ureq->_next = NULL;
   ureq->_sge_count = 1;
   ureq->_user = NULL;
-  ureq->_sge[0].iov_base = "moved";
-  ureq->_sge[0].iov_len = 5;
+  ureq->_sge[0].iov_base = moved_ns; // destination namespace of the move
+  ureq->_sge[0].iov_len = sizeof( dbBE_Redis_namespace_t* );
 
   dbBE_Redis_request_t *req = dbBE_Redis_request_allocate( ureq );
   if( req == NULL )
@@ -98,7 +101,7 @@ int key_creation_test()
         break;
         break;
       default:
-        ureq->_ns_hdl = "test";
+        ureq->_ns_hdl = ns;
         if( req->_step->_expect == dbBE_REDIS_TYPE_UNSPECIFIED )
           return 10000;
         break;
@@ -113,22 +116,30 @@ int key_creation_test()
         if( refkeylen < 0 )
           rc = 50;
 
-        char *key = dbBE_Transport_sr_buffer_get_available_position( buf );
-        int keylen = dbBE_Redis_create_key_cmd( req, key,
-                                                dbBE_Transport_sr_buffer_remaining( buf ) >= DBBE_REDIS_MAX_KEY_LEN ? DBBE_REDIS_MAX_KEY_LEN : dbBE_Transport_sr_buffer_remaining( buf ) );
-        if( keylen < 0 )
+        dbBE_Transport_sr_buffer_reset( buf );
+        dbBE_Redis_key_sge_t key;
+        int keylen = dbBE_Redis_create_key_cmd( req, buf, &key );
+        if(( keylen <= 0 ) || ( keylen > DBBE_REDIS_KEY_SGE_MAX ))
         {
           rc = 100;
           free( ureq->_key );
           continue;
         }
 
-        if(( key == NULL ) || ( ureq->_key == NULL ))
+        if( ureq->_key == NULL )
           return ENOMEM;
 
+        // the flattened key has to be the reference key with bulk string header and terminator
+        if( Flatten_cmd( key._sge, key._count, flat ) != 0 )
+          rc = 200;
+        char *key_str = dbBE_Transport_sr_buffer_get_start( flat );
         double loglen = log10( refkeylen ) + 1;
         int key_in_buf = (int)( loglen ) + 3;
-        if( strncmp( reference, &key[ key_in_buf ], refkeylen ) )
+        if( strtol( &key_str[1], NULL, 10 ) != refkeylen )
+          rc = n+1;
+        if( strncmp( reference, &key_str[ key_in_buf ], refkeylen ) )
+          rc = n+1;
+        if( strcmp( &key_str[ key_in_buf + refkeylen ], "\r\n" ) )
           rc = n+1;
 
         free( ureq->_key );
@@ -136,6 +147,9 @@ int key_creation_test()
     } while (( dbBE_Redis_request_stage_transition( req ) == 0 ) && ( rc == 0 ));
   }
   dbBE_Redis_request_destroy( req );
+  dbBE_Redis_namespace_destroy( moved_ns );
+  dbBE_Redis_namespace_destroy( ns );
+  dbBE_Transport_sr_buffer_free( flat );
   dbBE_Transport_sr_buffer_free( buf );
   free( reference );
   free( ureq );
@@ -144,6 +158,45 @@ int key_creation_test()
 
 
 
+int encode_test()
+{
+  int rc = 0;
+  char buf[ DBBE_REDIS_ENCODE_HEAD_MAX + 16 ];
+  char ref[ DBBE_REDIS_ENCODE_HEAD_MAX + 16 ];
+  const int64_t values[] = { 0, 1, 9, 10, 99, 100, 101, 999, 1000, 9999, 10000, 12345678, 123456789,
+                             -1, -10, -12345, INT64_MAX, INT64_MIN };
+  unsigned n;
+  for( n = 0; n < sizeof( values ) / sizeof( values[0] ); ++n )
+  {
+    int len = dbBE_Redis_encode_int( buf, values[ n ] );
+    buf[ len ] = '\0';
+    rc += TEST( len, snprintf( ref, sizeof( ref ), "%"PRId64, values[ n ] ) );
+    rc += TEST( strcmp( buf, ref ), 0 );
+
+    len = dbBE_Redis_encode_line( buf, ':', values[ n ] );
+    buf[ len ] = '\0';
+    rc += TEST( len, snprintf( ref, sizeof( ref ), ":%"PRId64"\r\n", values[ n ] ) );
+    rc += TEST( strcmp( buf, ref ), 0 );
+  }
+
+  int len = dbBE_Redis_encode_uint( buf, UINT64_MAX );
+  buf[ len ] = '\0';
+  rc += TEST( strcmp( buf, "18446744073709551615" ), 0 );
+
+  len = dbBE_Redis_encode_bulk_head( buf, 1024 );
+  buf[ len ] = '\0';
+  rc += TEST( strcmp( buf, "$1024\r\n" ), 0 );
+
+  len = dbBE_Redis_encode_bulk_string( buf, "Hello", 5 );
+  buf[ len ] = '\0';
+  rc += TEST( strcmp( buf, "$5\r\nHello\r\n" ), 0 );
+
+  len = dbBE_Redis_encode_bulk_string( buf, NULL, 0 );
+  buf[ len ] = '\0';
+  rc += TEST( strcmp( buf, "$0\r\n\r\n" ), 0 );
+  return rc;
+}
+
 int main( int argc, char ** argv )
 {
   int rc = 0;
@@ -445,7 +498,7 @@ int main( int argc, char ** argv )
   dbBE_Transport_sr_buffer_reset( sr_buf );
   rc += TEST_RC( dbBE_Redis_create_command_sge( req,
                                                 sr_buf,
-                                                cmd ), 2, cmdlen );
+                                                cmd ), 4, cmdlen );
   rc += TEST( Flatten_cmd( cmd, cmdlen, data_buf ), 0 );
   rc += TEST( strcmp( "*2\r\n$3\r\nDEL\r\n$11\r\nTestNS::bla\r\n", // delkeys uses the key only (the prefix is already in the key, internally)
                       dbBE_Transport_sr_buffer_get_start( data_buf ) ),
@@ -625,6 +678,7 @@ int main( int argc, char ** argv )
   free(ureq);
 
   rc += key_creation_test();
+  rc += encode_test();
 
   dbBE_Redis_namespace_destroy( target_ns );
   dbBE_Redis_namespace_destroy( ns );
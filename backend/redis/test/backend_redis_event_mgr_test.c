@@ -96,6 +96,36 @@ int main( int argc, char **argv )
   close( conn->_socket );
   dbBE_Redis_connection_destroy( conn );
 
+  /////////////////////////////////////////////////////////
+  //  testing harvest()
+  // separate mgr: the unconnected socket above would be reported as hung up
+  dbBE_Redis_event_mgr_t *hmgr = dbBE_Redis_event_mgr_init( timeout );
+  rc += TEST_NOT( hmgr, NULL );
+  dbBE_Redis_connection_t *ready[ 4 ];
+  rc += TEST( dbBE_Redis_event_mgr_harvest( NULL, ready, 4 ), -EINVAL );
+  rc += TEST( dbBE_Redis_event_mgr_harvest( hmgr, NULL, 4 ), -EINVAL );
+  rc += TEST( dbBE_Redis_event_mgr_harvest( hmgr, ready, 0 ), -EINVAL );
+
+  // a connection with pending data is harvested exactly once
+  int sv[ 2 ];
+  rc += TEST( socketpair( AF_UNIX, SOCK_STREAM, 0, sv ), 0 );
+  dbBE_Redis_connection_t *pconn = dbBE_Redis_connection_create( DBBE_REDIS_SR_BUFFER_LEN );
+  rc += TEST_NOT( pconn, NULL );
+  TEST_BREAK( rc, "socket pair setup failed" );
+  pconn->_socket = sv[0];
+  pconn->_index = 2;
+  rc += TEST( dbBE_Redis_event_mgr_add( hmgr, pconn ), 0 );
+  rc += TEST( write( sv[1], "+OK\r\n", 5 ), 5 );
+  rc += TEST( dbBE_Redis_event_mgr_harvest( hmgr, ready, 4 ), 1 );
+  rc += TEST( ready[0], pconn );
+  rc += TEST( dbBE_Redis_event_mgr_harvest( hmgr, ready, 4 ), 0 );
+  rc += TEST( dbBE_Redis_event_mgr_rm( hmgr, pconn ), 0 );
+  dbBE_Redis_connection_destroy( pconn );
+  rc += TEST( dbBE_Redis_event_mgr_exit( hmgr ), 0 );
+  close( sv[0] );
+  close( sv[1] );
+  TEST_LOG( rc, "harvest testing" );
+
   TEST_BREAK( rc, "Error injection tests failed." );
 
   /////////////////////////////////////////////////////////
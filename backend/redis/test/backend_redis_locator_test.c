@@ -96,6 +96,21 @@ int main( int argc, char ** argv )
   // destroy the locator
   rc += TEST( dbBE_Redis_locator_destroy( locator ), 0 );
 
+  // hash slots as computed by Redis (CLUSTER KEYSLOT)
+  rc += TEST( dbBE_Redis_locator_hash( "foo", 3 ), 12182 );
+  rc += TEST( dbBE_Redis_locator_hash( "bar", 3 ), 5061 );
+
+  // hash tags: only the first non-empty {...} section is hashed
+  rc += TEST( dbBE_Redis_locator_hash( "{user1000}.following", 20 ), dbBE_Redis_locator_hash( "user1000", 8 ) );
+  rc += TEST( dbBE_Redis_locator_hash( "{user1000}.followers", 20 ), dbBE_Redis_locator_hash( "user1000", 8 ) );
+  rc += TEST( dbBE_Redis_locator_hash( "foo{bar}{zap}", 13 ), dbBE_Redis_locator_hash( "bar", 3 ) );
+  rc += TEST( dbBE_Redis_locator_hash( "foo{{bar}}zap", 13 ), dbBE_Redis_locator_hash( "{bar", 4 ) );
+  rc += TEST_NOT( dbBE_Redis_locator_hash( "foo{}{bar}", 10 ), dbBE_Redis_locator_hash( "bar", 3 ) );
+  rc += TEST_NOT( dbBE_Redis_locator_hash( "foo{bar", 7 ), dbBE_Redis_locator_hash( "bar", 3 ) );
+  // the tag has to be within the given length
+  rc += TEST_NOT( dbBE_Redis_locator_hash( "foo{bar}", 6 ), dbBE_Redis_locator_hash( "bar", 3 ) );
+  TEST_LOG( rc, "dbBE_Redis_locator_hash" );
+
   printf( "Test exiting with rc=%d\n", rc );
   return rc;
 }
@@ -0,0 +1,296 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+ * micro benchmark: throughput of the RESP parser over pipelined reply streams
+ * compares the terminator search and integer decoding with the previous byte-wise scans
+ * usage: backend_redis_parse_bench [iterations [captured-replies-file]]
+ * a captured file holds raw RESP replies as received from Redis (e.g. a dump of the socket payload)
+ */
+
+#include "test_utils.h"
+#include "../parse.h"
+#include "../result.h"
+#include "../scan.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <x86intrin.h>
+#endif
+
+#define BENCH_STREAM_LEN ( 1024 * 1024 )
+
+/*
+ * the previous terminator search: one byte at a time
+ */
+static __attribute__((noinline))
+char* find_terminator_bytewise( char *haystack, const int64_t limit )
+{
+  char *p = haystack;
+  int64_t pos = 0;
+  while( pos < limit )
+  {
+    while( ( pos < limit - 1 ) && ( *p != '\r'))
+    {
+      ++pos;
+      ++p;
+    }
+    if( ( *p == '\r') && ( p[1] == '\n'))
+      return p;
+    ++pos;
+    ++p;
+  }
+  return NULL;
+}
+
+/*
+ * the previous integer decoding: one digit at a time
+ */
+static __attribute__((noinline))
+int64_t extract_integer_bytewise( char *p, size_t *parsed, const int64_t limit )
+{
+  size_t pp = 0;
+  int64_t sign = 1;
+  int64_t ret = 0;
+  int64_t remaining = limit;
+
+  if( *p == '-' )
+  {
+    sign = -1;
+    ++p;
+    ++pp;
+    --remaining;
+  }
+  while((*p != '\r') && (*p != '\0' ) && ( remaining > 0 ))
+  {
+    ret *= 10;
+    int64_t digit = *p - '0';
+    if(( digit > 9 ) || ( digit < 0 ))
+      return DBBE_REDIS_NAN;
+    ret += digit;
+    ++p;
+    ++pp;
+    --remaining;
+  }
+  if( remaining < 2 )
+  {
+    *parsed = 0;
+    return -EAGAIN;
+  }
+  if( *p == '\r' ) { p++; pp++; }
+  if( *p == '\n' ) { p++; pp++; }
+  *parsed = pp;
+  return ret * sign;
+}
+
+static
+double now_nsec()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static
+uint64_t now_cycles()
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+/*
+ * fill the stream with replies of one kind until it's full
+ * returns the stream length
+ */
+static
+size_t create_stream( char *stream, const char *kind )
+{
+  // reply values of 1 to 8 digits (counts, lengths, sizes)
+  const int divisors[ 8 ] = { 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+  size_t len = 0;
+  int n = 0;
+  char line[ 256 ];
+  while( 1 )
+  {
+    int l;
+    if( strcmp( kind, "int" ) == 0 )  // batched put/remove
+      l = snprintf( line, sizeof( line ), ":%d\r\n", ( n * 7919 ) % divisors[ n % 8 ] );
+    else if( strcmp( kind, "status" ) == 0 )
+      l = snprintf( line, sizeof( line ), "+OK\r\n" );
+    else if( strcmp( kind, "bulk" ) == 0 )  // get of small values
+      l = snprintf( line, sizeof( line ), "$48\r\nvalue_%042d\r\n", n );
+    else  // directory scan: cursor and a page of keys
+      l = snprintf( line, sizeof( line ), "*2\r\n$4\r\n%04d\r\n*4\r\n$12\r\nns::key_%04d\r\n$12\r\nns::key_%04d\r\n$12\r\nns::key_%04d\r\n$12\r\nns::key_%04d\r\n",
+                    n % 10000, n % 10000, ( n + 1 ) % 10000, ( n + 2 ) % 10000, ( n + 3 ) % 10000 );
+    if( len + l >= BENCH_STREAM_LEN )
+      break;
+    memcpy( stream + len, line, l );
+    len += l;
+    ++n;
+  }
+  return len;
+}
+
+/*
+ * parse all replies of the stream; the parser terminates strings in place, so start from a fresh copy
+ */
+static
+int parse_stream( dbBE_Redis_sr_buffer_t *sr_buf, const char *stream, const size_t len,
+                  const long iterations, double *nsec, uint64_t *cycles, long *replies )
+{
+  int rc = 0;
+  dbBE_Redis_result_t result;
+  memset( &result, 0, sizeof( result ) );
+  *nsec = 0;
+  *cycles = 0;
+  *replies = 0;
+
+  long i;
+  for( i = 0; ( i < iterations ) && ( rc == 0 ); ++i )
+  {
+    dbBE_Transport_sr_buffer_reset( sr_buf );
+    memcpy( dbBE_Transport_sr_buffer_get_start( sr_buf ), stream, len );
+    dbBE_Transport_sr_buffer_add_data( sr_buf, len, 0 );
+
+    double start = now_nsec();
+    uint64_t cstart = now_cycles();
+    while(( rc == 0 ) && ( ! dbBE_Transport_sr_buffer_empty( sr_buf ) ))
+    {
+      rc = dbBE_Redis_parse_sr_buffer( sr_buf, &result );
+      dbBE_Redis_result_cleanup( &result, 0 );
+      ++(*replies);
+    }
+    *cycles += now_cycles() - cstart;
+    *nsec += now_nsec() - start;
+  }
+  return rc;
+}
+
+int main( int argc, char ** argv )
+{
+  int rc = 0;
+  long iterations = ( argc > 1 ) ? strtol( argv[1], NULL, 10 ) : 20;
+  if( iterations <= 0 )
+    iterations = 20;
+
+  char *stream = (char*)calloc( 1, BENCH_STREAM_LEN + 64 );
+  dbBE_Redis_sr_buffer_t *sr_buf = dbBE_Transport_sr_buffer_allocate( BENCH_STREAM_LEN + 64 );
+  rc += TEST_NOT( stream, NULL );
+  rc += TEST_NOT( sr_buf, NULL );
+  TEST_BREAK( rc, "allocation failed" );
+
+  printf( "scan implementation: %s\n", DBBE_REDIS_SCAN_IMPL );
+
+  // terminator search over a long bulk string (e.g. a large value)
+  memset( stream, 'v', BENCH_STREAM_LEN );
+  memcpy( stream + BENCH_STREAM_LEN - 2, "\r\n", 2 );
+  rc += TEST( find_terminator_bytewise( stream, BENCH_STREAM_LEN ), dbBE_Redis_find_terminator( stream, BENCH_STREAM_LEN ) );
+  volatile uintptr_t sink = 0;
+  long i;
+  double start = now_nsec();
+  for( i = 0; i < iterations; ++i )
+    sink += (uintptr_t)find_terminator_bytewise( stream, BENCH_STREAM_LEN );
+  double bytewise = ( now_nsec() - start ) / iterations;
+  start = now_nsec();
+  for( i = 0; i < iterations; ++i )
+    sink += (uintptr_t)dbBE_Redis_find_terminator( stream, BENCH_STREAM_LEN );
+  double vector = ( now_nsec() - start ) / iterations;
+  printf( "terminator search: bytewise=%.2f B/ns vector=%.2f B/ns (%.1fx)\n",
+          BENCH_STREAM_LEN / bytewise, BENCH_STREAM_LEN / vector, bytewise / vector );
+
+  // integer decoding of reply values
+  int64_t check = 0;
+  size_t len = create_stream( stream, "int" );
+  start = now_nsec();
+  for( i = 0; i < iterations; ++i )
+  {
+    size_t pos = 0;
+    while( pos < len )
+    {
+      size_t parsed = 0;
+      sink += extract_integer_bytewise( stream + pos + 1, &parsed, len - pos - 1 );
+      if( parsed == 0 )
+        break;
+      pos += parsed + 1;
+    }
+  }
+  bytewise = ( now_nsec() - start ) / iterations;
+  start = now_nsec();
+  for( i = 0; i < iterations; ++i )
+  {
+    size_t pos = 0;
+    while( pos < len )
+    {
+      size_t parsed = 0;
+      int64_t v = dbBE_Redis_extract_integer( stream + pos + 1, &parsed, len - pos - 1 );
+      check += v;
+      if( parsed == 0 )
+        break;
+      pos += parsed + 1;
+    }
+  }
+  vector = ( now_nsec() - start ) / iterations;
+  sink += check;
+  printf( "integer decoding: bytewise=%.2f B/ns swar=%.2f B/ns (%.1fx)\n",
+          len / bytewise, len / vector, bytewise / vector );
+
+  // full parser over reply streams
+  const char *kinds[] = { "int", "status", "bulk", "scan", NULL };
+  int k;
+  for( k = 0; ( kinds[ k ] != NULL ) || (( argc > 2 ) && ( k == 4 )); ++k )
+  {
+    const char *name = kinds[ k ];
+    if( name == NULL )
+    {
+      // captured replies from a file
+      FILE *f = fopen( argv[2], "rb" );
+      if( f == NULL )
+      {
+        perror( argv[2] );
+        break;
+      }
+      len = fread( stream, 1, BENCH_STREAM_LEN, f );
+      fclose( f );
+      name = argv[2];
+    }
+    else
+      len = create_stream( stream, name );
+
+    double nsec;
+    uint64_t cycles;
+    long replies;
+    rc += TEST( parse_stream( sr_buf, stream, len, iterations, &nsec, &cycles, &replies ), 0 );
+    double bytes = (double)len * iterations;
+    if( cycles != 0 )
+      printf( "parse %-8s: %ld replies, %.2f B/ns, %.2f B/cycle, %.1f ns/reply\n",
+              name, replies / iterations, bytes / nsec, bytes / cycles, nsec / replies );
+    else
+      printf( "parse %-8s: %ld replies, %.2f B/ns, %.1f ns/reply\n",
+              name, replies / iterations, bytes / nsec, nsec / replies );
+  }
+
+  dbBE_Transport_sr_buffer_free( sr_buf );
+  free( stream );
+  printf( "Test exiting with rc=%d\n", rc );
+  return rc;
+}
@@ -23,6 +23,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <inttypes.h>
 
 #include <libdatabroker.h>
 #include "../backend/redis/result.h"
@@ -481,6 +482,34 @@ int TestRedis_parse_ctx_buffer()
   rc += TEST( dbBE_Transport_sr_buffer_available( sr_buf ), len );
   rc += TEST( dbBE_Transport_sr_buffer_processed( sr_buf ), len );
 
+  // parse a null array (timed out BLPOP) which is reported like a nil string
+  len = TestReset_sr_buffer( sr_buf, "*-1\r\n" );
+  err_code = dbBE_Redis_parse_sr_buffer( sr_buf, &result );
+  rc += TEST( err_code, 0 );
+  rc += TEST( result._type, dbBE_REDIS_TYPE_CHAR );
+  rc += TEST( result._data._string._data, NULL );
+  rc += TEST( result._data._string._size, 0 );
+  rc += TEST( dbBE_Transport_sr_buffer_processed( sr_buf ), len );
+
+  // an incomplete last string in an array needs more data by default
+  len = TestReset_sr_buffer( sr_buf, "*2\r\n$3\r\nkey\r\n$10\r\nHello" );
+  err_code = dbBE_Redis_parse_sr_buffer( sr_buf, &result );
+  rc += TEST( err_code, -EAGAIN );
+  rc += TEST( dbBE_Transport_sr_buffer_processed( sr_buf ), 0 );
+
+  // but is a partial string if the caller allows a partial tail (BLPOP response)
+  err_code = dbBE_Redis_parse_sr_buffer_partial_tail( sr_buf, &result );
+  rc += TEST( err_code, 0 );
+  rc += TEST( result._type, dbBE_REDIS_TYPE_ARRAY );
+  rc += TEST( result._data._array._len, 2 );
+  rc += TEST( result._data._array._data[ 0 ]._type, dbBE_REDIS_TYPE_CHAR );
+  rc += TEST( strncmp( result._data._array._data[ 0 ]._data._string._data, "key", 4 ), 0 );
+  rc += TEST( result._data._array._data[ 1 ]._type, dbBE_REDIS_TYPE_STRING_PART );
+  rc += TEST( result._data._array._data[ 1 ]._data._pstring._total_size, 10 );
+  rc += TEST( result._data._array._data[ 1 ]._data._pstring._size, 5 );
+  rc += TEST( dbBE_Transport_sr_buffer_processed( sr_buf ), len );
+  dbBE_Redis_result_cleanup( &result, 0 );
+
   // continue parsing should return invalid because there's no more data to parse in the initialized string
   err_code = dbBE_Redis_parse_sr_buffer( sr_buf, &result );
   rc += TEST( err_code, -ENODATA );
@@ -620,6 +649,140 @@ int TestRedis_parse_ctx_buffer_errors()
   return rc;
 }
 
+/*
+ * the vectorized terminator search and digit decoding need to match a plain byte-wise scan
+ * at every alignment, length, and position of the terminator
+ */
+int TestRedis_scan()
+{
+  int rc = 0;
+  char buf[ 160 ];
+  int64_t limit;
+  int pos;
+
+  for( limit = 0; limit < 140; ++limit )
+    for( pos = -1; pos < limit + 2; ++pos )
+    {
+      memset( buf, 'x', sizeof( buf ) );
+      buf[ 3 ] = '\r';   // a lone CR is no terminator
+      buf[ 20 ] = '\n';  // neither is a lone LF
+      if( pos >= 0 )
+      {
+        buf[ pos ] = '\r';
+        buf[ pos + 1 ] = '\n';
+      }
+      char *expect = NULL;
+      int i;
+      for( i = 0; ( i + 1 < limit ) && ( expect == NULL ); ++i )
+        if(( buf[ i ] == '\r' ) && ( buf[ i + 1 ] == '\n' ))
+          expect = &buf[ i ];
+      if( dbBE_Redis_find_terminator( buf, limit ) != expect )
+      {
+        rc += TEST( dbBE_Redis_find_terminator( buf, limit ), expect );
+        fprintf( stderr, "terminator mismatch: limit=%"PRId64" pos=%d\n", limit, pos );
+      }
+    }
+  TEST_LOG( rc, "Terminator scan" );
+
+  const int64_t values[] = { 0, 7, 42, 1054, 99999999, 100000000, 123456789012ll, -1, -20153, -12345678 };
+  int n;
+  for( n = 0; n < (int)( sizeof( values ) / sizeof( int64_t ) ); ++n )
+  {
+    size_t parsed = 0;
+    int len = snprintf( buf, sizeof( buf ), "%"PRId64"\r\n:1\r\n:2\r\n", values[ n ] );
+    rc += TEST( dbBE_Redis_extract_integer( buf, &parsed, len ), values[ n ] );
+    rc += TEST( parsed, strchr( buf, '\n' ) - buf + 1 );
+  }
+  TEST_LOG( rc, "Integer decoding" );
+
+  printf( "TestRedis_scan exiting with rc=%d\n", rc );
+  return rc;
+}
+
+int TestRedis_parse_resume()
+{
+  int rc = 0;
+  int err_code;
+  size_t n;
+  size_t len;
+
+  dbBE_Redis_sr_buffer_t *sr_buf;
+  dbBE_Redis_result_t result;
+  dbBE_Redis_parse_state_t state;
+  memset( &result, 0, sizeof( dbBE_Redis_result_t ) );
+
+  sr_buf = dbBE_Transport_sr_buffer_allocate( DBBE_TEST_BUFFER_LEN );
+  if( sr_buf == NULL )
+    return 1;
+
+  // a nested response (like SCAN) arriving one byte at a time
+  const char *response = "*2\r\n$1\r\n0\r\n*3\r\n$4\r\nkey1\r\n$4\r\nkey2\r\n:42\r\n";
+  len = strlen( response );
+  TestReset_sr_buffer( sr_buf, "" );
+  dbBE_Redis_parse_state_init( &state, DBBE_REDIS_PARSE_PARTIAL );
+  int64_t last_processed = 0;
+  err_code = -EAGAIN;
+  for( n = 1; ( n <= len ) && ( err_code == -EAGAIN ); ++n )
+  {
+    *dbBE_Transport_sr_buffer_get_available_position( sr_buf ) = response[ n - 1 ];
+    dbBE_Transport_sr_buffer_add_data( sr_buf, 1, 0 );
+    err_code = dbBE_Redis_parse_sr_buffer_resume( sr_buf, &result, &state );
+    // completed elements are never parsed again
+    rc += TEST( dbBE_Transport_sr_buffer_processed( sr_buf ) >= last_processed, 1 );
+    last_processed = dbBE_Transport_sr_buffer_processed( sr_buf );
+    if( n < len )
+      rc += TEST( err_code, -EAGAIN );
+  }
+  rc += TEST( err_code, 0 );
+  rc += TEST( n - 1, len );
+  rc += TEST( state._depth, 0 );
+  rc += TEST( dbBE_Transport_sr_buffer_processed( sr_buf ), len );
+  rc += TEST( result._type, dbBE_REDIS_TYPE_ARRAY );
+  rc += TEST( result._data._array._len, 2 );
+  rc += TEST( strncmp( result._data._array._data[ 0 ]._data._string._data, "0", 2 ), 0 );
+  dbBE_Redis_result_t *keys = &result._data._array._data[ 1 ];
+  rc += TEST( keys->_type, dbBE_REDIS_TYPE_ARRAY );
+  rc += TEST( keys->_data._array._len, 3 );
+  rc += TEST( strncmp( keys->_data._array._data[ 0 ]._data._string._data, "key1", 5 ), 0 );
+  rc += TEST( strncmp( keys->_data._array._data[ 1 ]._data._string._data, "key2", 5 ), 0 );
+  rc += TEST( keys->_data._array._data[ 2 ]._type, dbBE_REDIS_TYPE_INT );
+  rc += TEST( keys->_data._array._data[ 2 ]._data._integer, 42 );
+  dbBE_Redis_result_cleanup( &result, 0 );
+
+  // the buffer position stays at the first incomplete element
+  len = TestReset_sr_buffer( sr_buf, "*2\r\n:3053\r\n$10\r\nblafa" );
+  dbBE_Redis_parse_state_init( &state, DBBE_REDIS_PARSE_PARTIAL );
+  rc += TEST( dbBE_Redis_parse_sr_buffer_resume( sr_buf, &result, &state ), -EAGAIN );
+  rc += TEST( dbBE_Transport_sr_buffer_processed( sr_buf ), 11 );
+  rc += TEST( state._depth, 1 );
+  rc += TEST( result._data._array._data[ 0 ]._data._integer, 3053 );
+  size_t added = snprintf( dbBE_Transport_sr_buffer_get_available_position( sr_buf ), 12, "seled\r\n" );
+  dbBE_Transport_sr_buffer_add_data( sr_buf, added, 0 );
+  rc += TEST( dbBE_Redis_parse_sr_buffer_resume( sr_buf, &result, &state ), 0 );
+  rc += TEST( dbBE_Transport_sr_buffer_processed( sr_buf ), len + added );
+  rc += TEST( result._data._array._data[ 1 ]._type, dbBE_REDIS_TYPE_CHAR );
+  rc += TEST( strncmp( result._data._array._data[ 1 ]._data._string._data, "blafaseled", 11 ), 0 );
+  dbBE_Redis_result_cleanup( &result, 0 );
+
+  // without partial strings, an incomplete string waits for the rest
+  len = TestReset_sr_buffer( sr_buf, "$10\r\nHello" );
+  dbBE_Redis_parse_state_init( &state, 0 );
+  rc += TEST( dbBE_Redis_parse_sr_buffer_resume( sr_buf, &result, &state ), -EAGAIN );
+  rc += TEST( dbBE_Transport_sr_buffer_processed( sr_buf ), 0 );
+  added = snprintf( dbBE_Transport_sr_buffer_get_available_position( sr_buf ), 12, "World\r\n" );
+  dbBE_Transport_sr_buffer_add_data( sr_buf, added, 0 );
+  rc += TEST( dbBE_Redis_parse_sr_buffer_resume( sr_buf, &result, &state ), 0 );
+  rc += TEST( result._type, dbBE_REDIS_TYPE_CHAR );
+  rc += TEST( strncmp( result._data._string._data, "HelloWorld", 11 ), 0 );
+  dbBE_Redis_result_cleanup( &result, 0 );
+
+  rc += TEST( dbBE_Redis_parse_sr_buffer_resume( sr_buf, &result, NULL ), -EINVAL );
+
+  dbBE_Transport_sr_buffer_free( sr_buf );
+  printf( "TestRedis_parse_resume exiting with rc=%d\n", rc );
+  return rc;
+}
+
 // define the function here because it's not exposed in header file
 dbBE_Transport_sge_buffer_t* dbBE_Redis_parse_copy_assemble_sge( dbBE_Request_t *r,
                                                              dbBE_Redis_result_t *c,
@@ -851,6 +1014,8 @@ int main( int argc, char ** argv )
   rc += TestRedis_extract_bulk_string();
   rc += TestRedis_parse_ctx_buffer();
   rc += TestRedis_parse_ctx_buffer_errors();
+  rc += TestRedis_parse_resume();
+  rc += TestRedis_scan();
   rc += TestSGEAssemble();
 
   printf( "Test exiting with rc=%d\n", rc );
@@ -0,0 +1,280 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef __APPLE__
+#include <stdlib.h>
+#else
+#include <malloc.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+
+#include "../backend/redis/redis.h"
+#include "../backend/redis/request.h"
+#include "../backend/redis/complete.h"
+#include "../backend/transports/memcopy.h"
+#include "test_utils.h"
+
+// the receiver's connection claims to be this node; the other end of the socket pair plays the server
+#define DBBE_TEST_NODE "127.0.0.1:7000"
+// nothing listens here, links and slot map queries fail right away
+#define DBBE_TEST_UNREACHABLE "127.0.0.1:1"
+
+typedef struct
+{
+  int _fd;
+  const char *_data;
+  int _delay_us;
+} dbBE_Test_server_t;
+
+/*
+ * write the rest of a response after a moment; the receiver has to wait for it
+ */
+static
+void* delayed_write( void *arg )
+{
+  dbBE_Test_server_t *srv = (dbBE_Test_server_t*)arg;
+  usleep( srv->_delay_us );
+  if( write( srv->_fd, srv->_data, strlen( srv->_data ) ) < 0 )
+    perror( "delayed_write" );
+  return NULL;
+}
+
+/*
+ * answer the ROLE query of the MOVED handling
+ */
+static
+void* answer_role( void *arg )
+{
+  dbBE_Test_server_t *srv = (dbBE_Test_server_t*)arg;
+  char cmd[ 128 ];
+  size_t len = 0;
+  memset( cmd, 0, sizeof( cmd ) );
+  while(( strstr( cmd, "ROLE\r\n" ) == NULL ) && ( len < sizeof( cmd ) - 1 ))
+  {
+    ssize_t rlen = read( srv->_fd, cmd + len, sizeof( cmd ) - 1 - len );
+    if( rlen <= 0 )
+      return NULL;
+    len += rlen;
+  }
+  if( write( srv->_fd, srv->_data, strlen( srv->_data ) ) < 0 )
+    perror( "answer_role" );
+  return NULL;
+}
+
+static
+dbBE_Redis_context_t* test_context_create( dbBE_Redis_conn_mgr_config_t *config, const int fd )
+{
+  dbBE_Redis_context_t *ctx = (dbBE_Redis_context_t*)calloc( 1, sizeof( dbBE_Redis_context_t ) );
+  if( ctx == NULL )
+    return NULL;
+
+  ctx->_spec = dbBE_Redis_command_stages_spec_init();
+  ctx->_locator = dbBE_Redis_locator_create();
+  ctx->_compl_q = dbBE_Ring_create( 16 );
+  ctx->_compl_overflow = dbBE_Completion_queue_create( 0 );
+  ctx->_retry_q = dbBE_Redis_s2r_queue_create( 1 );
+  ctx->_transport = &dbBE_Memcopy_transport;
+  config->_rbuf_len = ctx->_transport->_recv_buffer_len;
+  config->_sbuf_len = ctx->_transport->_send_buffer_len;
+  ctx->_conn_mgr = dbBE_Redis_connection_mgr_init( config );
+
+  dbBE_Redis_connection_t *conn = dbBE_Redis_connection_create( config->_rbuf_len );
+  if(( ctx->_spec == NULL ) || ( ctx->_locator == NULL ) || ( ctx->_compl_q == NULL ) ||
+      ( ctx->_compl_overflow == NULL ) || ( ctx->_retry_q == NULL ) || ( ctx->_conn_mgr == NULL ) ||
+      ( conn == NULL ))
+    return NULL;
+
+  conn->_socket = fd;
+  conn->_address = dbBE_Network_address_from_string( DBBE_TEST_NODE );
+  conn->_status = DBBE_CONNECTION_STATUS_AUTHORIZED;
+  if( dbBE_Redis_connection_mgr_add( ctx->_conn_mgr, conn ) != 0 )
+    return NULL;
+  return ctx;
+}
+
+static
+void test_context_destroy( dbBE_Redis_context_t *ctx )
+{
+  dbBE_Redis_connection_mgr_exit( ctx->_conn_mgr );
+  dbBE_Redis_s2r_queue_destroy( ctx->_retry_q );
+  dbBE_Completion_queue_destroy( ctx->_compl_overflow );
+  dbBE_Ring_destroy( ctx->_compl_q );
+  dbBE_Redis_locator_destroy( ctx->_locator );
+  dbBE_Redis_command_stages_spec_destroy( ctx->_spec );
+  free( ctx );
+}
+
+/*
+ * post a put to the connection as if it was sent there, then feed the response
+ */
+static
+dbBE_Redis_request_t* test_post_put( dbBE_Redis_context_t *ctx, dbBE_Request_t *user, const int asking )
+{
+  dbBE_Redis_connection_t *conn = dbBE_Redis_connection_mgr_get_connection_at( ctx->_conn_mgr, 0 );
+  dbBE_Redis_request_t *request = dbBE_Redis_request_allocate( user );
+  if( request == NULL )
+    return NULL;
+  request->_asking = asking;
+  dbBE_Redis_s2r_queue_push( conn->_posted_q, request );
+  return request;
+}
+
+static
+int test_expect_completion( dbBE_Redis_context_t *ctx, dbBE_Request_t *user, const DBR_Errorcode_t status )
+{
+  int rc = 0;
+  dbBE_Completion_t *completion = dbBE_Redis_completion_pop( ctx );
+  rc += TEST_NOT( completion, NULL );
+  if( completion != NULL )
+  {
+    rc += TEST( completion->_user, user );
+    rc += TEST( completion->_status, status );
+    dbBE_Redis_completion_release( completion );
+  }
+  rc += TEST( dbBE_Redis_completion_pop( ctx ), NULL );
+  return rc;
+}
+
+static
+int test_wait_refresh( dbBE_Redis_context_t *ctx )
+{
+  int retry = 5000;
+  while(( ! dbBE_Redis_slotmap_refresh_ready( ctx ) ) && ( --retry > 0 ))
+    usleep( 1000 );
+  return TEST( dbBE_Redis_slotmap_refresh_ready( ctx ), 1 );
+}
+
+int main( int argc, char ** argv )
+{
+  int rc = 0;
+  int sv[ 2 ];
+  pthread_t server;
+  dbBE_Test_server_t srv;
+  dbBE_Redis_conn_mgr_config_t config;
+
+  rc += TEST( socketpair( AF_UNIX, SOCK_STREAM, 0, sv ), 0 );
+  dbBE_Redis_context_t *ctx;
+  rc += TEST_NOT_RC( test_context_create( &config, sv[0] ), NULL, ctx );
+  TEST_BREAK( rc, "Context setup failed\n" );
+  dbBE_Redis_connection_t *conn = dbBE_Redis_connection_mgr_get_connection_at( ctx->_conn_mgr, 0 );
+  srv._fd = sv[1];
+
+  char value[] = "WORLD";
+  dbBE_Request_t *user = (dbBE_Request_t*)calloc( 1, sizeof( dbBE_Request_t ) + sizeof( dbBE_sge_t ) );
+  rc += TEST_NOT( user, NULL );
+  TEST_BREAK( rc, "Request allocation failed\n" );
+  user->_key = "HELLO";
+  user->_opcode = DBBE_OPCODE_PUT;
+  user->_user = user;
+  user->_sge_count = 1;
+  user->_sge[0].iov_base = value;
+  user->_sge[0].iov_len = strlen( value );
+
+  // ASK to a known node: retry there once with ASKING
+  dbBE_Redis_request_t *request = test_post_put( ctx, user, 0 );
+  rc += TEST_NOT( request, NULL );
+  TEST_BREAK( rc, "Request allocation failed\n" );
+  rc += TEST( write( sv[1], "-ASK 866 " DBBE_TEST_NODE "\r\n", 25 ), 25 );
+  dbBE_Redis_receiver_trigger( ctx );
+  rc += TEST( dbBE_Redis_s2r_queue_pop( ctx->_retry_q ), request );
+  rc += TEST( request->_asking, 1 );
+  rc += TEST( request->_location._type, DBBE_REDIS_REQUEST_LOCATION_TYPE_CONNECTION );
+  rc += TEST( request->_location._data._connection, conn );
+  rc += TEST( dbBE_Redis_completion_pop( ctx ), NULL );
+  TEST_LOG( rc, "ASK to known node" );
+
+  // the ASKING reply is skipped, even if the actual response only arrives with the next recv
+  dbBE_Redis_s2r_queue_push( conn->_posted_q, request );
+  rc += TEST( write( sv[1], "+OK\r\n:", 6 ), 6 );
+  srv._data = "1\r\n";
+  srv._delay_us = 50000;
+  rc += TEST( pthread_create( &server, NULL, delayed_write, &srv ), 0 );
+  dbBE_Redis_receiver_trigger( ctx );
+  pthread_join( server, NULL );
+  rc += test_expect_completion( ctx, user, DBR_SUCCESS );
+  rc += TEST( dbBE_Redis_s2r_queue_len( conn->_posted_q ), 0 );
+  rc += TEST( dbBE_Redis_s2r_queue_len( ctx->_retry_q ), 0 );
+  TEST_LOG( rc, "ASKING reply and split response" );
+
+  // rejected ASKING: the request fails even though the node executed the command
+  request = test_post_put( ctx, user, 1 );
+  rc += TEST( write( sv[1], "-ERR not in cluster mode\r\n:1\r\n", 30 ), 30 );
+  dbBE_Redis_receiver_trigger( ctx );
+  rc += test_expect_completion( ctx, user, DBR_ERR_BE_GENERAL );
+  rc += TEST( dbBE_Redis_s2r_queue_len( conn->_posted_q ), 0 );
+  rc += TEST( dbBE_Redis_s2r_queue_len( ctx->_retry_q ), 0 );
+
+  // rejected ASKING: another redirect still applies
+  request = test_post_put( ctx, user, 1 );
+  rc += TEST( write( sv[1], "-ERR busy\r\n-ASK 866 " DBBE_TEST_NODE "\r\n", 36 ), 36 );
+  dbBE_Redis_receiver_trigger( ctx );
+  rc += TEST( dbBE_Redis_s2r_queue_pop( ctx->_retry_q ), request );
+  rc += TEST( request->_asking, 1 );
+  rc += TEST( dbBE_Redis_completion_pop( ctx ), NULL );
+  dbBE_Redis_request_destroy( request );
+  TEST_LOG( rc, "ASKING rejected" );
+
+  // ASK to an unreachable node fails the request
+  request = test_post_put( ctx, user, 0 );
+  rc += TEST( write( sv[1], "-ASK 866 " DBBE_TEST_UNREACHABLE "\r\n", 22 ), 22 );
+  dbBE_Redis_receiver_trigger( ctx );
+  rc += test_expect_completion( ctx, user, DBR_ERR_NOCONNECT );
+  rc += TEST( dbBE_Redis_s2r_queue_len( ctx->_retry_q ), 0 );
+  TEST_LOG( rc, "ASK to unreachable node" );
+
+  // MOVED to an unreachable new master fails the request and starts a slot map refresh
+  request = test_post_put( ctx, user, 0 );
+  srv._data = "*3\r\n$6\r\nmaster\r\n:0\r\n*0\r\n";
+  rc += TEST( pthread_create( &server, NULL, answer_role, &srv ), 0 );
+  rc += TEST( write( sv[1], "-MOVED 866 " DBBE_TEST_UNREACHABLE "\r\n", 24 ), 24 );
+  dbBE_Redis_receiver_trigger( ctx );
+  pthread_join( server, NULL );
+  rc += test_expect_completion( ctx, user, DBR_ERR_NOCONNECT );
+  rc += TEST( dbBE_Redis_s2r_queue_len( ctx->_retry_q ), 0 );
+  TEST_LOG( rc, "MOVED to unreachable node" );
+
+  // slot map refresh: one at a time, rate limited, and a failed fetch is dropped
+  rc += TEST( dbBE_Redis_slotmap_refresh_start( NULL, DBBE_TEST_UNREACHABLE ), -EINVAL );
+  rc += TEST( dbBE_Redis_slotmap_refresh_start( ctx, NULL ), -EINVAL );
+  rc += TEST( dbBE_Redis_slotmap_refresh_start( ctx, DBBE_TEST_UNREACHABLE ), -EBUSY );
+  rc += test_wait_refresh( ctx );
+  rc += TEST( dbBE_Redis_slotmap_refresh_apply( ctx ), -ENOMSG );
+  rc += TEST( ctx->_refresh_state, DBBE_REDIS_SLOTMAP_REFRESH_IDLE );
+  rc += TEST( dbBE_Redis_slotmap_refresh_apply( ctx ), 0 );
+  rc += TEST( dbBE_Redis_locator_get_conn_index( ctx->_locator, 866 ), DBBE_REDIS_LOCATOR_INDEX_INVAL );
+
+  usleep( DBBE_REDIS_SLOTMAP_REFRESH_INTERVAL * 1000 );
+  rc += TEST( dbBE_Redis_slotmap_refresh_start( ctx, DBBE_TEST_UNREACHABLE ), 0 );
+  rc += TEST( dbBE_Redis_slotmap_refresh_start( ctx, DBBE_TEST_UNREACHABLE ), -EBUSY );
+  rc += test_wait_refresh( ctx );
+  rc += TEST( dbBE_Redis_slotmap_refresh_apply( ctx ), -ENOMSG );
+  TEST_LOG( rc, "slot map refresh" );
+
+  test_context_destroy( ctx );
+  close( sv[1] );
+  free( user );
+
+  printf( "Test exiting with rc=%d\n", rc );
+  return rc;
+}
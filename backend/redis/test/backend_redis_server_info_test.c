@@ -24,6 +24,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <unistd.h>
 #include <libdatabroker.h>
 
 #include "../backend/redis/server_info.h"
@@ -360,6 +361,26 @@ int cluster_info_test()
   rc += TEST( dbBE_Redis_server_info_get_last_slot( si ), 2999 );
   rc += TEST( dbBE_Redis_server_info_getsize( si ), 4 );
 
+  // topology snapshot round trip
+  char cache[ 256 ];
+  snprintf( cache, 256, "/tmp/dbr_topology_test.%d", (int)getpid() );
+  rc += TEST( dbBE_Redis_cluster_info_save( NULL, "sock://seed:6300", cache ), -EINVAL );
+  rc += TEST( dbBE_Redis_cluster_info_load( cache, "sock://seed:6300" ), NULL );
+  rc += TEST( dbBE_Redis_cluster_info_save( ci, "sock://seed:6300", cache ), 0 );
+  rc += TEST( dbBE_Redis_cluster_info_load( cache, "sock://other:6300" ), NULL );
+
+  dbBE_Redis_cluster_info_t *cached;
+  rc += TEST_NOT_RC( dbBE_Redis_cluster_info_load( cache, "sock://seed:6300" ), NULL, cached );
+  TEST_BREAK( rc, "Topology cache load failed" );
+  rc += TEST( cached->_cluster_size, 3 );
+  rc += TEST_NOT_RC( dbBE_Redis_cluster_info_get_server_by_addr( cached, "sock://127.0.0.3:6302" ), NULL, si );
+  rc += TEST( dbBE_Redis_server_info_get_first_slot( si ), 2000 );
+  rc += TEST( dbBE_Redis_server_info_get_last_slot( si ), 2999 );
+  rc += TEST( dbBE_Redis_server_info_getsize( si ), 4 );
+  rc += TEST( strcmp( dbBE_Redis_server_info_get_master( si ), "sock://127.0.0.1:6302" ), 0 );
+  rc += TEST( dbBE_Redis_cluster_info_destroy( cached ), 0 );
+  unlink( cache );
+
 
   // result cleanup
   // free up the strdup-allocated entries in the result since they are not cleaned up by result_cleanup()
@@ -27,6 +27,8 @@
 #endif
 #include <string.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
 
 int main( int argc, char ** argv )
 {
@@ -224,6 +226,52 @@ int main( int argc, char ** argv )
 
   TEST_LOG( rc, "REMOVE:");
 
+  req->_key = "HELLO";
+  req->_next = NULL;
+  req->_ns_hdl = ns;
+  req->_opcode = DBBE_OPCODE_GET;
+  req->_user = req;
+  req->_sge_count = 1;
+  memset( buf, 0, 128 );
+  req->_sge[0].iov_base = (void*)buf;
+  req->_sge[0].iov_len = 128;
+
+  // the get of a missing key gets parked on the server; a cancel is noticed within one BLPOP slice
+  rhandle = dbBE.post( BE, req, 1 );
+  rc += TEST_NOT_INFO( rhandle, NULL, "Posting GET to cancel" );
+  if( rhandle != NULL )
+  {
+    dbBE_Completion_t *comp = NULL;
+    int n;
+    for( n = 0; ( n < 200 ) && ( comp == NULL ); ++n )
+    {
+      comp = dbBE.test_any( BE );
+      usleep( 1000 );
+    }
+    rc += TEST( comp, NULL );
+
+    struct timespec start, now;
+    int64_t elapsed_ms = 0;
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    rc += TEST( dbBE.cancel( BE, rhandle ), 0 );
+    do
+    {
+      comp = dbBE.test_any( BE );
+      clock_gettime( CLOCK_MONOTONIC, &now );
+      elapsed_ms = ( now.tv_sec - start.tv_sec ) * 1000 + ( now.tv_nsec - start.tv_nsec ) / 1000000;
+    } while(( comp == NULL ) && ( elapsed_ms < 3000 * DBBE_REDIS_BLOCKING_SLICE ));
+    rc += TEST_NOT( comp, NULL );
+    rc += TEST( elapsed_ms < 1000 * DBBE_REDIS_BLOCKING_SLICE + 500, 1 );
+    if( comp != NULL )
+    {
+      rc += TEST( comp->_user, req->_user );
+      rc += TEST( comp->_status, DBR_ERR_CANCELLED );
+      free( comp );
+    }
+  }
+
+  TEST_LOG( rc, "CANCEL:");
+
   // create a namespace
   req->_key = "KEYSPACE";
   req->_next = NULL;
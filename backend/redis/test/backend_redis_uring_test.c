@@ -0,0 +1,116 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef __APPLE__
+#include <stdlib.h>
+#else
+#include <malloc.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "../backend/redis/uring.h"
+#include "test_utils.h"
+
+
+int main( int argc, char ** argv )
+{
+  int rc = 0;
+
+  if( ! dbBE_Redis_uring_available() )
+  {
+    // without io_uring, the engine has to refuse and the socket calls are used
+    rc += TEST( dbBE_Redis_uring_create(), NULL );
+    printf( "io_uring not available. Test exiting with rc=%d\n", rc );
+    return rc;
+  }
+
+  rc += TEST( dbBE_Redis_uring_send( NULL, NULL ), -EINVAL );
+  rc += TEST( dbBE_Redis_uring_send_flush( NULL ), -EINVAL );
+  rc += TEST( dbBE_Redis_uring_recv( NULL, NULL, 0 ), -EINVAL );
+
+  dbBE_Redis_uring_t *ring;
+  rc += TEST_NOT_RC( dbBE_Redis_uring_create(), NULL, ring );
+  TEST_BREAK( rc, "Failed to create ring\n" );
+
+  // a connection on one end of a socket pair, the other end plays the server
+  int sv[ 2 ];
+  rc += TEST( socketpair( AF_UNIX, SOCK_STREAM, 0, sv ), 0 );
+  dbBE_Redis_connection_t *conn;
+  rc += TEST_NOT_RC( dbBE_Redis_connection_create( 16384 ), NULL, conn );
+  TEST_BREAK( rc, "Connection setup failed\n" );
+  conn->_socket = sv[0];
+  conn->_index = 0;
+  conn->_status = DBBE_CONNECTION_STATUS_AUTHORIZED;
+
+  // send: queued twice, sent once
+  dbBE_sge_t *cmd = dbBE_Transport_sge_buffer_get_current( conn->_cmd );
+  cmd[0].iov_base = "*1\r\n";
+  cmd[0].iov_len = 4;
+  cmd[1].iov_base = "$4\r\nPING\r\n";
+  cmd[1].iov_len = 10;
+  dbBE_Transport_sge_buffer_add( conn->_cmd, 2 );
+
+  rc += TEST( dbBE_Redis_uring_send( ring, conn ), 0 );
+  rc += TEST( dbBE_Redis_uring_send( ring, conn ), 0 );
+  rc += TEST( dbBE_Redis_uring_send_flush( ring ), 0 );
+  rc += TEST( dbBE_Transport_sge_count( conn->_cmd ), 0 );
+  rc += TEST( dbBE_Redis_uring_send_flush( ring ), 0 );
+
+  char data[ 64 ];
+  memset( data, 0, sizeof( data ) );
+  rc += TEST( read( sv[1], data, sizeof( data ) ), 14 );
+  rc += TEST( strcmp( data, "*1\r\n$4\r\nPING\r\n" ), 0 );
+
+  // recv: the result is picked up by the next connection_recv() without another syscall
+  dbBE_Redis_sr_buffer_t *buf = dbBE_Transport_dbuffer_get_active( conn->_recvbuf );
+  rc += TEST( write( sv[1], "+PONG\r\n", 7 ), 7 );
+  dbBE_Redis_connection_set_active( conn );
+  rc += TEST( dbBE_Redis_uring_recv( ring, &conn, 1 ), 1 );
+  rc += TEST( conn->_prefetched, 1 );
+  rc += TEST( conn->_status, DBBE_CONNECTION_STATUS_AUTHORIZED );
+  rc += TEST( dbBE_Redis_connection_recv( conn, buf ), 7 );
+  rc += TEST( conn->_prefetched, 0 );
+  rc += TEST( strncmp( dbBE_Transport_sr_buffer_get_start( buf ), "+PONG\r\n", 7 ), 0 );
+
+  // not ready: skipped, because the buffer still has unprocessed data
+  dbBE_Redis_connection_set_active( conn );
+  rc += TEST( dbBE_Redis_uring_recv( ring, &conn, 1 ), 0 );
+  rc += TEST( conn->_prefetched, 0 );
+  dbBE_Transport_sr_buffer_reset( buf );
+
+  // no data: left to the regular receive path
+  rc += TEST( dbBE_Redis_uring_recv( ring, &conn, 1 ), 0 );
+  rc += TEST( conn->_prefetched, 0 );
+  rc += TEST( conn->_status, DBBE_CONNECTION_STATUS_PENDING_DATA );
+
+  // peer closed: the connection goes down
+  close( sv[1] );
+  rc += TEST( dbBE_Redis_uring_recv( ring, &conn, 1 ), 0 );
+  rc += TEST( dbBE_Redis_connection_recv( conn, buf ), -ENOTCONN );
+  rc += TEST( dbBE_Redis_connection_RTR( conn ), 0 );
+
+  dbBE_Redis_connection_destroy( conn );
+  dbBE_Redis_uring_destroy( ring );
+
+  printf( "Test exiting with rc=%d\n", rc );
+  return rc;
+}
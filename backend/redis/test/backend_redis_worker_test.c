@@ -0,0 +1,150 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "test_utils.h"
+#include "../backend/common/dbbe_api.h"
+#include "../redis.h"
+#include "../worker.h"
+
+#include <stdio.h>
+#ifdef __APPLE__
+#include <stdlib.h>
+#else
+#include <malloc.h>
+#endif
+#include <string.h>
+#include <stdlib.h>
+
+#define WORKER_TEST_WORKERS ( 4 )
+#define WORKER_TEST_REQUESTS ( 512 )
+#define WORKER_TEST_VALUE_LEN ( 32 )
+
+/*
+ * post all requests, trigger only with the last one and collect all completions
+ */
+static
+int run_requests( dbBE_Handle_t BE, dbBE_Request_t **reqs, const int count )
+{
+  int rc = 0;
+  int n;
+  for( n = 0; n < count; ++n )
+  {
+    dbBE_Request_handle_t rh = NULL;
+    while(( rh = dbBE.post( BE, reqs[ n ], n == count - 1 )) == NULL )
+      rc += TEST( errno, EAGAIN );
+    if( rc != 0 )
+      return rc;
+  }
+
+  int completed = 0;
+  while( completed < count )
+  {
+    dbBE_Completion_t *comp = dbBE.test_any( BE );
+    if( comp == NULL )
+    {
+      dbBE.wait( BE, 100000 );
+      continue;
+    }
+    dbBE_Request_t *req = (dbBE_Request_t*)comp->_user;
+    if( req->_opcode == DBBE_OPCODE_READ )
+      rc += TEST( comp->_rc, WORKER_TEST_VALUE_LEN );
+    else
+      rc += TEST( comp->_status, DBR_SUCCESS );
+    dbBE.release( BE, comp );
+    ++completed;
+  }
+  return rc;
+}
+
+int main( int argc, char ** argv )
+{
+  int rc = 0;
+  int n;
+
+  dbBE_Handle_t BE = NULL;
+  dbBE_Redis_namespace_t *ns = NULL;
+
+  setenv( DBR_BE_WORKERS_ENV, "4", 1 );
+
+  rc += TEST_NOT_RC( dbBE.initialize(), NULL, BE );
+  rc += TEST_NOT_RC( dbBE_Redis_namespace_create("WORKERSPACE"), NULL, ns );
+  TEST_BREAK( rc, "Backend initialization failed" );
+
+  dbBE_Redis_context_t *rbe = (dbBE_Redis_context_t*)BE;
+  rc += TEST( rbe->_worker_count, WORKER_TEST_WORKERS );
+  rc += TEST_NOT( rbe->_workers, NULL );
+
+  // an interrupted wait returns without a completion
+  rc += TEST( dbBE.wakeup( BE ), 0 );
+  rc += TEST( dbBE.wait( BE, 10000000 ), 0 );
+  rc += TEST( dbBE.wait( BE, 1000 ), 0 );
+  TEST_LOG( rc, "Workers started" );
+
+  dbBE_Request_t *reqs[ WORKER_TEST_REQUESTS ];
+  char *keys = (char*)calloc( WORKER_TEST_REQUESTS, 32 );
+  char *values = (char*)calloc( WORKER_TEST_REQUESTS, WORKER_TEST_VALUE_LEN );
+  char *results = (char*)calloc( WORKER_TEST_REQUESTS, WORKER_TEST_VALUE_LEN );
+  for( n = 0; n < WORKER_TEST_REQUESTS; ++n )
+  {
+    reqs[ n ] = (dbBE_Request_t*)calloc( 1, sizeof( dbBE_Request_t ) + sizeof( dbBE_sge_t ) );
+    snprintf( &keys[ n * 32 ], 32, "worker_key_%d", n );
+    memset( &values[ n * WORKER_TEST_VALUE_LEN ], 'a' + ( n % 26 ), WORKER_TEST_VALUE_LEN );
+  }
+
+  // keys are spread across the hash slots and thus across all connections and workers
+  for( n = 0; n < WORKER_TEST_REQUESTS; ++n )
+  {
+    reqs[ n ]->_key = &keys[ n * 32 ];
+    reqs[ n ]->_ns_hdl = ns;
+    reqs[ n ]->_opcode = DBBE_OPCODE_PUT;
+    reqs[ n ]->_user = reqs[ n ];
+    reqs[ n ]->_sge_count = 1;
+    reqs[ n ]->_sge[0].iov_base = &values[ n * WORKER_TEST_VALUE_LEN ];
+    reqs[ n ]->_sge[0].iov_len = WORKER_TEST_VALUE_LEN;
+  }
+  rc += run_requests( BE, reqs, WORKER_TEST_REQUESTS );
+  TEST_LOG( rc, "PUT" );
+
+  for( n = 0; n < WORKER_TEST_REQUESTS; ++n )
+  {
+    reqs[ n ]->_opcode = DBBE_OPCODE_READ;
+    reqs[ n ]->_sge[0].iov_base = &results[ n * WORKER_TEST_VALUE_LEN ];
+  }
+  rc += run_requests( BE, reqs, WORKER_TEST_REQUESTS );
+  rc += TEST( memcmp( values, results, WORKER_TEST_REQUESTS * WORKER_TEST_VALUE_LEN ), 0 );
+  TEST_LOG( rc, "READ" );
+
+  for( n = 0; n < WORKER_TEST_REQUESTS; ++n )
+  {
+    reqs[ n ]->_opcode = DBBE_OPCODE_REMOVE;
+    reqs[ n ]->_sge_count = 0;
+  }
+  rc += run_requests( BE, reqs, WORKER_TEST_REQUESTS );
+  TEST_LOG( rc, "REMOVE" );
+
+  for( n = 0; n < WORKER_TEST_REQUESTS; ++n )
+    free( reqs[ n ] );
+  free( results );
+  free( values );
+  free( keys );
+
+  rc += TEST( dbBE_Redis_namespace_destroy( ns ), 0 );
+  rc += TEST( dbBE.exit( BE ), 0 );
+
+  printf( "Test exiting with rc=%d\n", rc );
+  return rc;
+}
@@ -0,0 +1,525 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef __APPLE__
+#include <stdlib.h>
+#else
+#include <malloc.h>  // malloc
+#endif
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "logutil.h"
+#include "uring.h"
+
+#ifdef DBBE_REDIS_WITH_URING
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+#ifndef RWF_NOWAIT
+#define RWF_NOWAIT ( 0x00000008 )
+#endif
+
+// one submission per connection is the most a batch can hold
+#define DBBE_REDIS_URING_ENTRIES ( DBBE_REDIS_MAX_CONNECTIONS )
+
+typedef struct
+{
+  dbBE_Redis_connection_t *_conn;
+  ssize_t _total;
+  struct msghdr _msg;
+} dbBE_Redis_uring_send_t;
+
+struct dbBE_Redis_uring
+{
+  int _fd;
+  unsigned _entries;
+
+  // submission ring
+  void *_sq_ptr;
+  size_t _sq_size;
+  unsigned *_sq_head;
+  unsigned *_sq_tail;
+  unsigned *_sq_mask;
+  unsigned *_sq_array;
+  struct io_uring_sqe *_sqes;
+  size_t _sqes_size;
+
+  // completion ring (shares the mapping with the submission ring if the kernel supports it)
+  void *_cq_ptr;
+  size_t _cq_size;
+  unsigned *_cq_head;
+  unsigned *_cq_tail;
+  unsigned *_cq_mask;
+  struct io_uring_cqe *_cqes;
+
+  unsigned _queued;  // prepared but not yet submitted entries
+
+  // queued sends of the current batch
+  dbBE_Redis_uring_send_t _sends[ DBBE_REDIS_URING_ENTRIES ];
+  int _send_count;
+
+  // registered receive buffers, one slot per connection index
+  int _fixed;                                        // sparse buffer table is registered
+  uint64_t _buf_gen[ DBBE_REDIS_MAX_CONNECTIONS ];   // buffer generation registered in the slot
+  int8_t _buf_ok[ DBBE_REDIS_MAX_CONNECTIONS ];      // the registration of the slot succeeded
+  int8_t _recv_queued[ DBBE_REDIS_MAX_CONNECTIONS ]; // a receive of the connection is in the current batch
+};
+
+
+static inline
+int dbBE_Redis_uring_sys_setup( unsigned entries, struct io_uring_params *p )
+{
+  return (int)syscall( __NR_io_uring_setup, entries, p );
+}
+
+static inline
+int dbBE_Redis_uring_sys_enter( int fd, unsigned to_submit, unsigned min_complete, unsigned flags )
+{
+  return (int)syscall( __NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0 );
+}
+
+static inline
+int dbBE_Redis_uring_sys_register( int fd, unsigned opcode, void *arg, unsigned nr_args )
+{
+  return (int)syscall( __NR_io_uring_register, fd, opcode, arg, nr_args );
+}
+
+
+int dbBE_Redis_uring_available()
+{
+  struct io_uring_params p;
+  memset( &p, 0, sizeof( p ) );
+  int fd = dbBE_Redis_uring_sys_setup( 1, &p );
+  if( fd < 0 )
+    return 0;
+  close( fd );
+  return 1;
+}
+
+dbBE_Redis_uring_t* dbBE_Redis_uring_create()
+{
+  dbBE_Redis_uring_t *ring = (dbBE_Redis_uring_t*)calloc( 1, sizeof( dbBE_Redis_uring_t ) );
+  if( ring == NULL )
+    return NULL;
+
+  struct io_uring_params p;
+  memset( &p, 0, sizeof( p ) );
+  ring->_fd = dbBE_Redis_uring_sys_setup( DBBE_REDIS_URING_ENTRIES, &p );
+  if( ring->_fd < 0 )
+  {
+    int err = errno;
+    LOG( DBG_VERBOSE, stderr, "io_uring setup failed. errno=%d\n", err );
+    free( ring );
+    errno = err;
+    return NULL;
+  }
+  ring->_entries = p.sq_entries;
+
+  ring->_sq_size = p.sq_off.array + p.sq_entries * sizeof( unsigned );
+  ring->_cq_size = p.cq_off.cqes + p.cq_entries * sizeof( struct io_uring_cqe );
+  if( p.features & IORING_FEAT_SINGLE_MMAP )
+  {
+    if( ring->_cq_size > ring->_sq_size )
+      ring->_sq_size = ring->_cq_size;
+    ring->_cq_size = ring->_sq_size;
+  }
+
+  ring->_sq_ptr = mmap( NULL, ring->_sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring->_fd, IORING_OFF_SQ_RING );
+  if( ring->_sq_ptr == MAP_FAILED )
+    goto error;
+
+  if( p.features & IORING_FEAT_SINGLE_MMAP )
+    ring->_cq_ptr = ring->_sq_ptr;
+  else
+  {
+    ring->_cq_ptr = mmap( NULL, ring->_cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          ring->_fd, IORING_OFF_CQ_RING );
+    if( ring->_cq_ptr == MAP_FAILED )
+    {
+      ring->_cq_ptr = NULL;
+      goto error;
+    }
+  }
+
+  ring->_sqes_size = p.sq_entries * sizeof( struct io_uring_sqe );
+  ring->_sqes = (struct io_uring_sqe*)mmap( NULL, ring->_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                           ring->_fd, IORING_OFF_SQES );
+  if( ring->_sqes == MAP_FAILED )
+  {
+    ring->_sqes = NULL;
+    goto error;
+  }
+
+  char *sq = (char*)ring->_sq_ptr;
+  ring->_sq_head = (unsigned*)( sq + p.sq_off.head );
+  ring->_sq_tail = (unsigned*)( sq + p.sq_off.tail );
+  ring->_sq_mask = (unsigned*)( sq + p.sq_off.ring_mask );
+  ring->_sq_array = (unsigned*)( sq + p.sq_off.array );
+
+  char *cq = (char*)ring->_cq_ptr;
+  ring->_cq_head = (unsigned*)( cq + p.cq_off.head );
+  ring->_cq_tail = (unsigned*)( cq + p.cq_off.tail );
+  ring->_cq_mask = (unsigned*)( cq + p.cq_off.ring_mask );
+  ring->_cqes = (struct io_uring_cqe*)( cq + p.cq_off.cqes );
+
+  // a sparse table lets each connection (re-)register its buffer individually
+  // without it (or if memlock limits are hit), receives go without registered buffers
+  struct io_uring_rsrc_register reg;
+  memset( &reg, 0, sizeof( reg ) );
+  reg.nr = DBBE_REDIS_MAX_CONNECTIONS;
+  reg.flags = IORING_RSRC_REGISTER_SPARSE;
+  ring->_fixed = ( dbBE_Redis_uring_sys_register( ring->_fd, IORING_REGISTER_BUFFERS2, &reg, sizeof( reg ) ) == 0 );
+  LOG( DBG_VERBOSE, stderr, "io_uring created. entries=%u, registered buffers=%d\n", ring->_entries, ring->_fixed );
+
+  return ring;
+
+error:
+  {
+    int err = errno;
+    LOG( DBG_ERR, stderr, "io_uring ring mapping failed. errno=%d\n", err );
+    dbBE_Redis_uring_destroy( ring );
+    errno = err;
+  }
+  return NULL;
+}
+
+void dbBE_Redis_uring_destroy( dbBE_Redis_uring_t *ring )
+{
+  if( ring == NULL )
+    return;
+
+  if( ring->_sqes != NULL )
+    munmap( ring->_sqes, ring->_sqes_size );
+  if(( ring->_cq_ptr != NULL ) && ( ring->_cq_ptr != ring->_sq_ptr ))
+    munmap( ring->_cq_ptr, ring->_cq_size );
+  if(( ring->_sq_ptr != NULL ) && ( ring->_sq_ptr != MAP_FAILED ))
+    munmap( ring->_sq_ptr, ring->_sq_size );
+  // closing the ring also drops the buffer registrations
+  if( ring->_fd >= 0 )
+    close( ring->_fd );
+
+  memset( ring, 0, sizeof( dbBE_Redis_uring_t ) );
+  free( ring );
+}
+
+
+/*
+ * return the next free submission entry; the caller makes sure there's space
+ */
+static inline
+struct io_uring_sqe* dbBE_Redis_uring_get_sqe( dbBE_Redis_uring_t *ring )
+{
+  unsigned tail = *ring->_sq_tail + ring->_queued;
+  unsigned idx = tail & *ring->_sq_mask;
+  struct io_uring_sqe *sqe = &ring->_sqes[ idx ];
+  memset( sqe, 0, sizeof( struct io_uring_sqe ) );
+  ring->_sq_array[ idx ] = idx;
+  ++ring->_queued;
+  return sqe;
+}
+
+/*
+ * publish the prepared entries, submit them, and wait for all of them to complete
+ */
+static
+int dbBE_Redis_uring_submit_and_wait( dbBE_Redis_uring_t *ring )
+{
+  // the completion queue is drained after each batch, so everything in it belongs to this batch
+  unsigned expected = ring->_queued;
+  unsigned to_submit = ring->_queued;
+  __atomic_store_n( ring->_sq_tail, *ring->_sq_tail + ring->_queued, __ATOMIC_RELEASE );
+  ring->_queued = 0;
+
+  for( ;; )
+  {
+    unsigned ready = __atomic_load_n( ring->_cq_tail, __ATOMIC_ACQUIRE ) - *ring->_cq_head;
+    if(( to_submit == 0 ) && ( ready >= expected ))
+      break;
+
+    unsigned wait = ( ready < expected ) ? expected - ready : 0;
+    int rc = dbBE_Redis_uring_sys_enter( ring->_fd, to_submit, wait, IORING_ENTER_GETEVENTS );
+    if( rc < 0 )
+    {
+      if( errno == EINTR )
+        continue;
+      LOG( DBG_ERR, stderr, "io_uring_enter failed. errno=%d\n", errno );
+      return -errno;
+    }
+    to_submit -= ( (unsigned)rc < to_submit ) ? (unsigned)rc : to_submit;
+  }
+  return 0;
+}
+
+/*
+ * hand out the next completion or NULL
+ */
+static inline
+struct io_uring_cqe* dbBE_Redis_uring_peek_cqe( dbBE_Redis_uring_t *ring, unsigned *head )
+{
+  if( *head == __atomic_load_n( ring->_cq_tail, __ATOMIC_ACQUIRE ) )
+    return NULL;
+  return &ring->_cqes[ *head & *ring->_cq_mask ];
+}
+
+
+int dbBE_Redis_uring_send( dbBE_Redis_uring_t *ring,
+                           dbBE_Redis_connection_t *conn )
+{
+  if(( ring == NULL ) || ( conn == NULL ) || ( conn->_cmd->_index > DBBE_SGE_MAX ))
+    return -EINVAL;
+  if( conn->_cmd->_index == 0 )
+    return 0;  // nothing to send
+  if( ! dbBE_Redis_connection_RTS( conn ) )
+    return -ENOTCONN;
+
+  // the sender lists a connection once per group of requests; the batch sends everything at once
+  int n;
+  for( n = 0; n < ring->_send_count; ++n )
+    if( ring->_sends[ n ]._conn == conn )
+      return 0;
+
+  int rc = 0;
+  if(( ring->_send_count >= DBBE_REDIS_URING_ENTRIES ) || ( ring->_queued >= ring->_entries ))
+    rc = dbBE_Redis_uring_send_flush( ring );
+
+  dbBE_Redis_uring_send_t *send = &ring->_sends[ ring->_send_count ];
+  send->_conn = conn;
+  send->_total = dbBE_SGE_get_len( conn->_cmd->_cmd, conn->_cmd->_index );
+  memset( &send->_msg, 0, sizeof( struct msghdr ) );
+  send->_msg.msg_iov = conn->_cmd->_cmd;
+  send->_msg.msg_iovlen = conn->_cmd->_index;
+
+  struct io_uring_sqe *sqe = dbBE_Redis_uring_get_sqe( ring );
+  sqe->opcode = IORING_OP_SENDMSG;
+  sqe->fd = conn->_socket;
+  sqe->addr = (uint64_t)(uintptr_t)&send->_msg;
+  sqe->len = 1;
+  sqe->user_data = (uint64_t)ring->_send_count;
+  ++ring->_send_count;
+
+  return rc;
+}
+
+int dbBE_Redis_uring_send_flush( dbBE_Redis_uring_t *ring )
+{
+  if( ring == NULL )
+    return -EINVAL;
+  if( ring->_send_count == 0 )
+    return 0;
+
+  int rc = dbBE_Redis_uring_submit_and_wait( ring );
+  if( rc != 0 )
+  {
+    // the ring is unusable; drop the batch like a failed sendmsg() would
+    int n;
+    for( n = 0; n < ring->_send_count; ++n )
+      dbBE_Transport_sge_buffer_reset( ring->_sends[ n ]._conn->_cmd );
+    ring->_send_count = 0;
+    return rc;
+  }
+
+  unsigned head = *ring->_cq_head;
+  struct io_uring_cqe *cqe;
+  while(( cqe = dbBE_Redis_uring_peek_cqe( ring, &head ) ) != NULL )
+  {
+    dbBE_Redis_uring_send_t *send = &ring->_sends[ cqe->user_data ];
+    dbBE_Redis_connection_t *conn = send->_conn;
+    ssize_t sent = cqe->res;
+    ++head;
+
+    if(( sent > 0 ) && ( sent < send->_total ))
+    {
+      // rare: finish the rest with the regular path (it resets the cmd vector)
+      LOG( DBG_VERBOSE, stderr, "io_uring partial send %zd of %zd on conn %d\n", sent, send->_total, conn->_index );
+      dbBE_Redis_connection_cmd_consume( conn, sent );
+      sent = dbBE_Redis_connection_send_cmd( conn );
+    }
+    else
+      dbBE_Transport_sge_buffer_reset( conn->_cmd );
+
+    if(( sent < 0 ) && ( rc == 0 ))
+    {
+      LOG( DBG_ERR, stderr, "io_uring send on conn %d failed. rc=%zd\n", conn->_index, sent );
+      rc = (int)sent;
+    }
+  }
+  __atomic_store_n( ring->_cq_head, head, __ATOMIC_RELEASE );
+  ring->_send_count = 0;
+  return rc;
+}
+
+
+/*
+ * make sure the recv buffers of the connection are registered in its slot
+ * returns 1 if the receive can use the registered buffer
+ */
+static
+int dbBE_Redis_uring_register_conn( dbBE_Redis_uring_t *ring,
+                                    dbBE_Redis_connection_t *conn )
+{
+  int slot = conn->_index;
+  if( ring->_fixed == 0 )
+    return 0;
+
+  // only attempt once per buffer generation; a failed registration falls back to plain receives
+  if( ring->_buf_gen[ slot ] != conn->_buffer_gen )
+  {
+    dbBE_Transport_dbuffer_t *dbuf = conn->_recvbuf;
+    struct iovec iov;
+    iov.iov_base = dbuf->_buf[0]._start;  // both halves are one allocation
+    iov.iov_len = dbBE_Transport_sr_buffer_get_size( &dbuf->_buf[0] ) + dbBE_Transport_sr_buffer_get_size( &dbuf->_buf[1] );
+
+    struct io_uring_rsrc_update2 up;
+    memset( &up, 0, sizeof( up ) );
+    up.offset = slot;
+    up.data = (uint64_t)(uintptr_t)&iov;
+    up.nr = 1;
+    ring->_buf_ok[ slot ] = ( dbBE_Redis_uring_sys_register( ring->_fd, IORING_REGISTER_BUFFERS_UPDATE, &up, sizeof( up ) ) == 1 );
+    ring->_buf_gen[ slot ] = conn->_buffer_gen;
+    if( ring->_buf_ok[ slot ] == 0 )
+      LOG( DBG_VERBOSE, stderr, "io_uring buffer registration for conn %d failed. errno=%d\n", slot, errno );
+  }
+  return ring->_buf_ok[ slot ];
+}
+
+int dbBE_Redis_uring_recv( dbBE_Redis_uring_t *ring,
+                           dbBE_Redis_connection_t **conns,
+                           const int count )
+{
+  if(( ring == NULL ) || ( conns == NULL ) || ( count < 0 ))
+    return -EINVAL;
+
+  int n;
+  int prepared = 0;
+  for( n = 0; n < count; ++n )
+  {
+    dbBE_Redis_connection_t *conn = conns[ n ];
+    if(( conn == NULL ) || ( conn->_prefetched ) || ( conn->_status != DBBE_CONNECTION_STATUS_PENDING_DATA ))
+      continue;
+    // the active list may contain a connection more than once
+    if(( (unsigned)conn->_index >= DBBE_REDIS_MAX_CONNECTIONS ) || ( ring->_recv_queued[ conn->_index ] ))
+      continue;
+
+    // leftovers of a previous receive are handled by the regular path
+    dbBE_Redis_sr_buffer_t *buf = dbBE_Transport_dbuffer_get_active( conn->_recvbuf );
+    if( ! dbBE_Transport_sr_buffer_empty( buf ) )
+      continue;
+
+    if( ring->_queued >= ring->_entries )
+      break;
+
+    dbBE_Transport_sr_buffer_reset( buf );
+    struct io_uring_sqe *sqe = dbBE_Redis_uring_get_sqe( ring );
+    sqe->fd = conn->_socket;
+    sqe->addr = (uint64_t)(uintptr_t)dbBE_Transport_sr_buffer_get_available_position( buf );
+    sqe->len = dbBE_Redis_connection_recv_limit( buf );
+    sqe->user_data = (uint64_t)(uintptr_t)conn;
+    if( dbBE_Redis_uring_register_conn( ring, conn ) )
+    {
+      // never block the batch on a connection without data
+      sqe->opcode = IORING_OP_READ_FIXED;
+      sqe->rw_flags = RWF_NOWAIT;
+      sqe->buf_index = conn->_index;
+    }
+    else
+    {
+      sqe->opcode = IORING_OP_RECV;
+      sqe->msg_flags = MSG_DONTWAIT;
+    }
+    ring->_recv_queued[ conn->_index ] = 1;
+    ++prepared;
+  }
+
+  if( prepared == 0 )
+    return 0;
+
+  int rc = dbBE_Redis_uring_submit_and_wait( ring );
+  if( rc != 0 )
+    return rc;
+
+  int received = 0;
+  unsigned head = *ring->_cq_head;
+  struct io_uring_cqe *cqe;
+  while(( cqe = dbBE_Redis_uring_peek_cqe( ring, &head ) ) != NULL )
+  {
+    dbBE_Redis_connection_t *conn = (dbBE_Redis_connection_t*)(uintptr_t)cqe->user_data;
+    ssize_t res = cqe->res;
+    ++head;
+
+    ring->_recv_queued[ conn->_index ] = 0;
+
+    // interrupted or not ready for a non-blocking read: leave it to the regular receive path
+    if(( res == -EINTR ) || ( res == -EAGAIN ))
+      continue;
+
+    dbBE_Redis_sr_buffer_t *buf = dbBE_Transport_dbuffer_get_active( conn->_recvbuf );
+    size_t requested = dbBE_Redis_connection_recv_limit( buf );  // buf is still as it was when the receive was queued
+    conn->_prefetch_rc = dbBE_Redis_connection_recv_result( conn, buf, res, requested );
+    conn->_prefetched = 1;
+    if( conn->_prefetch_rc > 0 )
+      ++received;
+  }
+  __atomic_store_n( ring->_cq_head, head, __ATOMIC_RELEASE );
+  return received;
+}
+
+#else // DBBE_REDIS_WITH_URING
+
+int dbBE_Redis_uring_available()
+{
+  return 0;
+}
+
+dbBE_Redis_uring_t* dbBE_Redis_uring_create()
+{
+  errno = ENOSYS;
+  return NULL;
+}
+
+void dbBE_Redis_uring_destroy( dbBE_Redis_uring_t *ring )
+{
+}
+
+int dbBE_Redis_uring_send( dbBE_Redis_uring_t *ring,
+                           dbBE_Redis_connection_t *conn )
+{
+  return -ENOSYS;
+}
+
+int dbBE_Redis_uring_send_flush( dbBE_Redis_uring_t *ring )
+{
+  return -ENOSYS;
+}
+
+int dbBE_Redis_uring_recv( dbBE_Redis_uring_t *ring,
+                           dbBE_Redis_connection_t **conns,
+                           const int count )
+{
+  return -ENOSYS;
+}
+
+#endif // DBBE_REDIS_WITH_URING
@@ -0,0 +1,73 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef BACKEND_REDIS_URING_H_
+#define BACKEND_REDIS_URING_H_
+
+#include "definitions.h"
+#include "connection.h"
+
+/*
+ * io_uring I/O engine (DBR_BE_IOENGINE=uring)
+ * one instance per I/O context (the caller thread without workers, or each worker)
+ * sends of all pending connections are submitted and completed with a single io_uring_enter()
+ * receives of all active connections are batched the same way into the connection's
+ * registered receive buffers; the receiver then picks up the result without another syscall
+ *
+ * without io_uring support at build or run time, create() fails and the socket calls are used
+ */
+typedef struct dbBE_Redis_uring dbBE_Redis_uring_t;
+
+/*
+ * return 1 if the engine was built in and the kernel supports it; 0 otherwise
+ */
+int dbBE_Redis_uring_available();
+
+/*
+ * create the ring; returns NULL and sets errno if io_uring is not supported
+ */
+dbBE_Redis_uring_t* dbBE_Redis_uring_create();
+
+/*
+ * destroy the ring and release the registered buffers
+ */
+void dbBE_Redis_uring_destroy( dbBE_Redis_uring_t *ring );
+
+/*
+ * queue the cmd vector of a connection for sending
+ * flushes the queued sends first if the ring is full
+ */
+int dbBE_Redis_uring_send( dbBE_Redis_uring_t *ring,
+                           dbBE_Redis_connection_t *conn );
+
+/*
+ * submit all queued sends and wait for their completion
+ * partial sends are finished with the regular send path
+ * returns 0 or the first error
+ */
+int dbBE_Redis_uring_send_flush( dbBE_Redis_uring_t *ring );
+
+/*
+ * receive on all connections in the list that have pending data
+ * the results are stored with each connection and returned by its next dbBE_Redis_connection_recv()
+ * returns the number of connections that received data or a negative error
+ */
+int dbBE_Redis_uring_recv( dbBE_Redis_uring_t *ring,
+                           dbBE_Redis_connection_t **conns,
+                           const int count );
+
+#endif /* BACKEND_REDIS_URING_H_ */
@@ -0,0 +1,347 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef __APPLE__
+#include <stdlib.h>
+#else
+#include <malloc.h>  // malloc
+#endif
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "logutil.h"
+#include "worker.h"
+
+
+int dbBE_Redis_worker_wakeup( dbBE_Redis_worker_t *worker )
+{
+  if(( worker == NULL ) || ( worker->_wakeup_fd[1] < 0 ))
+    return -EINVAL;
+
+  // a full pipe already guarantees the wakeup
+  char c = 0;
+  if(( write( worker->_wakeup_fd[1], &c, 1 ) < 0 ) && ( errno != EAGAIN ) && ( errno != EWOULDBLOCK ))
+    return -errno;
+  return 0;
+}
+
+int dbBE_Redis_worker_forward( dbBE_Redis_context_t *backend,
+                               const int id,
+                               dbBE_Redis_request_t *request )
+{
+  if(( backend == NULL ) || ( request == NULL ) || ( id < 0 ) || ( id >= backend->_worker_count ))
+    return -EINVAL;
+
+  dbBE_Redis_worker_t *worker = &backend->_workers[ id ];
+  if( dbBE_Redis_s2r_queue_push( worker->_inbox, request ) != 0 )
+    return -ENOMEM;
+  dbBE_Redis_worker_wakeup( worker );
+  return 0;
+}
+
+/*
+ * create the poll list of owned connections + wakeup pipe
+ * requires the backend lock
+ */
+static
+int dbBE_Redis_worker_poll_setup( dbBE_Redis_worker_t *worker )
+{
+  dbBE_Redis_connection_mgr_t *conn_mgr = worker->_backend->_conn_mgr;
+  int nfds = 0;
+  int i;
+  for( i = 0; i < (int)DBBE_REDIS_MAX_CONNECTIONS; ++i )
+  {
+    dbBE_Redis_connection_t *conn = dbBE_Redis_connection_mgr_get_connection_at( conn_mgr, i );
+    if(( conn == NULL ) || ( conn->_worker != worker->_id ) || ( ! dbBE_Redis_connection_RTR( conn ) ))
+      continue;
+    worker->_polled[ nfds ] = conn;
+    worker->_polled_idx[ nfds ] = i;
+    worker->_fds[ nfds ].fd = conn->_socket;
+    worker->_fds[ nfds ].events = POLLIN;
+    worker->_fds[ nfds ].revents = 0;
+    ++nfds;
+  }
+  worker->_fds[ nfds ].fd = worker->_wakeup_fd[0];
+  worker->_fds[ nfds ].events = POLLIN;
+  worker->_fds[ nfds ].revents = 0;
+  worker->_nfds = nfds;
+  return nfds + 1;
+}
+
+/*
+ * turn the poll results into the list of active connections for the receiver
+ * requires the backend lock
+ */
+static
+void dbBE_Redis_worker_collect_ready( dbBE_Redis_worker_t *worker )
+{
+  dbBE_Redis_connection_mgr_t *conn_mgr = worker->_backend->_conn_mgr;
+  int n;
+  worker->_ready_count = 0;
+  for( n = 0; n < worker->_nfds; ++n )
+  {
+    if( worker->_fds[ n ].revents == 0 )
+      continue;
+    // only pick up connections that are still the same since the poll list was created
+    dbBE_Redis_connection_t *conn = worker->_polled[ n ];
+    if(( dbBE_Redis_connection_mgr_get_connection_at( conn_mgr, worker->_polled_idx[ n ] ) != conn ) ||
+        ( conn->_socket != worker->_fds[ n ].fd ) ||
+        ( conn->_worker != worker->_id ))
+      continue;
+    dbBE_Redis_connection_set_active( conn );
+    worker->_ready[ worker->_ready_count++ ] = conn;
+  }
+  worker->_nfds = 0;
+}
+
+/*
+ * connection recovery touches connections of all workers, so it requires exclusive access
+ */
+static
+dbBE_Redis_connection_recoverable_t dbBE_Redis_worker_recover( dbBE_Redis_worker_t *worker )
+{
+  dbBE_Redis_context_t *backend = worker->_backend;
+  dbBE_Redis_connection_recoverable_t recoverable = DBBE_REDIS_CONNECTION_RECOVERED;
+
+  pthread_rwlock_wrlock( &backend->_io_lock );
+  pthread_mutex_lock( &backend->_lock );
+  if( backend->_recover != 0 )
+  {
+    recoverable = dbBE_Redis_sender_recover( backend );
+    backend->_recover = 0;
+    ++backend->_recoveries;
+  }
+  pthread_mutex_unlock( &backend->_lock );
+  pthread_rwlock_unlock( &backend->_io_lock );
+  return recoverable;
+}
+
+static
+void* dbBE_Redis_worker_main( void *arg )
+{
+  dbBE_Redis_worker_t *worker = (dbBE_Redis_worker_t*)arg;
+  dbBE_Redis_context_t *backend = worker->_backend;
+
+  dbBE_Redis_io_args_t args;
+  args._backend = backend;
+  args._looping = 1;
+  args._worker = worker;
+
+  unsigned recoveries = 0;
+  char buf[ 64 ];
+
+  while( worker->_running )
+  {
+    pthread_rwlock_rdlock( &backend->_io_lock );
+
+    pthread_mutex_lock( &backend->_lock );
+    if( recoveries == backend->_recoveries )
+      dbBE_Redis_worker_collect_ready( worker );
+    pthread_mutex_unlock( &backend->_lock );
+
+    // receive on all ready connections with a single syscall; the receiver picks up the results
+    if(( worker->_uring != NULL ) && ( worker->_ready_count > 0 ))
+      dbBE_Redis_uring_recv( worker->_uring, worker->_ready, worker->_ready_count );
+
+    dbBE_Redis_sender( (void*)&args );
+    dbBE_Redis_receiver( (void*)&args );
+
+    pthread_mutex_lock( &backend->_lock );
+    size_t queued = dbBE_Ring_len( backend->_work_q );
+    // a blocked post can retry now that there's space in the work queue
+    if(( backend->_post_blocked != 0 ) && ( queued < dbBE_Ring_capacity( backend->_work_q ) ))
+    {
+      backend->_post_blocked = 0;
+      pthread_cond_broadcast( &backend->_cpl_cond );
+    }
+    else if( dbBE_Redis_completion_len( backend ) != 0 )
+      pthread_cond_broadcast( &backend->_cpl_cond );
+    int busy = ( dbBE_Redis_s2r_queue_len( worker->_inbox ) != 0 )
+        || ( dbBE_Redis_s2r_queue_len( backend->_retry_q ) != 0 )
+        || ( queued != 0 );
+    int recover = backend->_recover;
+    int nfds = dbBE_Redis_worker_poll_setup( worker );
+    recoveries = backend->_recoveries;
+    pthread_mutex_unlock( &backend->_lock );
+
+    pthread_rwlock_unlock( &backend->_io_lock );
+
+    if(( recover != 0 ) && ( dbBE_Redis_worker_recover( worker ) != DBBE_REDIS_CONNECTION_RECOVERED ))
+      busy = 0; // don't spin while the cluster is not reachable
+
+    if( poll( worker->_fds, nfds, busy ? 0 : DBBE_REDIS_WORKER_POLL_TIMEOUT ) < 0 )
+    {
+      if( errno != EINTR )
+        LOG( DBG_ERR, stderr, "Redis worker %d: poll failed. errno=%d\n", worker->_id, errno );
+      worker->_nfds = 0;
+    }
+
+    if( worker->_fds[ nfds - 1 ].revents != 0 )
+      while( read( worker->_wakeup_fd[0], buf, sizeof( buf ) ) > 0 ) {}
+  }
+  return NULL;
+}
+
+/*
+ * release the resources of a (stopped or never started) worker
+ */
+static
+void dbBE_Redis_worker_cleanup( dbBE_Redis_worker_t *worker )
+{
+  if( worker->_wakeup_fd[0] >= 0 )
+    close( worker->_wakeup_fd[0] );
+  if( worker->_wakeup_fd[1] >= 0 )
+    close( worker->_wakeup_fd[1] );
+  worker->_wakeup_fd[0] = worker->_wakeup_fd[1] = -1;
+  if( worker->_inbox != NULL )
+    dbBE_Redis_s2r_queue_destroy( worker->_inbox );
+  if( worker->_sender_connections != NULL )
+    free( worker->_sender_connections );
+  if( worker->_sender_buffer != NULL )
+    dbBE_Transport_sr_buffer_free( worker->_sender_buffer );
+  dbBE_Redis_uring_destroy( worker->_uring );
+  worker->_inbox = NULL;
+  worker->_sender_connections = NULL;
+  worker->_sender_buffer = NULL;
+  worker->_uring = NULL;
+}
+
+static
+int dbBE_Redis_worker_init( dbBE_Redis_worker_t *worker, dbBE_Redis_context_t *backend, const int id )
+{
+  memset( worker, 0, sizeof( dbBE_Redis_worker_t ) );
+  worker->_id = id;
+  worker->_backend = backend;
+  worker->_wakeup_fd[0] = worker->_wakeup_fd[1] = -1;
+
+  if(( pipe( worker->_wakeup_fd ) != 0 )
+      || ( fcntl( worker->_wakeup_fd[0], F_SETFL, O_NONBLOCK ) != 0 )
+      || ( fcntl( worker->_wakeup_fd[1], F_SETFL, O_NONBLOCK ) != 0 ))
+  {
+    int err = errno;
+    LOG( DBG_ERR, stderr, "Redis worker %d: Failed to create wakeup pipe. errno=%d\n", id, err );
+    return -err;
+  }
+
+  worker->_sender_buffer = dbBE_Transport_sr_buffer_allocate( DBBE_REDIS_SR_BUFFER_LEN );
+  worker->_sender_connections = (int*)calloc( DBBE_REDIS_COALESCED_MAX * DBBE_REDIS_MAX_CONNECTIONS + 1, sizeof( int ));
+  worker->_inbox = dbBE_Redis_s2r_queue_create( 1 );
+  if(( worker->_sender_buffer == NULL ) || ( worker->_sender_connections == NULL ) || ( worker->_inbox == NULL ))
+  {
+    LOG( DBG_ERR, stderr, "Redis worker %d: Failed to allocate sender resources\n", id );
+    return -ENOMEM;
+  }
+
+  if( backend->_ioengine_uring )
+  {
+    worker->_uring = dbBE_Redis_uring_create();
+    if( worker->_uring == NULL )
+      LOG( DBG_ERR, stderr, "Redis worker %d: io_uring not available (errno=%d); using socket calls\n", id, errno );
+  }
+  return 0;
+}
+
+int dbBE_Redis_workers_start( dbBE_Redis_context_t *backend, const int count )
+{
+  if(( backend == NULL ) || ( count <= 0 ) || ( count > DBBE_REDIS_MAX_WORKERS ) || ( backend->_workers != NULL ))
+    return -EINVAL;
+
+  dbBE_Redis_worker_t *workers = (dbBE_Redis_worker_t*)calloc( count, sizeof( dbBE_Redis_worker_t ) );
+  if( workers == NULL )
+    return -ENOMEM;
+
+  int rc = 0;
+  int n;
+  for( n = 0; n < count; ++n )
+  {
+    rc = dbBE_Redis_worker_init( &workers[ n ], backend, n );
+    if( rc != 0 )
+    {
+      for( ; n >= 0; --n )
+        dbBE_Redis_worker_cleanup( &workers[ n ] );
+      free( workers );
+      return rc;
+    }
+  }
+
+  // redistribute the existing connections; from here on everything needs to happen under the lock
+  pthread_mutex_lock( &backend->_lock );
+  backend->_workers = workers;
+  backend->_worker_count = count;
+  backend->_conn_mgr->_worker_count = count;
+  for( n = 0; n < (int)DBBE_REDIS_MAX_CONNECTIONS; ++n )
+  {
+    if( backend->_conn_mgr->_connections[ n ] != NULL )
+      backend->_conn_mgr->_connections[ n ]->_worker = n % count;
+    if( backend->_conn_mgr->_broken[ n ] != NULL )
+      backend->_conn_mgr->_broken[ n ]->_worker = n % count;
+  }
+
+  for( n = 0; n < count; ++n )
+  {
+    workers[ n ]._running = 1;
+    rc = pthread_create( &workers[ n ]._thread, NULL, dbBE_Redis_worker_main, (void*)&workers[ n ] );
+    if( rc != 0 )
+    {
+      LOG( DBG_ERR, stderr, "Redis worker %d: Failed to start thread. rc=%d\n", n, rc );
+      workers[ n ]._running = 0;
+      break;
+    }
+  }
+  pthread_mutex_unlock( &backend->_lock );
+
+  if( rc != 0 )
+  {
+    dbBE_Redis_workers_stop( backend );
+    return -rc;
+  }
+  return 0;
+}
+
+int dbBE_Redis_workers_stop( dbBE_Redis_context_t *backend )
+{
+  if( backend == NULL )
+    return -EINVAL;
+  if( backend->_workers == NULL )
+    return 0;
+
+  int n;
+  for( n = 0; n < backend->_worker_count; ++n )
+  {
+    dbBE_Redis_worker_t *worker = &backend->_workers[ n ];
+    if( worker->_running == 0 )
+      continue;
+    worker->_running = 0;
+    dbBE_Redis_worker_wakeup( worker );
+    pthread_join( worker->_thread, NULL );
+  }
+
+  // requests that are stuck in an inbox are dropped just like the ones in the other queues
+  for( n = 0; n < backend->_worker_count; ++n )
+    dbBE_Redis_worker_cleanup( &backend->_workers[ n ] );
+
+  free( backend->_workers );
+  backend->_workers = NULL;
+  backend->_worker_count = 0;
+  backend->_conn_mgr->_worker_count = 0;
+  return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef BACKEND_REDIS_WORKER_H_
+#define BACKEND_REDIS_WORKER_H_
+
+#include <pthread.h>
+#include <poll.h>
+
+#include "definitions.h"
+#include "redis.h"
+#include "uring.h"
+
+/*
+ * I/O worker thread
+ * each worker owns the connections with ( index % worker_count == id ) incl. their blocking connections
+ * only the owner sends, receives, and parses on a connection; requests for other connections
+ * are forwarded to the inbox of the owning worker
+ */
+typedef struct dbBE_Redis_worker
+{
+  pthread_t _thread;
+  int _id;
+  volatile int _running;
+  int _wakeup_fd[ 2 ];                        // pipe to interrupt the poll
+  dbBE_Redis_context_t *_backend;
+  dbBE_Redis_sr_buffer_t *_sender_buffer;     // command assembly buffer of this worker
+  int *_sender_connections;                   // pending connections of this worker's sender
+  dbBE_Redis_s2r_queue_t *_inbox;             // requests forwarded by other workers (protected by the backend lock)
+
+  struct pollfd _fds[ DBBE_REDIS_MAX_CONNECTIONS + 1 ];  // owned connections + wakeup pipe
+  dbBE_Redis_connection_t *_polled[ DBBE_REDIS_MAX_CONNECTIONS ];
+  int _polled_idx[ DBBE_REDIS_MAX_CONNECTIONS ];
+  int _nfds;
+  dbBE_Redis_connection_t *_ready[ DBBE_REDIS_MAX_CONNECTIONS ];  // owned connections with pending data
+  int _ready_count;
+  dbBE_Redis_uring_t *_uring;                 // io_uring engine of this worker (DBR_BE_IOENGINE=uring) or NULL
+} dbBE_Redis_worker_t;
+
+
+/*
+ * start the I/O worker threads
+ * from here on, the backend lock needs to be held when accessing queues and topology
+ */
+int dbBE_Redis_workers_start( dbBE_Redis_context_t *backend, const int count );
+
+/*
+ * stop and join all worker threads and release their resources
+ */
+int dbBE_Redis_workers_stop( dbBE_Redis_context_t *backend );
+
+/*
+ * interrupt the poll of a worker
+ */
+int dbBE_Redis_worker_wakeup( dbBE_Redis_worker_t *worker );
+
+/*
+ * hand a request over to the worker that owns its connection
+ * requires the backend lock
+ */
+int dbBE_Redis_worker_forward( dbBE_Redis_context_t *backend,
+                               const int id,
+                               dbBE_Redis_request_t *request );
+
+/*
+ * return the next owned connection with pending data or NULL if there's none
+ */
+static inline
+dbBE_Redis_connection_t* dbBE_Redis_worker_get_active( dbBE_Redis_worker_t *worker )
+{
+  if(( worker == NULL ) || ( worker->_ready_count <= 0 ))
+    return NULL;
+  return worker->_ready[ --worker->_ready_count ];
+}
+
+#endif /* BACKEND_REDIS_WORKER_H_ */
@@ -0,0 +1,127 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include "libdbrAPI.h"
+
+#include <stdlib.h>
+
+/*
+ * one chain entry with a single SGE per tuple, all entries in one allocation
+ * for puts the return size points into the entry itself, for reads into the user size array
+ */
+static
+dbrDA_Request_chain_t* dbrBatch_create_chain( const int count,
+                                              void **va_ptr,
+                                              int64_t *size,
+                                              DBR_Tuple_name_t *tuple_name,
+                                              const int user_ret_size )
+{
+  if(( count <= 0 ) || ( va_ptr == NULL ) || ( size == NULL ) || ( tuple_name == NULL ))
+    return NULL;
+
+  const size_t entry_size = sizeof( dbrDA_Request_chain_t ) + sizeof( dbBE_sge_t );
+  char *mem = (char*)calloc( count, entry_size );
+  if( mem == NULL )
+    return NULL;
+
+  int i;
+  for( i = 0; i < count; ++i )
+  {
+    dbrDA_Request_chain_t *req = (dbrDA_Request_chain_t*)( mem + i * entry_size );
+    req->_next = ( i < count - 1 ) ? (dbrDA_Request_chain_t*)( mem + (i+1) * entry_size ) : NULL;
+    req->_key = tuple_name[ i ];
+    req->_size = size[ i ];
+    req->_ret_size = user_ret_size ? &size[ i ] : &req->_size;
+    req->_sge_count = 1;
+    req->_value_sge[0].iov_base = va_ptr[ i ];
+    req->_value_sge[0].iov_len = size[ i ];
+  }
+  return (dbrDA_Request_chain_t*)mem;
+}
+
+DBR_Errorcode_t
+dbrPutBatch( DBR_Handle_t cs_handle,
+             const int count,
+             void **va_ptr,
+             int64_t *size,
+             DBR_Tuple_name_t *tuple_name,
+             DBR_Group_t group,
+             DBR_Errorcode_t *status )
+{
+  dbrDA_Request_chain_t *req = dbrBatch_create_chain( count, va_ptr, size, tuple_name, 0 );
+  if( req == NULL )
+    return DBR_ERR_INVALID;
+
+  DBR_Errorcode_t rc;
+  rc = libdbrPutBatch( cs_handle,
+                       req,
+                       group,
+                       status );
+  free( req );
+  return rc;
+}
+
+DBR_Errorcode_t
+dbrGetBatch( DBR_Handle_t cs_handle,
+             const int count,
+             void **va_ptr,
+             int64_t *size,
+             DBR_Tuple_name_t *tuple_name,
+             DBR_Tuple_template_t match_template,
+             DBR_Group_t group,
+             int flags,
+             DBR_Errorcode_t *status )
+{
+  dbrDA_Request_chain_t *req = dbrBatch_create_chain( count, va_ptr, size, tuple_name, 1 );
+  if( req == NULL )
+    return DBR_ERR_INVALID;
+
+  DBR_Errorcode_t rc;
+  rc = libdbrGetBatch( cs_handle,
+                       req,
+                       match_template,
+                       group,
+                       flags,
+                       status );
+  free( req );
+  return rc;
+}
+
+DBR_Errorcode_t
+dbrReadBatch( DBR_Handle_t cs_handle,
+              const int count,
+              void **va_ptr,
+              int64_t *size,
+              DBR_Tuple_name_t *tuple_name,
+              DBR_Tuple_template_t match_template,
+              DBR_Group_t group,
+              int flags,
+              DBR_Errorcode_t *status )
+{
+  dbrDA_Request_chain_t *req = dbrBatch_create_chain( count, va_ptr, size, tuple_name, 1 );
+  if( req == NULL )
+    return DBR_ERR_INVALID;
+
+  DBR_Errorcode_t rc;
+  rc = libdbrReadBatch( cs_handle,
+                        req,
+                        match_template,
+                        group,
+                        flags,
+                        status );
+  free( req );
+  return rc;
+}
@@ -18,6 +18,7 @@
 #include "libdatabroker_int.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 DBR_Errorcode_t
 dbrGet (DBR_Handle_t cs_handle,
@@ -28,7 +29,9 @@ dbrGet (DBR_Handle_t cs_handle,
         DBR_Group_t group,
         int flags )
 {
-  dbrDA_Request_chain_t *req = (dbrDA_Request_chain_t*)calloc( 1, sizeof( dbrDA_Request_chain_t ) + sizeof( dbBE_sge_t ) );;
+  dbrDA_Request_single_t single;
+  memset( &single, 0, sizeof( single ) );
+  dbrDA_Request_chain_t *req = &single._chain;
   req->_key = tuple_name;
   req->_ret_size = size;
   req->_size = *size;
@@ -43,7 +46,6 @@ dbrGet (DBR_Handle_t cs_handle,
                   match_template,
                   group,
                   flags );
-  free( req );
   return rc;
 }
 
@@ -70,6 +72,42 @@ dbrGetA (DBR_Handle_t cs_handle,
                      match_template,
                      group,
                      flags,
-                     size );
+                     size,
+                     NULL,
+                     NULL );
   // no free of req here, since it's needed for dbrTest()
 }
+
+
+DBR_Tag_t
+dbrGetA_cb (DBR_Handle_t cs_handle,
+            void *va_ptr,
+            int64_t *size,
+            DBR_Tuple_name_t tuple_name,
+            DBR_Tuple_template_t match_template,
+            DBR_Group_t group,
+            int flags,
+            DBR_Callback_t callback,
+            void *user )
+{
+  if( callback == NULL )
+    return DB_TAG_ERROR;
+
+  dbrDA_Request_chain_t *req = (dbrDA_Request_chain_t*)calloc( 1, sizeof( dbrDA_Request_chain_t ) + sizeof( dbBE_sge_t ) );
+  req->_key = tuple_name;
+  req->_ret_size = size;
+  req->_size = *size;
+  req->_sge_count = 1;
+  req->_value_sge[0].iov_base = va_ptr;
+  req->_value_sge[0].iov_len = *size;
+
+  return libdbrGetA( cs_handle,
+                     req,
+                     match_template,
+                     group,
+                     flags,
+                     size,
+                     callback,
+                     user );
+  // no free of req here, it's cleaned up when the request completes
+}
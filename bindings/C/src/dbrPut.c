@@ -17,6 +17,7 @@
 #include "libdbrAPI.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 DBR_Errorcode_t
 dbrPut (DBR_Handle_t cs_handle,
@@ -25,7 +26,9 @@ dbrPut (DBR_Handle_t cs_handle,
         DBR_Tuple_name_t tuple_name,
         DBR_Group_t group)
 {
-  dbrDA_Request_chain_t *req = (dbrDA_Request_chain_t*)calloc( 1, sizeof( dbrDA_Request_chain_t ) + sizeof( dbBE_sge_t ) );
+  dbrDA_Request_single_t single;
+  memset( &single, 0, sizeof( single ) );
+  dbrDA_Request_chain_t *req = &single._chain;
   req->_key = tuple_name;
   req->_size = size;
   req->_ret_size = &req->_size;
@@ -37,7 +40,6 @@ dbrPut (DBR_Handle_t cs_handle,
   rc = libdbrPut( cs_handle,
                   req,
                   group );
-  free( req );
   return rc;
 }
 
@@ -60,6 +62,38 @@ dbrPutA (DBR_Handle_t cs_handle,
 
   return libdbrPutA( cs_handle,
                      req,
-                     group );
+                     group,
+                     NULL,
+                     NULL );
   // no free of req here, since it's needed for dbrTest()
 }
+
+
+DBR_Tag_t
+dbrPutA_cb (DBR_Handle_t cs_handle,
+            void *va_ptr,
+            int64_t size,
+            DBR_Tuple_name_t tuple_name,
+            DBR_Group_t group,
+            DBR_Callback_t callback,
+            void *user )
+{
+  if( callback == NULL )
+    return DB_TAG_ERROR;
+
+  dbrDA_Request_chain_t *req = (dbrDA_Request_chain_t*)calloc( 1, sizeof( dbrDA_Request_chain_t) + sizeof( dbBE_sge_t ));
+  req->_key = tuple_name;
+  req->_next = NULL;
+  req->_size = size;
+  req->_ret_size = &req->_size;
+  req->_sge_count = 1;
+  req->_value_sge[0].iov_base = va_ptr;
+  req->_value_sge[0].iov_len = size;
+
+  return libdbrPutA( cs_handle,
+                     req,
+                     group,
+                     callback,
+                     user );
+  // no free of req here, it's cleaned up when the request completes
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include "libdbrAPI.h"
+
+DBR_Errorcode_t
+dbrTestSome( const int count,
+             DBR_Tag_t *tags,
+             int *completed,
+             int *indices,
+             DBR_Errorcode_t *status )
+{
+  return libdbrTestSome( count, tags, completed, indices, status );
+}
+
+DBR_Errorcode_t
+dbrWaitAny( const int count,
+            DBR_Tag_t *tags,
+            int *index,
+            DBR_Errorcode_t *status )
+{
+  return libdbrWaitAny( count, tags, index, status );
+}
+
+DBR_Errorcode_t
+dbrWaitAll( const int count,
+            DBR_Tag_t *tags,
+            DBR_Errorcode_t *status )
+{
+  return libdbrWaitAll( count, tags, status );
+}
@@ -202,6 +202,12 @@ def testKey(dbr_hdl, tuple_name):
     retval = libdatabroker.dbrTestKey(dbr_hdl, tuple_name)
     return retval
 
+def stat(dbr_hdl, group, tuple_name):
+    count = ffi.new('int64_t*')
+    size = ffi.new('int64_t*')
+    retval = libdatabroker.dbrStat(dbr_hdl, group.encode(), tuple_name.encode(), count, size)
+    return count[0], size[0], retval
+
 def directory(dbr_hdl, match_template, group, count, size):
     tbuf = createBuf('char[]',size)
     rsize = ffi.new('int64_t*')
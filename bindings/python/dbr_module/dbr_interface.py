@@ -172,6 +172,12 @@ DBR_Tag_t dbrReadA( DBR_Handle_t cs_handle,
 
 DBR_Errorcode_t dbrTestKey( DBR_Handle_t cs_handle, DBR_Tuple_name_t tuple_name );
 
+DBR_Errorcode_t dbrStat( DBR_Handle_t cs_handle,
+                         DBR_Group_t group,
+                         DBR_Tuple_name_t tuple_name,
+                         int64_t *count,
+                         int64_t *size );
+
 DBR_Errorcode_t dbrDirectory( DBR_Handle_t cs_handle,
                               DBR_Tuple_template_t match_template,
                               DBR_Group_t group,
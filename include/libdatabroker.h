@@ -44,6 +44,26 @@
  */
 #define DBR_TIMEOUT_DEFAULT ( 5 )
 
+#define DBR_PROGRESS_ENV "DBR_PROGRESS"
+/**
+ * @brief Background progress.
+ *
+ * If enabled, a library-owned thread drives the back-end and completes requests
+ * while the application is busy. Test calls then only check the request status.
+ * It can be enabled by setting the environment variable **DBR_PROGRESS** to 1.
+ */
+#define DBR_PROGRESS_DEFAULT ( 0 )
+
+#define DBR_MAX_TAGS_ENV "DBR_MAX_TAGS"
+/**
+ * @brief Maximum number of outstanding requests.
+ *
+ * The table of in-flight requests starts with DBR_POSTED_QUEUE_DEPTH entries and
+ * grows on demand up to this limit. Beyond it, asynchronous calls fail with DB_TAG_ERROR.
+ * It can be set using the environment variable **DBR_MAX_TAGS**.
+ */
+#define DBR_MAX_TAGS_DEFAULT ( 1048576 )
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -261,7 +281,7 @@ typedef void* DBR_Iterator_t;
 
 
 /**
- * @brief Maximum number of in-flight non-blocking commands
+ * @brief Initial number of in-flight non-blocking commands (see DBR_MAX_TAGS_DEFAULT)
  */
 #define DBR_POSTED_QUEUE_DEPTH ( 1024 )
 
@@ -642,6 +662,108 @@ DBR_Tag_t dbrReadA( DBR_Handle_t dbr_handle,
                     DBR_Group_t group,
                     int flags );
 
+/**
+ * @brief Insert a batch of tuples in a namespace.
+ *
+ * The function inserts count independent tuples with a single submission.
+ * All tuples are handed to the back-end as one unit, which allows it to
+ * pipeline the requests instead of processing them one by one.
+ * Each tuple i is given by the pointer va_ptr[i], size[i], and tuple_name[i].
+ *
+ * The function is blocking and it will return when all tuples are stored in the namespace.
+ *
+ * @param [in] dbr_handle   Handle to the namespace.
+ * @param [in] count        Number of tuples in the batch.
+ * @param [in] va_ptr       Array of pointers to the tuple data.
+ * @param [in] size         Array of tuple sizes.
+ * @param [in] tuple_name   Array of names/keys identifying the tuples.
+ * @param [in] group        Group to which the namespace belongs.
+ * @param [out] status      Array receiving the status of each tuple as dbrPut() would return it (may be NULL).
+ *
+ * @return
+ *    - DBR_SUCCESS if all tuples got inserted successfully;
+ *    - The status of the first failed tuple, otherwise.
+ *
+ * @see DBR_Errorcode_t
+ *
+ */
+DBR_Errorcode_t dbrPutBatch( DBR_Handle_t dbr_handle,
+                             const int count,
+                             void **va_ptr,
+                             int64_t *size,
+                             DBR_Tuple_name_t *tuple_name,
+                             DBR_Group_t group,
+                             DBR_Errorcode_t *status );
+
+/**
+ * @brief Get a batch of tuples from a namespace.
+ *
+ * The function gets and consumes count independent tuples with a single submission.
+ * Each tuple i is retrieved into the buffer va_ptr[i] of size size[i],
+ * size[i] will be updated with the effective length of the tuple.
+ *
+ * The function is blocking and it will return when all tuples are retrieved
+ * or the timeout is reached (see dbrGet() for the flags).
+ *
+ * @param [in] dbr_handle   Handle to the namespace.
+ * @param [in] count        Number of tuples in the batch.
+ * @param [out] va_ptr      Array of pointers to the buffers that will contain the tuples.
+ * @param [inout] size      Array of buffer sizes, updated with the length of the tuples.
+ * @param [in] tuple_name   Array of names/keys identifying the tuples.
+ * @param [in] match_template Template identifying a set of tuple names.
+ * @param [in] group        Group to which the namespace belongs.
+ * @param [in] flags        DBR_FLAGS_NONE or DBR_FLAGS_NOWAIT for immediate return option.
+ * @param [out] status      Array receiving the status of each tuple as dbrGet() would return it (may be NULL).
+ *
+ * @return
+ *    - DBR_SUCCESS if all tuples got retrieved successfully;
+ *    - The status of the first failed tuple, otherwise.
+ *
+ * @see DBR_Errorcode_t
+ *
+ */
+DBR_Errorcode_t dbrGetBatch( DBR_Handle_t dbr_handle,
+                             const int count,
+                             void **va_ptr,
+                             int64_t *size,
+                             DBR_Tuple_name_t *tuple_name,
+                             DBR_Tuple_template_t match_template,
+                             DBR_Group_t group,
+                             int flags,
+                             DBR_Errorcode_t *status );
+
+/**
+ * @brief Read a batch of tuples from a namespace.
+ *
+ * Same as dbrGetBatch() except that the tuples are copied and not consumed from the namespace.
+ *
+ * @param [in] dbr_handle   Handle to the namespace.
+ * @param [in] count        Number of tuples in the batch.
+ * @param [out] va_ptr      Array of pointers to the buffers that will contain the tuples.
+ * @param [inout] size      Array of buffer sizes, updated with the length of the tuples.
+ * @param [in] tuple_name   Array of names/keys identifying the tuples.
+ * @param [in] match_template Template identifying a set of tuple names.
+ * @param [in] group        Group to which the namespace belongs.
+ * @param [in] flags        DBR_FLAGS_NONE or DBR_FLAGS_NOWAIT for immediate return option.
+ * @param [out] status      Array receiving the status of each tuple as dbrRead() would return it (may be NULL).
+ *
+ * @return
+ *    - DBR_SUCCESS if all tuples got retrieved successfully;
+ *    - The status of the first failed tuple, otherwise.
+ *
+ * @see DBR_Errorcode_t
+ *
+ */
+DBR_Errorcode_t dbrReadBatch( DBR_Handle_t dbr_handle,
+                              const int count,
+                              void **va_ptr,
+                              int64_t *size,
+                              DBR_Tuple_name_t *tuple_name,
+                              DBR_Tuple_template_t match_template,
+                              DBR_Group_t group,
+                              int flags,
+                              DBR_Errorcode_t *status );
+
 /**
  * @brief Check the existence of a tuple.
  *
@@ -661,6 +783,32 @@ DBR_Tag_t dbrReadA( DBR_Handle_t dbr_handle,
 DBR_Errorcode_t dbrTestKey( DBR_Handle_t dbr_handle,
                             DBR_Tuple_name_t tuple_name );
 
+/**
+ * @brief Retrieve metadata of a tuple.
+ *
+ * The function returns the number of values stored under a tuple name
+ * and the size of the first value (the one a dbrRead() or dbrGet() would return).
+ * It does not return or transfer any tuple value.
+ *
+ * @param [in]  dbr_handle Handle to the namespace.
+ * @param [in]  group      Group where the tuple is stored.
+ * @param [in]  tuple_name Name/Key of the tuple.
+ * @param [out] count      Number of values stored under the tuple name (may be NULL).
+ * @param [out] size       Size of the first value in bytes (may be NULL).
+ *
+ * @return
+ *    - DBR_SUCCESS if the tuple is present.
+ *    - DBR_ERR_UNAVAIL if the tuple is unavailable (count and size are set to 0).
+ *    - An error code identifying the issue, otherwise.
+ *
+ *  @see DBR_Errorcode_t
+ */
+DBR_Errorcode_t dbrStat( DBR_Handle_t dbr_handle,
+                         DBR_Group_t group,
+                         DBR_Tuple_name_t tuple_name,
+                         int64_t *count,
+                         int64_t *size );
+
 
 /**
  * @brief Retrieve a list of available tuple names/keys
@@ -768,6 +916,77 @@ DBR_Errorcode_t dbrRemove( DBR_Handle_t dbr_handle,
  */
 DBR_Errorcode_t dbrTest( DBR_Tag_t req_tag );
 
+/**
+ * @brief Test the completion of a set of asynchronous calls.
+ *
+ * Non-blocking. Drives the back-end once for all calls of the set and
+ * completes every call of the set that is done. The tags of completed calls
+ * are replaced by DB_TAG_ERROR in the array, entries with DB_TAG_ERROR are ignored.
+ *
+ * @param [in] count         Number of tags in the array.
+ * @param [inout] tags       Array of tags corresponding to asynchronous calls.
+ * @param [out] completed    Number of calls that completed.
+ * @param [out] indices      Array of at least count entries receiving the indices of the completed calls (may be NULL).
+ * @param [out] status       Array of at least count entries receiving the status of the completed calls
+ *                           as dbrTest() would return it, in the same order as indices (may be NULL).
+ *
+ * @return
+ *    - DBR_SUCCESS if the set could be tested (even if nothing completed);
+ *    - An error code identifying the issue, otherwise.
+ *
+ */
+DBR_Errorcode_t dbrTestSome( const int count,
+                             DBR_Tag_t *tags,
+                             int *completed,
+                             int *indices,
+                             DBR_Errorcode_t *status );
+
+/**
+ * @brief Wait for the completion of any call of a set of asynchronous calls.
+ *
+ * Blocks until one call of the set completes or the timeout is reached.
+ * The tag of the completed call is replaced by DB_TAG_ERROR in the array,
+ * entries with DB_TAG_ERROR are ignored.
+ *
+ * @param [in] count         Number of tags in the array.
+ * @param [inout] tags       Array of tags corresponding to asynchronous calls.
+ * @param [out] index        Index of the completed call or -1 if there is no active tag in the array.
+ * @param [out] status       Status of the completed call as dbrTest() would return it (may be NULL).
+ *
+ * @return
+ *    - DBR_SUCCESS if a call completed or there is no active tag in the array;
+ *    - DBR_ERR_TIMEOUT if no call completed before the timeout;
+ *    - An error code identifying the issue, otherwise.
+ *
+ */
+DBR_Errorcode_t dbrWaitAny( const int count,
+                            DBR_Tag_t *tags,
+                            int *index,
+                            DBR_Errorcode_t *status );
+
+/**
+ * @brief Wait for the completion of all calls of a set of asynchronous calls.
+ *
+ * Blocks until all calls of the set complete or the timeout is reached.
+ * The tags of completed calls are replaced by DB_TAG_ERROR in the array,
+ * entries with DB_TAG_ERROR are ignored.
+ *
+ * @param [in] count         Number of tags in the array.
+ * @param [inout] tags       Array of tags corresponding to asynchronous calls.
+ * @param [out] status       Array of count entries receiving the status of each call as dbrTest()
+ *                           would return it; DBR_ERR_INPROGRESS if the call did not complete,
+ *                           DBR_ERR_TAGERROR for ignored entries (may be NULL).
+ *
+ * @return
+ *    - DBR_SUCCESS if all calls completed successfully;
+ *    - DBR_ERR_TIMEOUT if not all calls completed before the timeout;
+ *    - The status of the first failed call, otherwise.
+ *
+ */
+DBR_Errorcode_t dbrWaitAll( const int count,
+                            DBR_Tag_t *tags,
+                            DBR_Errorcode_t *status );
+
 
 /**
  * @brief Cancel an asynchronous call.
@@ -211,5 +211,77 @@ DBR_Errorcode_t dbrGet_v( DBR_Handle_t dbr_handle,
                           DBR_Group_t group,
                           int flags );
 
+/**
+ * @typedef DBR_Callback_t
+ * @brief Completion callback of an asynchronous call.
+ *
+ * Invoked once the call is complete with the tag of the call, the status that
+ * dbrTest() would have returned, and the user pointer given when the call was posted.
+ * When the callback runs, the tag is already released and must not be tested.
+ *
+ * Callbacks are invoked by the library progress thread (DBR_PROGRESS=1) or, without
+ * progress thread, by any thread that calls dbrTest(), dbrTestSome(), dbrWaitAny() or dbrWaitAll().
+ * dbrTestSome() with a count of 0 can be used to only drive the progress of requests with callbacks.
+ * Callbacks are free to post new calls but should not block for long.
+ */
+typedef void (*DBR_Callback_t)( DBR_Tag_t tag, DBR_Errorcode_t status, void *user );
+
+/**
+ * @brief Insert a tuple in a namespace asynchronously with a completion callback.
+ *
+ * Same functionality as dbrPutA(), except that the completion is signaled by
+ * calling callback instead of requiring the user to test the returned tag.
+ *
+ * @return A tag identifying the call or DB_TAG_ERROR if the call could not be posted
+ *         (in which case the callback is not invoked).
+ */
+DBR_Tag_t dbrPutA_cb( DBR_Handle_t dbr_handle,
+                      void *va_ptr,
+                      int64_t size,
+                      DBR_Tuple_name_t tuple_name,
+                      DBR_Group_t group,
+                      DBR_Callback_t callback,
+                      void *user );
+
+/**
+ * @brief Get a tuple from a namespace asynchronously with a completion callback.
+ *
+ * Same functionality as dbrGetA(), except that the completion is signaled by
+ * calling callback instead of requiring the user to test the returned tag.
+ * The size is updated before the callback is invoked.
+ *
+ * @return A tag identifying the call or DB_TAG_ERROR if the call could not be posted
+ *         (in which case the callback is not invoked).
+ */
+DBR_Tag_t dbrGetA_cb( DBR_Handle_t dbr_handle,
+                      void *va_ptr,
+                      int64_t *size,
+                      DBR_Tuple_name_t tuple_name,
+                      DBR_Tuple_template_t match_template,
+                      DBR_Group_t group,
+                      int flags,
+                      DBR_Callback_t callback,
+                      void *user );
+
+/**
+ * @brief Read a tuple from a namespace asynchronously with a completion callback.
+ *
+ * Same functionality as dbrReadA(), except that the completion is signaled by
+ * calling callback instead of requiring the user to test the returned tag.
+ * The size is updated before the callback is invoked.
+ *
+ * @return A tag identifying the call or DB_TAG_ERROR if the call could not be posted
+ *         (in which case the callback is not invoked).
+ */
+DBR_Tag_t dbrReadA_cb( DBR_Handle_t dbr_handle,
+                       void *va_ptr,
+                       int64_t *size,
+                       DBR_Tuple_name_t tuple_name,
+                       DBR_Tuple_template_t match_template,
+                       DBR_Group_t group,
+                       int flags,
+                       DBR_Callback_t callback,
+                       void *user );
+
 
 #endif /* INCLUDE_LIBDATABROKER_EXTRAS_H_ */
@@ -51,6 +51,7 @@ libdbrAddUnits( DBR_Handle_t cs_handle,
                                                      tag );
   if( pctx == NULL )
   {
+    dbrTag_release( cs->_reverse, tag );
     rc = DBR_ERR_NOMEMORY;
     goto error;
   }
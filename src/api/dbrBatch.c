@@ -0,0 +1,227 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include "logutil.h"
+#include "util/lock_tools.h"
+#include "libdatabroker.h"
+#include "libdatabroker_int.h"
+#include "libdbrAPI.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * translate the completion of one batch item into the status the
+ * corresponding blocking call (dbrPut/dbrGet/dbrRead) would return
+ */
+static
+DBR_Errorcode_t libdbrBatch_item_status( dbrRequestContext_t *item,
+                                         const int enable_timeout )
+{
+  if( item->_be_request_hdl == NULL )
+    return DBR_ERR_BE_POST;
+
+  DBR_Errorcode_t rc = item->_cpl._status;
+  switch( rc )
+  {
+    case DBR_SUCCESS:
+      rc = dbrCheck_response_item( item );
+      break;
+    case DBR_ERR_UNAVAIL:
+      if( enable_timeout == 0 )
+        break;
+      // intentionally no break if timeout is requested
+    case DBR_ERR_INPROGRESS:
+      rc = DBR_ERR_TIMEOUT;
+      break;
+    case DBR_ERR_CANCELLED:
+      if( enable_timeout == 0 )
+        rc = DBR_ERR_UNAVAIL;
+      else
+        rc = DBR_ERR_TIMEOUT;
+      break;
+    case DBR_ERR_BE_GENERAL:
+      if(( enable_timeout == 0 ) && ( item->_req._opcode != DBBE_OPCODE_PUT ))
+        rc = DBR_ERR_UNAVAIL;
+      break;
+    default:
+      break;
+  }
+  return rc;
+}
+
+/*
+ * all items of a batch share one tag and get posted to the back-end
+ * with a single trigger at the end, so the sender can pipeline them
+ * returns DBR_SUCCESS if all items succeeded, otherwise the status of the first failed item
+ */
+static
+DBR_Errorcode_t libdbrBatch( dbBE_Opcode op,
+                             DBR_Handle_t cs_handle,
+                             dbrDA_Request_chain_t *request,
+                             DBR_Tuple_template_t match_template,
+                             DBR_Group_t group,
+                             int flags,
+                             DBR_Errorcode_t *status )
+{
+  dbrName_space_t *cs = (dbrName_space_t*)cs_handle;
+
+  if(( cs == NULL ) || ( cs->_reverse == NULL ) || ( cs->_status != dbrNS_STATUS_REFERENCED ) || ( request == NULL ))
+    return DBR_ERR_INVALID;
+
+  if( cs->_be_ctx == NULL )
+    return DBR_ERR_NSINVAL;
+
+  dbrDA_Request_chain_t *chain = request;
+  int enable_timeout = (( op != DBBE_OPCODE_PUT ) && (( flags & DBR_FLAGS_NOWAIT ) == 0 ));
+
+  DBR_Tag_t tag = dbrTag_get( cs->_reverse );
+  if( tag == DB_TAG_ERROR )
+    return DBR_ERR_TAGERROR;
+
+#ifdef DBR_DATA_ADAPTERS
+  // data pre-processing plugin
+  if( cs->_reverse->_data_adapter != NULL )
+  {
+    if( op == DBBE_OPCODE_PUT )
+      chain = cs->_reverse->_data_adapter->pre_write( request );
+    else
+      chain = cs->_reverse->_data_adapter->pre_read( request );
+    if( chain == NULL )
+    {
+      dbrTag_release( cs->_reverse, tag );
+      return DBR_ERR_PLUGIN;
+    }
+  }
+#endif
+
+  DBR_Errorcode_t rc = DBR_SUCCESS;
+  dbrRequestContext_t *head =
+      dbrCreate_request_chain( op,
+                               cs_handle,
+                               group,
+                               NULL,
+                               DBR_GROUP_EMPTY,
+                               chain,
+                               match_template,
+                               flags,
+                               tag );
+  if( head == NULL )
+  {
+    dbrTag_release( cs->_reverse, tag );
+    rc = DBR_ERR_NOMEMORY;
+    goto error;
+  }
+
+  if( dbrInsert_request( cs, head ) == DB_TAG_ERROR )
+  {
+    rc = DBR_ERR_TAGERROR;
+    goto error;
+  }
+
+  DBR_Request_handle_t req_handle = dbrPost_request( head );
+  if( req_handle == NULL )
+  {
+    // items before the failing one are already in flight and have to complete before cleanup
+    dbrRequestContext_t *last = NULL;
+    dbrRequestContext_t *item;
+    for( item = head; ( item != NULL ) && ( item->_be_request_hdl != NULL ); item = item->_next )
+      last = item;
+    if( last == NULL )
+    {
+      rc = DBR_ERR_BE_POST;
+      goto error;
+    }
+    dbrRequestContext_t *unposted = last->_next;
+    last->_next = NULL;
+    dbrWait_request( cs, head, enable_timeout );
+    last->_next = unposted;
+  }
+  else
+    dbrWait_request( cs, req_handle, enable_timeout );
+
+  // the first failing item determines the return code of the batch
+  // a plugin may have split the caller's items; then only the post hook can tell their status
+  dbrRequestContext_t *item;
+  int n = 0;
+  for( item = head; item != NULL; item = item->_next, ++n )
+  {
+    DBR_Errorcode_t item_rc = libdbrBatch_item_status( item, enable_timeout );
+    if(( status != NULL ) && ( chain == request ))
+      status[ n ] = item_rc;
+    if(( rc == DBR_SUCCESS ) && ( item_rc != DBR_SUCCESS ))
+      rc = item_rc;
+  }
+
+#ifdef DBR_DATA_ADAPTERS
+  // data post-processing plugin; the plugin may have changed the chain, so the item status no longer applies
+  if( cs->_reverse->_data_adapter != NULL )
+  {
+    if( op == DBBE_OPCODE_PUT )
+      rc = cs->_reverse->_data_adapter->post_write( chain, rc );
+    else
+      rc = cs->_reverse->_data_adapter->post_read( chain, request, rc );
+    if( status != NULL )
+      for( n = 0, chain = request; chain != NULL; chain = chain->_next, ++n )
+        status[ n ] = rc;
+  }
+#endif
+
+  dbrRemove_request( cs, head );
+  return rc;
+
+error:
+  dbrRemove_request( cs, head );
+#ifdef DBR_DATA_ADAPTERS
+  if( cs->_reverse->_data_adapter != NULL )
+    rc = cs->_reverse->_data_adapter->error_handler( chain, ( op == DBBE_OPCODE_PUT ) ? DBRDA_WRITE : DBRDA_READ, rc );
+#endif
+  if( status != NULL )
+    for( chain = request; chain != NULL; chain = chain->_next )
+      *status++ = rc;
+  return rc;
+}
+
+DBR_Errorcode_t
+libdbrPutBatch( DBR_Handle_t cs_handle,
+                dbrDA_Request_chain_t *request,
+                DBR_Group_t group,
+                DBR_Errorcode_t *status )
+{
+  return libdbrBatch( DBBE_OPCODE_PUT, cs_handle, request, NULL, group, 0, status );
+}
+
+DBR_Errorcode_t
+libdbrGetBatch( DBR_Handle_t cs_handle,
+                dbrDA_Request_chain_t *request,
+                DBR_Tuple_template_t match_template,
+                DBR_Group_t group,
+                int flags,
+                DBR_Errorcode_t *status )
+{
+  return libdbrBatch( DBBE_OPCODE_GET, cs_handle, request, match_template, group, flags, status );
+}
+
+DBR_Errorcode_t
+libdbrReadBatch( DBR_Handle_t cs_handle,
+                 dbrDA_Request_chain_t *request,
+                 DBR_Tuple_template_t match_template,
+                 DBR_Group_t group,
+                 int flags,
+                 DBR_Errorcode_t *status )
+{
+  return libdbrBatch( DBBE_OPCODE_READ, cs_handle, request, match_template, group, flags, status );
+}
@@ -29,14 +29,14 @@ DBR_Errorcode_t libdbrCancel( DBR_Tag_t req_tag )
   if( main_ctx == NULL )
     return DBR_ERR_INVALID;
 
-  if(( req_tag < 0 ) || ( req_tag >= dbrMAX_TAGS ))
+  if( req_tag < 0 )
     return DBR_ERR_TAGERROR;
 
-  BIGLOCK_LOCK( main_ctx );
+  TAGLOCK_LOCK( main_ctx );
 
-  dbrRequestContext_t *rctx = main_ctx->_cs_wq[ req_tag ];
+  dbrRequestContext_t *rctx = dbrTag_lookup( main_ctx, req_tag );
   if( rctx == NULL )
-    BIGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_TAGERROR );
+    TAGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_TAGERROR );
 
 #else
 #error "Currently not supported because of lack of access to main context and locking"
@@ -52,14 +52,14 @@ DBR_Errorcode_t libdbrCancel( DBR_Tag_t req_tag )
 
   DBR_Errorcode_t rc = dbrValidateTag( rctx, req_tag );
   if( rc != DBR_SUCCESS )
-    BIGLOCK_UNLOCKRETURN( main_ctx, rc );
+    TAGLOCK_UNLOCKRETURN( main_ctx, rc );
 
   dbrName_space_t* cs = rctx->_ctx;
   if( cs->_be_ctx == NULL )
-    BIGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_NSINVAL );
+    TAGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_NSINVAL );
 
   // todo: call the back-end cancel op
 
   rc = dbrRemove_request( cs, rctx );
-  BIGLOCK_UNLOCKRETURN( main_ctx, rc );
+  TAGLOCK_UNLOCKRETURN( main_ctx, rc );
 }
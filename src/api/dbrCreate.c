@@ -49,22 +49,15 @@ libdbrCreate (DBR_Name_t db_name,
   if( ctx->_be_ctx == NULL )
     return NULL;
 
-  BIGLOCK_LOCK( ctx );
+  NSLOCK_LOCK( ctx );
   dbrName_space_t *cs = NULL;
 
   // check if this name is already tracked in the in-mem table
-  uint32_t idx = dbrMain_find( ctx, db_name );
-  if( idx != dbrERROR_INDEX )
+  cs = dbrMain_find( ctx, db_name );
+  if( cs != NULL )
   {
     // already existing CS is an error - but check the global state to be sure!!
     local_result = DBR_ERR_EXISTS;
-
-    cs = ctx->_cs_list[ idx ];
-    if( cs == NULL )
-    {
-      errno = ENOENT;
-      BIGLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
-    }
   }
   else
   {
@@ -73,7 +66,7 @@ libdbrCreate (DBR_Name_t db_name,
     if( cs == NULL )
     {
       errno = ENOMEM;
-      BIGLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
+      NSLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
     }
 
     local_result = DBR_SUCCESS;
@@ -81,7 +74,7 @@ libdbrCreate (DBR_Name_t db_name,
 
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
+    NSLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
 
   rctx = dbrCreate_request_ctx( DBBE_OPCODE_NSCREATE,
                                 cs,
@@ -95,7 +88,10 @@ libdbrCreate (DBR_Name_t db_name,
                                 NULL,
                                 tag );
   if( rctx == NULL )
+  {
+    dbrTag_release( cs->_reverse, tag );
     goto error;
+  }
 
   DBR_Tag_t rtag = dbrInsert_request( cs, rctx );
   if( rtag == DB_TAG_ERROR )
@@ -127,15 +123,15 @@ libdbrCreate (DBR_Name_t db_name,
 
   // assign the returned namespace handle from the backend
   cs->_be_ns_hdl = (dbBE_NS_Handle_t)rctx->_cpl._rc;
-  rctx->_status = dbrSTATUS_CLOSED;
+  DBR_REQUEST_STATUS_SET( rctx, dbrSTATUS_CLOSED );
 
   dbrRemove_request( cs, rctx );
 
-  BIGLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)cs );
+  NSLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)cs );
 error:
   dbrRemove_request( cs, rctx );
   if( local_result == DBR_SUCCESS )
     dbrMain_delete( ctx, cs );
 
-  BIGLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
+  NSLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
 }
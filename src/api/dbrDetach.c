@@ -34,20 +34,20 @@ libdbrDetach (DBR_Handle_t cs_handle)
       (( cs->_status != dbrNS_STATUS_REFERENCED ) && ( cs->_status != dbrNS_STATUS_DELETED ) ))
     return DBR_ERR_INVALID;
 
-  BIGLOCK_LOCK( cs->_reverse );
+  NSLOCK_LOCK( cs->_reverse );
 
   // try to detach locally
   int ref = cs->_ref_count;
 
   // if that fails, then don't bother detaching globally because we haven't been attached to it
   if( ref < 1 )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_NSINVAL );
+    NSLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_NSINVAL );
 
   dbrMain_context_t *ctx = cs->_reverse;
 
   DBR_Tag_t tag = dbrTag_get( ctx );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_TAGERROR );
+    NSLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_TAGERROR );
 
   DBR_Errorcode_t rc = DBR_SUCCESS;
   dbrRequestContext_t *rctx = dbrCreate_request_ctx( DBBE_OPCODE_NSDETACH,
@@ -62,7 +62,10 @@ libdbrDetach (DBR_Handle_t cs_handle)
                                                      NULL,
                                                      tag );
   if( rctx == NULL )
+  {
+    dbrTag_release( ctx, tag );
     goto error;
+  }
 
   DBR_Tag_t rtag = dbrInsert_request( cs, rctx );
   if( rtag == DB_TAG_ERROR )
@@ -91,7 +94,7 @@ libdbrDetach (DBR_Handle_t cs_handle)
   // try to detach locally
   ref = dbrMain_detach( ctx, cs );
 
-  BIGLOCK_UNLOCKRETURN( ctx, DBR_SUCCESS );
+  NSLOCK_UNLOCKRETURN( ctx, DBR_SUCCESS );
 error:
 
   fprintf( stderr, "failed to detach or name space doesn't exist: %s\n", cs->_db_name );
@@ -100,7 +103,7 @@ error:
 
   // detach locally because we know we're attached
   ref = dbrMain_detach( ctx, cs );
-  BIGLOCK_UNLOCK( ctx );
+  NSLOCK_UNLOCK( ctx );
 
   if( ref <= 1 )
     return DBR_ERR_NSBUSY;
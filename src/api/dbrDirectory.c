@@ -35,11 +35,9 @@ libdbrDirectory( DBR_Handle_t cs_handle,
   if(( cs->_be_ctx == NULL ) || ( cs->_reverse == NULL ) || (cs->_status != dbrNS_STATUS_REFERENCED ))
     return DBR_ERR_NSINVAL;
 
-  BIGLOCK_LOCK( cs->_reverse );
-
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_TAGERROR );
+    return DBR_ERR_TAGERROR;
 
   dbBE_sge_t sge[2];
   sge[0].iov_base = result_buffer;
@@ -62,6 +60,7 @@ libdbrDirectory( DBR_Handle_t cs_handle,
                                                     tag );
   if( ctx == NULL )
   {
+    dbrTag_release( cs->_reverse, tag );
     rc = DBR_ERR_NOMEMORY;
     goto error;
   }
@@ -91,6 +90,6 @@ libdbrDirectory( DBR_Handle_t cs_handle,
 error:
   dbrRemove_request( cs, ctx );
 
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
 }
 
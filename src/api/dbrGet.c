@@ -41,12 +41,10 @@ libdbrGet (DBR_Handle_t cs_handle,
   dbrDA_Request_chain_t *chain = request;
   int enable_timeout = ((flags & DBR_FLAGS_NOWAIT ) == 0 );
 
-  BIGLOCK_LOCK( cs->_reverse );
-
   // create a deletion request (to be appended to the get)
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_TAGERROR );
+    return DBR_ERR_TAGERROR;
 
 #ifdef DBR_DATA_ADAPTERS
   // read-path request pre-processing plugin
@@ -54,7 +52,10 @@ libdbrGet (DBR_Handle_t cs_handle,
   {
     chain = cs->_reverse->_data_adapter->pre_read( request );
     if( chain == NULL )
-      BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_PLUGIN );
+    {
+      dbrTag_release( cs->_reverse, tag );
+      return DBR_ERR_PLUGIN;
+    }
   }
 #endif
 
@@ -71,6 +72,7 @@ libdbrGet (DBR_Handle_t cs_handle,
                                tag );
   if( head == NULL )
   {
+    dbrTag_release( cs->_reverse, tag );
     rc = DBR_ERR_NOMEMORY;
     goto error;
   }
@@ -123,7 +125,7 @@ libdbrGet (DBR_Handle_t cs_handle,
   }
 
   dbrRemove_request( cs, head );
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
 
 error:
   dbrRemove_request( cs, head );
@@ -131,5 +133,5 @@ error:
   if( cs->_reverse->_data_adapter != NULL )
     rc = cs->_reverse->_data_adapter->error_handler( chain, DBRDA_READ, rc );
 #endif
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
 }
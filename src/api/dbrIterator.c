@@ -35,7 +35,7 @@ libdbrIterator( DBR_Handle_t cs_handle,
 
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, NULL );
+    return NULL;
 
   DBR_Errorcode_t rc = DBR_SUCCESS;
 
@@ -52,6 +52,7 @@ libdbrIterator( DBR_Handle_t cs_handle,
                                                     tag );
   if( ctx == NULL )
   {
+    dbrTag_release( cs->_reverse, tag );
     rc = DBR_ERR_NOMEMORY;
     goto error;
   }
@@ -81,9 +82,9 @@ libdbrIterator( DBR_Handle_t cs_handle,
   }
 
   dbrRemove_request( cs, ctx );
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, iterator );
+  return iterator;
 
 error:
   tuple_name[0] = '\0';
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, NULL );
+  return NULL;
 }
@@ -48,13 +48,10 @@ DBR_Errorcode_t libdbrMove ( DBR_Handle_t src_cs_handle,
   if( src_cs == dst_cs )
     return DBR_SUCCESS;
 
-  BIGLOCK_LOCK( src_cs->_reverse );
-
-
   // src_cs->_reverse == dst_cs->_reverse
   DBR_Tag_t tag = dbrTag_get( src_cs->_reverse ); // reverse points always to the same dbrMain_context
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( src_cs->_reverse, DBR_ERR_TAGERROR );
+    return DBR_ERR_TAGERROR;
 
   dbrRequestContext_t *rctx = dbrCreate_request_ctx( DBBE_OPCODE_MOVE,
                                                     src_cs_handle,
@@ -69,6 +66,7 @@ DBR_Errorcode_t libdbrMove ( DBR_Handle_t src_cs_handle,
                                                     tag );
   if( rctx == NULL )
   {
+    dbrTag_release( src_cs->_reverse, tag );
     rc = DBR_ERR_NOMEMORY;
     goto error;
   }
@@ -102,5 +100,5 @@ DBR_Errorcode_t libdbrMove ( DBR_Handle_t src_cs_handle,
 error:
   dbrRemove_request( src_cs, rctx );
 
-  BIGLOCK_UNLOCKRETURN( src_cs->_reverse, rc );
+  return rc;
 }
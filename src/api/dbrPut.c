@@ -33,11 +33,9 @@ libdbrPut( DBR_Handle_t cs_handle,
   if(( cs->_be_ctx == NULL ) || (cs->_reverse == NULL ) || (cs->_status != dbrNS_STATUS_REFERENCED ))
     return DBR_ERR_NSINVAL;
 
-  BIGLOCK_LOCK( cs->_reverse );
-
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_TAGERROR );
+    return DBR_ERR_TAGERROR;
 
   dbrDA_Request_chain_t *chain = request;
 
@@ -47,7 +45,10 @@ libdbrPut( DBR_Handle_t cs_handle,
   {
     chain = cs->_reverse->_data_adapter->pre_write( request );
     if( chain == NULL )
-      BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_PLUGIN );
+    {
+      dbrTag_release( cs->_reverse, tag );
+      return DBR_ERR_PLUGIN;
+    }
   }
 #endif
 
@@ -63,7 +64,10 @@ libdbrPut( DBR_Handle_t cs_handle,
                                0,
                                tag );
   if( head == NULL )
+  {
+    dbrTag_release( cs->_reverse, tag );
     goto error;
+  }
 
   if( dbrInsert_request( cs, head ) == DB_TAG_ERROR )
   {
@@ -99,7 +103,7 @@ libdbrPut( DBR_Handle_t cs_handle,
   }
 
   dbrRemove_request( cs, head );
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
 
 error:
   dbrRemove_request( cs, head );
@@ -107,5 +111,5 @@ error:
   if( cs->_reverse->_data_adapter != NULL )
     rc = cs->_reverse->_data_adapter->error_handler( chain, DBRDA_WRITE, rc );
 #endif
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
 }
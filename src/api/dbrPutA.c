@@ -24,7 +24,9 @@
 
 DBR_Tag_t libdbrPutA (DBR_Handle_t cs_handle,
                       dbrDA_Request_chain_t *request,
-                      DBR_Group_t group)
+                      DBR_Group_t group,
+                      DBR_Callback_t callback,
+                      void *user )
 {
   dbrName_space_t *cs = (dbrName_space_t*)cs_handle;
   if(( cs == NULL ) || ( cs->_be_ctx == NULL ) || ( cs->_reverse == NULL ) || (cs->_status != dbrNS_STATUS_REFERENCED ))
@@ -35,11 +37,9 @@ DBR_Tag_t libdbrPutA (DBR_Handle_t cs_handle,
 
   dbrDA_Request_chain_t *chain = request;
 
-  BIGLOCK_LOCK( cs->_reverse );
-
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DB_TAG_ERROR );
+    return DB_TAG_ERROR;
 
 #ifdef DBR_DATA_ADAPTERS
   // write-path data pre-processing plugin
@@ -47,7 +47,10 @@ DBR_Tag_t libdbrPutA (DBR_Handle_t cs_handle,
   {
     chain = cs->_reverse->_data_adapter->pre_write( request );
     if( chain == NULL )
-      BIGLOCK_UNLOCKRETURN( cs->_reverse, DB_TAG_ERROR );
+    {
+      dbrTag_release( cs->_reverse, tag );
+      return DB_TAG_ERROR;
+    }
   }
 #endif
 
@@ -62,10 +65,15 @@ DBR_Tag_t libdbrPutA (DBR_Handle_t cs_handle,
                                0,
                                tag );
   if( head == NULL )
+  {
+    dbrTag_release( cs->_reverse, tag );
     return DB_TAG_ERROR;
+  }
 
   head->_rchain = chain; // potentially modified chain after plugin
   head->_ochain = request; // actual request chain from user
+  if( callback != NULL )
+    dbrRequest_set_callback( head, callback, user );
   DBR_Tag_t ptag = dbrInsert_request( cs, head );
   if( ptag == DB_TAG_ERROR )
   {
@@ -77,7 +85,9 @@ DBR_Tag_t libdbrPutA (DBR_Handle_t cs_handle,
   if( put_handle == NULL )
     goto error;
 
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, head->_tag );
+  // with a callback, the request might be gone right after the release
+  dbrRequest_release_callback( head );
+  return ptag;
 
 error:
   dbrRemove_request( cs, head );
@@ -85,6 +95,6 @@ error:
   if( cs->_reverse->_data_adapter != NULL )
     cs->_reverse->_data_adapter->error_handler( chain, DBRDA_WRITE, DBR_ERR_TAGERROR );
 #endif
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, DB_TAG_ERROR );
+  return DB_TAG_ERROR;
 }
 
@@ -39,11 +39,9 @@ libdbrQuery (DBR_Handle_t cs_handle,
   if(( cs == NULL ) || ( cs->_be_ctx == NULL ) || ( cs->_reverse == NULL ) || (cs->_status != dbrNS_STATUS_REFERENCED ))
     return DBR_ERR_NSINVAL;
 
-  BIGLOCK_LOCK( cs->_reverse );
-
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_TAGERROR );
+    return DBR_ERR_TAGERROR;
 
   // check the redis main space for db_name
   dbr_Name_meta_t meta;
@@ -67,6 +65,7 @@ libdbrQuery (DBR_Handle_t cs_handle,
                                                      tag );
   if( rctx == NULL )
   {
+    dbrTag_release( cs->_reverse, tag );
     rc = DBR_ERR_NOMEMORY;
     goto error;
   }
@@ -97,7 +96,7 @@ libdbrQuery (DBR_Handle_t cs_handle,
   if( rctx->_cpl._rc == 0 )
   {
     printf("db_name doesn't exist: %s\n", cs->_db_name );
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_NSINVAL );
+    return DBR_ERR_NSINVAL;
   }
   else
     LOG( DBG_INFO, stdout, "found db_name: %s\n", meta.id );
@@ -105,5 +104,5 @@ libdbrQuery (DBR_Handle_t cs_handle,
 error:
   dbrRemove_request( cs, rctx );
 
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
 }
@@ -23,41 +23,6 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-DBR_Errorcode_t
-libdbrTestKey( DBR_Handle_t cs_handle,
-               DBR_Tuple_name_t tuple_name,
-               DBR_Tuple_template_t match_template,
-               DBR_Group_t group )
-{
-  if( cs_handle == NULL )
-    return DBR_ERR_INVALID;
-
-  dbrName_space_t *cs = (dbrName_space_t*)cs_handle;
-  if(( cs->_be_ctx == NULL ) || ( cs->_reverse == NULL ) || (cs->_status != dbrNS_STATUS_REFERENCED ))
-    return DBR_ERR_NSINVAL;
-
-  int64_t retsize;
-
-  dbrDA_Request_chain_t *req = (dbrDA_Request_chain_t*)calloc( 1, sizeof( dbrDA_Request_chain_t ) + sizeof( dbBE_sge_t ) );;
-  req->_key = tuple_name;
-  req->_sge_count = 1;
-  req->_value_sge[0].iov_base = cs->_reverse->_tmp_testkey_buf;
-  req->_value_sge[0].iov_len = DBR_TMP_BUFFER_LEN;
-
-  DBR_Errorcode_t rc;
-  rc = libdbrRead( cs_handle,
-                   req,
-                   &retsize,
-                   match_template,
-                   group,
-                   DBBE_OPCODE_FLAGS_IMMEDIATE );
-  free( req );
-  return rc;
-}
-
-
-
-
 DBR_Errorcode_t
 libdbrRead(DBR_Handle_t cs_handle,
            dbrDA_Request_chain_t *request,
@@ -75,13 +40,11 @@ libdbrRead(DBR_Handle_t cs_handle,
 
   dbrDA_Request_chain_t *chain = request;
 
-  BIGLOCK_LOCK( cs->_reverse );
-
   int enable_timeout = ((flags & DBR_FLAGS_NOWAIT ) == 0 );
 
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_TAGERROR );
+    return DBR_ERR_TAGERROR;
 
 #ifdef DBR_DATA_ADAPTERS
   // read-path request pre-processing plugin
@@ -89,7 +52,10 @@ libdbrRead(DBR_Handle_t cs_handle,
   {
     chain = cs->_reverse->_data_adapter->pre_read( request );
     if( chain == NULL )
-      BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_PLUGIN );
+    {
+      dbrTag_release( cs->_reverse, tag );
+      return DBR_ERR_PLUGIN;
+    }
   }
 #endif
 
@@ -106,6 +72,7 @@ libdbrRead(DBR_Handle_t cs_handle,
                                tag );
   if( head == NULL )
   {
+    dbrTag_release( cs->_reverse, tag );
     rc = DBR_ERR_NOMEMORY;
     goto error;
   }
@@ -158,7 +125,7 @@ libdbrRead(DBR_Handle_t cs_handle,
   }
 
   dbrRemove_request( cs, head );
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
 
 error:
   dbrRemove_request( cs, head );
@@ -166,6 +133,6 @@ error:
   if( cs->_reverse->_data_adapter != NULL )
     rc = cs->_reverse->_data_adapter->error_handler( chain, DBRDA_READ, rc );
 #endif
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
 }
 
@@ -28,7 +28,9 @@ DBR_Tag_t libdbrReadA(DBR_Handle_t cs_handle,
                       DBR_Tuple_template_t match_template,
                       DBR_Group_t group,
                       int flags,
-                      int64_t *ret_size )
+                      int64_t *ret_size,
+                      DBR_Callback_t callback,
+                      void *user )
 {
   dbrName_space_t *cs = (dbrName_space_t*)cs_handle;
   if(( cs == NULL ) || ( cs->_be_ctx == NULL ) || ( cs->_reverse == NULL ) || (cs->_status != dbrNS_STATUS_REFERENCED ))
@@ -36,11 +38,9 @@ DBR_Tag_t libdbrReadA(DBR_Handle_t cs_handle,
 
   dbrDA_Request_chain_t *chain = request;
 
-  BIGLOCK_LOCK( cs->_reverse );
-
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DB_TAG_ERROR );
+    return DB_TAG_ERROR;
 
 #ifdef DBR_DATA_ADAPTERS
   // read-path request pre-processing plugin
@@ -48,7 +48,10 @@ DBR_Tag_t libdbrReadA(DBR_Handle_t cs_handle,
   {
     chain = cs->_reverse->_data_adapter->pre_read( request );
     if( chain == NULL )
-      BIGLOCK_UNLOCKRETURN( cs->_reverse, DB_TAG_ERROR );
+    {
+      dbrTag_release( cs->_reverse, tag );
+      return DB_TAG_ERROR;
+    }
   }
 #endif
 
@@ -63,10 +66,15 @@ DBR_Tag_t libdbrReadA(DBR_Handle_t cs_handle,
                                flags,
                                tag );
   if( head == NULL )
+  {
+    dbrTag_release( cs->_reverse, tag );
     return DB_TAG_ERROR;
+  }
 
   head->_rchain = chain;
   head->_ochain = request;
+  if( callback != NULL )
+    dbrRequest_set_callback( head, callback, user );
   DBR_Tag_t rtag = dbrInsert_request( cs, head );
   if( rtag == DB_TAG_ERROR )
     goto error;
@@ -75,7 +83,9 @@ DBR_Tag_t libdbrReadA(DBR_Handle_t cs_handle,
   if( read_handle == NULL )
     goto error;
 
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, head->_tag );
+  // with a callback, the request might be gone right after the release
+  dbrRequest_release_callback( head );
+  return rtag;
 
 error:
   dbrRemove_request( cs, head );
@@ -86,5 +96,5 @@ error:
   if( cs->_reverse->_data_adapter != NULL )
     cs->_reverse->_data_adapter->error_handler( chain, DBRDA_READ, DBR_ERR_TAGERROR );
 #endif
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, DB_TAG_ERROR );
+  return DB_TAG_ERROR;
 }
@@ -33,11 +33,9 @@ libdbrRemove( DBR_Handle_t cs_handle,
   if(( cs->_be_ctx == NULL ) || ( cs->_reverse == NULL ) || (cs->_status != dbrNS_STATUS_REFERENCED ))
     return DBR_ERR_NSINVAL;
 
-  BIGLOCK_LOCK( cs->_reverse );
-
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_TAGERROR );
+    return DBR_ERR_TAGERROR;
 
   DBR_Errorcode_t rc = DBR_SUCCESS;
   dbrRequestContext_t *ctx = dbrCreate_request_ctx( DBBE_OPCODE_REMOVE,
@@ -53,6 +51,7 @@ libdbrRemove( DBR_Handle_t cs_handle,
                                                     tag );
   if( ctx == NULL )
   {
+    dbrTag_release( cs->_reverse, tag );
     rc = DBR_ERR_NOMEMORY;
     goto error;
   }
@@ -85,6 +84,6 @@ libdbrRemove( DBR_Handle_t cs_handle,
 error:
   dbrRemove_request( cs, ctx );
 
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
 }
 
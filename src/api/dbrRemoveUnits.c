@@ -52,6 +52,7 @@ DBR_Errorcode_t libdbrRemoveUnits( DBR_Handle_t cs_handle,
                                                      tag );
   if( pctx == NULL )
   {
+    dbrTag_release( cs->_reverse, tag );
     rc = DBR_ERR_NOMEMORY;
     goto error;
   }
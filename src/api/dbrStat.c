@@ -0,0 +1,114 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include "util/lock_tools.h"
+#include "libdatabroker.h"
+#include "libdatabroker_int.h"
+#include "libdbrAPI.h"
+
+#include <stdio.h>
+
+DBR_Errorcode_t
+libdbrStat( DBR_Handle_t cs_handle,
+            DBR_Group_t group,
+            DBR_Tuple_name_t tuple_name,
+            DBR_Tuple_template_t match_template,
+            int64_t *count,
+            int64_t *size )
+{
+  if( cs_handle == NULL )
+    return DBR_ERR_INVALID;
+
+  dbrName_space_t *cs = (dbrName_space_t*)cs_handle;
+  if(( cs->_be_ctx == NULL ) || ( cs->_reverse == NULL ) || (cs->_status != dbrNS_STATUS_REFERENCED ))
+    return DBR_ERR_NSINVAL;
+
+  DBR_Tag_t tag = dbrTag_get( cs->_reverse );
+  if( tag == DB_TAG_ERROR )
+    return DBR_ERR_TAGERROR;
+
+  // without a request for the size, the back-end can skip looking at the value
+  int64_t stat[ 2 ] = { 0, 0 };
+  dbBE_sge_t sge;
+  sge.iov_base = stat;
+  sge.iov_len = ( size != NULL ) ? sizeof( stat ) : sizeof( int64_t );
+
+  DBR_Errorcode_t rc = DBR_SUCCESS;
+  dbrRequestContext_t *ctx = dbrCreate_request_ctx( DBBE_OPCODE_STAT,
+                                                    cs_handle,
+                                                    group,
+                                                    NULL,
+                                                    DBR_GROUP_EMPTY,
+                                                    1,
+                                                    &sge,
+                                                    NULL,
+                                                    tuple_name,
+                                                    match_template,
+                                                    tag );
+  if( ctx == NULL )
+  {
+    dbrTag_release( cs->_reverse, tag );
+    rc = DBR_ERR_NOMEMORY;
+    goto error;
+  }
+
+  if( dbrInsert_request( cs, ctx ) == DB_TAG_ERROR )
+  {
+    rc = DBR_ERR_TAGERROR;
+    goto error;
+  }
+
+  DBR_Request_handle_t req_handle = dbrPost_request( ctx );
+  if( req_handle == NULL )
+  {
+    rc = DBR_ERR_BE_POST;
+    goto error;
+  }
+
+  rc = dbrWait_request( cs, req_handle, 0 );
+  switch( rc ) {
+  case DBR_SUCCESS:
+    rc = dbrCheck_response( ctx );
+    break;
+  default:
+    goto error;
+  }
+
+error:
+  dbrRemove_request( cs, ctx );
+
+  if( rc != DBR_SUCCESS )
+    stat[ 0 ] = stat[ 1 ] = 0;
+  if( count != NULL )
+    *count = stat[ 0 ];
+  if( size != NULL )
+    *size = stat[ 1 ];
+  return rc;
+}
+
+DBR_Errorcode_t
+libdbrTestKey( DBR_Handle_t cs_handle,
+               DBR_Tuple_name_t tuple_name,
+               DBR_Tuple_template_t match_template,
+               DBR_Group_t group )
+{
+  return libdbrStat( cs_handle,
+                     group,
+                     tuple_name,
+                     match_template,
+                     NULL,
+                     NULL );
+}
@@ -42,64 +42,73 @@ DBR_Errorcode_t csPostProcessRequest( dbrRequestContext_t *rctx )
       break;
   }
 
-  rctx->_status = dbrSTATUS_CLOSED;
+  DBR_REQUEST_STATUS_SET( rctx, dbrSTATUS_CLOSED );
   return rc_out;
 }
 
-DBR_Errorcode_t
-libdbrTest( DBR_Tag_t req_tag)
+/*
+ * tests the request of a tag and completes it once the full chain is done
+ * with drive == 0, only the request status is checked without calling into the back-end
+ */
+static
+DBR_Errorcode_t libdbrTest_ext( DBR_Tag_t req_tag, const int drive )
 {
 #ifdef DBR_INTTAG
 
-  if(( req_tag < 0 ) || ( req_tag >= dbrMAX_TAGS ))
+  if( req_tag < 0 )
     return DBR_ERR_TAGERROR;
 
   dbrMain_context_t *main_ctx = dbrCheckCreateMainCTX();
   if( main_ctx == NULL )
     return DBR_ERR_INVALID;
 
-  BIGLOCK_LOCK( main_ctx );
+  TAGLOCK_LOCK( main_ctx );
 
-  dbrRequestContext_t *rctx = main_ctx->_cs_wq[ req_tag ];
+  dbrRequestContext_t *rctx = dbrTag_lookup( main_ctx, req_tag );
   if( rctx == NULL )
   {
     LOG( DBG_WARN, stderr, "Request entry for tag %"PRId64" is deleted\n", req_tag );
-    BIGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_TAGERROR );
+    TAGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_TAGERROR );
   }
 
 #else
 #error "Currently not supported because of lack of access to main context and locking"
   if( req_tag == NULL
       || req_tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_TAGERROR );
+    TAGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_TAGERROR );
 
   dbrRequestContext_t *rctx = *(dbrRequestContext_t**)req_tag;
   if( rctx == NULL )
-    BIGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_TAGERROR );
+    TAGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_TAGERROR );
 
 #endif
 
 
   DBR_Errorcode_t rc = dbrValidateTag( rctx, req_tag );
   if( rc != DBR_SUCCESS )
-    BIGLOCK_UNLOCKRETURN( main_ctx, rc );
+    TAGLOCK_UNLOCKRETURN( main_ctx, rc );
 
   dbrName_space_t* cs = rctx->_ctx;
   if( cs->_be_ctx == NULL )
-    BIGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_NSINVAL );
+    TAGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_NSINVAL );
 
   dbrRequestContext_t *chain = rctx;
 
   // check the full chain of requests before returning
   while( chain != NULL )
   {
-    if( chain->_status == dbrSTATUS_CLOSED )
+    if( DBR_REQUEST_STATUS_GET( chain ) == dbrSTATUS_CLOSED )
     {
       chain = chain->_next;
       continue;
     }
 
-    rc = dbrTest_request( cs, chain );
+    if( drive )
+      rc = dbrTest_request( cs, chain );
+    else if( DBR_REQUEST_STATUS_GET( chain ) == dbrSTATUS_READY )
+      rc = chain->_cpl._status;
+    else
+      rc = DBR_ERR_INPROGRESS;
 
     switch( rc )
     {
@@ -113,7 +122,7 @@ libdbrTest( DBR_Tag_t req_tag)
         // but let outside know that it is pending!
 
         // todo: for now keeping this case separate despite being empty
-        BIGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_INPROGRESS );
+        TAGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_INPROGRESS );
 
       default:
         break;
@@ -131,7 +140,7 @@ libdbrTest( DBR_Tag_t req_tag)
     {
       LOG( DBG_ERR, stderr, "BUG: User request in context is NULL. Chained request check issue?\n" );
       dbrRemove_request( rctx->_ctx, rctx );
-      BIGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_HANDLE );
+      TAGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_HANDLE );
     }
     dbrDA_Request_chain_t *rchain = rctx->_rchain;
     switch( rctx->_req._opcode )
@@ -165,5 +174,234 @@ libdbrTest( DBR_Tag_t req_tag)
 
   dbrRemove_request( rctx->_ctx, rctx );
 
-  BIGLOCK_UNLOCKRETURN( main_ctx, rc );
+  TAGLOCK_UNLOCKRETURN( main_ctx, rc );
+}
+
+DBR_Errorcode_t
+libdbrTest( DBR_Tag_t req_tag )
+{
+  DBR_Errorcode_t rc = libdbrTest_ext( req_tag, 1 );
+  dbrMain_context_t *main_ctx = dbrCheckCreateMainCTX();
+  if( main_ctx != NULL )
+    dbrCallback_dispatch( main_ctx );
+  return rc;
+}
+
+int dbrCallback_dispatch( dbrMain_context_t *ctx )
+{
+  int n = 0;
+  while( __atomic_load_n( &ctx->_cb_ready, __ATOMIC_ACQUIRE ) != NULL )
+  {
+    pthread_mutex_lock( &ctx->_cb_lock );
+    dbrRequestContext_t *head = ctx->_cb_ready;
+    if( head != NULL )
+    {
+      __atomic_store_n( &ctx->_cb_ready, head->_cb_next, __ATOMIC_RELEASE );
+      if( head->_cb_next == NULL )
+        ctx->_cb_ready_tail = NULL;
+    }
+    pthread_mutex_unlock( &ctx->_cb_lock );
+    if( head == NULL )
+      break;
+
+    // completing the request releases the tag and the request, so grab what the callback needs first
+    DBR_Callback_t callback = head->_callback;
+    void *user = head->_cb_user;
+    DBR_Tag_t tag = head->_tag;
+
+    DBR_Errorcode_t rc = libdbrTest_ext( tag, 0 );
+    callback( tag, rc, user );
+    ++n;
+  }
+  return n;
+}
+
+/*
+ * look up and pin the requests of a set of tags
+ * pinned requests stay valid while they're polled without the tag lock, even if another thread completes them
+ * tags that are DB_TAG_ERROR (e.g. completed before) or unknown get a NULL entry
+ */
+static
+dbrRequestContext_t** libdbrTest_tag_set( dbrMain_context_t *main_ctx,
+                                          const int count,
+                                          DBR_Tag_t *tags )
+{
+  dbrRequestContext_t **set = (dbrRequestContext_t**)calloc( count, sizeof( dbrRequestContext_t* ) );
+  if( set == NULL )
+    return NULL;
+
+  int n;
+  TAGLOCK_LOCK( main_ctx );
+  for( n = 0; n < count; ++n )
+    set[ n ] = dbrTag_pin( main_ctx, tags[ n ] );
+  TAGLOCK_UNLOCK( main_ctx );
+  return set;
+}
+
+static
+void libdbrTest_tag_unpin( dbrMain_context_t *main_ctx,
+                           const int count,
+                           DBR_Tag_t *tags,
+                           dbrRequestContext_t **set )
+{
+  int n;
+  TAGLOCK_LOCK( main_ctx );
+  for( n = 0; n < count; ++n )
+    if( set[ n ] != NULL )
+      dbrTag_unpin( main_ctx, tags[ n ] );
+  TAGLOCK_UNLOCK( main_ctx );
+}
+
+/*
+ * common part of the tag set functions:
+ * wait until min_done requests are done, then complete up to max_complete of them
+ * completed tags are reported in indices/status and replaced by DB_TAG_ERROR
+ */
+static
+DBR_Errorcode_t libdbrWait_tag_set( const int count,
+                                    DBR_Tag_t *tags,
+                                    const int min_done,
+                                    const int max_complete,
+                                    const int enable_timeout,
+                                    int *completed,
+                                    int *indices,
+                                    DBR_Errorcode_t *status )
+{
+  if( completed != NULL )
+    *completed = 0;
+
+  if(( count < 0 ) || (( count > 0 ) && ( tags == NULL )))
+    return DBR_ERR_INVALID;
+
+  dbrMain_context_t *main_ctx = dbrCheckCreateMainCTX();
+  if( main_ctx == NULL )
+    return DBR_ERR_INVALID;
+
+  if( count == 0 )
+  {
+    // nothing to test, but drive the back-end to make progress on requests with callbacks
+    int ndone = dbrWait_request_set( main_ctx, NULL, 0, 0, NULL, 0 );
+    dbrCallback_dispatch( main_ctx );
+    return ( ndone < 0 ) ? DBR_ERR_BE_GENERAL : DBR_SUCCESS;
+  }
+
+  dbrRequestContext_t **set = libdbrTest_tag_set( main_ctx, count, tags );
+  int *done = (int*)calloc( count, sizeof( int ) );
+  if(( set == NULL ) || ( done == NULL ))
+  {
+    if( set != NULL )
+      libdbrTest_tag_unpin( main_ctx, count, tags, set );
+    free( set );
+    free( done );
+    return DBR_ERR_NOMEMORY;
+  }
+
+  int n;
+  int active = 0;
+  for( n = 0; n < count; ++n )
+    active += ( set[ n ] != NULL );
+
+  int64_t timeout = enable_timeout ? (int64_t)main_ctx->_config._timeout_sec * 1000000 : -1;
+  int ndone = dbrWait_request_set( main_ctx,
+                                   set,
+                                   count,
+                                   ( min_done < active ) ? min_done : active,
+                                   done,
+                                   timeout );
+
+  DBR_Errorcode_t rc = DBR_SUCCESS;
+  if( ndone < 0 )
+    rc = DBR_ERR_BE_GENERAL;
+  else if( ndone < (( min_done < active ) ? min_done : active ))
+    rc = DBR_ERR_TIMEOUT;
+
+  // unpin first, so that completing a tag below destroys its requests right away
+  libdbrTest_tag_unpin( main_ctx, count, tags, set );
+
+  int ncomplete = 0;
+  for( n = 0; ( ndone > 0 ) && ( n < count ) && ( ncomplete < max_complete ); ++n )
+  {
+    if( done[ n ] == 0 )
+      continue;
+
+    // somebody else is processing this tag or already completed it
+    DBR_Errorcode_t trc = libdbrTest_ext( tags[ n ], 0 );
+    if(( trc == DBR_ERR_INPROGRESS ) || ( trc == DBR_ERR_TAGERROR ))
+      continue;
+
+    tags[ n ] = DB_TAG_ERROR;
+    if( indices != NULL )
+      indices[ ncomplete ] = n;
+    if( status != NULL )
+      status[ ncomplete ] = trc;
+    ++ncomplete;
+  }
+
+  if( completed != NULL )
+    *completed = ncomplete;
+
+  free( done );
+  free( set );
+  dbrCallback_dispatch( main_ctx );
+  return rc;
+}
+
+DBR_Errorcode_t
+libdbrTestSome( const int count,
+                DBR_Tag_t *tags,
+                int *completed,
+                int *indices,
+                DBR_Errorcode_t *status )
+{
+  return libdbrWait_tag_set( count, tags, 0, count, 0, completed, indices, status );
+}
+
+DBR_Errorcode_t
+libdbrWaitAny( const int count,
+               DBR_Tag_t *tags,
+               int *index,
+               DBR_Errorcode_t *status )
+{
+  if( index != NULL )
+    *index = -1;
+  return libdbrWait_tag_set( count, tags, 1, 1, 1, NULL, index, status );
+}
+
+DBR_Errorcode_t
+libdbrWaitAll( const int count,
+               DBR_Tag_t *tags,
+               DBR_Errorcode_t *status )
+{
+  if(( count < 0 ) || (( count > 0 ) && ( tags == NULL )))
+    return DBR_ERR_INVALID;
+
+  int *indices = (int*)calloc( count + 1, sizeof( int ) );
+  DBR_Errorcode_t *cstatus = (DBR_Errorcode_t*)calloc( count + 1, sizeof( DBR_Errorcode_t ) );
+  if(( indices == NULL ) || ( cstatus == NULL ))
+  {
+    free( indices );
+    free( cstatus );
+    return DBR_ERR_NOMEMORY;
+  }
+
+  int n;
+  if( status != NULL )
+    for( n = 0; n < count; ++n )
+      status[ n ] = ( tags[ n ] == DB_TAG_ERROR ) ? DBR_ERR_TAGERROR : DBR_ERR_INPROGRESS;
+
+  int completed = 0;
+  DBR_Errorcode_t rc = libdbrWait_tag_set( count, tags, count, count, 1, &completed, indices, cstatus );
+
+  // status is by position in the tag array
+  for( n = 0; n < completed; ++n )
+  {
+    if( status != NULL )
+      status[ indices[ n ] ] = cstatus[ n ];
+    if(( rc == DBR_SUCCESS ) && ( cstatus[ n ] != DBR_SUCCESS ))
+      rc = cstatus[ n ];
+  }
+
+  free( indices );
+  free( cstatus );
+  return rc;
 }
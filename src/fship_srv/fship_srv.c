@@ -37,6 +37,7 @@
 #include <unistd.h> // fork
 #include <stdlib.h> // exit
 #include <sys/socket.h> // socket
+#include <sys/un.h> // sockaddr_un
 #include <sys/types.h> // ..
 #include <sys/stat.h> // ..
 #include <fcntl.h> // ..open
@@ -92,6 +93,14 @@ dbrFShip_main_context_t* dbrFShip_main_context_create( dbrFShip_config_t *cfg )
     return NULL;
   }
 
+  // the server drives the back-end itself and its completions don't belong to the client lib
+  if( ctx->_mctx->_config._progress != 0 )
+  {
+    LOG( DBG_WARN, stderr, "Ignoring %s for the fship server.\n", DBR_PROGRESS_ENV );
+    dbrProgress_stop( ctx->_mctx );
+    ctx->_mctx->_config._progress = 0;
+  }
+
   ctx->_conn_queue = dbBE_Connection_queue_create( DBR_FSHIP_CONNECTIONS_LIMIT );
   ctx->_r_buf = dbBE_Transport_sr_buffer_allocate( cfg->_max_mem >> 1 );
   if( ctx->_r_buf == NULL )
@@ -152,6 +161,8 @@ int main( int argc, char **argv )
 
   signal( SIGTERM, dbrFShip_termination_handler );
   signal( SIGINT, dbrFShip_termination_handler );
+  // clients that went away (or a server probing for a stale socket file) must not kill the service
+  signal( SIGPIPE, SIG_IGN );
 
   evthread_use_pthreads();
   struct event_base *evbase = event_base_new();
@@ -195,6 +206,8 @@ int main( int argc, char **argv )
 
   if( tio._threadrc != 0 )
     LOG( DBG_ERR, stderr, "Listener thread exited with rc=%d\n", tio._threadrc );
+  if( tio._unix_path[0] != '\0' )
+    unlink( tio._unix_path );
 
   event_base_free( evbase );
 
@@ -500,7 +513,7 @@ void usage()
   fprintf( stderr, " fship_srv [options]\n\n"\
                    "   -h        display help\n"\
                    "   -d        run as daemon\n"\
-                   "   -l <url>  listen at provided URL\n"\
+                   "   -l <url>  listen at provided URL (sock://<host>:<port> or unix://<path>)\n"\
                    "   -M <MB>   max buffering memory size in MB\n\n");
 }
 
@@ -609,6 +622,33 @@ void dbrFShip_connection_wakeup( evutil_socket_t socket, short ev_type, void *ar
   }
 }
 
+/*
+ * a socket file left behind by a crashed server would block the bind
+ * only remove it if it is a socket that nobody accepts connections on anymore
+ */
+static
+int dbrFShip_unix_clear_stale( const struct sockaddr_un *addr, const socklen_t addrlen )
+{
+  struct stat st;
+  if( lstat( addr->sun_path, &st ) != 0 )
+    return ( errno == ENOENT ) ? 0 : -errno;
+  if( ! S_ISSOCK( st.st_mode ) )
+    return -EADDRINUSE;
+
+  int probe = socket( AF_UNIX, SOCK_STREAM, 0 );
+  if( probe < 0 )
+    return -errno;
+  int rc = connect( probe, (const struct sockaddr*)addr, addrlen );
+  int err = errno;
+  close( probe );
+  if(( rc == 0 ) || ( err != ECONNREFUSED ))
+    return -EADDRINUSE;
+
+  if( unlink( addr->sun_path ) != 0 )
+    return -errno;
+  return 0;
+}
+
 void* dbrFShip_listen_start( void *arg )
 {
   if( arg == NULL )
@@ -620,27 +660,43 @@ void* dbrFShip_listen_start( void *arg )
   if( evbase == NULL )
     return NULL;
 
-  int s = 0;
+  int s = -1;
 
   char *url = tio->_cfg->_listenaddr;
   struct addrinfo *addrs = dbBE_Common_resolve_address( url, 0 );
   struct addrinfo *cur = addrs;
   while( cur != NULL )
   {
-    s = socket( AF_INET, SOCK_STREAM, 0 );
+    s = socket( cur->ai_family, SOCK_STREAM, 0 );
     if( s < 0 )
     {
       tio->_threadrc = -errno;
       break;
     }
 
+    if( cur->ai_family == AF_UNIX )
+    {
+      int stale_rc = dbrFShip_unix_clear_stale( (struct sockaddr_un*)cur->ai_addr, cur->ai_addrlen );
+      if( stale_rc != 0 )
+      {
+        LOG( DBG_ERR, stderr, "Unable to listen at %s. rc=%d\n", url, stale_rc );
+        tio->_threadrc = stale_rc;
+        close( s );
+        s = -1;
+        break;
+      }
+    }
+
     if( bind( s, cur->ai_addr, cur->ai_addrlen ) == 0 )
     {
+      if( cur->ai_family == AF_UNIX )
+        snprintf( tio->_unix_path, sizeof( tio->_unix_path ), "%s", ((struct sockaddr_un*)cur->ai_addr)->sun_path );
       break;
     }
 
     tio->_threadrc = -errno;
     close( s );
+    s = -1;
     cur = cur->ai_next;
   }
 
@@ -730,10 +786,10 @@ void* dbrFShip_listen_start( void *arg )
 
   while( tio->_keep_running )
   {
-    struct sockaddr naddr;
+    struct sockaddr_storage naddr;
     socklen_t naddrlen = sizeof( naddr );
 
-    int nes = accept( s, &naddr, &naddrlen );
+    int nes = accept( s, (struct sockaddr*)&naddr, &naddrlen );
     if( nes > 0 )
     {
       dbBE_Connection_t *connection = dbBE_Connection_create();
@@ -745,7 +801,7 @@ void* dbrFShip_listen_start( void *arg )
 
       connection->_socket = nes;
       connection->_status = DBBE_CONNECTION_STATUS_AUTHORIZED;
-      connection->_address = dbBE_Network_address_copy( &naddr, naddrlen );
+      connection->_address = dbBE_Network_address_copy( (struct sockaddr*)&naddr, naddrlen );
       if( dbBE_Network_address_to_string( connection->_address, connection->_url, DBBE_URL_MAX_LENGTH ) == NULL )
       {
         LOG( DBG_ERR, stderr, "Network address translation to URL failed.\n" );
@@ -915,6 +971,7 @@ dbrFShip_request_ctx_t* dbrFShip_create_request( dbBE_Request_t *req, dbrFShip_c
     case DBBE_OPCODE_READ:
     case DBBE_OPCODE_NSQUERY:
     case DBBE_OPCODE_ITERATOR:
+    case DBBE_OPCODE_STAT:
       // since these requests come with an SGE header, we need to create space to store the data
       if( req->_sge_count > 0 )
       {
@@ -995,6 +1052,7 @@ int dbrFShip_completion_cleanup( dbrFShip_request_ctx_t *rctx )
     case DBBE_OPCODE_READ:
     case DBBE_OPCODE_NSQUERY:
     case DBBE_OPCODE_ITERATOR:
+    case DBBE_OPCODE_STAT:
       // an SGE buffer was created, so we have to free it here
       if( req->_sge_count > 0 )
         free( req->_sge[0].iov_base );
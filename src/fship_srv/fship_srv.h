@@ -24,6 +24,8 @@
 #include "transports/sr_buffer.h"
 #include "client_context.h"
 
+#include <sys/un.h> // sockaddr_un
+
 #define DBR_FSHIP_CONNECTIONS_LIMIT ( 1024 )
 
 #define DBR_FSHIP_CONNECTION_WAKEUP_INTERVAL ( 1 )
@@ -66,6 +68,7 @@ typedef struct dbrFShip_threadio
   dbBE_Connection_queue_t *_conn_queue; // connection queue with activated connections
   dbrFShip_config_t *_cfg; // base configuration of the service
   int _threadrc; // return value of accept thread
+  char _unix_path[ sizeof( ((struct sockaddr_un*)0)->sun_path ) ]; // socket file created by the accept thread (removed at shutdown)
 } dbrFShip_threadio_t;
 
 void* dbrFShip_listen_start( void *arg );
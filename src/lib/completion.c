@@ -22,110 +22,151 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <stdlib.h>
-#include <sys/time.h>
+#include <time.h>
 #include <errno.h>
+#include <sched.h>
 
-DBR_Errorcode_t dbrCheck_response( dbrRequestContext_t *rctx )
+/*
+ * waiting for a request starts with a number of plain test loops (completions are often quick)
+ * then sleeps in slices that grow up to a max, checking the request between slices
+ * the slices are short enough to not add much latency if nobody else wakes up the waiter
+ */
+#ifndef DEVMODE
+#define DBR_WAIT_SPIN_LOOPS ( 256 )
+#else
+#define DBR_WAIT_SPIN_LOOPS ( 1 )
+#endif
+#define DBR_WAIT_SLEEP_MIN_USEC ( 16 )
+#define DBR_WAIT_SLEEP_MAX_USEC ( 1000 )
+
+static inline
+int64_t dbrWait_now_usec()
+{
+  struct timespec now;
+  clock_gettime( DBR_WAIT_CLOCK, &now );
+  return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+DBR_Errorcode_t dbrCheck_response_item( dbrRequestContext_t *rctx )
 {
   if( rctx == NULL )
     return DBR_ERR_INVALID;
 
   DBR_Errorcode_t rc = DBR_SUCCESS;
-  dbrRequestContext_t *chain = rctx;
-  while( chain != NULL )
-  {
-    dbBE_Request_t *req = &chain->_req;
-    dbBE_Completion_t *cpl = &chain->_cpl;
+  dbBE_Request_t *req = &rctx->_req;
+  dbBE_Completion_t *cpl = &rctx->_cpl;
 
-    int64_t rsize = 0;
+  int64_t rsize = 0;
 
-    if(( req->_opcode != DBBE_OPCODE_READ )&&( cpl->_rc < 0 ))
-      return cpl->_status;
+  if(( req->_opcode != DBBE_OPCODE_READ )&&( cpl->_rc < 0 ))
+    return cpl->_status;
 
-    switch( req->_opcode )
-    {
-      case DBBE_OPCODE_PUT:
-        // good if completion rc bytes match 1 or more (number of inserted items)
-        if( cpl->_rc < 1 )
-          rc = DBR_ERR_UBUFFER;
-        break;
-      case DBBE_OPCODE_READ:
+  switch( req->_opcode )
+  {
+    case DBBE_OPCODE_PUT:
+      // good if completion rc bytes match 1 or more (number of inserted items)
+      if( cpl->_rc < 1 )
+        rc = DBR_ERR_UBUFFER;
+      break;
+    case DBBE_OPCODE_READ:
+      if( cpl->_rc < 0 )
+      {
+        rc = DBR_ERR_UNAVAIL;
+        cpl->_rc = 0;
+      }
+      // no break on purpose
+    case DBBE_OPCODE_GET:
+      // good if the completion rc bytes is less or equal the size in SGEs
+      rsize = dbrSGE_extract_size( req );
+      if( rsize < cpl->_rc )
+        rc = DBR_ERR_UBUFFER;
+      // operation in progress if the returned data size is NULL buy completion says: success
+      if( cpl->_status == DBR_SUCCESS )
+      {
         if( cpl->_rc < 0 )
-        {
-          rc = DBR_ERR_UNAVAIL;
-          cpl->_rc = 0;
-        }
-        // no break on purpose
-      case DBBE_OPCODE_GET:
-        // good if the completion rc bytes is less or equal the size in SGEs
-        rsize = dbrSGE_extract_size( req );
-        if( rsize < cpl->_rc )
-          rc = DBR_ERR_UBUFFER;
-        // operation in progress if the returned data size is NULL buy completion says: success
-        if( cpl->_status == DBR_SUCCESS )
-        {
-          if( cpl->_rc < 0 )
-            rc = DBR_ERR_INVALID;
-          else if( chain->_rc ) // check if not NULL!
-            *chain->_rc = cpl->_rc; // set the return value
-        }
-        else
-          rc = cpl->_status;
-        break;
-
-      case DBBE_OPCODE_DIRECTORY:
-        // good if the completion rc bytes is less or equal the size in SGE[0] because other parts of the sge contain the count
-        if( req->_sge[0].iov_len < (size_t)cpl->_rc )
-          rc = DBR_ERR_UBUFFER;
-        if( cpl->_status == DBR_SUCCESS )
-        {
-          if( cpl->_rc < 0 )
-            rc = DBR_ERR_INVALID;
-          else if( chain->_rc )
-            *chain->_rc = cpl->_rc;
-        }
-        else
-          rc = cpl->_status;
-        break;
-
-      case DBBE_OPCODE_MOVE:
+          rc = DBR_ERR_INVALID;
+        else if( rctx->_rc ) // check if not NULL!
+          *rctx->_rc = cpl->_rc; // set the return value
+      }
+      else
         rc = cpl->_status;
-        break;
+      break;
 
-      case DBBE_OPCODE_REMOVE:
+    case DBBE_OPCODE_DIRECTORY:
+      // good if the completion rc bytes is less or equal the size in SGE[0] because other parts of the sge contain the count
+      if( req->_sge[0].iov_len < (size_t)cpl->_rc )
+        rc = DBR_ERR_UBUFFER;
+      if( cpl->_status == DBR_SUCCESS )
+      {
+        if( cpl->_rc < 0 )
+          rc = DBR_ERR_INVALID;
+        else if( rctx->_rc )
+          *rctx->_rc = cpl->_rc;
+      }
+      else
         rc = cpl->_status;
-        break;
+      break;
+
+    case DBBE_OPCODE_MOVE:
+      rc = cpl->_status;
+      break;
+
+    case DBBE_OPCODE_REMOVE:
+      rc = cpl->_status;
+      break;
 
-      case DBBE_OPCODE_NSCREATE:
-      case DBBE_OPCODE_NSATTACH:
+    case DBBE_OPCODE_NSCREATE:
+    case DBBE_OPCODE_NSATTACH:
+      rc = cpl->_status;
+      break;
+    case DBBE_OPCODE_NSADDUNITS:
+    case DBBE_OPCODE_NSREMOVEUNITS:
+      // good if the completion rc is 0
+      if( cpl->_rc != 0 )
         rc = cpl->_status;
-        break;
-      case DBBE_OPCODE_NSADDUNITS:
-      case DBBE_OPCODE_NSREMOVEUNITS:
-        // good if the completion rc is 0
-        if( cpl->_rc != 0 )
-          rc = cpl->_status;
-        break;
-      case DBBE_OPCODE_NSDETACH:
-        // good if the completion rc is > 0
-        if( cpl->_rc <= 0 )
-          rc = cpl->_status;
-        break;
-      case DBBE_OPCODE_NSDELETE:
-        // nothing
-        break;
-      case DBBE_OPCODE_NSQUERY:
-        // good if the completion rc is > 0 with the sge locations containing the name space meta data
-        rsize = dbrSGE_extract_size( req );
-        if(( rsize < cpl->_rc ) || ( cpl->_rc == 0 ))
-          rc = DBR_ERR_UBUFFER;
-        break;
-      case DBBE_OPCODE_ITERATOR:
-        *chain->_rc = cpl->_rc; // set the returned iterator
-        break;
-      default:
-        return DBR_ERR_INVALIDOP;
-    }
+      break;
+    case DBBE_OPCODE_NSDETACH:
+      // good if the completion rc is > 0
+      if( cpl->_rc <= 0 )
+        rc = cpl->_status;
+      break;
+    case DBBE_OPCODE_NSDELETE:
+      // nothing
+      break;
+    case DBBE_OPCODE_NSQUERY:
+      // good if the completion rc is > 0 with the sge locations containing the name space meta data
+      rsize = dbrSGE_extract_size( req );
+      if(( rsize < cpl->_rc ) || ( cpl->_rc == 0 ))
+        rc = DBR_ERR_UBUFFER;
+      break;
+    case DBBE_OPCODE_ITERATOR:
+      *rctx->_rc = cpl->_rc; // set the returned iterator
+      break;
+    case DBBE_OPCODE_STAT:
+      // count and size are already in the sge
+      rc = cpl->_status;
+      break;
+    default:
+      return DBR_ERR_INVALIDOP;
+  }
+  return rc;
+}
+
+DBR_Errorcode_t dbrCheck_response( dbrRequestContext_t *rctx )
+{
+  if( rctx == NULL )
+    return DBR_ERR_INVALID;
+
+  DBR_Errorcode_t rc = DBR_SUCCESS;
+  dbrRequestContext_t *chain = rctx;
+  while( chain != NULL )
+  {
+    DBR_Errorcode_t item_rc = dbrCheck_response_item( chain );
+    if(( item_rc == DBR_ERR_INVALIDOP ) ||
+        (( chain->_req._opcode != DBBE_OPCODE_READ ) && ( chain->_cpl._rc < 0 )))
+      return item_rc;
+    if( item_rc != DBR_SUCCESS )
+      rc = item_rc;
     chain = chain->_next;
   }
 
@@ -172,10 +213,41 @@ DBR_Errorcode_t dbrProcess_completion( dbrRequestContext_t *rctx,
       break;
   }
 
-  rctx->_status = dbrSTATUS_READY;
+  // once READY is visible, the owner may remove the request and recycle rctx
+  // anything still needed from it has to be loaded before the publish
+  dbrRequestContext_t *cb_head = rctx->_cb_head;
+  dbrMain_context_t *ctx = ( rctx->_ctx != NULL ) ? rctx->_ctx->_reverse : NULL;
+
+  // publish the completion to the thread that owns the request
+  DBR_REQUEST_STATUS_SET( rctx, dbrSTATUS_READY );
+
+  // the last completion of a chain with callback queues the chain for its callback
+  if(( cb_head != NULL ) && ( __atomic_sub_fetch( &cb_head->_cb_pending, 1, __ATOMIC_ACQ_REL ) == 0 ))
+    dbrCallback_enqueue( ctx, cb_head );
+
+  // wake up any thread that's sleeping until one of its requests completes
+  // (seq_cst pairs with the sleeper's announcement in dbrCompletion_sleep())
+  if(( ctx != NULL ) && ( __atomic_load_n( &ctx->_cpl_sleepers, __ATOMIC_SEQ_CST ) != 0 ))
+  {
+    pthread_mutex_lock( &ctx->_cpl_lock );
+    pthread_cond_broadcast( &ctx->_cpl_cond );
+    pthread_mutex_unlock( &ctx->_cpl_lock );
+  }
   return DBR_SUCCESS;
 }
 
+void dbrCallback_enqueue( dbrMain_context_t *ctx, dbrRequestContext_t *head )
+{
+  head->_cb_next = NULL;
+  pthread_mutex_lock( &ctx->_cb_lock );
+  if( ctx->_cb_ready_tail != NULL )
+    ctx->_cb_ready_tail->_cb_next = head;
+  else
+    __atomic_store_n( &ctx->_cb_ready, head, __ATOMIC_RELEASE );
+  ctx->_cb_ready_tail = head;
+  pthread_mutex_unlock( &ctx->_cb_lock );
+}
+
 /*
  * signals a request cancellation to the back-end
  */
@@ -183,7 +255,107 @@ DBR_Errorcode_t dbrCancel_request( dbrName_space_t *cs, dbrRequestContext_t *req
 {
   if(( cs == NULL ) || ( req_rctx == NULL ))
     return DBR_ERR_INVALID;
-  return cs->_be_ctx->_api->cancel( cs->_be_ctx->_context, req_rctx->_be_request_hdl );
+
+  BELOCK_LOCK( cs->_reverse );
+  DBR_Errorcode_t rc = cs->_be_ctx->_api->cancel( cs->_be_ctx->_context, req_rctx->_be_request_hdl );
+  BELOCK_UNLOCK( cs->_reverse );
+  return rc;
+}
+
+int dbrHarvest_completion( dbrMain_context_t *ctx )
+{
+  if(( ctx == NULL ) || ( ctx->_be_ctx == NULL ))
+    return -EINVAL;
+
+  dbBE_Completion_t *compl = ctx->_be_ctx->_api->test_any( ctx->_be_ctx->_context );
+  if( compl == NULL )
+    return 0;
+
+  dbrRequestContext_t *cmpl_rctx = (dbrRequestContext_t*)compl->_user;
+  if( cmpl_rctx == NULL )
+  {
+    fprintf( stderr, "BUG in interaction with system library. Empty user-ptr in completion.\n" );
+    return -EPROTO; // if there was no user ptr attached, then we have a serious problem
+  }
+  dbrProcess_completion( cmpl_rctx, compl );
+  if( ctx->_be_ctx->_api->release != NULL )
+    ctx->_be_ctx->_api->release( ctx->_be_ctx->_context, compl );
+  else
+    free( compl ); // clean up
+  return 1;
+}
+
+int dbrHarvest_completions( dbrMain_context_t *ctx, const int max )
+{
+  int harvested = 0;
+  // step aside if somebody needs the back-end lock to post
+  while(( harvested < max ) && ( __atomic_load_n( &ctx->_be_waiting, __ATOMIC_ACQUIRE ) == 0 ))
+  {
+    int rc = dbrHarvest_completion( ctx );
+    if( rc < 0 )
+      return rc;
+    if( rc == 0 )
+      break;
+    harvested += rc;
+  }
+  return harvested;
+}
+
+int dbrBackend_wait( dbrMain_context_t *ctx, int64_t timeout_usec )
+{
+  if(( ctx == NULL ) || ( ctx->_be_ctx == NULL ))
+    return -EINVAL;
+
+  if(( ctx->_be_ctx->_api->wait == NULL ) || ( ctx->_be_ctx->_api->wakeup == NULL ))
+    return -ENOSYS;
+
+  // announce the sleep before checking for threads that need the lock; BELOCK_LOCK does the reverse
+  int rc = 1;
+  __atomic_store_n( &ctx->_be_sleeping, 1, __ATOMIC_SEQ_CST );
+  if( __atomic_load_n( &ctx->_be_waiting, __ATOMIC_SEQ_CST ) == 0 )
+    rc = ctx->_be_ctx->_api->wait( ctx->_be_ctx->_context, timeout_usec );
+  __atomic_store_n( &ctx->_be_sleeping, 0, __ATOMIC_SEQ_CST );
+  return rc;
+}
+
+/*
+ * sleep until a completion gets processed by another thread or the timeout expires
+ * returns early if the request is already complete
+ */
+static
+void dbrCompletion_sleep( dbrMain_context_t *ctx, dbrRequestContext_t *rctx, int64_t timeout_usec )
+{
+  int64_t deadline = dbrWait_now_usec() + timeout_usec;
+  struct timespec ts;
+  ts.tv_sec = deadline / 1000000;
+  ts.tv_nsec = ( deadline % 1000000 ) * 1000;
+
+  pthread_mutex_lock( &ctx->_cpl_lock );
+  __atomic_add_fetch( &ctx->_cpl_sleepers, 1, __ATOMIC_SEQ_CST );
+  if( __atomic_load_n( &rctx->_status, __ATOMIC_SEQ_CST ) != dbrSTATUS_READY )
+    pthread_cond_timedwait( &ctx->_cpl_cond, &ctx->_cpl_lock, &ts );
+  __atomic_sub_fetch( &ctx->_cpl_sleepers, 1, __ATOMIC_SEQ_CST );
+  pthread_mutex_unlock( &ctx->_cpl_lock );
+}
+
+/*
+ * sleep until there's a chance that the request has completed
+ * if nobody else drives the back-end, this thread sleeps in the back-end until any connection becomes ready
+ * otherwise it waits for the thread that drives the back-end to signal a completion
+ */
+static
+void dbrWait_sleep( dbrName_space_t *cs, dbrRequestContext_t *rctx, int64_t timeout_usec )
+{
+  dbrMain_context_t *ctx = cs->_reverse;
+  if(( ctx->_config._progress == 0 ) && BELOCK_TRYLOCK( ctx ))
+  {
+    int rc = dbrBackend_wait( ctx, timeout_usec );
+    BELOCK_UNLOCK( ctx );
+    if( rc == -ENOSYS )
+      usleep( timeout_usec );
+    return;
+  }
+  dbrCompletion_sleep( ctx, rctx, timeout_usec );
 }
 
 /*
@@ -191,6 +363,8 @@ DBR_Errorcode_t dbrCancel_request( dbrName_space_t *cs, dbrRequestContext_t *req
  * processes the completion
  * if it was the desired request, then returns: the status (success/error)
  * if it was a different request, it returns DBR_INPROGRESS
+ * if another thread is already driving the back-end, it only checks the request status
+ * because that thread harvests completions for everybody
  */
 DBR_Errorcode_t dbrTest_request( dbrName_space_t *cs, dbrRequestContext_t *req_rctx )
 {
@@ -204,21 +378,22 @@ DBR_Errorcode_t dbrTest_request( dbrName_space_t *cs, dbrRequestContext_t *req_r
   DBR_Errorcode_t ret = DBR_ERR_INPROGRESS;
 
   // first, try to drive the backend and see if we can complete anything (else)
-  dbBE_Completion_t *compl = cs->_be_ctx->_api->test_any( cs->_be_ctx->_context );
-  if( compl != NULL )
+  // unless the progress thread is taking care of that
+  if( cs->_reverse->_config._progress == 0 )
   {
-    dbrRequestContext_t *cmpl_rctx = (dbrRequestContext_t*)compl->_user;
-    if( cmpl_rctx == NULL )
+    if( BELOCK_TRYLOCK( cs->_reverse ) )
     {
-      fprintf( stderr, "BUG in interaction with system library. Empty user-ptr in completion.\n" );
-      return DBR_ERR_BE_GENERAL; // if there was no user ptr attached, then we have a serious problem
+      int harvested = dbrHarvest_completion( cs->_reverse );
+      BELOCK_UNLOCK( cs->_reverse );
+      if( harvested == -EPROTO )
+        return DBR_ERR_BE_GENERAL;
     }
-    dbrProcess_completion( cmpl_rctx, compl );
-    free( compl ); // clean up
+    else
+      sched_yield(); // somebody else is in the back-end, don't compete for the cpu with it
   }
 
   // then see if we completed this request
-  if( req_rctx->_status == dbrSTATUS_READY )
+  if( DBR_REQUEST_STATUS_GET( req_rctx ) == dbrSTATUS_READY )
   {
     // this guy is complete - clean up and return status
     ret = req_rctx->_cpl._status;
@@ -234,64 +409,62 @@ DBR_Errorcode_t dbrWait_request( dbrName_space_t *cs,
   if(( hdl == NULL ) || ( cs == NULL ))
     return DBR_ERR_INVALID;
 
-  DBR_Errorcode_t rc;
-  struct timeval start_time, now, elapsed;
-  start_time.tv_sec = 0;
-  elapsed.tv_sec = 0;
+  DBR_Errorcode_t rc = DBR_ERR_INPROGRESS;
+
+  // deadline is based on a monotonic clock to be immune against time adjustments
+  int64_t deadline = INT64_MAX;
+  if( enable_timeout )
+    deadline = dbrWait_now_usec() + (int64_t)cs->_reverse->_config._timeout_sec * 1000000;
 
   DBR_Request_handle_t chain = hdl;
 
   /*
    * This loop should allow to drive the backend while waiting for completions
    * Reduces the requirement for a backend to make independent progress in a separate thread
-   * Only uses gettimeofday every N loops to reduce the number of syscalls
+   * After a short spinning phase, the thread sleeps between tests until either
+   * the back-end has activity or another thread signals a completion
    */
 
-#ifndef DEVMODE
-#define DBR_TIMEOUT_CHECKLOOPS ( 0x3FFF )
-#else
-#define DBR_TIMEOUT_CHECKLOOPS ( 0x1 )
-#endif
-
   // check the full chain of requests before returning
   while( chain != NULL )
   {
-    /*
-     * have a loop count to reduce the amount of gettimeofday calls
-     * start with negative offset to prevent the syscall for the first N iterations
-     */
-    uint64_t timeloops = (uint64_t)-100;
-    uint64_t timecalls = 0;
+    unsigned spins = 0;
+    int64_t slice = DBR_WAIT_SLEEP_MIN_USEC;
+    int64_t now = 0;
     do
     {
       rc = dbrTest_request( cs, chain );
-      if((rc == DBR_ERR_INPROGRESS)
-         && enable_timeout)
+      if( rc != DBR_ERR_INPROGRESS )
+        break;
+      if( ++spins < DBR_WAIT_SPIN_LOOPS )
       {
-        if( ((++timeloops) & DBR_TIMEOUT_CHECKLOOPS ) == 0 )
-        {
-          gettimeofday( &now, NULL );
-          ++timecalls;
-          if( start_time.tv_sec == 0 )
-          {
-            start_time.tv_sec = now.tv_sec;
-            start_time.tv_usec = now.tv_usec;
-          }
-          elapsed.tv_sec = (now.tv_sec * 1e6 + now.tv_usec) - (start_time.tv_sec * 1e6 + start_time.tv_usec);
-          elapsed.tv_sec /= 1e6;
-        }
+        // the progress thread needs the cpu more than this loop
+        if( cs->_reverse->_config._progress != 0 )
+          sched_yield();
+        continue;
       }
-    } while( rc == DBR_ERR_INPROGRESS
-             && ( elapsed.tv_sec < cs->_reverse->_config._timeout_sec ));
+
+      now = dbrWait_now_usec();
+      if( now >= deadline )
+        break;
+
+      dbrWait_sleep( cs, chain, ( deadline - now < slice ) ? deadline - now : slice );
+      if( slice < DBR_WAIT_SLEEP_MAX_USEC )
+        slice *= 2;
+    } while( rc == DBR_ERR_INPROGRESS );
 
     // ToDo: if Timeout -> send first a cancel and wait for acknowledge.
     //       otherwise internal structures could be in danger.
-    if(( rc == DBR_ERR_INPROGRESS )&& (elapsed.tv_sec >= cs->_reverse->_config._timeout_sec))
+    if( rc == DBR_ERR_INPROGRESS )
     {
       dbrCancel_request( cs, chain );
-      rc = DBR_ERR_INPROGRESS;
-      while( rc == DBR_ERR_INPROGRESS )
-        rc = dbrTest_request( cs, chain );
+      slice = DBR_WAIT_SLEEP_MIN_USEC;
+      while(( rc = dbrTest_request( cs, chain ) ) == DBR_ERR_INPROGRESS )
+      {
+        dbrWait_sleep( cs, chain, slice );
+        if( slice < DBR_WAIT_SLEEP_MAX_USEC )
+          slice *= 2;
+      }
     }
 
 
@@ -299,3 +472,84 @@ DBR_Errorcode_t dbrWait_request( dbrName_space_t *cs,
   }
   return rc;
 }
+
+/*
+ * a request is done once all requests of its chain are complete
+ * (closed ones were already completed and post-processed by a previous test)
+ */
+static
+int dbrRequest_chain_done( dbrRequestContext_t *rctx )
+{
+  for( ; rctx != NULL; rctx = rctx->_next )
+  {
+    dbrRequest_status_t st = DBR_REQUEST_STATUS_GET( rctx );
+    if(( st != dbrSTATUS_READY ) && ( st != dbrSTATUS_CLOSED ))
+      return 0;
+  }
+  return 1;
+}
+
+int dbrWait_request_set( dbrMain_context_t *ctx,
+                         dbrRequestContext_t **set,
+                         const int count,
+                         const int min_done,
+                         int *done,
+                         const int64_t timeout_usec )
+{
+  if(( ctx == NULL ) || (( count > 0 ) && (( set == NULL ) || ( done == NULL ))))
+    return -EINVAL;
+
+  int64_t deadline = INT64_MAX;
+  if( timeout_usec >= 0 )
+    deadline = dbrWait_now_usec() + timeout_usec;
+
+  unsigned spins = 0;
+  int64_t slice = DBR_WAIT_SLEEP_MIN_USEC;
+  while( 1 )
+  {
+    // one pass over the back-end can complete many requests of the set
+    // (or anything that's available if there's no set, e.g. requests with callbacks)
+    if(( ctx->_config._progress == 0 ) && BELOCK_TRYLOCK( ctx ))
+    {
+      int harvested = dbrHarvest_completions( ctx, ( count > 0 ) ? count : dbrMAX_TAGS );
+      BELOCK_UNLOCK( ctx );
+      if( harvested == -EPROTO )
+        return -EPROTO;
+    }
+
+    int n;
+    int ndone = 0;
+    dbrRequestContext_t *pending = NULL;
+    for( n = 0; n < count; ++n )
+    {
+      done[ n ] = 0;
+      if( set[ n ] == NULL )
+        continue;
+      done[ n ] = dbrRequest_chain_done( set[ n ] );
+      if( done[ n ] )
+        ++ndone;
+      else if( pending == NULL )
+        pending = set[ n ];
+    }
+
+    if(( ndone >= min_done ) || ( pending == NULL ))
+      return ndone;
+
+    if( ++spins < DBR_WAIT_SPIN_LOOPS )
+    {
+      if( ctx->_config._progress != 0 )
+        sched_yield();
+      continue;
+    }
+
+    int64_t now = dbrWait_now_usec();
+    if( now >= deadline )
+      return ndone;
+
+    // any completion might be one of ours, so sleeping on the first pending one is as good as any other
+    dbrWait_sleep( pending->_ctx, pending, ( deadline - now < slice ) ? deadline - now : slice );
+    if( slice < DBR_WAIT_SLEEP_MAX_USEC )
+      slice *= 2;
+  }
+  return 0;
+}
@@ -19,6 +19,7 @@
 #include "libdatabroker_int.h"
 #include "lib/backend.h"
 #include "memutil.h"
+#include "common/utility.h"
 
 #include <stddef.h>
 #include <errno.h>
@@ -30,19 +31,66 @@
 #include <string.h>
 
 
-uint32_t dbrMain_find( dbrMain_context_t *libctx, DBR_Name_t name )
+/*
+ * find the bucket link that points to a name space with the given name and hash
+ * the link contains NULL if there's no such name space
+ */
+static
+dbrName_space_t** dbrMain_find_link( dbrMain_context_t *libctx, const char *name, const uint32_t hash )
+{
+  dbrName_space_t **link = &libctx->_cs_list[ hash & libctx->_cs_mask ];
+  while(( *link != NULL ) &&
+        (( (*link)->_hash != hash ) || ( strncmp( (*link)->_db_name, name, DBR_MAX_KEY_LEN ) != 0 )))
+    link = &(*link)->_next;
+  return link;
+}
+
+/*
+ * double the number of buckets of the name space table
+ * the table stays intact if there's no memory
+ */
+static
+int dbrMain_table_grow( dbrMain_context_t *libctx )
+{
+  uint32_t new_mask = ( libctx->_cs_mask << 1 ) + 1;
+  dbrName_space_t **table = (dbrName_space_t**)calloc( (size_t)new_mask + 1, sizeof( dbrName_space_t* ) );
+  if( table == NULL )
+    return -ENOMEM;
+
+  uint32_t b;
+  for( b = 0; b <= libctx->_cs_mask; ++b )
+  {
+    dbrName_space_t *cs = libctx->_cs_list[ b ];
+    while( cs != NULL )
+    {
+      dbrName_space_t *next = cs->_next;
+      cs->_next = table[ cs->_hash & new_mask ];
+      table[ cs->_hash & new_mask ] = cs;
+      cs = next;
+    }
+  }
+  free( libctx->_cs_list );
+  libctx->_cs_list = table;
+  libctx->_cs_mask = new_mask;
+  return 0;
+}
+
+/*
+ * check that cs is the name space that's tracked under its name
+ */
+static inline
+int dbrMain_is_listed( dbrMain_context_t *libctx, dbrName_space_t *cs )
 {
-  if( libctx == NULL )
-    return dbrERROR_INDEX;
+  return (( cs->_db_name != NULL ) &&
+          ( *dbrMain_find_link( libctx, cs->_db_name, cs->_hash ) == cs ));
+}
 
-  uint32_t n;
-  for( n=0; (n<dbrNUM_DB_MAX); ++n )
-    if( ( libctx->_cs_list[ n ] != NULL ) &&
-        ( libctx->_cs_list[ n ]->_db_name != NULL ) &&
-        ( strncmp( libctx->_cs_list[ n ]->_db_name, name, DBR_MAX_KEY_LEN ) == 0 ))
-      return n;
+dbrName_space_t* dbrMain_find( dbrMain_context_t *libctx, DBR_Name_t name )
+{
+  if(( libctx == NULL ) || ( name == NULL ))
+    return NULL;
 
-  return dbrERROR_INDEX;
+  return *dbrMain_find_link( libctx, name, dbBE_String_hash( name, DBR_MAX_KEY_LEN ) );
 }
 
 dbrName_space_t* dbrMain_create_local( DBR_Name_t db_name )
@@ -60,10 +108,11 @@ dbrName_space_t* dbrMain_create_local( DBR_Name_t db_name )
   cs->_reverse = dbrCheckCreateMainCTX();
   cs->_be_ctx = dbrlib_backend_get_handle();
   cs->_status = dbrNS_STATUS_CREATED;
-  cs->_idx = dbrERROR_INDEX;
+  cs->_hash = dbBE_String_hash( db_name, DBR_MAX_KEY_LEN );
+  cs->_next = NULL;
   cs->_be_ns_hdl = NULL;
 
-  if( dbrMain_insert( cs->_reverse, cs ) == dbrERROR_INDEX )
+  if( dbrMain_insert( cs->_reverse, cs ) != 0 )
   {
     LOG( DBG_ERR, stderr, "Reference count error detected while creating namespace.\n" );
     memset( cs, 0, sizeof( dbrName_space_t ) );
@@ -73,45 +122,35 @@ dbrName_space_t* dbrMain_create_local( DBR_Name_t db_name )
   return cs;
 }
 
-// inserts cs into an empty slot (idempotent if already inserted before)
-uint32_t dbrMain_insert( dbrMain_context_t *libctx, dbrName_space_t *cs )
+// inserts cs into the name space table (idempotent if already inserted before)
+int dbrMain_insert( dbrMain_context_t *libctx, dbrName_space_t *cs )
 {
-  if(( libctx == NULL ) || ( cs == NULL ))
-    return dbrERROR_INDEX;
+  if(( libctx == NULL ) || ( cs == NULL ) || ( cs->_db_name == NULL ))
+    return -EINVAL;
 
-  uint32_t idx = 0;
-  if( cs->_idx == dbrERROR_INDEX ) // not yet inserted?
-  {
-    // find the first hole in the context list
-    // todo: current search has O(N) complexity, improve that later!!!
-    while((idx<dbrNUM_DB_MAX) && ( libctx->_cs_list[ idx ] != NULL ))
-      ++idx;
-
-    // if we hit the end, then everything is occupied
-    // todo: for now just return error, later maybe extend the list
-    if( idx == dbrNUM_DB_MAX )
-      return dbrERROR_INDEX;
-  }
-  else
-    idx = cs->_idx;
+  dbrName_space_t **link = dbrMain_find_link( libctx, cs->_db_name, cs->_hash );
 
-  // insert
-  if(( libctx->_cs_list[ idx ] != NULL ) && ( libctx->_cs_list[ idx ] != cs ))
+  // do nothing if already inserted
+  if( *link == cs )
+    return 0;
+
+  if( *link != NULL )
   {
     LOG( DBG_ERR, stderr, "Inconsistent namespace table.\n" );
-    return dbrERROR_INDEX;
+    return -EEXIST;
   }
 
-  // do nothing if already inserted
-  if( libctx->_cs_list[ idx ] == cs )
-    return idx;
+  // keep the load factor <= 1; a failed grow only costs longer bucket chains
+  if(( libctx->_cs_count > libctx->_cs_mask ) && ( dbrMain_table_grow( libctx ) == 0 ))
+    link = dbrMain_find_link( libctx, cs->_db_name, cs->_hash );
 
-  libctx->_cs_list[ idx ] = cs;
+  cs->_next = NULL;
+  *link = cs;
+  ++libctx->_cs_count;
   cs->_ref_count = 1;
-  cs->_idx = idx;
   cs->_status = dbrNS_STATUS_REFERENCED;
 
-  return idx;
+  return 0;
 }
 
 int dbrMain_attach( dbrMain_context_t *libctx, dbrName_space_t *cs )
@@ -120,8 +159,7 @@ int dbrMain_attach( dbrMain_context_t *libctx, dbrName_space_t *cs )
     return -EINVAL;
 
   // check consistency
-  uint32_t idx = cs->_idx;
-  if(( libctx->_cs_list[ idx ] == NULL ) || ( cs != libctx->_cs_list[ idx ] ))
+  if( ! dbrMain_is_listed( libctx, cs ) )
   {
     LOG( DBG_ERR, stderr, "Inconsistent Namespace table.\n" );
     return -ENOENT;
@@ -150,7 +188,13 @@ dbrMain_delete_local( dbrMain_context_t *libctx, dbrName_space_t *cs )
     LOG( DBG_ERR, stderr, "Reference count error: expected namespace status DELETED.\n" );
   }
 
-  uint32_t idx = cs->_idx;
+  dbrName_space_t **link = dbrMain_find_link( libctx, cs->_db_name, cs->_hash );
+  if( *link == cs )
+  {
+    *link = cs->_next;
+    --libctx->_cs_count;
+  }
+
   if( memzero( cs->_db_name, 0, strlen( cs->_db_name ) ) == NULL )
     rc = -EFAULT;
 
@@ -160,7 +204,6 @@ dbrMain_delete_local( dbrMain_context_t *libctx, dbrName_space_t *cs )
     rc = -EFAULT;
 
   free( cs );
-  libctx->_cs_list[ idx ] = NULL;
 
   return rc;
 }
@@ -171,8 +214,7 @@ int dbrMain_detach( dbrMain_context_t *libctx, dbrName_space_t *cs )
     return -EINVAL;
 
   // check consistency
-  uint32_t idx = cs->_idx;
-  if(( libctx->_cs_list[ idx ] == NULL ) || ( cs != libctx->_cs_list[ idx ] ))
+  if( ! dbrMain_is_listed( libctx, cs ) )
   {
     LOG( DBG_ERR, stderr, "Inconsistent Namespace table.\n" );
     return -ENOENT;
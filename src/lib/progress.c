@@ -0,0 +1,109 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "logutil.h"
+#include "libdatabroker_int.h"
+
+#include <stddef.h>
+#include <errno.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/*
+ * number of idle rounds (no completion) before the progress thread starts to sleep between rounds
+ */
+#define DBR_PROGRESS_IDLE_SPINS ( 1024 )
+#define DBR_PROGRESS_IDLE_SLEEP_USEC ( 1000 )
+
+/*
+ * library-owned thread that drives the back-end and harvests completions (DBR_PROGRESS=1)
+ * application threads then only have to check the status of their requests
+ */
+static void* dbrProgress_main( void *arg )
+{
+  dbrMain_context_t *ctx = (dbrMain_context_t*)arg;
+  unsigned idle = 0;
+
+  LOG( DBG_VERBOSE, stderr, "Progress thread started\n" );
+  while( __atomic_load_n( &ctx->_progress_running, __ATOMIC_ACQUIRE ) != 0 )
+  {
+    int completed = 0;
+    if( BELOCK_TRYLOCK( ctx ) )
+    {
+      completed = dbrHarvest_completion( ctx );
+      BELOCK_UNLOCK( ctx );
+    }
+
+    // no locks held here, so the callbacks are free to call into the library
+    if( dbrCallback_dispatch( ctx ) > 0 )
+      idle = 0;
+
+    if( completed > 0 )
+    {
+      idle = 0;
+      continue;
+    }
+
+    // don't burn a core while there's nothing to do
+    // once idle for a while, sleep in the back-end until a connection becomes ready
+    if( ++idle < DBR_PROGRESS_IDLE_SPINS )
+      sched_yield();
+    else if( BELOCK_TRYLOCK( ctx ) )
+    {
+      int rc = dbrBackend_wait( ctx, DBR_PROGRESS_IDLE_SLEEP_USEC );
+      BELOCK_UNLOCK( ctx );
+      if( rc == -ENOSYS )
+        usleep( DBR_PROGRESS_IDLE_SLEEP_USEC );
+    }
+    else
+      sched_yield();
+  }
+  LOG( DBG_VERBOSE, stderr, "Progress thread stopped\n" );
+  return NULL;
+}
+
+int dbrProgress_start( dbrMain_context_t *ctx )
+{
+  if(( ctx == NULL ) || ( ctx->_be_ctx == NULL ))
+    return -EINVAL;
+
+  if( ctx->_progress_running != 0 )
+    return -EALREADY;
+
+  __atomic_store_n( &ctx->_progress_running, 1, __ATOMIC_RELEASE );
+  int rc = pthread_create( &ctx->_progress_thread, NULL, dbrProgress_main, ctx );
+  if( rc != 0 )
+  {
+    __atomic_store_n( &ctx->_progress_running, 0, __ATOMIC_RELEASE );
+    LOG( DBG_ERR, stderr, "libdatabroker: failed to start progress thread. rc=%d\n", rc );
+    return -rc;
+  }
+  return 0;
+}
+
+int dbrProgress_stop( dbrMain_context_t *ctx )
+{
+  if( ctx == NULL )
+    return -EINVAL;
+
+  if( ctx->_progress_running == 0 )
+    return 0;
+
+  __atomic_store_n( &ctx->_progress_running, 0, __ATOMIC_RELEASE );
+  return -pthread_join( ctx->_progress_thread, NULL );
+}
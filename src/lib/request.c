@@ -29,6 +29,48 @@
 #include "logutil.h"
 #include "libdatabroker.h"
 #include "libdatabroker_int.h"
+#include "common/pool.h"
+
+/*
+ * backpressure when the back-end queue is full
+ */
+#define dbrPOST_HARVEST_MAX ( 128 )
+#define dbrPOST_BACKOFF_USEC ( 1000 )
+
+/*
+ * request contexts come in size classes by their SGE tail (1, 2, 4, ... SGEs)
+ * larger requests are rare and use the heap directly
+ */
+#define dbrREQUEST_POOL_CLASSES ( 7 )
+#define dbrREQUEST_POOL_CACHED ( 1024 )
+#define dbrREQUEST_POOL_SIZE( c ) ( sizeof( dbrRequestContext_t ) + ( 1 << (c) ) * sizeof( dbBE_sge_t ) )
+
+static dbBE_Pool_t gRequest_pool[ dbrREQUEST_POOL_CLASSES ] =
+{
+  DBBE_POOL_INITIALIZER( dbrREQUEST_POOL_SIZE( 0 ), dbrREQUEST_POOL_CACHED ),
+  DBBE_POOL_INITIALIZER( dbrREQUEST_POOL_SIZE( 1 ), dbrREQUEST_POOL_CACHED ),
+  DBBE_POOL_INITIALIZER( dbrREQUEST_POOL_SIZE( 2 ), dbrREQUEST_POOL_CACHED ),
+  DBBE_POOL_INITIALIZER( dbrREQUEST_POOL_SIZE( 3 ), dbrREQUEST_POOL_CACHED ),
+  DBBE_POOL_INITIALIZER( dbrREQUEST_POOL_SIZE( 4 ), dbrREQUEST_POOL_CACHED ),
+  DBBE_POOL_INITIALIZER( dbrREQUEST_POOL_SIZE( 5 ), dbrREQUEST_POOL_CACHED ),
+  DBBE_POOL_INITIALIZER( dbrREQUEST_POOL_SIZE( 6 ), dbrREQUEST_POOL_CACHED )
+};
+
+static inline
+int dbrRequest_pool_class( const int sge_count )
+{
+  int c = 0;
+  while(( c < dbrREQUEST_POOL_CLASSES ) && (( 1 << c ) < sge_count ))
+    ++c;
+  return c;
+}
+
+void dbrRequest_pool_drain( void )
+{
+  int c;
+  for( c = 0; c < dbrREQUEST_POOL_CLASSES; ++c )
+    dbBE_Pool_drain( &gRequest_pool[ c ] );
+}
 
 
 dbrRequestContext_t* dbrCreate_request_ctx(dbBE_Opcode op,
@@ -82,9 +124,17 @@ dbrRequestContext_t* dbrCreate_request_ctx(dbBE_Opcode op,
       break;
   }
 
-  dbrRequestContext_t *req = (dbrRequestContext_t*)calloc( 1, sizeof( dbrRequestContext_t ) + sge_count * sizeof(dbBE_sge_t) );
+  int pool_class = dbrRequest_pool_class( sge_count );
+  dbrRequestContext_t *req;
+  if( pool_class < dbrREQUEST_POOL_CLASSES )
+    req = (dbrRequestContext_t*)dbBE_Pool_get( &gRequest_pool[ pool_class ] );
+  else
+    req = (dbrRequestContext_t*)malloc( sizeof( dbrRequestContext_t ) + sge_count * sizeof(dbBE_sge_t) );
   if( req == NULL )
     return NULL;
+  memset( req, 0, sizeof( dbrRequestContext_t ) + sge_count * sizeof(dbBE_sge_t) );
+  if( pool_class < dbrREQUEST_POOL_CLASSES )
+    req->_pool_class = pool_class + 1;
 
   req->_req._ns_hdl = cs->_be_ns_hdl;
   req->_req._group = group;
@@ -97,7 +147,7 @@ dbrRequestContext_t* dbrCreate_request_ctx(dbBE_Opcode op,
     memcpy( req->_req._sge, sge, sge_count * sizeof( dbBE_sge_t ) );
   // req->_cpl just keep it all 0 after memset
   req->_cpl._status = DBR_SUCCESS;
-  req->_status = dbrSTATUS_PENDING;
+  DBR_REQUEST_STATUS_SET( req, dbrSTATUS_PENDING );
   req->_ctx = cs;
   req->_be_request_hdl = NULL;
   req->_rc = rc;
@@ -110,8 +160,12 @@ DBR_Errorcode_t dbrDestroy_request( dbrRequestContext_t *rctx )
 {
   if( rctx == NULL )
     return DBR_ERR_INVALID;
+  int pool_class = rctx->_pool_class;
   memset( rctx, 0, sizeof( dbrRequestContext_t ) + rctx->_req._sge_count * sizeof(dbBE_sge_t) );
-  free( rctx );
+  if( pool_class > 0 )
+    dbBE_Pool_put( &gRequest_pool[ pool_class - 1 ], rctx );
+  else
+    free( rctx );
   return DBR_SUCCESS;
 }
 
@@ -190,36 +244,17 @@ DBR_Tag_t dbrInsert_request( dbrName_space_t *cs, dbrRequestContext_t *rctx )
       || rctx == NULL || cs->_reverse == NULL )
     return DB_TAG_ERROR;
 
-  dbrRequestContext_t** cs_wq = cs->_reverse->_cs_wq;
-
   DBR_Tag_t tag = rctx->_tag;
 
   if( dbrValidateTag( rctx, tag ) != DBR_SUCCESS )
     return DB_TAG_ERROR;
 
-#ifdef DBR_INTTAG
-  unsigned int tag_idx = tag;
-
-#else
-  dbrRequestContext_t** p_rctx = (dbrRequestContext_t**)tag;
-  if( p_rctx < cs_wq
-      || &cs_wq[ dbrMAX_TAGS ] <= p_rctx )
-    return DB_TAG_ERROR;
-
-  unsigned int tag_idx = p_rctx - cs_wq;
-#endif
-
-  if( cs_wq[ tag_idx ] != NULL )
+  TAGLOCK_LOCK( cs->_reverse );
+  if( dbrTag_insert( cs->_reverse, tag, rctx ) != 0 )
   {
-    if( cs_wq[ tag_idx ]->_status != dbrSTATUS_CLOSED )
-    {
-      return DB_TAG_ERROR;
-    }
-    free( cs_wq[ tag_idx ] );
-    cs_wq[ tag_idx ] = NULL;
+    TAGLOCK_UNLOCKRETURN( cs->_reverse, DB_TAG_ERROR );
   }
-
-  cs_wq[ tag_idx ] = rctx;
+  TAGLOCK_UNLOCK( cs->_reverse );
   return tag;
 }
 
@@ -229,50 +264,53 @@ DBR_Errorcode_t dbrRemove_request( dbrName_space_t *cs, dbrRequestContext_t *rct
       || rctx == NULL || cs->_reverse == NULL )
     return DBR_ERR_INVALID;
 
-  dbrRequestContext_t** cs_wq = cs->_reverse->_cs_wq;
-
   DBR_Tag_t tag = rctx->_tag;
 
   if( dbrValidateTag( rctx, tag ) != DBR_SUCCESS )
     return DBR_ERR_TAGERROR;
 
-#ifdef DBR_INTTAG
-  unsigned int tag_idx = tag;
-
-#else
-  dbrRequestContext_t** p_rctx = (dbrRequestContext_t**)tag;
-  if( p_rctx < cs_wq
-      || &cs_wq[ dbrMAX_TAGS ] <= p_rctx )
-    return DBR_ERR_TAGERROR;
+  DBR_Errorcode_t rc = DBR_ERR_HANDLE; // assume the rctx-handle is not in the WQ-list until we actually find it
+  TAGLOCK_LOCK( cs->_reverse );
+  dbrRequestContext_t *entry = dbrTag_lookup( cs->_reverse, tag );
+  int released = ( entry != NULL );
 
-  unsigned int tag_idx = p_rctx - cs_wq;
-#endif
+  // a tag set waiter still polls these requests, the last one to unpin the tag destroys them
+  if( released && dbrTag_retire( cs->_reverse, tag ) )
+  {
+    for( ; entry != NULL; entry = entry->_next )
+      if( rctx == entry )
+        rc = DBR_SUCCESS;
+    TAGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  }
 
-  DBR_Errorcode_t rc = DBR_ERR_HANDLE; // assume the rctx-handle is not in the WQ-list until we actually find it
-  while( cs_wq[ tag_idx ] != NULL )
+  while( entry != NULL )
   {
-    dbrRequestContext_t *chain = cs_wq[ tag_idx ]->_next;
+    dbrRequestContext_t *chain = entry->_next;
     if(( chain != NULL )&&( chain->_tag != tag ))
     {
       printf( "BUG: chained request with different tag.\n" );
-      return DBR_ERR_INVALID;
+      TAGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_INVALID );
     }
     // todo: if there's a backend handle reference, we might have to clean it up
-    if( cs_wq[ tag_idx ]->_be_request_hdl != NULL )
+    if( entry->_be_request_hdl != NULL )
       LOG( DBG_VERBOSE, stderr, "TODO: cleanup backend handle?\n" );
 
-    if( rctx == cs_wq[ tag_idx ] )
+    if( rctx == entry )
     {
       LOG( DBG_VERBOSE, stdout, "Found the requested context\n" );
       rc = DBR_SUCCESS;
     }
 
     // todo: to prevent request deletion caused by an invalid rctx, move the requests to tmp deletion queue instead until we're sure the correct stuff is deleted
-    dbrDestroy_request( cs_wq[ tag_idx ] );
-    cs_wq[ tag_idx ] = chain;
+    dbrDestroy_request( entry );
+    entry = chain;
   }
 
-  cs_wq[ tag_idx ] = NULL;
+  // the tag is free for reuse right away, stale copies of it are caught by the generation
+  // a tag without inserted request stays reserved for its owner
+  if( released )
+    dbrTag_release( cs->_reverse, tag );
+  TAGLOCK_UNLOCK( cs->_reverse );
   return rc;
 }
 
@@ -281,7 +319,8 @@ DBR_Request_handle_t dbrPost_request_ext( dbrRequestContext_t *rctx, const int w
   if( rctx == NULL || rctx->_ctx == NULL || rctx->_ctx->_reverse == NULL )
     return NULL;
 
-  dbrBackend_t *be = rctx->_ctx->_reverse->_be_ctx;
+  dbrMain_context_t *ctx = rctx->_ctx->_reverse;
+  dbrBackend_t *be = ctx->_be_ctx;
   dbrRequestContext_t *chain = rctx;
   int rcount = 0;
   while( chain != NULL )
@@ -289,7 +328,10 @@ DBR_Request_handle_t dbrPost_request_ext( dbrRequestContext_t *rctx, const int w
     if( dbrValidateTag( chain, chain->_tag ) != DBR_SUCCESS )
       return NULL;
 
-    if( chain->_ctx->_reverse->_cs_wq[ chain->_tag ] == NULL )
+    TAGLOCK_LOCK( ctx );
+    dbrRequestContext_t *inserted = dbrTag_lookup( ctx, chain->_tag );
+    TAGLOCK_UNLOCK( ctx );
+    if( inserted == NULL )
     {
       LOG( DBG_ERR, stderr, "Request not inserted in namespace request list.\n" );
       return NULL;
@@ -301,16 +343,27 @@ DBR_Request_handle_t dbrPost_request_ext( dbrRequestContext_t *rctx, const int w
       return NULL;
     }
     chain->_cpl._status = DBR_ERR_INPROGRESS;
-    chain->_status = dbrSTATUS_PENDING;
+    DBR_REQUEST_STATUS_SET( chain, dbrSTATUS_PENDING );
 
     rcount = ((rcount+1) % 128 );
     int trigger = (( chain->_next == NULL ) && ( with_trigger )) || ( rcount == 0 );
     dbBE_Request_handle_t be_handle = NULL;
+    // lock per attempt to let other threads into the back-end while the queue is full
     do {
+      BELOCK_LOCK( ctx );
       be_handle = be->_api->post( be->_context, &chain->_req, trigger );
+      int post_errno = errno;
+      // queue is full: drain completions or sleep until the back-end made room instead of spinning
+      if(( be_handle == NULL ) && ( post_errno == EAGAIN ))
+      {
+        if(( ctx->_config._progress != 0 ) || ( dbrHarvest_completions( ctx, dbrPOST_HARVEST_MAX ) <= 0 ))
+          dbrBackend_wait( ctx, dbrPOST_BACKOFF_USEC );
+      }
+      BELOCK_UNLOCK( ctx );
+      errno = post_errno;
     } while(( be_handle == NULL ) && ( errno == EAGAIN ));
 
-      if( be_handle == NULL )
+    if( be_handle == NULL )
       goto error;
     chain->_be_request_hdl = be_handle;
 
@@ -327,3 +380,29 @@ DBR_Request_handle_t dbrPost_request( dbrRequestContext_t *rctx )
 {
   return dbrPost_request_ext( rctx, 1 );
 }
+
+DBR_Errorcode_t dbrRequest_set_callback( dbrRequestContext_t *head, DBR_Callback_t callback, void *user )
+{
+  if(( head == NULL ) || ( callback == NULL ))
+    return DBR_ERR_INVALID;
+
+  int pending = 1; // reference of the poster
+  dbrRequestContext_t *chain;
+  for( chain = head; chain != NULL; chain = chain->_next )
+  {
+    chain->_cb_head = head;
+    ++pending;
+  }
+  head->_callback = callback;
+  head->_cb_user = user;
+  __atomic_store_n( &head->_cb_pending, pending, __ATOMIC_RELEASE );
+  return DBR_SUCCESS;
+}
+
+void dbrRequest_release_callback( dbrRequestContext_t *head )
+{
+  if(( head == NULL ) || ( head->_callback == NULL ))
+    return;
+  if( __atomic_sub_fetch( &head->_cb_pending, 1, __ATOMIC_ACQ_REL ) == 0 )
+    dbrCallback_enqueue( head->_ctx->_reverse, head );
+}
@@ -20,16 +20,30 @@
 
 #include "errorcodes.h"
 #include "libdatabroker.h"
+#include "libdatabroker_ext.h"
 
 #include "util/lock_tools.h"
 #include "common/dbbe_api.h"
 #include "dbrda_api.h"
 #include "lib/backend.h"
 
-#define dbrMAX_TAGS ( DBR_POSTED_QUEUE_DEPTH )
-#define dbrNUM_DB_MAX ( 1024 )
-#define dbrERROR_INDEX ( (uint32_t)-1)
-#define DBR_TMP_BUFFER_LEN ( 128 * 1024 * 1024 )
+#define dbrMAX_TAGS ( DBR_POSTED_QUEUE_DEPTH )  ///< initial size of the tag table
+
+/**
+ * a tag is the index into the tag table and the generation of the entry at allocation time
+ * the generation is bumped when the tag is released, so stale tags don't find a newer request
+ */
+#define dbrTAG_INDEX_BITS ( 32 )
+#define dbrTAG_INDEX_MASK ( 0xFFFFFFFFULL )
+#define dbrTAG_GEN_MASK ( 0x7FFFFFFFU )   // keeps tags positive
+#define dbrTAG_MAKE( idx, gen ) ( (DBR_Tag_t)( ((uint64_t)(gen) << dbrTAG_INDEX_BITS ) | (uint64_t)(idx) ) )
+#define dbrTAG_INDEX( tag ) ( (uint32_t)( (uint64_t)(tag) & dbrTAG_INDEX_MASK ) )
+#define dbrTAG_GEN( tag ) ( (uint32_t)( (uint64_t)(tag) >> dbrTAG_INDEX_BITS ) )
+
+#define dbrTAG_LIST_END ( (uint32_t)-1 )   ///< end of the free list
+#define dbrTAG_ALLOCATED ( (uint32_t)-2 )  ///< entry is not on the free list
+#define dbrTAG_REMOVED ( (uint32_t)-3 )    ///< request is removed, but still pinned by a waiter
+#define dbrNS_TABLE_INITIAL ( 64 )  ///< initial number of buckets of the name space table (power of 2)
 
 
 #include "lib/sge.h"
@@ -49,6 +63,22 @@
 #define DBR_REQUEST_REFERENCE_INC( r )  if( ! DBR_REQUEST_IS_REFERENCE(r) ) (r)._count += (1 << 2 )
 #define DBR_REQUEST_REFERENCE_DEC( r )  if(( ! DBR_REQUEST_IS_REFERENCE(r) ) && ( (r)._count > DBR_REQUEST_REFERENCE_ZERO )) (r)._count -= (1 << 2 )
 
+/**
+ * completions might get harvested by any thread that drives the back-end
+ * the request status is what publishes the completion data to the owner of the request
+ */
+#define DBR_REQUEST_STATUS_GET( rctx ) __atomic_load_n( &(rctx)->_status, __ATOMIC_ACQUIRE )
+#define DBR_REQUEST_STATUS_SET( rctx, st ) __atomic_store_n( &(rctx)->_status, (st), __ATOMIC_RELEASE )
+
+/**
+ * clock for wait deadlines and the completion condition variable
+ */
+#ifdef __APPLE__
+#define DBR_WAIT_CLOCK CLOCK_REALTIME   // no pthread_condattr_setclock()
+#else
+#define DBR_WAIT_CLOCK CLOCK_MONOTONIC
+#endif
+
 struct dbrMain_context;
 
 
@@ -66,10 +96,11 @@ typedef enum
  * @brief Internal local representation of a name space
  * @typedef
  */
-typedef struct
+typedef struct dbrName_space
 {
   struct dbrMain_context *_reverse;  ///< something to reverse lookup of several name space data depending on DB_handle_t type definition
-  uint32_t _idx;                     ///< index into name space table
+  struct dbrName_space *_next;       ///< next name space in the same bucket of the name space table
+  uint32_t _hash;                    ///< hash of the name to index the name space table
   int _ref_count;                    ///< local reference counter
   DBR_Name_t _db_name;               ///< name of the name space
   dbrBackend_t *_be_ctx;             ///< back end access context
@@ -118,14 +149,30 @@ typedef struct dbrRequestContext
   dbrDA_Request_chain_t *_rchain;  ///< actual request chain, potentially modified after plugin call
   dbrDA_Request_chain_t *_ochain;  ///< original request chain from user
   struct dbrRequestContext *_next;
+  DBR_Callback_t _callback;        ///< (head only) completion callback of the user
+  void *_cb_user;                  ///< (head only) user pointer passed to the callback
+  int _cb_pending;                 ///< (head only) incomplete requests of the chain + 1 reference of the poster
+  struct dbrRequestContext *_cb_head;  ///< head of the chain if a callback is registered, NULL otherwise
+  struct dbrRequestContext *_cb_next;  ///< next entry in the queue of chains that are ready for their callback
+  int _pool_class;                 ///< size class + 1 if allocated from the request pool, 0 for heap allocations
   dbBE_Request_t _req;     ///< dynamic length
 } dbrRequestContext_t;
 
 typedef dbrRequestContext_t* DBR_Request_handle_t;
 
+typedef struct dbrTag_entry
+{
+  dbrRequestContext_t *_rctx;  ///< request (chain) of the tag, NULL while the tag is reserved but not inserted
+  uint32_t _gen;               ///< generation of the entry
+  uint32_t _next_free;         ///< next entry of the free list, dbrTAG_ALLOCATED, or dbrTAG_REMOVED
+  uint32_t _pins;              ///< number of waiters that reference the request outside of the tag lock
+} dbrTag_entry_t;
+
 typedef struct dbrConfig
 {
   long int _timeout_sec;
+  uint32_t _max_tags;        ///< upper limit of the tag table size (DBR_MAX_TAGS)
+  int _progress;             ///< a library thread drives the back-end (DBR_PROGRESS)
 } dbrConfig_t;
 
 // global context data
@@ -133,14 +180,27 @@ typedef struct dbrMain_context
 {
   dbrConfig_t _config;                        ///< configuration data
   dbrBackend_t *_be_ctx;                      ///< back-end context/plugin handle
-  dbrName_space_t *_cs_list[dbrNUM_DB_MAX];   ///< CS handles array keeping track of all name spaces locally
-  dbrRequestContext_t *_cs_wq[ dbrMAX_TAGS ]; ///< request queue by tag
-
-  // todo: we'll need an array of head/tail tags to track responses from each node in a cluster
-  uint64_t _tag_head;                     ///< tag for the next request
-  uint64_t _tag_tail;                     ///< tag of the next expected completion
-  pthread_mutex_t _biglock;               ///< initial step to thread-safe lib; starting with big lock in main context
-  void* _tmp_testkey_buf;                 ///< a tmp buffer that holds return values for testkey command
+  dbrName_space_t **_cs_list;                 ///< hash table of CS handles keeping track of all name spaces locally
+  uint32_t _cs_mask;                          ///< number of buckets of the name space table - 1
+  uint32_t _cs_count;                         ///< number of name spaces in the table
+  dbrTag_entry_t *_cs_wq;                     ///< request table by tag index, grows on demand
+
+  uint32_t _tag_capacity;                 ///< number of entries in the request table
+  uint32_t _tag_free;                     ///< head of the free list of tags
+  uint32_t _tag_count;                    ///< number of allocated tags
+  pthread_mutex_t _tag_lock;              ///< protects tag allocation and the request queue (recursive)
+  pthread_mutex_t _ns_lock;               ///< protects the local name space table
+  pthread_mutex_t _be_lock;               ///< serializes calls into the back-end (posting and completion harvesting)
+  int _be_waiting;                        ///< number of threads blocked on _be_lock; pollers step aside while > 0
+  int _be_sleeping;                       ///< the holder of _be_lock is blocked in the back-end wait()
+  pthread_mutex_t _cpl_lock;              ///< protects sleeping on _cpl_cond
+  pthread_cond_t _cpl_cond;               ///< signaled when completions are processed and somebody sleeps
+  int _cpl_sleepers;                      ///< number of threads sleeping on _cpl_cond
+  pthread_mutex_t _cb_lock;               ///< protects the callback queue
+  dbrRequestContext_t *_cb_ready;         ///< queue of completed requests with pending callbacks
+  dbrRequestContext_t *_cb_ready_tail;    ///< tail of the callback queue
+  pthread_t _progress_thread;             ///< back-end progress thread if enabled by config
+  int _progress_running;                  ///< progress thread keeps going while != 0
 #ifdef DBR_DATA_ADAPTERS
   void *_da_library;                        ///< library handle to the data adapter library
   dbrDA_api_t *_data_adapter;               ///< if there's a data adapter library loaded, it's referenced here
@@ -156,8 +216,17 @@ int dbrMain_exit(void);
 
 dbrName_space_t* dbrMain_create_local( DBR_Name_t db_name );
 
-uint32_t dbrMain_find( dbrMain_context_t *libctx, DBR_Name_t name );
-uint32_t dbrMain_insert( dbrMain_context_t *libctx, dbrName_space_t *cs );
+/*
+ * find a name space by name (requires the name space lock)
+ * returns NULL if the name space is not in the local table
+ */
+dbrName_space_t* dbrMain_find( dbrMain_context_t *libctx, DBR_Name_t name );
+
+/*
+ * insert a name space into the local table (idempotent if already inserted before)
+ * returns 0 on success or a negative error code
+ */
+int dbrMain_insert( dbrMain_context_t *libctx, dbrName_space_t *cs );
 int dbrMain_detach( dbrMain_context_t *libctx, dbrName_space_t *cs );
 int dbrMain_delete( dbrMain_context_t *libctx, dbrName_space_t *cs );
 int dbrMain_attach( dbrMain_context_t *libctx, dbrName_space_t *cs );
@@ -166,6 +235,39 @@ int dbrMain_attach( dbrMain_context_t *libctx, dbrName_space_t *cs );
 // request creation/posting
 
 DBR_Tag_t dbrTag_get( dbrMain_context_t *ctx );
+
+/*
+ * return a tag that never got a request inserted (e.g. in error paths)
+ * tags with inserted requests are released by dbrRemove_request()
+ */
+void dbrTag_release( dbrMain_context_t *ctx, DBR_Tag_t tag );
+
+/*
+ * find the request of a tag (requires the tag lock)
+ * returns NULL for invalid, stale, or reserved tags
+ */
+dbrRequestContext_t* dbrTag_lookup( dbrMain_context_t *ctx, DBR_Tag_t tag );
+
+/*
+ * put a request into the entry of its reserved tag (requires the tag lock)
+ * returns -EINVAL if the tag is invalid, stale, or already has a request
+ */
+int dbrTag_insert( dbrMain_context_t *ctx, DBR_Tag_t tag, dbrRequestContext_t *rctx );
+
+/*
+ * find the request of a tag and keep it alive until dbrTag_unpin() (requires the tag lock)
+ * the request can still be completed and removed by another thread in the meantime,
+ * but it's only destroyed once the last pin is gone
+ * returns NULL for invalid, stale, or reserved tags
+ */
+dbrRequestContext_t* dbrTag_pin( dbrMain_context_t *ctx, DBR_Tag_t tag );
+void dbrTag_unpin( dbrMain_context_t *ctx, DBR_Tag_t tag );
+
+/*
+ * hide a pinned tag from lookups instead of releasing it (requires the tag lock)
+ * returns 1 if the tag is pinned and its requests are left to the last dbrTag_unpin(), 0 otherwise
+ */
+int dbrTag_retire( dbrMain_context_t *ctx, DBR_Tag_t tag );
 DBR_Errorcode_t dbrValidateTag( dbrRequestContext_t *rctx, DBR_Tag_t req_tag );
 
 dbrRequestContext_t* dbrCreate_request_ctx(dbBE_Opcode op,
@@ -181,6 +283,11 @@ dbrRequestContext_t* dbrCreate_request_ctx(dbBE_Opcode op,
                                            DBR_Tag_t tag );
 DBR_Errorcode_t dbrDestroy_request( dbrRequestContext_t *rctx );
 
+/*
+ * release the cached request contexts (at library exit)
+ */
+void dbrRequest_pool_drain( void );
+
 dbrRequestContext_t* dbrCreate_request_chain( dbBE_Opcode op,
                                               dbrName_space_t *ns,
                                               DBR_Group_t group,
@@ -197,16 +304,83 @@ DBR_Errorcode_t dbrRemove_request( dbrName_space_t *cs, dbrRequestContext_t *rct
 DBR_Request_handle_t dbrPost_request_ext( dbrRequestContext_t *rctx, const int with_trigger );
 DBR_Request_handle_t dbrPost_request( dbrRequestContext_t *rctx );
 
+/*
+ * register a completion callback for a request chain before it gets posted
+ * the poster holds a reference until dbrRequest_release_callback() so that the
+ * callback cannot complete and free the chain while it's still being posted
+ */
+DBR_Errorcode_t dbrRequest_set_callback( dbrRequestContext_t *head, DBR_Callback_t callback, void *user );
+void dbrRequest_release_callback( dbrRequestContext_t *head );
+
 
 //////////////////////////////////////////////////////////////////////
 // request tracking/completion
 
 DBR_Errorcode_t dbrCheck_response( dbrRequestContext_t *rctx );
 
+/*
+ * check the response of a single request of a chain (e.g. one item of a batch)
+ */
+DBR_Errorcode_t dbrCheck_response_item( dbrRequestContext_t *rctx );
+
+/*
+ * fetch and process at most one completion from the back-end (requires the back-end lock)
+ * returns 1 if a completion was processed, 0 if there was none, or a negative error code
+ */
+int dbrHarvest_completion( dbrMain_context_t *ctx );
+
+/*
+ * process up to max completions from the back-end (requires the back-end lock)
+ * returns the number of processed completions or a negative error code
+ */
+int dbrHarvest_completions( dbrMain_context_t *ctx, const int max );
+
+/*
+ * sleep in the back-end until it might make progress, the timeout expires,
+ * or another thread needs the back-end lock (requires the back-end lock)
+ * returns -ENOSYS if the back-end has no wait support
+ */
+int dbrBackend_wait( dbrMain_context_t *ctx, int64_t timeout_usec );
+
 DBR_Errorcode_t dbrTest_request( dbrName_space_t *cs, DBR_Request_handle_t hdl );
 DBR_Errorcode_t dbrWait_request( dbrName_space_t *cs,
                                  DBR_Request_handle_t hdl,
                                  int enable_timeout );
 
+/*
+ * drive the back-end until at least min_done requests of the set are complete or the timeout expires
+ * NULL entries are ignored, done[i] is set to 1 for each complete request
+ * min_done == 0 makes a single non-blocking pass, timeout_usec < 0 waits without timeout
+ * with count == 0, it only drives the back-end once
+ * returns the number of complete requests or a negative error code
+ */
+int dbrWait_request_set( dbrMain_context_t *ctx,
+                         dbrRequestContext_t **set,
+                         const int count,
+                         const int min_done,
+                         int *done,
+                         const int64_t timeout_usec );
+
+//////////////////////////////////////////////////////////////////////
+// optional back-end progress thread
+
+int dbrProgress_start( dbrMain_context_t *ctx );
+int dbrProgress_stop( dbrMain_context_t *ctx );
+
+//////////////////////////////////////////////////////////////////////
+// completion callbacks
+
+/*
+ * queue a completed request chain for its callback (called during completion processing)
+ */
+void dbrCallback_enqueue( dbrMain_context_t *ctx, dbrRequestContext_t *head );
+
+/*
+ * complete the queued requests and invoke their callbacks
+ * must not be called with any of the library locks held, since the callbacks may call into the library
+ * returns the number of invoked callbacks
+ */
+int dbrCallback_dispatch( dbrMain_context_t *ctx );
+
 
 #endif /* SRC_LIBDATABROKER_INT_H_ */
@@ -19,9 +19,20 @@
 #define SRC_LIBDBRAPI_H_
 
 #include "libdatabroker.h"
+#include "libdatabroker_ext.h"
 #include "dbrda_api.h"
 #include "../backend/common/dbbe_api.h"
 
+/*
+ * single-item request chain of the blocking calls, kept on the caller's stack
+ * (_sge provides the storage of _chain._value_sge[0])
+ */
+typedef struct
+{
+  dbrDA_Request_chain_t _chain;
+  struct iovec _sge;
+} dbrDA_Request_single_t;
+
 DBR_Handle_t
 libdbrCreate( DBR_Name_t db_name,
               DBR_Tuple_persist_level_t level,
@@ -67,7 +78,9 @@ libdbrPut( DBR_Handle_t cs_handle,
 DBR_Tag_t
 libdbrPutA( DBR_Handle_t cs_handle,
             dbrDA_Request_chain_t *request,
-            DBR_Group_t group );
+            DBR_Group_t group,
+            DBR_Callback_t callback,
+            void *user );
 
 DBR_Errorcode_t
 libdbrGet( DBR_Handle_t cs_handle,
@@ -83,7 +96,9 @@ libdbrGetA(DBR_Handle_t cs_handle,
            DBR_Tuple_template_t match_template,
            DBR_Group_t group,
            int flags,
-           int64_t *ret_size );
+           int64_t *ret_size,
+           DBR_Callback_t callback,
+           void *user );
 
 DBR_Errorcode_t
 libdbrRead( DBR_Handle_t cs_handle,
@@ -99,7 +114,35 @@ libdbrReadA(DBR_Handle_t cs_handle,
             DBR_Tuple_template_t match_template,
             DBR_Group_t group,
             int flags,
-            int64_t *ret_size );
+            int64_t *ret_size,
+            DBR_Callback_t callback,
+            void *user );
+
+/*
+ * batch functions: one tag and one back-end trigger for a chain of independent tuples
+ * status (optional) receives one entry per request of the chain
+ */
+DBR_Errorcode_t
+libdbrPutBatch( DBR_Handle_t cs_handle,
+                dbrDA_Request_chain_t *request,
+                DBR_Group_t group,
+                DBR_Errorcode_t *status );
+
+DBR_Errorcode_t
+libdbrGetBatch( DBR_Handle_t cs_handle,
+                dbrDA_Request_chain_t *request,
+                DBR_Tuple_template_t match_template,
+                DBR_Group_t group,
+                int flags,
+                DBR_Errorcode_t *status );
+
+DBR_Errorcode_t
+libdbrReadBatch( DBR_Handle_t cs_handle,
+                 dbrDA_Request_chain_t *request,
+                 DBR_Tuple_template_t match_template,
+                 DBR_Group_t group,
+                 int flags,
+                 DBR_Errorcode_t *status );
 
 DBR_Errorcode_t
 libdbrTestKey( DBR_Handle_t cs_handle,
@@ -107,6 +150,14 @@ libdbrTestKey( DBR_Handle_t cs_handle,
                DBR_Tuple_template_t match_template,
                DBR_Group_t group );
 
+DBR_Errorcode_t
+libdbrStat( DBR_Handle_t cs_handle,
+            DBR_Group_t group,
+            DBR_Tuple_name_t tuple_name,
+            DBR_Tuple_template_t match_template,
+            int64_t *count,
+            int64_t *size );
+
 DBR_Errorcode_t
 libdbrMove( DBR_Handle_t src_cs_handle,
             DBR_Group_t src_group,
@@ -148,5 +199,23 @@ libdbrTest( DBR_Tag_t req_tag );
 DBR_Errorcode_t
 libdbrCancel( DBR_Tag_t req_tag );
 
+DBR_Errorcode_t
+libdbrTestSome( const int count,
+                DBR_Tag_t *tags,
+                int *completed,
+                int *indices,
+                DBR_Errorcode_t *status );
+
+DBR_Errorcode_t
+libdbrWaitAny( const int count,
+               DBR_Tag_t *tags,
+               int *index,
+               DBR_Errorcode_t *status );
+
+DBR_Errorcode_t
+libdbrWaitAll( const int count,
+               DBR_Tag_t *tags,
+               DBR_Errorcode_t *status );
+
 
 #endif /* SRC_LIBDBRAPI_H_ */
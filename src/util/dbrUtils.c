@@ -29,6 +29,7 @@
 #include <malloc.h>
 #endif
 #include <string.h>
+#include <time.h>
 #include <errno.h>
 #include <limits.h>
 #include <stdio.h>
@@ -38,6 +39,40 @@
 static dbrMain_context_t *gMain_context = NULL;
 static pthread_mutex_t gMain_creation_lock = PTHREAD_MUTEX_INITIALIZER;
 
+/*
+ * double the size of the tag table (up to the configured max) and put the new entries on the free list
+ * requires the tag lock once the main context is in use
+ */
+static
+int dbrTag_table_grow( dbrMain_context_t *ctx )
+{
+  uint32_t old_cap = ctx->_tag_capacity;
+  if( old_cap >= ctx->_config._max_tags )
+    return -ENOSPC;
+
+  uint64_t new_cap = ( old_cap == 0 ) ? dbrMAX_TAGS : (uint64_t)old_cap * 2;
+  if( new_cap > ctx->_config._max_tags )
+    new_cap = ctx->_config._max_tags;
+
+  dbrTag_entry_t *table = (dbrTag_entry_t*)realloc( ctx->_cs_wq, new_cap * sizeof( dbrTag_entry_t ) );
+  if( table == NULL )
+    return -ENOMEM;
+
+  // chain the new entries in index order in front of the (empty) free list
+  uint32_t n;
+  for( n = old_cap; n < new_cap; ++n )
+  {
+    table[ n ]._rctx = NULL;
+    table[ n ]._gen = 0;
+    table[ n ]._pins = 0;
+    table[ n ]._next_free = ( n + 1 < new_cap ) ? n + 1 : ctx->_tag_free;
+  }
+  ctx->_tag_free = old_cap;
+  ctx->_cs_wq = table;
+  ctx->_tag_capacity = (uint32_t)new_cap;
+  return 0;
+}
+
 dbrMain_context_t* dbrCheckCreateMainCTX(void)
 {
   pthread_mutex_lock( &gMain_creation_lock );
@@ -64,13 +99,36 @@ dbrMain_context_t* dbrCheckCreateMainCTX(void)
     if( gMain_context->_config._timeout_sec == 0 )
       gMain_context->_config._timeout_sec = INT_MAX;
 
-    gMain_context->_tmp_testkey_buf = malloc( DBR_TMP_BUFFER_LEN );
-    if( gMain_context->_tmp_testkey_buf == NULL )
+    to_str = getenv(DBR_PROGRESS_ENV);
+    if( to_str == NULL )
+      gMain_context->_config._progress = DBR_PROGRESS_DEFAULT;
+    else
+      gMain_context->_config._progress = ( strtol( to_str, NULL, 10 ) != 0 );
+
+    to_str = getenv(DBR_MAX_TAGS_ENV);
+    long int max_tags = ( to_str != NULL ) ? strtol( to_str, NULL, 10 ) : DBR_MAX_TAGS_DEFAULT;
+    if( max_tags <= 0 )
+      max_tags = DBR_MAX_TAGS_DEFAULT;
+    if( max_tags >= dbrTAG_REMOVED )
+      max_tags = dbrTAG_REMOVED - 1;
+    gMain_context->_config._max_tags = (uint32_t)max_tags;
+
+    gMain_context->_cs_list = (dbrName_space_t**)calloc( dbrNS_TABLE_INITIAL, sizeof( dbrName_space_t* ) );
+    if( gMain_context->_cs_list == NULL )
+    {
+      LOG( DBG_ERR, stderr, "libdatabroker: failed to allocate name space table.\n" );
+      pthread_mutex_unlock( &gMain_creation_lock );
+      dbrMain_exit();
+      return NULL;
+    }
+    gMain_context->_cs_mask = dbrNS_TABLE_INITIAL - 1;
+
+    gMain_context->_tag_free = dbrTAG_LIST_END;
+    if( dbrTag_table_grow( gMain_context ) != 0 )
     {
-      LOG( DBG_ERR, stderr, "libdatabroker: failed to allocate tmp key buffer.\n" );
-      free( gMain_context );
-      gMain_context = NULL;
+      LOG( DBG_ERR, stderr, "libdatabroker: failed to allocate request table.\n" );
       pthread_mutex_unlock( &gMain_creation_lock );
+      dbrMain_exit();
       return NULL;
     }
 
@@ -108,7 +166,26 @@ dbrMain_context_t* dbrCheckCreateMainCTX(void)
       }
     }
 #endif
-    pthread_mutex_init( &gMain_context->_biglock, NULL );
+    pthread_mutexattr_t tag_attr;
+    pthread_mutexattr_init( &tag_attr );
+    pthread_mutexattr_settype( &tag_attr, PTHREAD_MUTEX_RECURSIVE );
+    pthread_mutex_init( &gMain_context->_tag_lock, &tag_attr );
+    pthread_mutexattr_destroy( &tag_attr );
+    pthread_mutex_init( &gMain_context->_ns_lock, NULL );
+    pthread_mutex_init( &gMain_context->_be_lock, NULL );
+
+    pthread_condattr_t cpl_attr;
+    pthread_condattr_init( &cpl_attr );
+#ifndef __APPLE__
+    pthread_condattr_setclock( &cpl_attr, DBR_WAIT_CLOCK );
+#endif
+    pthread_cond_init( &gMain_context->_cpl_cond, &cpl_attr );
+    pthread_condattr_destroy( &cpl_attr );
+    pthread_mutex_init( &gMain_context->_cpl_lock, NULL );
+    pthread_mutex_init( &gMain_context->_cb_lock, NULL );
+
+    if(( gMain_context->_config._progress != 0 ) && ( dbrProgress_start( gMain_context ) != 0 ))
+      gMain_context->_config._progress = 0; // fall back to progress by the application threads
   }
 
   pthread_mutex_unlock( &gMain_creation_lock );
@@ -124,15 +201,10 @@ int dbrMain_exit(void)
     return 0;
   }
 
-  int rc = dbrlib_backend_delete( gMain_context->_be_ctx );
+  // the progress thread needs the back-end, stop it first
+  dbrProgress_stop( gMain_context );
 
-  if( gMain_context->_tmp_testkey_buf != NULL )
-  {
-    LOG( DBG_VERBOSE, stdout, "Cleaning up temporary buffer\n");
-    memset( gMain_context->_tmp_testkey_buf, 0, DBR_TMP_BUFFER_LEN );
-    free( gMain_context->_tmp_testkey_buf );
-    gMain_context->_tmp_testkey_buf = NULL;
-  }
+  int rc = dbrlib_backend_delete( gMain_context->_be_ctx );
 
 #ifdef DBR_DATA_ADAPTERS
   if( gMain_context->_da_library != NULL )
@@ -142,7 +214,15 @@ int dbrMain_exit(void)
   }
 #endif
 
-  pthread_mutex_destroy( &gMain_context->_biglock );
+  pthread_mutex_destroy( &gMain_context->_cb_lock );
+  pthread_cond_destroy( &gMain_context->_cpl_cond );
+  pthread_mutex_destroy( &gMain_context->_cpl_lock );
+  pthread_mutex_destroy( &gMain_context->_be_lock );
+  pthread_mutex_destroy( &gMain_context->_ns_lock );
+  pthread_mutex_destroy( &gMain_context->_tag_lock );
+  free( gMain_context->_cs_wq );
+  free( gMain_context->_cs_list );
+  dbrRequest_pool_drain();
   memset( gMain_context, 0, sizeof( dbrMain_context_t ) );
   free( gMain_context );
   gMain_context = NULL;
@@ -157,58 +237,126 @@ DBR_Tag_t dbrTag_get( dbrMain_context_t *ctx )
   if( ctx == NULL )
     return DB_TAG_ERROR;
 
-  typeof(ctx->_tag_head) t = ctx->_tag_head;
-
-  // hop through the work entries to check for available tags
-  while( ctx->_cs_wq[ t ] != NULL )
+  TAGLOCK_LOCK( ctx );
+  if(( ctx->_tag_free == dbrTAG_LIST_END ) && ( dbrTag_table_grow( ctx ) != 0 ))
   {
-    // while we're at it: clean up any closed request entries
-    // !! make sure the whole chain is in closed state !!
+    LOG( DBG_ERR, stderr, "No more tags available for async op (%"PRIu32" outstanding)\n", ctx->_tag_count );
+    TAGLOCK_UNLOCKRETURN( ctx, DB_TAG_ERROR );
+  }
 
-    dbrRequestContext_t *rctx = ctx->_cs_wq[ t ];
-    dbrRequest_status_t st = rctx->_status;
-    while(( st == dbrSTATUS_CLOSED ) && ( rctx->_next != NULL ))
-    {
-      rctx = rctx->_next;
-      st = rctx->_status;
-    }
+  uint32_t t = ctx->_tag_free;
+  dbrTag_entry_t *entry = &ctx->_cs_wq[ t ];
+  ctx->_tag_free = entry->_next_free;
+  entry->_next_free = dbrTAG_ALLOCATED;
+  entry->_rctx = NULL;
+  ++ctx->_tag_count;
+  DBR_Tag_t tag = dbrTAG_MAKE( t, entry->_gen );
+  TAGLOCK_UNLOCK( ctx );
 
-    if( st == dbrSTATUS_CLOSED )
-    {
-      dbrRequestContext_t *r = ctx->_cs_wq[ t ];
-      memset( r, 0, sizeof( dbrRequestContext_t ) + r->_req._sge_count * sizeof(dbBE_sge_t) );
-      free( r );
-      ctx->_cs_wq[ t ] = NULL;
-      break;
-    }
+  return tag;
+}
 
-    t = ( t + 1 ) % dbrMAX_TAGS;
-    if( t == ctx->_tag_head )
-    {
-      LOG( DBG_ERR, stderr, "No more tags available for async op\n" );
-      return DB_TAG_ERROR;
-    }
-  }
+/*
+ * returns the allocated table entry of a tag or NULL (requires the tag lock)
+ */
+static
+dbrTag_entry_t* dbrTag_entry( dbrMain_context_t *ctx, DBR_Tag_t tag )
+{
+  if( tag < 0 )
+    return NULL;
+  uint32_t t = dbrTAG_INDEX( tag );
+  if( t >= ctx->_tag_capacity )
+    return NULL;
+  dbrTag_entry_t *entry = &ctx->_cs_wq[ t ];
+  if(( entry->_next_free != dbrTAG_ALLOCATED ) || ( entry->_gen != dbrTAG_GEN( tag ) ))
+    return NULL;
+  return entry;
+}
 
-  ctx->_tag_head = ( t + 1 ) % dbrMAX_TAGS;
+/*
+ * puts an entry back on the free list, the new generation invalidates stale copies of its tag (requires the tag lock)
+ */
+static
+void dbrTag_free_entry( dbrMain_context_t *ctx, uint32_t t )
+{
+  dbrTag_entry_t *entry = &ctx->_cs_wq[ t ];
+  entry->_rctx = NULL;
+  entry->_gen = ( entry->_gen + 1 ) & dbrTAG_GEN_MASK;
+  // LIFO keeps the recently used (cache-warm) entries in use
+  entry->_next_free = ctx->_tag_free;
+  ctx->_tag_free = t;
+  --ctx->_tag_count;
+}
 
-#ifdef DBR_INTTAG
-//  LOG( DBG_INFO, stdout, "Returning Tag: %d\n", t );
-  return (DBR_Tag_t)t;
-#else
-  // needs to point into the array!
-  // -> otherwise there is no index calculation afterwards
-  return (DBR_Tag_t)&ctx->_cs_wq[ t ];
-#endif
+void dbrTag_release( dbrMain_context_t *ctx, DBR_Tag_t tag )
+{
+  if( ctx == NULL )
+    return;
+
+  TAGLOCK_LOCK( ctx );
+  if( dbrTag_entry( ctx, tag ) != NULL )
+    dbrTag_free_entry( ctx, dbrTAG_INDEX( tag ) );
+  TAGLOCK_UNLOCK( ctx );
+}
+
+dbrRequestContext_t* dbrTag_lookup( dbrMain_context_t *ctx, DBR_Tag_t tag )
+{
+  if( ctx == NULL )
+    return NULL;
+  dbrTag_entry_t *entry = dbrTag_entry( ctx, tag );
+  return ( entry != NULL ) ? entry->_rctx : NULL;
+}
+
+int dbrTag_insert( dbrMain_context_t *ctx, DBR_Tag_t tag, dbrRequestContext_t *rctx )
+{
+  dbrTag_entry_t *entry = dbrTag_entry( ctx, tag );
+  if(( entry == NULL ) || ( entry->_rctx != NULL ))
+    return -EINVAL;
+  entry->_rctx = rctx;
+  return 0;
+}
+
+dbrRequestContext_t* dbrTag_pin( dbrMain_context_t *ctx, DBR_Tag_t tag )
+{
+  if( ctx == NULL )
+    return NULL;
+  dbrTag_entry_t *entry = dbrTag_entry( ctx, tag );
+  if(( entry == NULL ) || ( entry->_rctx == NULL ))
+    return NULL;
+  ++entry->_pins;
+  return entry->_rctx;
+}
+
+void dbrTag_unpin( dbrMain_context_t *ctx, DBR_Tag_t tag )
+{
+  if(( ctx == NULL ) || ( tag < 0 ) || ( dbrTAG_INDEX( tag ) >= ctx->_tag_capacity ))
+    return;
+
+  // a retired entry is invisible to dbrTag_entry(), but its generation is still that of the pinned tag
+  uint32_t t = dbrTAG_INDEX( tag );
+  dbrTag_entry_t *entry = &ctx->_cs_wq[ t ];
+  if(( entry->_gen != dbrTAG_GEN( tag ) ) || ( entry->_pins == 0 ))
+    return;
+
+  if(( --entry->_pins == 0 ) && ( entry->_next_free == dbrTAG_REMOVED ))
+  {
+    dbrDestroy_request_chain( entry->_rctx );
+    dbrTag_free_entry( ctx, t );
+  }
+}
+
+int dbrTag_retire( dbrMain_context_t *ctx, DBR_Tag_t tag )
+{
+  dbrTag_entry_t *entry = dbrTag_entry( ctx, tag );
+  if(( entry == NULL ) || ( entry->_pins == 0 ))
+    return 0;
+  entry->_next_free = dbrTAG_REMOVED;
+  return 1;
 }
 
 DBR_Errorcode_t dbrValidateTag( dbrRequestContext_t *rctx, DBR_Tag_t req_tag )
 {
-#ifdef DBR_INTTAG
-  if(( req_tag >= 0 ) && ( req_tag < dbrMAX_TAGS ))
-#else
-  if(( req_tag != NULL ) && ( req_tag != DB_TAG_ERROR ))
-#endif
+  if( req_tag >= 0 )
     return DBR_SUCCESS;
   else
     return DBR_ERR_TAGERROR;
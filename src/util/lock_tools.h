@@ -18,12 +18,53 @@
 #ifndef SRC_UTIL_LOCK_TOOLS_H_
 #define SRC_UTIL_LOCK_TOOLS_H_
 
+#include <pthread.h>
 
-#define BIGLOCK_LOCK( ctx ) pthread_mutex_lock( &(ctx)->_biglock )
+/*
+ * lock ordering: NSLOCK -> TAGLOCK -> BELOCK
+ * none of them is held while a caller waits for a request to complete
+ * except for the NSLOCK during name space create/attach/detach/delete
+ */
+
+/*
+ * tag allocation and the request table (_cs_wq)
+ * recursive, so that libdbrTest() can hold it while removing the request
+ */
+#define TAGLOCK_LOCK( ctx ) pthread_mutex_lock( &(ctx)->_tag_lock )
+
+#define TAGLOCK_UNLOCK( ctx ) pthread_mutex_unlock( &(ctx)->_tag_lock )
+
+#define TAGLOCK_UNLOCKRETURN( ctx, rc ) { TAGLOCK_UNLOCK( ctx ); return (rc); }
+
+/*
+ * local name space table (_cs_list) and name space reference counts
+ */
+#define NSLOCK_LOCK( ctx ) pthread_mutex_lock( &(ctx)->_ns_lock )
+
+#define NSLOCK_UNLOCK( ctx ) pthread_mutex_unlock( &(ctx)->_ns_lock )
+
+#define NSLOCK_UNLOCKRETURN( ctx, rc ) { NSLOCK_UNLOCK( ctx ); return (rc); }
+
+/*
+ * calls into the back-end (post/cancel/test_any) are serialized because the back-end isn't thread-safe
+ * the lock is only held for the duration of a single call
+ * threads that have to get in (posting, canceling) announce themselves in _be_waiting,
+ * threads that only poll for completions use the TRYLOCK and step aside for them
+ * and if the lock holder sleeps in the back-end, it gets woken up
+ */
+#define BELOCK_LOCK( ctx ) \
+  { \
+    __atomic_add_fetch( &(ctx)->_be_waiting, 1, __ATOMIC_SEQ_CST ); \
+    if( __atomic_load_n( &(ctx)->_be_sleeping, __ATOMIC_SEQ_CST ) != 0 ) \
+      (ctx)->_be_ctx->_api->wakeup( (ctx)->_be_ctx->_context ); \
+    pthread_mutex_lock( &(ctx)->_be_lock ); \
+    __atomic_sub_fetch( &(ctx)->_be_waiting, 1, __ATOMIC_ACQ_REL ); \
+  }
 
-#define BIGLOCK_UNLOCK( ctx ) pthread_mutex_unlock( &(ctx)->_biglock )
+#define BELOCK_TRYLOCK( ctx ) \
+  (( __atomic_load_n( &(ctx)->_be_waiting, __ATOMIC_ACQUIRE ) == 0 ) && ( pthread_mutex_trylock( &(ctx)->_be_lock ) == 0 ))
 
-#define BIGLOCK_UNLOCKRETURN( ctx, rc ) { BIGLOCK_UNLOCK( ctx ); return (rc); }
+#define BELOCK_UNLOCK( ctx ) pthread_mutex_unlock( &(ctx)->_be_lock )
 
 
 #endif /* SRC_UTIL_LOCK_TOOLS_H_ */
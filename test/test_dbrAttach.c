@@ -48,6 +48,43 @@ int DetachTest()
   return rc;
 }
 
+// more name spaces than the former fixed-size table could hold
+#define TEST_NAMESPACE_COUNT ( 1500 )
+
+int ManyNamespacesTest()
+{
+  int rc = 0;
+  int n;
+  char name[ DBR_MAX_KEY_LEN ];
+  DBR_Handle_t ns[ TEST_NAMESPACE_COUNT ];
+  DBR_GroupList_t groups = DBR_GROUP_LIST_EMPTY;
+  DBR_Tuple_persist_level_t level = DBR_PERST_VOLATILE_SIMPLE;
+
+  for( n = 0; n < TEST_NAMESPACE_COUNT; ++n )
+  {
+    snprintf( name, DBR_MAX_KEY_LEN, "ManyNS_%d", n );
+    rc += TEST_NOT_RC( dbrCreate( name, level, groups ), NULL, ns[ n ] );
+  }
+  TEST_LOG( rc, "Creating many name spaces" );
+
+  // the second attach finds the local entry and returns the same handle
+  for( n = 0; n < TEST_NAMESPACE_COUNT; ++n )
+  {
+    snprintf( name, DBR_MAX_KEY_LEN, "ManyNS_%d", n );
+    rc += TEST( dbrAttach( name ), ns[ n ] );
+    rc += TEST( dbrDetach( ns[ n ] ), DBR_SUCCESS );
+  }
+  TEST_LOG( rc, "Attaching many name spaces" );
+
+  for( n = 0; n < TEST_NAMESPACE_COUNT; ++n )
+  {
+    snprintf( name, DBR_MAX_KEY_LEN, "ManyNS_%d", n );
+    rc += TEST( dbrDelete( name ), DBR_SUCCESS );
+  }
+  TEST_LOG( rc, "Deleting many name spaces" );
+
+  return rc;
+}
 
 int main( int argc, char ** argv )
 {
@@ -121,6 +158,7 @@ int main( int argc, char ** argv )
   free( name );
 
   rc += DetachTest();
+  rc += ManyNamespacesTest();
 
   printf( "Test exiting with rc=%d\n", rc );
   return rc;
@@ -0,0 +1,122 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef DEBUG_LEVEL
+#define DEBUG_LEVEL DBG_VERBOSE
+#endif
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libdatabroker.h>
+#include "test_utils.h"
+
+#define TEST_BATCH_SIZE ( 100 )
+#define TEST_VALUE_LEN ( 64 )
+
+int main( int argc, char ** argv )
+{
+  int rc = 0;
+  int i;
+
+  DBR_Name_t name = strdup("BatchTestNS");
+  DBR_Tuple_persist_level_t level = DBR_PERST_VOLATILE_SIMPLE;
+  DBR_GroupList_t groups = 0;
+
+  DBR_Handle_t cs_hdl = dbrCreate (name, level, groups);
+  rc += TEST_NOT( cs_hdl, NULL );
+  TEST_BREAK( rc, "Namespace creation failed" );
+
+  void *in[ TEST_BATCH_SIZE ];
+  void *out[ TEST_BATCH_SIZE ];
+  int64_t size[ TEST_BATCH_SIZE ];
+  DBR_Tuple_name_t keys[ TEST_BATCH_SIZE ];
+  DBR_Errorcode_t status[ TEST_BATCH_SIZE ];
+
+  for( i = 0; i < TEST_BATCH_SIZE; ++i )
+  {
+    keys[i] = (DBR_Tuple_name_t)calloc( 1, DBR_MAX_KEY_LEN );
+    snprintf( keys[i], DBR_MAX_KEY_LEN, "batchkey_%d", i );
+    in[i] = calloc( 1, TEST_VALUE_LEN );
+    out[i] = calloc( 1, TEST_VALUE_LEN );
+    size[i] = snprintf( (char*)in[i], TEST_VALUE_LEN, "value of item %d", i );
+    status[i] = DBR_ERR_GENERIC;
+  }
+
+  rc += TEST( dbrPutBatch( cs_hdl, TEST_BATCH_SIZE, in, size, keys, DBR_GROUP_EMPTY, status ), DBR_SUCCESS );
+  for( i = 0; i < TEST_BATCH_SIZE; ++i )
+    rc += TEST( status[i], DBR_SUCCESS );
+  TEST_LOG( rc, "Batch put" );
+
+  // read everything back, the sizes get updated with the actual length
+  for( i = 0; i < TEST_BATCH_SIZE; ++i )
+  {
+    size[i] = TEST_VALUE_LEN;
+    status[i] = DBR_ERR_GENERIC;
+  }
+  rc += TEST( dbrReadBatch( cs_hdl, TEST_BATCH_SIZE, out, size, keys, "", DBR_GROUP_EMPTY, DBR_FLAGS_NOWAIT, status ), DBR_SUCCESS );
+  for( i = 0; i < TEST_BATCH_SIZE; ++i )
+  {
+    rc += TEST( status[i], DBR_SUCCESS );
+    rc += TEST( size[i], (int64_t)strlen( (char*)in[i] ) );
+    rc += TEST( strncmp( (char*)in[i], (char*)out[i], TEST_VALUE_LEN ), 0 );
+  }
+  TEST_LOG( rc, "Batch read" );
+
+  // get with one item that does not exist, only that item reports an error
+  free( keys[ TEST_BATCH_SIZE / 2 ] );
+  keys[ TEST_BATCH_SIZE / 2 ] = strdup( "batchkey_missing" );
+  for( i = 0; i < TEST_BATCH_SIZE; ++i )
+  {
+    memset( out[i], 0, TEST_VALUE_LEN );
+    size[i] = TEST_VALUE_LEN;
+    status[i] = DBR_ERR_GENERIC;
+  }
+  rc += TEST( dbrGetBatch( cs_hdl, TEST_BATCH_SIZE, out, size, keys, "", DBR_GROUP_EMPTY, DBR_FLAGS_NOWAIT, status ), DBR_ERR_UNAVAIL );
+  for( i = 0; i < TEST_BATCH_SIZE; ++i )
+  {
+    if( i == TEST_BATCH_SIZE / 2 )
+    {
+      rc += TEST( status[i], DBR_ERR_UNAVAIL );
+      continue;
+    }
+    rc += TEST( status[i], DBR_SUCCESS );
+    rc += TEST( strncmp( (char*)in[i], (char*)out[i], TEST_VALUE_LEN ), 0 );
+  }
+  TEST_LOG( rc, "Batch get" );
+
+  // the get consumed the tuples
+  rc += TEST( dbrTestKey( cs_hdl, keys[0] ), DBR_ERR_UNAVAIL );
+
+  // invalid input
+  rc += TEST( dbrPutBatch( cs_hdl, 0, in, size, keys, DBR_GROUP_EMPTY, NULL ), DBR_ERR_INVALID );
+  rc += TEST( dbrPutBatch( NULL, TEST_BATCH_SIZE, in, size, keys, DBR_GROUP_EMPTY, NULL ), DBR_ERR_INVALID );
+
+  for( i = 0; i < TEST_BATCH_SIZE; ++i )
+  {
+    free( keys[i] );
+    free( in[i] );
+    free( out[i] );
+  }
+
+  rc += TEST( dbrDelete( name ), DBR_SUCCESS );
+  free( name );
+
+  printf( "Test exiting with rc=%d\n", rc );
+  return rc;
+}
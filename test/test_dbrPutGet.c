@@ -22,6 +22,7 @@
 #include <malloc.h>
 #endif
 #include <string.h>
+#include <time.h>
 
 #include "errorcodes.h"
 #include "libdatabroker.h"
@@ -142,6 +143,28 @@ int KeyTest( DBR_Handle_t cs_hdl,
   return rc;
 }
 
+int StatTest( DBR_Handle_t cs_hdl,
+              DBR_Tuple_name_t tupname,
+              const int64_t count,
+              const int64_t size,
+              const DBR_Errorcode_t expect )
+{
+  int rc = 0;
+  DBR_Errorcode_t ret = DBR_SUCCESS;
+  int64_t out_count = -1;
+  int64_t out_size = -1;
+  rc += TEST_RC( dbrStat( cs_hdl, 0, tupname, &out_count, &out_size ), expect, ret );
+  rc += TEST( out_count, count );
+  rc += TEST( out_size, size );
+
+  // count only
+  out_count = -1;
+  rc += TEST_RC( dbrStat( cs_hdl, 0, tupname, &out_count, NULL ), expect, ret );
+  rc += TEST( out_count, count );
+
+  return rc;
+}
+
 int GetTest_e( DBR_Handle_t cs_hdl,
                DBR_Tuple_name_t tupname,
                const char *instr,
@@ -196,6 +219,7 @@ int main( int argc, char ** argv )
   char *maintup = "Test/Tup:key";
 
   rc += KeyTest( cs_hdl, maintup, DBR_ERR_UNAVAIL );
+  rc += StatTest( cs_hdl, maintup, 0, 0, DBR_ERR_UNAVAIL );
 
   // put success test
   rc += PutTest( cs_hdl, maintup, "HelloWorld1", 11 );
@@ -207,6 +231,8 @@ int main( int argc, char ** argv )
   rc += PutTest( cs_hdl, "AlongishKeyWithMorechars_andsome-Other;characters:inside.WithEnter", "0123456\r\n78901234567890", 23 );
 
   rc += KeyTest( cs_hdl, maintup, DBR_SUCCESS );
+  rc += StatTest( cs_hdl, maintup, 4, 11, DBR_SUCCESS );
+  rc += StatTest( cs_hdl, "AlongishKeyWithMorechars_andsome-Other;characters:inside.", 2, 20, DBR_SUCCESS );
 
   TEST_LOG( rc, "PUT " );
 
@@ -284,7 +310,14 @@ int main( int argc, char ** argv )
 
 
   // create a timeout get
+  // it returns right after the timeout even though it's parked on the server (plus one BLPOP slice at most)
+  char *to_env = getenv( DBR_TIMEOUT_ENV );
+  long timeout = ( to_env != NULL ) ? strtol( to_env, NULL, 10 ) : DBR_TIMEOUT_DEFAULT;
+  struct timespec start, end;
+  clock_gettime( CLOCK_MONOTONIC, &start );
   rc += TEST_RC( dbrGet( cs_hdl, longOut, &longRet, "testTup", "", 0, DBR_FLAGS_NONE ), DBR_ERR_TIMEOUT, ret );
+  clock_gettime( CLOCK_MONOTONIC, &end );
+  rc += TEST( end.tv_sec - start.tv_sec <= timeout + 1, 1 );
 
   rc += TEST_RC( dbrRead( cs_hdl, longOut, &longRet, "testTup", "", 0, DBR_FLAGS_NOWAIT ), DBR_ERR_UNAVAIL, ret );
   rc += TEST_RC( dbrGet( cs_hdl, longOut, &longRet, "testTup", "", 0, DBR_FLAGS_NOWAIT ), DBR_ERR_UNAVAIL, ret );
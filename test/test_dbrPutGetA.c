@@ -34,6 +34,141 @@
 
 #define TEST_REQUEST_TIMEOUT ( 2 )
 
+#define TEST_TAGSET_SIZE ( 16 )
+
+int TagSetTest( DBR_Handle_t cs_hdl )
+{
+  int rc = 0;
+  int n;
+  char *in = (char*)"Hello Set!";
+  int in_size = strlen( in );
+  char keys[ TEST_TAGSET_SIZE ][ 32 ];
+  char out[ TEST_TAGSET_SIZE ][ 32 ];
+  int64_t out_size[ TEST_TAGSET_SIZE ];
+  DBR_Tag_t tags[ TEST_TAGSET_SIZE ];
+  DBR_Errorcode_t status[ TEST_TAGSET_SIZE ];
+  int indices[ TEST_TAGSET_SIZE ];
+
+  // wait for all puts at once
+  for( n = 0; n < TEST_TAGSET_SIZE; ++n )
+  {
+    snprintf( keys[n], 32, "tagset_%d", n );
+    tags[n] = dbrPutA( cs_hdl, in, in_size, keys[n], 0 );
+    rc += TEST_NOT( DB_TAG_ERROR, tags[n] );
+  }
+  rc += TEST( DBR_SUCCESS, dbrWaitAll( TEST_TAGSET_SIZE, tags, status ) );
+  for( n = 0; n < TEST_TAGSET_SIZE; ++n )
+  {
+    rc += TEST( DBR_SUCCESS, status[n] );
+    rc += TEST( DB_TAG_ERROR, tags[n] );
+  }
+
+  // all tags are done; nothing left to wait for
+  int index = 0;
+  rc += TEST( DBR_SUCCESS, dbrWaitAny( TEST_TAGSET_SIZE, tags, &index, NULL ) );
+  rc += TEST( -1, index );
+
+  // reads, each completes exactly once with wait any
+  for( n = 0; n < TEST_TAGSET_SIZE; ++n )
+  {
+    memset( out[n], 0, 32 );
+    out_size[n] = 32;
+    tags[n] = dbrReadA( cs_hdl, out[n], &out_size[n], keys[n], "", 0, DBR_FLAGS_NONE );
+    rc += TEST_NOT( DB_TAG_ERROR, tags[n] );
+  }
+  int seen[ TEST_TAGSET_SIZE ];
+  memset( seen, 0, sizeof( seen ) );
+  for( n = 0; n < TEST_TAGSET_SIZE; ++n )
+  {
+    DBR_Errorcode_t st = DBR_ERR_GENERIC;
+    rc += TEST( DBR_SUCCESS, dbrWaitAny( TEST_TAGSET_SIZE, tags, &index, &st ) );
+    rc += TEST( DBR_SUCCESS, st );
+    if(( index < 0 ) || ( index >= TEST_TAGSET_SIZE ))
+    {
+      ++rc;
+      break;
+    }
+    ++seen[ index ];
+    rc += TEST( DB_TAG_ERROR, tags[ index ] );
+    rc += TEST( in_size, out_size[ index ] );
+    rc += TEST( 0, strncmp( in, out[ index ], 32 ) );
+  }
+  for( n = 0; n < TEST_TAGSET_SIZE; ++n )
+    rc += TEST( 1, seen[n] );
+
+  // consume with gets and poll with test some
+  for( n = 0; n < TEST_TAGSET_SIZE; ++n )
+  {
+    out_size[n] = 32;
+    tags[n] = dbrGetA( cs_hdl, out[n], &out_size[n], keys[n], "", 0, DBR_FLAGS_NONE );
+    rc += TEST_NOT( DB_TAG_ERROR, tags[n] );
+  }
+  int remaining = TEST_TAGSET_SIZE;
+  struct timeval start_time, now;
+  gettimeofday( &start_time, NULL );
+  now = start_time;
+  while(( remaining > 0 ) && ( now.tv_sec - start_time.tv_sec <= TEST_REQUEST_TIMEOUT ))
+  {
+    int completed = 0;
+    rc += TEST( DBR_SUCCESS, dbrTestSome( TEST_TAGSET_SIZE, tags, &completed, indices, status ) );
+    for( n = 0; n < completed; ++n )
+    {
+      rc += TEST( DBR_SUCCESS, status[n] );
+      rc += TEST( DB_TAG_ERROR, tags[ indices[n] ] );
+    }
+    remaining -= completed;
+    gettimeofday( &now, NULL );
+  }
+  rc += TEST( 0, remaining );
+
+  // the gets consumed everything
+  for( n = 0; n < TEST_TAGSET_SIZE; ++n )
+    rc += TEST( DBR_ERR_UNAVAIL, dbrTestKey( cs_hdl, keys[n] ) );
+
+  return rc;
+}
+
+#define TEST_PIPELINE_DEPTH ( 4 * DBR_POSTED_QUEUE_DEPTH )
+
+/*
+ * more outstanding requests than the initial size of the tag table
+ */
+int DeepPipelineTest( DBR_Handle_t cs_hdl )
+{
+  int rc = 0;
+  int n;
+  char *in = (char*)"Hello Pipeline!";
+  int in_size = strlen( in );
+  DBR_Tag_t *tags = (DBR_Tag_t*)calloc( TEST_PIPELINE_DEPTH, sizeof( DBR_Tag_t ) );
+  DBR_Errorcode_t *status = (DBR_Errorcode_t*)calloc( TEST_PIPELINE_DEPTH, sizeof( DBR_Errorcode_t ) );
+  if(( tags == NULL ) || ( status == NULL ))
+    return 1;
+
+  for( n = 0; n < TEST_PIPELINE_DEPTH; ++n )
+  {
+    tags[n] = dbrPutA( cs_hdl, in, in_size, "pipeline", 0 );
+    rc += TEST_NOT( DB_TAG_ERROR, tags[n] );
+  }
+  DBR_Tag_t stale = tags[0];
+  rc += TEST( DBR_SUCCESS, dbrWaitAll( TEST_PIPELINE_DEPTH, tags, status ) );
+  for( n = 0; n < TEST_PIPELINE_DEPTH; ++n )
+    rc += TEST( DBR_SUCCESS, status[n] );
+
+  // the tag got released; reusing its table entry must not make it valid again
+  DBR_Tag_t tag = dbrPutA( cs_hdl, in, in_size, "pipeline", 0 );
+  rc += TEST_NOT( DB_TAG_ERROR, tag );
+  rc += TEST( DBR_ERR_TAGERROR, dbrTest( stale ) );
+  rc += TEST( DBR_SUCCESS, dbrWaitAll( 1, &tag, status ) );
+
+  int64_t count = 0;
+  rc += TEST( DBR_SUCCESS, dbrStat( cs_hdl, DBR_GROUP_EMPTY, "pipeline", &count, NULL ) );
+  rc += TEST( TEST_PIPELINE_DEPTH + 1, count );
+
+  free( status );
+  free( tags );
+  return rc;
+}
+
 int main( int argc, char ** argv )
 {
   int rc = 0;
@@ -208,6 +343,12 @@ int main( int argc, char ** argv )
 
   fprintf( stderr, "TEST: Completed check of late test for putA completion rc=%d\n", rc );
 
+  rc += TagSetTest( cs_hdl );
+  fprintf( stderr, "TEST: Completed check of tag set completion rc=%d\n", rc );
+
+  rc += DeepPipelineTest( cs_hdl );
+  fprintf( stderr, "TEST: Completed check of deep pipeline rc=%d\n", rc );
+
   // delete the name space
   ret = dbrDelete( name );
   rc += TEST( DBR_SUCCESS, ret );
@@ -0,0 +1,162 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef DEBUG_LEVEL
+#define DEBUG_LEVEL DBG_VERBOSE
+#endif
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include <libdatabroker.h>
+#include "test_utils.h"
+
+#define TEST_REQUEST_TIMEOUT ( 2 )
+
+#define TEST_THREADS ( 4 )
+#define TEST_ITERATIONS ( 32 )
+#define TEST_BATCH_SIZE ( 8 )
+
+typedef struct
+{
+  int _id;
+  int _rc;
+} PutGetThread_t;
+
+/*
+ * poll a tag with dbrTest until it completes or the test timeout expires
+ */
+DBR_Errorcode_t TestUntilDone( DBR_Tag_t tag )
+{
+  if( tag == DB_TAG_ERROR )
+    return DBR_ERR_TAGERROR;
+
+  struct timeval start_time, now;
+  gettimeofday( &start_time, NULL );
+  now = start_time;
+  DBR_Errorcode_t state = DBR_ERR_INPROGRESS;
+  while(( state == DBR_ERR_INPROGRESS ) && ( now.tv_sec - start_time.tv_sec <= TEST_REQUEST_TIMEOUT ))
+  {
+    state = dbrTest( tag );
+    gettimeofday( &now, NULL );
+  }
+  return state;
+}
+
+/*
+ * each thread works on its own name space while the others hammer the same library context
+ */
+void* PutGetThread( void *arg )
+{
+  PutGetThread_t *self = (PutGetThread_t*)arg;
+  int rc = 0;
+  int n, b;
+
+  char name[ 32 ];
+  snprintf( name, 32, "mt_cstestname_%d", self->_id );
+  DBR_Handle_t cs_hdl = dbrCreate( name, DBR_PERST_VOLATILE_SIMPLE, 0 );
+  rc += TEST_NOT( NULL, cs_hdl );
+  if( cs_hdl == NULL )
+  {
+    self->_rc = rc;
+    return NULL;
+  }
+
+  char in[ 64 ];
+  char out[ 64 ];
+  char key[ 32 ];
+  int64_t out_size;
+  for( n = 0; ( n < TEST_ITERATIONS ) && ( rc == 0 ); ++n )
+  {
+    snprintf( key, 32, "mtkey_%d", n );
+    snprintf( in, 64, "thread %d value %d", self->_id, n );
+    int in_size = strlen( in );
+
+    rc += TEST( DBR_SUCCESS, TestUntilDone( dbrPutA( cs_hdl, in, in_size, key, 0 ) ) );
+
+    memset( out, 0, 64 );
+    out_size = 64;
+    rc += TEST( DBR_SUCCESS, TestUntilDone( dbrReadA( cs_hdl, out, &out_size, key, "", 0, DBR_FLAGS_NONE ) ) );
+    rc += TEST( in_size, out_size );
+    rc += TEST( 0, strncmp( in, out, 64 ) );
+
+    memset( out, 0, 64 );
+    out_size = 64;
+    rc += TEST( DBR_SUCCESS, TestUntilDone( dbrGetA( cs_hdl, out, &out_size, key, "", 0, DBR_FLAGS_NONE ) ) );
+    rc += TEST( in_size, out_size );
+    rc += TEST( 0, strncmp( in, out, 64 ) );
+    rc += TEST( DBR_ERR_UNAVAIL, dbrTestKey( cs_hdl, key ) );
+
+    // a batch of puts completed with a tag set wait, then consumed by blocking gets
+    DBR_Tag_t tags[ TEST_BATCH_SIZE ];
+    DBR_Errorcode_t status[ TEST_BATCH_SIZE ];
+    for( b = 0; b < TEST_BATCH_SIZE; ++b )
+    {
+      tags[b] = dbrPutA( cs_hdl, in, in_size, "mtbatch", 0 );
+      rc += TEST_NOT( DB_TAG_ERROR, tags[b] );
+    }
+    rc += TEST( DBR_SUCCESS, dbrWaitAll( TEST_BATCH_SIZE, tags, status ) );
+    for( b = 0; b < TEST_BATCH_SIZE; ++b )
+    {
+      rc += TEST( DBR_SUCCESS, status[b] );
+      memset( out, 0, 64 );
+      out_size = 64;
+      rc += TEST( DBR_SUCCESS, dbrGet( cs_hdl, out, &out_size, "mtbatch", "", 0, DBR_FLAGS_NOWAIT ) );
+      rc += TEST( 0, strncmp( in, out, 64 ) );
+    }
+  }
+  TEST_LOG( rc, "Concurrent put/get" );
+
+  rc += TEST( DBR_SUCCESS, dbrDelete( name ) );
+
+  self->_rc = rc;
+  return NULL;
+}
+
+int main( int argc, char ** argv )
+{
+  int rc = 0;
+  int n;
+
+  PutGetThread_t args[ TEST_THREADS ];
+  pthread_t threads[ TEST_THREADS ];
+  int started[ TEST_THREADS ];
+
+  for( n = 0; n < TEST_THREADS; ++n )
+  {
+    args[n]._id = n;
+    args[n]._rc = 0;
+    started[n] = ( pthread_create( &threads[n], NULL, PutGetThread, &args[n] ) == 0 );
+    rc += TEST( 1, started[n] );
+  }
+
+  for( n = 0; n < TEST_THREADS; ++n )
+  {
+    if( ! started[n] )
+      continue;
+    pthread_join( threads[n], NULL );
+    rc += args[n]._rc;
+    fprintf( stderr, "TEST: Completed thread %d rc=%d\n", n, args[n]._rc );
+  }
+
+  printf( "Test exiting with rc=%d\n", rc );
+  return rc;
+}
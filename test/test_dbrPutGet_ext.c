@@ -21,7 +21,10 @@
 #else
 #include <malloc.h>
 #endif
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
 
 #include "errorcodes.h"
 #include "libdatabroker.h"
@@ -211,6 +214,123 @@ int GetTest_v( DBR_Handle_t cs_hdl,
   return rc;
 }
 
+#define CALLBACK_TEST_COUNT ( 8 )
+#define CALLBACK_TEST_TIMEOUT ( 5 )
+
+typedef struct
+{
+  int _calls;
+  int _errors;
+  DBR_Tag_t _tag;
+} CallbackTestState_t;
+
+void CallbackTest_cb( DBR_Tag_t tag, DBR_Errorcode_t status, void *user )
+{
+  CallbackTestState_t *state = (CallbackTestState_t*)user;
+  state->_tag = tag;
+  state->_errors += ( status != DBR_SUCCESS );
+  // the progress thread may run the callback, publish the call count last
+  __atomic_add_fetch( &state->_calls, 1, __ATOMIC_RELEASE );
+}
+
+/*
+ * drive progress without tags until all callbacks are in
+ * with the progress thread enabled, the callbacks have to arrive without any call into the library
+ */
+int CallbackTest_wait( CallbackTestState_t *state, const int count )
+{
+  char *progress = getenv( DBR_PROGRESS_ENV );
+  int drive = (( progress == NULL ) || ( strtol( progress, NULL, 10 ) == 0 ));
+
+  struct timeval start_time, now;
+  gettimeofday( &start_time, NULL );
+  now = start_time;
+  int calls = 0;
+  while(( calls < count ) && ( now.tv_sec - start_time.tv_sec <= CALLBACK_TEST_TIMEOUT ))
+  {
+    if( drive )
+      dbrTestSome( 0, NULL, NULL, NULL, NULL );
+    else
+      usleep( 1000 );
+    calls = 0;
+    int n;
+    for( n = 0; n < count; ++n )
+      calls += __atomic_load_n( &state[n]._calls, __ATOMIC_ACQUIRE );
+    gettimeofday( &now, NULL );
+  }
+  return calls;
+}
+
+int CallbackTest( DBR_Handle_t cs_hdl )
+{
+  int rc = 0;
+  int n;
+  char *in = "Callback value";
+  int64_t in_size = strlen( in );
+  char keys[ CALLBACK_TEST_COUNT ][ 32 ];
+  char out[ CALLBACK_TEST_COUNT ][ 32 ];
+  int64_t out_size[ CALLBACK_TEST_COUNT ];
+  CallbackTestState_t state[ CALLBACK_TEST_COUNT ];
+  DBR_Tag_t tags[ CALLBACK_TEST_COUNT ];
+
+  rc += TEST( DB_TAG_ERROR, dbrPutA_cb( cs_hdl, in, in_size, "cbkey", 0, NULL, NULL ) );
+
+  memset( state, 0, sizeof( state ) );
+  for( n = 0; n < CALLBACK_TEST_COUNT; ++n )
+  {
+    snprintf( keys[n], 32, "cbkey_%d", n );
+    tags[n] = dbrPutA_cb( cs_hdl, in, in_size, keys[n], 0, CallbackTest_cb, &state[n] );
+    rc += TEST_NOT( DB_TAG_ERROR, tags[n] );
+  }
+  rc += TEST( CALLBACK_TEST_COUNT, CallbackTest_wait( state, CALLBACK_TEST_COUNT ) );
+  for( n = 0; n < CALLBACK_TEST_COUNT; ++n )
+  {
+    rc += TEST( 1, state[n]._calls );
+    rc += TEST( 0, state[n]._errors );
+    rc += TEST( tags[n], state[n]._tag );
+    rc += TEST( DBR_SUCCESS, dbrTestKey( cs_hdl, keys[n] ) );
+  }
+  TEST_LOG( rc, "Callback put" );
+
+  // reads deliver the data before the callback
+  memset( state, 0, sizeof( state ) );
+  for( n = 0; n < CALLBACK_TEST_COUNT; ++n )
+  {
+    memset( out[n], 0, 32 );
+    out_size[n] = 32;
+    tags[n] = dbrReadA_cb( cs_hdl, out[n], &out_size[n], keys[n], "", 0, DBR_FLAGS_NONE, CallbackTest_cb, &state[n] );
+    rc += TEST_NOT( DB_TAG_ERROR, tags[n] );
+  }
+  rc += TEST( CALLBACK_TEST_COUNT, CallbackTest_wait( state, CALLBACK_TEST_COUNT ) );
+  for( n = 0; n < CALLBACK_TEST_COUNT; ++n )
+  {
+    rc += TEST( 0, state[n]._errors );
+    rc += TEST( in_size, out_size[n] );
+    rc += TEST( 0, strncmp( in, out[n], 32 ) );
+  }
+  TEST_LOG( rc, "Callback read" );
+
+  // get that completes only after the put
+  memset( state, 0, sizeof( state ) );
+  out_size[0] = 32;
+  tags[0] = dbrGetA_cb( cs_hdl, out[0], &out_size[0], "cbkey_late", "", 0, DBR_FLAGS_NONE, CallbackTest_cb, &state[0] );
+  rc += TEST_NOT( DB_TAG_ERROR, tags[0] );
+  rc += TEST( 0, state[0]._calls );
+  rc += TEST( DBR_SUCCESS, dbrPut( cs_hdl, in, in_size, "cbkey_late", 0 ) );
+  rc += TEST( 1, CallbackTest_wait( state, 1 ) );
+  rc += TEST( 0, state[0]._errors );
+  rc += TEST( in_size, out_size[0] );
+
+  for( n = 0; n < CALLBACK_TEST_COUNT; ++n )
+  {
+    out_size[n] = 32;
+    rc += TEST( DBR_SUCCESS, dbrGet( cs_hdl, out[n], &out_size[n], keys[n], "", 0, DBR_FLAGS_NOWAIT ) );
+  }
+  rc += KeyTest( cs_hdl, "cbkey_late", DBR_ERR_UNAVAIL );
+  TEST_LOG( rc, "Callback get" );
+  return rc;
+}
+
 int main( int argc, char ** argv )
 {
   int rc = 0;
@@ -260,6 +380,8 @@ int main( int argc, char ** argv )
   rc += GetTest_scatter( cs_hdl, "testTup", strs, len, 4 );
   TEST_LOG( rc, "First Get" );
 
+  rc += CallbackTest( cs_hdl );
+
   // delete the name space
   ret = dbrDelete( name );
   rc += TEST( DBR_SUCCESS, ret );
@@ -19,9 +19,11 @@
 #ifdef __APPLE__
 #include <stdlib.h>
 #else
+#include <stdlib.h>
 #include <malloc.h>
 #endif
 #include <unistd.h>
+#include <errno.h>
 #include <string.h>
 #include <sys/time.h>
 
@@ -30,63 +32,83 @@
 #include "test_utils.h"
 
 
+#define TAG_TEST_LIMIT ( 4 * dbrMAX_TAGS )
+
+static
+dbrRequestContext_t* dbrTag_test_request( DBR_Tag_t tag )
+{
+  dbrRequestContext_t *r = (dbrRequestContext_t *)malloc( sizeof (dbrRequestContext_t) + 5 * sizeof(dbBE_sge_t)  );
+  if( r == NULL )
+    return NULL;
+  memset( r, 0, sizeof( dbrRequestContext_t ) + 5 * sizeof(dbBE_sge_t) );
+  r->_req._sge_count = 5;
+  r->_tag = tag;
+  r->_status = dbrSTATUS_PENDING;
+  return r;
+}
+
 int dbrTag_get_test( dbrMain_context_t *mc )
 {
   const int TAG_TEST_COUNT = 10000;
   int rc = 0;
   int n = 0;
   DBR_Tag_t tag;
+  DBR_Tag_t *tags = (DBR_Tag_t*)calloc( TAG_TEST_LIMIT, sizeof( DBR_Tag_t ) );
 
-  if( mc == NULL )
+  if(( mc == NULL ) || ( tags == NULL ))
     return 1;
+
+  rc += TEST( mc->_config._max_tags, TAG_TEST_LIMIT );
+  rc += TEST( mc->_tag_capacity, dbrMAX_TAGS );
+
+  // the table grows beyond its initial size until the configured limit is reached
   while(( tag = dbrTag_get( mc ) ) != DB_TAG_ERROR )
   {
-    ++n;
-    dbrRequestContext_t *r = (dbrRequestContext_t *)malloc( sizeof (dbrRequestContext_t) + 5 * sizeof(dbBE_sge_t)  );
-    memset( r, 0, sizeof( dbrRequestContext_t ) + 5 * sizeof(dbBE_sge_t) );
-    r->_req._sge_count = 5;
-    mc->_cs_wq[ tag ] = r;
-
-    rc += TEST_NOT( mc->_cs_wq[ tag ], NULL );
-    LOG( DBG_INFO, stdout, "Freeing %p\n", mc->_cs_wq[ tag ] );
+    rc += TEST_NOT( n < TAG_TEST_LIMIT, 0 );
+    TEST_BREAK( rc, "Tag allocation beyond limit" );
+    dbrRequestContext_t *r = dbrTag_test_request( tag );
+    rc += TEST_NOT( r, NULL );
     TEST_BREAK( rc, "Allocation failure" );
-    mc->_cs_wq[ tag ]->_status = dbrSTATUS_PENDING;
-    LOG( DBG_INFO, stdout, "Allocated tag: %"PRId64"\n", tag );
+    rc += TEST( dbrTag_lookup( mc, tag ), NULL ); // reserved but not inserted
+    rc += TEST( dbrTag_insert( mc, tag, r ), 0 );
+    rc += TEST( dbrTag_insert( mc, tag, r ), -EINVAL );
+    rc += TEST( dbrTag_lookup( mc, tag ), r );
+    tags[ n++ ] = tag;
   }
-  rc += TEST( n < dbrMAX_TAGS, 0 );
-
   LOG( DBG_INFO, stdout, "Allocated tag count: %d\n", n );
-  rc += TEST( n, dbrMAX_TAGS );
+  rc += TEST( n, TAG_TEST_LIMIT );
+  rc += TEST( mc->_tag_capacity, TAG_TEST_LIMIT );
+  rc += TEST( mc->_tag_count, TAG_TEST_LIMIT );
 
+  // released tags get reused right away, old copies of them turn stale
   for( n = 0; n<TAG_TEST_COUNT; ++n )
   {
-    int p = random() % dbrMAX_TAGS;
-    LOG( DBG_INFO, stdout, "Testing tag %d; wqe[]=%p\n", p, mc->_cs_wq[ p ] );
-    rc += TEST( dbrValidateTag( NULL, p ), DBR_SUCCESS );
-    if( mc->_cs_wq[ p ] != NULL )
-      mc->_cs_wq[ p ]->_status = dbrSTATUS_CLOSED;
+    int p = random() % TAG_TEST_LIMIT;
+    DBR_Tag_t old = tags[ p ];
+    rc += TEST( dbrValidateTag( NULL, old ), DBR_SUCCESS );
+    rc += TEST( dbrDestroy_request( dbrTag_lookup( mc, old ) ), DBR_SUCCESS );
+    dbrTag_release( mc, old );
+    rc += TEST( dbrTag_lookup( mc, old ), NULL );
+
     tag = dbrTag_get( mc );
-    rc += TEST( tag, p );
+    rc += TEST_NOT( tag, DB_TAG_ERROR );
+    rc += TEST_NOT( tag, old );
+    rc += TEST( dbrTAG_INDEX( tag ), dbrTAG_INDEX( old ) );
 
-    dbrRequestContext_t *r = (dbrRequestContext_t *)malloc( sizeof (dbrRequestContext_t) + 5 * sizeof(dbBE_sge_t)  );
-    memset( r, 0, sizeof( dbrRequestContext_t ) + 5 * sizeof(dbBE_sge_t) );
-    r->_req._sge_count = 5;
-    mc->_cs_wq[ tag ] = r;
-    rc += TEST_NOT( mc->_cs_wq[ tag ], NULL );
+    dbrRequestContext_t *r = dbrTag_test_request( tag );
+    rc += TEST_NOT( r, NULL );
     TEST_BREAK( rc, "Allocation failure" );
-    mc->_cs_wq[ tag ]->_status = dbrSTATUS_PENDING;
-    LOG( DBG_INFO, stdout, "Allocated tag: %"PRId64"\n", tag );
-
-  }
-
-  for( n=0; n<dbrMAX_TAGS; ++n )
-  {
-    if( mc->_cs_wq[ n ] != NULL )
-      mc->_cs_wq[ n ]->_status = dbrSTATUS_CLOSED;
+    rc += TEST( dbrTag_insert( mc, old, r ), -EINVAL );
+    rc += TEST( dbrTag_insert( mc, tag, r ), 0 );
+    rc += TEST( dbrTag_lookup( mc, old ), NULL );
+    rc += TEST( dbrTag_lookup( mc, tag ), r );
+    tags[ p ] = tag;
+
+    // releasing a stale tag must not affect the current owner of the entry
+    dbrTag_release( mc, old );
+    rc += TEST( dbrTag_lookup( mc, tag ), r );
   }
-
-  // note because of status closed, this does cleanup of request entries
-  rc += TEST_NOT( dbrTag_get( mc ), DB_TAG_ERROR );
+  rc += TEST( mc->_tag_count, TAG_TEST_LIMIT );
 
   dbrRequestContext_t rctx;
   rc += TEST( dbrValidateTag( NULL, 0 ), DBR_SUCCESS );
@@ -94,21 +116,23 @@ int dbrTag_get_test( dbrMain_context_t *mc )
 #ifdef DBR_INTTAG
   rc += TEST( dbrValidateTag( &rctx, 0 ), DBR_SUCCESS );
   rc += TEST( dbrValidateTag( &rctx, DB_TAG_ERROR ), DBR_ERR_TAGERROR );
-  rc += TEST( dbrValidateTag( &rctx, dbrMAX_TAGS - 1 ), DBR_SUCCESS );
-  rc += TEST( dbrValidateTag( &rctx, dbrMAX_TAGS ), DBR_ERR_TAGERROR );
+  rc += TEST( dbrTag_lookup( mc, DB_TAG_ERROR ), NULL );
+  rc += TEST( dbrTag_lookup( mc, dbrTAG_MAKE( TAG_TEST_LIMIT, 0 ) ), NULL );
 #else
   rc += TEST( dbrValidateTag( &rctx, NULL ), DBR_ERR_TAGERROR );
   rc += TEST( dbrValidateTag( &rctx, DB_TAG_ERROR ), DBR_ERR_TAGERROR );
 #endif
 
   // test cleanup any remaining
-  for( n=0; n<dbrMAX_TAGS; ++n )
+  for( n=0; n<TAG_TEST_LIMIT; ++n )
   {
-    if( mc->_cs_wq[ n ] != NULL )
-      rc += TEST( dbrDestroy_request( mc->_cs_wq[ n ] ), DBR_SUCCESS );
-    mc->_cs_wq[ n ] = NULL;
+    rc += TEST( dbrDestroy_request( dbrTag_lookup( mc, tags[ n ] ) ), DBR_SUCCESS );
+    dbrTag_release( mc, tags[ n ] );
   }
+  rc += TEST( mc->_tag_count, 0 );
+  rc += TEST_NOT( dbrTag_get( mc ), DB_TAG_ERROR );
 
+  free( tags );
   return rc;
 }
 
@@ -132,6 +156,9 @@ int main( int argc, char ** argv )
   // testing of dbrTag_get
   rc += TEST( dbrTag_get( NULL ), DB_TAG_ERROR );
 
+  char limit[ 32 ];
+  snprintf( limit, sizeof( limit ), "%d", TAG_TEST_LIMIT );
+  setenv( DBR_MAX_TAGS_ENV, limit, 1 );
   mc = dbrCheckCreateMainCTX();
   rc += dbrTag_get_test( mc );
 
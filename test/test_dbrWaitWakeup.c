@@ -0,0 +1,148 @@
+/*
+ * Copyright © 2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef DEBUG_LEVEL
+#define DEBUG_LEVEL DBG_VERBOSE
+#endif
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/time.h>
+
+#include <libdatabroker.h>
+#include "test_utils.h"
+
+#define TEST_TIMEOUT_SEC "10"        // library timeout, the sleeper has to wake up long before
+#define TEST_SLEEP_DELAY_USEC ( 100000 )  // gives the sleeper time to pass the spinning phase
+#define TEST_WAKEUP_LIMIT_USEC ( 1000000 )
+#define TEST_ROUNDS ( 8 )
+
+typedef struct
+{
+  DBR_Handle_t _cs_hdl;
+  DBR_Tuple_name_t _key;
+  int _use_tag;              ///< wait with dbrWaitAny() instead of the blocking dbrGet()
+  int _started;
+  DBR_Errorcode_t _status;
+  char _out[ 64 ];
+  int64_t _out_size;
+  int64_t _elapsed_usec;
+} Sleeper_t;
+
+int64_t now_usec()
+{
+  struct timeval now;
+  gettimeofday( &now, NULL );
+  return (int64_t)now.tv_sec * 1000000 + now.tv_usec;
+}
+
+/*
+ * waits for a tuple that doesn't exist yet, so it ends up sleeping in the library
+ */
+void* Sleeper( void *arg )
+{
+  Sleeper_t *self = (Sleeper_t*)arg;
+  self->_out_size = 64;
+  memset( self->_out, 0, 64 );
+  __atomic_store_n( &self->_started, 1, __ATOMIC_RELEASE );
+
+  int64_t start = now_usec();
+  if( self->_use_tag )
+  {
+    DBR_Tag_t tag = dbrGetA( self->_cs_hdl, self->_out, &self->_out_size, self->_key, "", 0, DBR_FLAGS_NONE );
+    int index = -1;
+    self->_status = DBR_ERR_TAGERROR;
+    if( tag != DB_TAG_ERROR )
+      dbrWaitAny( 1, &tag, &index, &self->_status );
+  }
+  else
+    self->_status = dbrGet( self->_cs_hdl, self->_out, &self->_out_size, self->_key, "", 0, DBR_FLAGS_NONE );
+  self->_elapsed_usec = now_usec() - start;
+  return NULL;
+}
+
+/*
+ * one thread sleeps in a wait while the main thread posts the tuple it waits for
+ * the post has to get the back-end from the sleeper and the sleeper has to wake up for the completion
+ */
+int WakeupTest( DBR_Handle_t cs_hdl, const int use_tag )
+{
+  int rc = 0;
+  char *in = (char*)"Wake up!";
+  int in_size = strlen( in );
+
+  Sleeper_t sleeper;
+  memset( &sleeper, 0, sizeof( sleeper ) );
+  sleeper._cs_hdl = cs_hdl;
+  sleeper._key = (DBR_Tuple_name_t)"wakeup";
+  sleeper._use_tag = use_tag;
+
+  pthread_t thread;
+  rc += TEST( 0, pthread_create( &thread, NULL, Sleeper, &sleeper ) );
+  if( rc != 0 )
+    return rc;
+
+  while( __atomic_load_n( &sleeper._started, __ATOMIC_ACQUIRE ) == 0 )
+    sched_yield();
+  usleep( TEST_SLEEP_DELAY_USEC );
+
+  int64_t start = now_usec();
+  rc += TEST( DBR_SUCCESS, dbrPut( cs_hdl, in, in_size, sleeper._key, DBR_GROUP_EMPTY ) );
+  int64_t put_usec = now_usec() - start;
+
+  pthread_join( thread, NULL );
+
+  rc += TEST( DBR_SUCCESS, sleeper._status );
+  rc += TEST( in_size, sleeper._out_size );
+  rc += TEST( 0, strncmp( in, sleeper._out, 64 ) );
+  rc += TEST( 1, put_usec < TEST_WAKEUP_LIMIT_USEC );
+  rc += TEST( 1, sleeper._elapsed_usec >= TEST_SLEEP_DELAY_USEC );
+  rc += TEST( 1, sleeper._elapsed_usec < TEST_SLEEP_DELAY_USEC + TEST_WAKEUP_LIMIT_USEC );
+  fprintf( stderr, "TEST: sleeper (%s) woke up after %"PRId64"us, put took %"PRId64"us\n",
+           use_tag ? "dbrWaitAny" : "dbrGet", sleeper._elapsed_usec, put_usec );
+  return rc;
+}
+
+int main( int argc, char ** argv )
+{
+  int rc = 0;
+  int n;
+
+  // has to be in place before the library reads its configuration
+  setenv( DBR_TIMEOUT_ENV, TEST_TIMEOUT_SEC, 1 );
+
+  DBR_Name_t name = strdup("cstestname");
+  DBR_Handle_t cs_hdl = dbrCreate( name, DBR_PERST_VOLATILE_SIMPLE, 0 );
+  rc += TEST_NOT( NULL, cs_hdl );
+  TEST_BREAK( rc, "Name space creation failed" );
+
+  for( n = 0; n < TEST_ROUNDS; ++n )
+  {
+    rc += WakeupTest( cs_hdl, n & 1 );
+    TEST_LOG( rc, "Wakeup of a sleeping waiter" );
+  }
+
+  rc += TEST( DBR_SUCCESS, dbrDelete( name ) );
+
+  free( name );
+  printf( "Test exiting with rc=%d\n", rc );
+  return rc;
+}
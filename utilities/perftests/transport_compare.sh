@@ -0,0 +1,41 @@
+#!/bin/bash
+#
+# Copyright © 2020 IBM Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+#
+# Compare loopback TCP and unix domain socket transport to a node-local server.
+# The server has to listen on both, e.g. for Redis:
+#    redis-server --port 6379 --unixsocket /tmp/redis.sock
+#
+# Usage: transport_compare.sh [options passed to single]
+#    TCP_URL   tcp url of the server  (sock://localhost:6379)
+#    UNIX_URL  unix socket url        (unix:///tmp/redis.sock)
+#    SINGLE    path to the single benchmark (next to this script)
+#
+TCP_URL=${TCP_URL:-sock://localhost:6379}
+UNIX_URL=${UNIX_URL:-unix:///tmp/redis.sock}
+SINGLE=${SINGLE:-$(dirname $0)/single}
+
+if [ ! -x "$SINGLE" ]; then
+    echo "Cannot find the single benchmark at $SINGLE" >&2
+    exit 1
+fi
+
+rc=0
+for url in $TCP_URL $UNIX_URL; do
+    echo "### DBR_SERVER=$url"
+    DBR_SERVER=$url $SINGLE "$@" || rc=1
+done
+exit $rc